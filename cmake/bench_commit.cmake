@@ -0,0 +1,21 @@
+# writes BENCH_COMMIT_FILE with the commit checked out right now. run by the
+# bench_commit target on every build, the file is only rewritten when the
+# commit changed so main_bench.c is not rebuilt for nothing
+execute_process(
+    COMMAND git rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE BENCH_COMMIT
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET
+)
+if(NOT BENCH_COMMIT)
+    set(BENCH_COMMIT unknown)
+endif()
+set(BENCH_COMMIT_CONTENT "#define BENCH_COMMIT \"${BENCH_COMMIT}\"\n")
+set(BENCH_COMMIT_OLD "")
+if(EXISTS ${BENCH_COMMIT_FILE})
+    file(READ ${BENCH_COMMIT_FILE} BENCH_COMMIT_OLD)
+endif()
+if(NOT BENCH_COMMIT_OLD STREQUAL BENCH_COMMIT_CONTENT)
+    file(WRITE ${BENCH_COMMIT_FILE} "${BENCH_COMMIT_CONTENT}")
+endif()
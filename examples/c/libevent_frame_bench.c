@@ -0,0 +1,183 @@
+// libevent frame throughput bench against a local echo peer.
+// one event base runs an echo server and a client on 127.0.0.1. the client
+// keeps a window of frames in flight and decodes the echo with either
+//   frame: libevent_frame_dispatch (in place, all frames per read)
+//   copy : header copyout + malloc + copyout per frame (old GameMessage path)
+// usage: libevent_frame_bench [payload_bytes] [frames]
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+#endif
+
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/listener.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libevent_frame.h"
+
+#define WINDOW_FRAMES 4096 // frames in flight
+
+typedef struct {
+    struct event_base *base;
+    struct bufferevent *client;
+    struct evconnlistener *listener;
+    struct bufferevent *echo;
+    uint8_t *payload;
+    uint16_t payload_size;
+    long total;         // frames to send
+    long sent;
+    long received;
+    uint64_t bytes;     // payload bytes received
+    uint64_t checksum;  // keeps the decode from being optimized out
+    int use_copy;
+} bench_t;
+
+static double now_seconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void send_frames(bench_t *b, long count){
+    struct evbuffer *output = bufferevent_get_output(b->client);
+    while (count-- > 0 && b->sent < b->total) {
+        libevent_frame_write(output, LIBEVENT_MSG_CHAT, b->payload, b->payload_size);
+        b->sent++;
+    }
+}
+
+// echo server
+static void echo_read_cb(struct bufferevent *bev, void *ctx){
+    evbuffer_add_buffer(bufferevent_get_output(bev), bufferevent_get_input(bev));
+}
+
+static void echo_event_cb(struct bufferevent *bev, short events, void *ctx){
+    if (events & (BEV_EVENT_EOF | BEV_EVENT_ERROR)) bufferevent_free(bev);
+}
+
+static void accept_cb(struct evconnlistener *listener, evutil_socket_t fd, struct sockaddr *addr, int len, void *ctx){
+    bench_t *b = (bench_t *)ctx;
+    b->echo = bufferevent_socket_new(b->base, fd, BEV_OPT_CLOSE_ON_FREE);
+    bufferevent_setcb(b->echo, echo_read_cb, NULL, echo_event_cb, b);
+    bufferevent_enable(b->echo, EV_READ | EV_WRITE);
+}
+
+// client decode
+static bool on_frame(uint16_t type, const uint8_t *frame, size_t frame_length, void *user){
+    bench_t *b = (bench_t *)user;
+    b->received++;
+    b->bytes += frame_length - LIBEVENT_FRAME_HEADER_SIZE;
+    b->checksum += frame[frame_length - 1] + type;
+    return true;
+}
+
+static long decode_copy(bench_t *b, struct evbuffer *input){
+    long frames = 0;
+    for (;;) {
+        size_t len = evbuffer_get_length(input);
+        uint8_t header[LIBEVENT_FRAME_HEADER_SIZE];
+        if (len < sizeof(header)) break;
+        evbuffer_copyout(input, header, sizeof(header));
+        size_t frame_length = sizeof(header) + (size_t)((header[2] << 8) | header[3]);
+        if (len < frame_length) break;
+        uint8_t *buf = malloc(frame_length);
+        if (!buf) break;
+        evbuffer_copyout(input, buf, frame_length);
+        evbuffer_drain(input, frame_length);
+        on_frame((uint16_t)((buf[0] << 8) | buf[1]), buf, frame_length, b);
+        free(buf);
+        frames++;
+    }
+    return frames;
+}
+
+static void client_read_cb(struct bufferevent *bev, void *ctx){
+    bench_t *b = (bench_t *)ctx;
+    struct evbuffer *input = bufferevent_get_input(bev);
+    long frames = b->use_copy ? decode_copy(b, input) : libevent_frame_dispatch(input, on_frame, b);
+    send_frames(b, frames);
+    if (b->received >= b->total) event_base_loopbreak(b->base);
+}
+
+static void client_event_cb(struct bufferevent *bev, short events, void *ctx){
+    bench_t *b = (bench_t *)ctx;
+    if (events & BEV_EVENT_CONNECTED) {
+        send_frames(b, WINDOW_FRAMES);
+    } else if (events & (BEV_EVENT_EOF | BEV_EVENT_ERROR)) {
+        printf("client connection error\n");
+        event_base_loopbreak(b->base);
+    }
+}
+
+static int run(uint16_t payload_size, long total, int use_copy){
+    bench_t b = {0};
+    b.payload_size = payload_size;
+    b.total = total;
+    b.use_copy = use_copy;
+    b.payload = malloc(payload_size ? payload_size : 1);
+    for (uint16_t i = 0; i < payload_size; i++) b.payload[i] = (uint8_t)i;
+
+    b.base = event_base_new();
+    struct sockaddr_in sin = {0};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sin.sin_port = 0; // any free port
+    b.listener = evconnlistener_new_bind(b.base, accept_cb, &b, LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE, -1, (struct sockaddr *)&sin, sizeof(sin));
+    if (!b.listener) {
+        printf("listener failed\n");
+        return 1;
+    }
+    struct sockaddr_in bound = {0};
+    socklen_t bound_len = sizeof(bound);
+    getsockname(evconnlistener_get_fd(b.listener), (struct sockaddr *)&bound, &bound_len);
+
+    b.client = bufferevent_socket_new(b.base, -1, BEV_OPT_CLOSE_ON_FREE);
+    bufferevent_setcb(b.client, client_read_cb, NULL, client_event_cb, &b);
+    bufferevent_enable(b.client, EV_READ | EV_WRITE);
+    bufferevent_socket_connect(b.client, (struct sockaddr *)&bound, sizeof(bound));
+
+    double start = now_seconds();
+    event_base_dispatch(b.base);
+    double elapsed = now_seconds() - start;
+
+    printf("%-5s payload %5u frames %8ld  %8.3f s  %10.0f frames/s  %8.1f MB/s  (%llu)\n",
+        use_copy ? "copy" : "frame", payload_size, b.received, elapsed,
+        (double)b.received / elapsed, (double)b.bytes / elapsed / (1024.0 * 1024.0),
+        (unsigned long long)b.checksum);
+
+    bufferevent_free(b.client);
+    if (b.echo) bufferevent_free(b.echo);
+    evconnlistener_free(b.listener);
+    event_base_free(b.base);
+    free(b.payload);
+    return 0;
+}
+
+int main(int argc, char **argv){
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return 1;
+#endif
+    long payload = argc > 1 ? atol(argv[1]) : 64;
+    long frames = argc > 2 ? atol(argv[2]) : 1000000;
+    if (payload < 1 || payload > LIBEVENT_FRAME_MAX_PAYLOAD) payload = 64;
+
+    run((uint16_t)payload, frames, 1);
+    run((uint16_t)payload, frames, 0);
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 0;
+}
@@ -0,0 +1,595 @@
+// raylib 5.5
+// flecs v4.1.1
+// benchmark suite, no window. every scenario builds its own world with
+// fixed sizes and seeds so runs on different commits compare directly.
+//   transform_deep : chains of Transform3D children, update_transform_3d_system
+//   transform_wide : one root, two levels of wide children
+//   render_list    : block_t instances grouped by type, no draw calls
+//   ode_pile       : columns of boxes on a plane, ode_physics_system steps
+//   enet_loopback  : simulated peers on 127.0.0.1, network_service_system receives
+//                    and the enet outbox echoes every message back batched
+//   scene_load     : a saved level of block_t children read back with scene_load
+//   lua_system     : a script system moving Transform3D through field views
+//   lua_baseline   : the same work in a C system, the difference over items
+//                    is the per entity cost of the script binding
+// results go to stdout and a json file, one entry per scenario with
+// min/median/mean ms per iteration and items (entities, bodies, messages)
+// usage: bench [results.json] [scenario substring]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ecs_components.h"
+#include "module_block.h"
+#include "module_enet.h"
+#include "module_ode.h"
+#include "module_scene.h"
+#include "module_lua.h"
+
+#ifdef BENCH_COMMIT_HEADER
+    #include "bench_commit.h" // written from git by the bench_commit target on every build
+#endif
+#ifndef BENCH_COMMIT
+    #define BENCH_COMMIT "unknown"
+#endif
+
+#define BENCH_MAX_SAMPLES 512
+#define BENCH_MAX_RESULTS 16
+
+#define DEEP_CHAINS 16
+#define DEEP_DEPTH 128
+#define WIDE_CHILDREN 64            // per node, two levels below the root
+#define RENDER_BLOCKS 65536
+#define ODE_COLUMNS 8               // per side
+#define ODE_HEIGHT 8
+#define ODE_STEPS 240
+#define ENET_PORT 27655
+#define ENET_PEERS 16
+#define ENET_MESSAGES 2048          // per peer per round
+#define ENET_MESSAGE_SIZE 64
+#define ENET_BURST 64               // packets queued per peer per tick
+#define ENET_ROUNDS 5
+#define ENET_TIMEOUT 10.0           // seconds per round
+#define SCENE_ROOTS 1000
+#define SCENE_CHILDREN 199          // per root, 200k entities in all
+#define SCENE_ITERATIONS 5
+#define SCENE_PATH "bench.scene"
+#define LUA_ENTITIES 10000
+#define LUA_ITERATIONS 100
+
+typedef struct {
+    const char *name;
+    int64_t items;                  // per iteration
+    int32_t iterations;
+    double min_ms;
+    double median_ms;
+    double mean_ms;
+    double checksum;                // keeps the work from being optimized out
+    bool failed;
+} bench_result_t;
+
+static double now_seconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compare_double(const void *a, const void *b){
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_finish(bench_result_t *result, double *samples, int32_t count){
+    result->iterations = count;
+    if (count == 0) {
+        result->failed = true;
+        return;
+    }
+    double sum = 0.0;
+    for (int32_t i = 0; i < count; i++) sum += samples[i];
+    qsort(samples, (size_t)count, sizeof(double), compare_double);
+    result->min_ms = samples[0];
+    result->median_ms = samples[count / 2];
+    result->mean_ms = sum / count;
+}
+
+//===============================================
+// TRANSFORM
+//===============================================
+static ecs_entity_t bench_node(ecs_world_t *world, ecs_entity_t parent, Vector3 position){
+    ecs_entity_t e = parent ? ecs_new_w_pair(world, EcsChildOf, parent) : ecs_new(world);
+    ecs_set(world, e, Transform3D, {
+        .position = position,
+        .rotation = QuaternionIdentity(),
+        .scale = (Vector3){ 1.0f, 1.0f, 1.0f },
+        .localMatrix = MatrixIdentity(),
+        .worldMatrix = MatrixIdentity(),
+        .isDirty = true
+    });
+    return e;
+}
+
+// roots turn a little every iteration so the whole tree is recomputed
+static void bench_transform_run(ecs_world_t *world, const ecs_entity_t *roots, int32_t root_count,
+                                const ecs_entity_t *leaves, int32_t leaf_count, int32_t iterations, bench_result_t *result){
+    ecs_entity_t system = ecs_lookup(world, "update_transform_3d_system");
+    double samples[BENCH_MAX_SAMPLES];
+    int32_t count = 0;
+    for (int32_t i = 0; i < iterations + 2 && count < BENCH_MAX_SAMPLES; i++) {
+        for (int32_t r = 0; r < root_count; r++) {
+            Transform3D *transform = ecs_get_mut(world, roots[r], Transform3D);
+            transform->rotation = QuaternionFromAxisAngle((Vector3){ 0.0f, 1.0f, 0.0f }, i * 0.01f);
+            transform->isDirty = true;
+        }
+        double start = now_seconds();
+        ecs_run(world, system, 0.0f, NULL);
+        double ms = (now_seconds() - start) * 1000.0;
+        if (i >= 2) samples[count++] = ms; // first runs warm the tables
+    }
+    for (int32_t l = 0; l < leaf_count; l++) {
+        result->checksum += ecs_get(world, leaves[l], Transform3D)->worldMatrix.m12;
+    }
+    bench_finish(result, samples, count);
+}
+
+static bench_result_t bench_transform_deep(void){
+    bench_result_t result = { .name = "transform_deep", .items = DEEP_CHAINS * DEEP_DEPTH };
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    ecs_entity_t roots[DEEP_CHAINS], leaves[DEEP_CHAINS];
+    for (int32_t c = 0; c < DEEP_CHAINS; c++) {
+        ecs_entity_t node = bench_node(world, 0, (Vector3){ (float)c, 0.0f, 0.0f });
+        roots[c] = node;
+        for (int32_t d = 1; d < DEEP_DEPTH; d++) node = bench_node(world, node, (Vector3){ 0.0f, 0.1f, 0.0f });
+        leaves[c] = node;
+    }
+    bench_transform_run(world, roots, DEEP_CHAINS, leaves, DEEP_CHAINS, 20, &result);
+    ecs_fini(world);
+    return result;
+}
+
+static bench_result_t bench_transform_wide(void){
+    bench_result_t result = { .name = "transform_wide", .items = 1 + WIDE_CHILDREN + WIDE_CHILDREN * WIDE_CHILDREN };
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    ecs_entity_t root = bench_node(world, 0, (Vector3){ 0 });
+    ecs_entity_t leaves[WIDE_CHILDREN];
+    for (int32_t c = 0; c < WIDE_CHILDREN; c++) {
+        ecs_entity_t child = bench_node(world, root, (Vector3){ (float)c, 0.0f, 0.0f });
+        for (int32_t g = 0; g < WIDE_CHILDREN; g++) {
+            leaves[c] = bench_node(world, child, (Vector3){ 0.0f, (float)g, 0.0f });
+        }
+    }
+    bench_transform_run(world, &root, 1, leaves, WIDE_CHILDREN, 50, &result);
+    ecs_fini(world);
+    return result;
+}
+
+//===============================================
+// RENDER LIST
+//===============================================
+// the gather half of render_3d_blocks_system, the null backend only sums
+// the grouped matrices instead of drawing them
+static bench_result_t bench_render_list(void){
+    bench_result_t result = { .name = "render_list", .items = RENDER_BLOCKS };
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    module_init_block(world);
+    block_id_t types[4] = {
+        block_register_type(world, "grass", (int[BLOCK_FACE_COUNT]){ 1, 1, 1, 1, 0, 2 }),
+        block_register_type(world, "dirt", (int[BLOCK_FACE_COUNT]){ 2, 2, 2, 2, 2, 2 }),
+        block_register_type(world, "stone", (int[BLOCK_FACE_COUNT]){ 3, 3, 3, 3, 3, 3 }),
+        block_register_type(world, "sand", (int[BLOCK_FACE_COUNT]){ 4, 4, 4, 4, 4, 4 })
+    };
+    srand(1);
+    for (int32_t i = 0; i < RENDER_BLOCKS; i++) {
+        ecs_entity_t e = ecs_new(world);
+        Vector3 position = { (float)(i % 256), 0.0f, (float)(i / 256) };
+        ecs_set(world, e, Transform3D, {
+            .position = position,
+            .rotation = QuaternionIdentity(),
+            .scale = (Vector3){ 1.0f, 1.0f, 1.0f },
+            .localMatrix = MatrixTranslate(position.x, position.y, position.z),
+            .worldMatrix = MatrixTranslate(position.x, position.y, position.z)
+        });
+        ecs_set(world, e, block_t, { .type = types[rand() % 4] });
+    }
+
+    double samples[BENCH_MAX_SAMPLES];
+    int32_t count = 0;
+    for (int32_t i = 0; i < 52; i++) {
+        int32_t counts[BLOCK_MAX_TYPES];
+        double start = now_seconds();
+        int32_t total = block_instances_build(world, counts);
+        const block_world_t *bw = ecs_singleton_get(world, block_world_t);
+        double sum = 0.0;
+        for (int32_t n = 0; n < total; n++) sum += bw->instances[n].m12;
+        double ms = (now_seconds() - start) * 1000.0;
+        result.checksum = sum + counts[types[0]];
+        if (i >= 2) samples[count++] = ms;
+    }
+    bench_finish(&result, samples, count);
+    ecs_fini(world);
+    return result;
+}
+
+//===============================================
+// ODE
+//===============================================
+static bench_result_t bench_ode_pile(void){
+    bench_result_t result = { .name = "ode_pile", .items = ODE_COLUMNS * ODE_COLUMNS * ODE_HEIGHT };
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    module_init_ode(world);
+    const ode_context_t *ctx = ecs_singleton_get(world, ode_context_t);
+    dCreatePlane(ctx->space, 0, 1, 0, 0);
+
+    // staggered columns so the piles topple into each other
+    srand(1);
+    dBodyID bodies[ODE_COLUMNS * ODE_COLUMNS * ODE_HEIGHT];
+    int32_t body_count = 0;
+    for (int32_t x = 0; x < ODE_COLUMNS; x++) {
+        for (int32_t z = 0; z < ODE_COLUMNS; z++) {
+            for (int32_t y = 0; y < ODE_HEIGHT; y++) {
+                dBodyID body = dBodyCreate(ctx->world);
+                dMass mass;
+                dMassSetBox(&mass, 1.0, 1.0, 1.0, 1.0);
+                dBodySetMass(body, &mass);
+                dGeomID geom = dCreateBox(ctx->space, 1.0, 1.0, 1.0);
+                dGeomSetBody(geom, body);
+                float jitter = (float)rand() / (float)RAND_MAX * 0.3f;
+                dBodySetPosition(body, x * 1.1f + jitter, 0.5f + y * 1.05f, z * 1.1f + (y % 2) * 0.4f);
+                ecs_entity_t e = ecs_new(world);
+                ecs_set(world, e, ode_body_t, { .id = body });
+                ecs_set(world, e, ode_geom_t, { .id = geom });
+                bodies[body_count++] = body;
+            }
+        }
+    }
+
+    ecs_entity_t system = ecs_lookup(world, "ode_physics_system");
+    double samples[BENCH_MAX_SAMPLES];
+    int32_t count = 0;
+    for (int32_t i = 0; i < ODE_STEPS && count < BENCH_MAX_SAMPLES; i++) {
+        double start = now_seconds();
+        ecs_run(world, system, 1.0f / 60.0f, NULL);
+        samples[count++] = (now_seconds() - start) * 1000.0;
+    }
+    for (int32_t b = 0; b < body_count; b++) result.checksum += dBodyGetPosition(bodies[b])[1];
+    bench_finish(&result, samples, count);
+    ecs_fini(world);
+    return result;
+}
+
+//===============================================
+// ENET
+//===============================================
+// the bench world is the server. network_service_system receives the
+// messages of ENET_PEERS simulated clients and the observer echoes every
+// one through enet_outbox_send, batched and sent by enet_outbox_flush_system.
+// the clients are bare enet hosts on 127.0.0.1, only the world's systems
+// are timed.
+#define ENET_MSG_BENCH (ENET_MSG_BINARY_MAX - 1) // binary, the text observer skips it
+
+typedef struct {
+    ENetHost *clients[ENET_PEERS];
+    ENetPeer *peers[ENET_PEERS];    // client side
+    int64_t received;               // by the world
+    int64_t echoed;                 // back at the clients
+    uint64_t checksum;
+} bench_net_t;
+
+// world side, one call per message
+static void bench_net_on_packet(ecs_iter_t *it){
+    bench_net_t *net = it->ctx;
+    const enet_packet_t *packet = it->param;
+    const uint8_t *data = packet ? packet->data : NULL;
+    if (!data || packet->length < 1 + sizeof(uint32_t) || data[0] != ENET_MSG_BENCH) return;
+    uint32_t sequence;
+    memcpy(&sequence, data + 1, sizeof(sequence));
+    net->checksum += sequence;
+    net->received++;
+    enet_outbox_send(it->world, packet->peer, packet->data, packet->length, true);
+}
+
+// client side, the echoes arrive as outbox batches
+static void bench_net_service(bench_net_t *net){
+    ENetEvent event;
+    for (int32_t p = 0; p < ENET_PEERS; p++) {
+        while (enet_host_service(net->clients[p], &event, 0) > 0) {
+            if (event.type != ENET_EVENT_TYPE_RECEIVE) continue;
+            const uint8_t *data = event.packet->data;
+            size_t length = event.packet->dataLength;
+            if (length > 0 && data[0] == ENET_MSG_BATCH) {
+                size_t offset = 1;
+                while (offset + 2 <= length) {
+                    size_t size = (size_t)data[offset] | ((size_t)data[offset + 1] << 8);
+                    offset += 2 + size;
+                    net->echoed++;
+                }
+            } else if (length > 0) {
+                net->echoed++;
+            }
+            enet_packet_destroy(event.packet);
+        }
+    }
+}
+
+// one world tick: reset the outbox counters, receive, flush the batches
+static double bench_net_tick(ecs_world_t *world, const ecs_entity_t systems[3]){
+    double start = now_seconds();
+    for (int32_t s = 0; s < 3; s++) ecs_run(world, systems[s], 0.0f, NULL);
+    return now_seconds() - start;
+}
+
+static bench_result_t bench_enet_loopback(void){
+    bench_result_t result = { .name = "enet_loopback", .items = (int64_t)ENET_PEERS * ENET_MESSAGES };
+    bench_net_t net = { 0 };
+    if (enet_initialize() != 0) {
+        result.failed = true;
+        return result;
+    }
+    ENetAddress address = { 0 };
+    enet_address_set_host(&address, "127.0.0.1");
+    address.port = ENET_PORT;
+    ENetHost *server = enet_host_create(&address, ENET_PEERS, 1, 0, 0);
+    bool ok = server != NULL;
+
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    module_init_enet(world);
+    ecs_singleton_set(world, NetworkState, { .host = server, .serverStarted = true, .isServer = true });
+    ecs_observer(world, {
+        .query.terms = {{ EcsAny, .src.id = event_receive_packed }},
+        .events = { ecs_id(enet_packet_t) },
+        .callback = bench_net_on_packet,
+        .ctx = &net
+    });
+    const ecs_entity_t systems[3] = {
+        ecs_lookup(world, "enet_outbox_tick_system"),
+        ecs_lookup(world, "network_service_system"),
+        ecs_lookup(world, "enet_outbox_flush_system")
+    };
+
+    for (int32_t p = 0; ok && p < ENET_PEERS; p++) {
+        net.clients[p] = enet_host_create(NULL, 1, 1, 0, 0);
+        net.peers[p] = net.clients[p] ? enet_host_connect(net.clients[p], &address, 1, 0) : NULL;
+        ok = net.peers[p] != NULL;
+    }
+    // a peer entity with an outbox per connected client
+    double deadline = now_seconds() + ENET_TIMEOUT;
+    while (ok && ecs_count_id(world, ecs_id(enet_outbox_t)) < ENET_PEERS && now_seconds() < deadline) {
+        bench_net_tick(world, systems);
+        bench_net_service(&net);
+    }
+    ok = ok && ecs_count_id(world, ecs_id(enet_outbox_t)) == ENET_PEERS;
+
+    uint8_t message[ENET_MESSAGE_SIZE] = { ENET_MSG_BENCH };
+    double samples[ENET_ROUNDS];
+    int32_t count = 0;
+    uint32_t sequence = 0;
+    for (int32_t round = 0; ok && round < ENET_ROUNDS; round++) {
+        int64_t target = net.echoed + (int64_t)ENET_PEERS * ENET_MESSAGES;
+        int32_t sent = 0;
+        double world_seconds = 0.0;
+        deadline = now_seconds() + ENET_TIMEOUT;
+        while (net.echoed < target && now_seconds() < deadline) {
+            for (int32_t p = 0; p < ENET_PEERS && sent < ENET_MESSAGES; p++) {
+                for (int32_t b = 0; b < ENET_BURST && sent + b < ENET_MESSAGES; b++) {
+                    sequence++;
+                    memcpy(message + 1, &sequence, sizeof(sequence));
+                    enet_peer_send(net.peers[p], 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+                }
+                enet_host_flush(net.clients[p]);
+            }
+            sent = sent + ENET_BURST < ENET_MESSAGES ? sent + ENET_BURST : ENET_MESSAGES;
+            world_seconds += bench_net_tick(world, systems);
+            bench_net_service(&net);
+        }
+        ok = net.echoed == target;
+        if (ok) samples[count++] = world_seconds * 1000.0;
+    }
+    result.checksum = (double)net.checksum;
+
+    for (int32_t p = 0; p < ENET_PEERS; p++) {
+        if (net.peers[p]) enet_peer_disconnect_now(net.peers[p], 0);
+        if (net.clients[p]) enet_host_destroy(net.clients[p]);
+    }
+    ecs_fini(world);
+    if (server) enet_host_destroy(server);
+    enet_deinitialize();
+    bench_finish(&result, samples, count);
+    result.failed = result.failed || !ok;
+    return result;
+}
+
+//===============================================
+// SCENE
+//===============================================
+// every iteration loads into a new world, only scene_load is timed
+static bench_result_t bench_scene_load(void){
+    bench_result_t result = { .name = "scene_load", .items = SCENE_ROOTS * (1 + SCENE_CHILDREN) };
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    module_init_block(world);
+    module_init_scene(world);
+    block_id_t type = block_register_type(world, "grass", (int[BLOCK_FACE_COUNT]){ 1, 1, 1, 1, 0, 2 });
+    for (int32_t r = 0; r < SCENE_ROOTS; r++) {
+        ecs_entity_t root = bench_node(world, 0, (Vector3){ (float)(r % 32) * 16.0f, 0.0f, (float)(r / 32) * 16.0f });
+        char name[32];
+        snprintf(name, sizeof(name), "root_%d", (int)r);
+        ecs_set_name(world, root, name);
+        for (int32_t c = 0; c < SCENE_CHILDREN; c++) {
+            ecs_entity_t child = bench_node(world, root, (Vector3){ (float)(c % 16), (float)(c / 16), 0.0f });
+            ecs_set(world, child, block_t, { .type = type });
+        }
+    }
+    bool ok = scene_save(world, SCENE_PATH) == result.items;
+    ecs_fini(world);
+
+    double samples[BENCH_MAX_SAMPLES];
+    int32_t count = 0;
+    for (int32_t i = 0; ok && i < SCENE_ITERATIONS; i++) {
+        world = ecs_init();
+        module_init_raylib(world);
+        module_init_block(world);
+        module_init_scene(world);
+        block_register_type(world, "grass", (int[BLOCK_FACE_COUNT]){ 1, 1, 1, 1, 0, 2 });
+        double start = now_seconds();
+        int32_t loaded = scene_load(world, SCENE_PATH);
+        samples[count++] = (now_seconds() - start) * 1000.0;
+        ok = loaded == result.items;
+        result.checksum += loaded;
+        ecs_fini(world);
+    }
+    remove(SCENE_PATH);
+    bench_finish(&result, samples, count);
+    result.failed = result.failed || !ok;
+    return result;
+}
+
+//===============================================
+// LUA
+//===============================================
+static const char *bench_lua_source =
+    "ecs.system{\n"
+    "    name = 'bench_lua_system', phase = 'LogicUpdate', query = { 'Transform3D' },\n"
+    "    callback = function(it)\n"
+    "        local y = it:field(1, 'position.y')\n"
+    "        local dirty = it:field(1, 'isDirty')\n"
+    "        local dt = it.delta_time\n"
+    "        for i = 1, it.count do\n"
+    "            y[i] = y[i] + dt\n"
+    "            dirty[i] = true\n"
+    "        end\n"
+    "    end\n"
+    "}\n";
+
+static void bench_lua_baseline_system(ecs_iter_t *it){
+    Transform3D *transform = ecs_field(it, Transform3D, 0);
+    for (int i = 0; i < it->count; i++) {
+        transform[i].position.y += it->delta_time;
+        transform[i].isDirty = true;
+    }
+}
+
+// only the one system runs, the transform update is not part of it
+static bench_result_t bench_lua_run(const char *name, bool script){
+    bench_result_t result = { .name = name, .items = LUA_ENTITIES };
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    module_init_lua(world);
+    ecs_entity_t system = 0;
+    if (script) {
+        if (lua_script_run(world, bench_lua_source, "bench")) system = ecs_lookup(world, "bench_lua_system");
+    } else {
+        system = ecs_system(world, {
+            .entity = ecs_entity(world, { .name = "bench_lua_baseline_system" }),
+            .query.terms = {{ .id = ecs_id(Transform3D) }},
+            .callback = bench_lua_baseline_system
+        });
+    }
+    ecs_entity_t first = 0;
+    for (int32_t i = 0; i < LUA_ENTITIES; i++) {
+        ecs_entity_t e = bench_node(world, 0, (Vector3){ (float)(i % 100), 0.0f, (float)(i / 100) });
+        if (i == 0) first = e;
+    }
+
+    double samples[BENCH_MAX_SAMPLES];
+    int32_t count = 0;
+    for (int32_t i = 0; system && i < LUA_ITERATIONS + 2 && count < BENCH_MAX_SAMPLES; i++) {
+        double start = now_seconds();
+        ecs_run(world, system, 0.001f, NULL);
+        double ms = (now_seconds() - start) * 1000.0;
+        if (i >= 2) samples[count++] = ms;
+    }
+    if (system) result.checksum = ecs_get(world, first, Transform3D)->position.y;
+    ecs_fini(world);
+    bench_finish(&result, samples, count);
+    return result;
+}
+
+static bench_result_t bench_lua_system(void){
+    return bench_lua_run("lua_system", true);
+}
+
+static bench_result_t bench_lua_baseline(void){
+    return bench_lua_run("lua_baseline", false);
+}
+
+//===============================================
+// MAIN
+//===============================================
+typedef struct {
+    const char *name;
+    bench_result_t (*run)(void);
+} bench_scenario_t;
+
+static bool bench_write_json(const char *path, const bench_result_t *results, int32_t count){
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+    time_t now = time(NULL);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+#ifdef __VERSION__
+    const char *compiler = __VERSION__;
+#else
+    const char *compiler = "unknown";
+#endif
+#ifdef NDEBUG
+    const char *build = "release";
+#else
+    const char *build = "debug";
+#endif
+    fprintf(file, "{\n  \"commit\": \"%s\",\n  \"date\": \"%s\",\n  \"compiler\": \"%s\",\n  \"build\": \"%s\",\n  \"results\": [\n",
+        BENCH_COMMIT, date, compiler, build);
+    for (int32_t i = 0; i < count; i++) {
+        const bench_result_t *r = &results[i];
+        double per_second = r->median_ms > 0.0 ? (double)r->items / (r->median_ms / 1000.0) : 0.0;
+        fprintf(file, "    {\"name\": \"%s\", \"items\": %lld, \"iterations\": %d, \"min_ms\": %.6f, \"median_ms\": %.6f, "
+            "\"mean_ms\": %.6f, \"items_per_second\": %.1f, \"checksum\": %.6g, \"failed\": %s}%s\n",
+            r->name, (long long)r->items, (int)r->iterations, r->min_ms, r->median_ms, r->mean_ms,
+            per_second, r->checksum, r->failed ? "true" : "false", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+int main(int argc, char **argv){
+    const char *path = argc > 1 ? argv[1] : "bench_results.json";
+    const char *filter = argc > 2 ? argv[2] : NULL;
+    SetTraceLogLevel(LOG_WARNING);
+
+    const bench_scenario_t scenarios[] = {
+        { "transform_deep", bench_transform_deep },
+        { "transform_wide", bench_transform_wide },
+        { "render_list", bench_render_list },
+        { "ode_pile", bench_ode_pile },
+        { "enet_loopback", bench_enet_loopback },
+        { "scene_load", bench_scene_load },
+        { "lua_system", bench_lua_system },
+        { "lua_baseline", bench_lua_baseline }
+    };
+    bench_result_t results[BENCH_MAX_RESULTS];
+    int32_t count = 0;
+    bool failed = false;
+    printf("%-16s %10s %6s %10s %10s %10s %14s\n", "scenario", "items", "iters", "min ms", "median ms", "mean ms", "items/s");
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (filter && !strstr(scenarios[i].name, filter)) continue;
+        bench_result_t r = scenarios[i].run();
+        results[count++] = r;
+        failed = failed || r.failed;
+        printf("%-16s %10lld %6d %10.3f %10.3f %10.3f %14.0f%s\n", r.name, (long long)r.items, (int)r.iterations,
+            r.min_ms, r.median_ms, r.mean_ms, r.median_ms > 0.0 ? (double)r.items / (r.median_ms / 1000.0) : 0.0,
+            r.failed ? "  FAILED" : "");
+    }
+    if (!bench_write_json(path, results, count)) {
+        printf("could not write %s\n", path);
+        return 1;
+    }
+    printf("results: %s (%s)\n", path, BENCH_COMMIT);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+// raylib 5.5
+// flecs v4.1.1
+// block raycast bench, no window
+// builds a terrain of chunked blocks and times the same rays with
+//   brute: GetRayCollisionBox against every block, nearest hit (old picking)
+//   dda  : block_raycast, one cell per step
+//   batch: block_raycast_batch
+// usage: rlm [terrain_size] [rays]
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ecs_components.h"
+#include "module_block.h"
+
+#define TERRAIN_DEPTH 8     // blocks below y = 0
+
+static double now_seconds(void){
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float random_range(float min, float max){
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+int main(int argc, char **argv){
+    int size = argc > 1 ? atoi(argv[1]) : 128;
+    int ray_count = argc > 2 ? atoi(argv[2]) : 2000;
+    if (size < 16) size = 16;
+    if (ray_count < 1) ray_count = 1;
+
+    ecs_world_t *world = ecs_init();
+    module_init_raylib(world);
+    module_init_block(world);
+    block_id_t grass = block_register_type(world, "grass", (int[BLOCK_FACE_COUNT]){ 1, 1, 1, 1, 0, 2 });
+    block_id_t stone = block_register_type(world, "stone", (int[BLOCK_FACE_COUNT]){ 3, 3, 3, 3, 3, 3 });
+
+    // the brute force side keeps one box per block like the cube_wire_t entities
+    int capacity = size * size * (TERRAIN_DEPTH + 12);
+    BoundingBox *boxes = malloc(sizeof(BoundingBox) * capacity);
+    int block_count = 0;
+    for (int x = -size / 2; x < size / 2; x++) {
+        for (int z = -size / 2; z < size / 2; z++) {
+            int top = (int)(4.0f + 3.0f * sinf(x * 0.2f) + 3.0f * cosf(z * 0.15f));
+            for (int y = -TERRAIN_DEPTH; y <= top && block_count < capacity; y++) {
+                block_set(world, x, y, z, y == top ? grass : stone);
+                boxes[block_count++] = (BoundingBox){
+                    (Vector3){ x - 0.5f, y - 0.5f, z - 0.5f },
+                    (Vector3){ x + 0.5f, y + 0.5f, z + 0.5f }
+                };
+            }
+        }
+    }
+
+    // mouse picks from above plus horizontal line of sight rays
+    srand(1);
+    Ray *rays = malloc(sizeof(Ray) * ray_count);
+    for (int i = 0; i < ray_count; i++) {
+        float half = size * 0.5f;
+        rays[i].position = (Vector3){ random_range(-half, half), random_range(12.0f, 40.0f), random_range(-half, half) };
+        rays[i].direction = (Vector3){ random_range(-1.0f, 1.0f), random_range(-1.0f, -0.05f), random_range(-1.0f, 1.0f) };
+        if (i % 4 == 0) {
+            rays[i].position.y = random_range(-6.0f, 10.0f);
+            rays[i].direction.y = 0.0f;
+        }
+        // GetRayCollisionBox distances are in direction lengths
+        rays[i].direction = Vector3Normalize(rays[i].direction);
+    }
+
+    // brute force is slow, time a slice of the rays
+    int brute_count = ray_count < 200 ? ray_count : 200;
+    int mismatches = 0;
+    double start = now_seconds();
+    for (int i = 0; i < brute_count; i++) {
+        RayCollision nearest = { 0 };
+        nearest.distance = FLT_MAX;
+        for (int b = 0; b < block_count; b++) {
+            RayCollision collision = GetRayCollisionBox(rays[i], boxes[b]);
+            if (collision.hit && collision.distance < nearest.distance) nearest = collision;
+        }
+        if (nearest.distance > BLOCK_RAYCAST_MAX_DISTANCE) nearest.hit = false;
+        block_hit_t hit = block_raycast(world, rays[i], 0.0f);
+        if (nearest.hit != hit.hit || (hit.hit && fabsf(nearest.distance - hit.distance) > 1e-3f)) mismatches++;
+    }
+    double brute = (now_seconds() - start) / brute_count;
+
+    int hits = 0;
+    start = now_seconds();
+    for (int i = 0; i < ray_count; i++) {
+        hits += block_raycast(world, rays[i], 0.0f).hit;
+    }
+    double dda = (now_seconds() - start) / ray_count;
+
+    block_hit_t *results = malloc(sizeof(block_hit_t) * ray_count);
+    start = now_seconds();
+    block_raycast_batch(world, rays, NULL, 0.0f, ray_count, results);
+    double batch = (now_seconds() - start) / ray_count;
+
+    printf("blocks %d  rays %d  hits %d  mismatches %d/%d\n", block_count, ray_count, hits, mismatches, brute_count);
+    printf("brute %10.3f us/ray\n", brute * 1e6);
+    printf("dda   %10.3f us/ray\n", dda * 1e6);
+    printf("batch %10.3f us/ray\n", batch * 1e6);
+
+    free(results);
+    free(rays);
+    free(boxes);
+    ecs_fini(world);
+    return 0;
+}
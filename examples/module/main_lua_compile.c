@@ -0,0 +1,39 @@
+// lua 5.4
+// compiles lua scripts to stripped bytecode for release builds, the flecs
+// app built with LUA_SCRIPT_PRECOMPILED loads script.luac next to script.lua
+// usage: lua_compile script.lua [more.lua ...]
+
+#include <stdio.h>
+#include "lua.h"
+#include "lauxlib.h"
+
+static int write_chunk(lua_State *L, const void *data, size_t size, void *ud){
+    return fwrite(data, 1, size, (FILE *)ud) == size ? 0 : 1;
+}
+
+static int compile(const char *path){
+    char out_path[1024];
+    if (snprintf(out_path, sizeof(out_path), "%sc", path) >= (int)sizeof(out_path)) return 1;
+    lua_State *L = luaL_newstate();
+    if (!L) return 1;
+    if (luaL_loadfile(L, path) != LUA_OK) {
+        fprintf(stderr, "%s\n", lua_tostring(L, -1));
+        lua_close(L);
+        return 1;
+    }
+    FILE *file = fopen(out_path, "wb");
+    int failed = !file || lua_dump(L, write_chunk, file, 1) != 0;
+    if (file && fclose(file) != 0) failed = 1;
+    if (failed) {
+        fprintf(stderr, "could not write %s\n", out_path);
+        remove(out_path);
+    }
+    lua_close(L);
+    return failed;
+}
+
+int main(int argc, char **argv){
+    int failed = 0;
+    for (int i = 1; i < argc; i++) failed |= compile(argv[i]);
+    return failed;
+}
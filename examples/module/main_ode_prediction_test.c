@@ -0,0 +1,139 @@
+// raylib 5.5
+// flecs v4.1.1
+// client side prediction test
+// S = start server, C = connect client, then WASD + SPACE to move the capsule.
+// right mouse toggles mouse look. run one server and one client window.
+
+#include <stdio.h>
+#include "ecs_components.h"
+#include "module_dev.h"
+#include "module_enet.h"
+#include "module_ode.h"
+#include "module_prediction.h"
+
+#define MOUSE_SENSITIVITY 0.002f
+#define CAMERA_DISTANCE 8.0f
+#define CAMERA_HEIGHT 4.0f
+
+typedef struct {
+    float yaw;
+} camera_follow_t;
+ECS_COMPONENT_DECLARE(camera_follow_t);
+
+// third person camera behind the local predicted player
+void camera_follow_system(ecs_iter_t *it){
+    Transform3D *transform = ecs_field(it, Transform3D, 0);
+    main_context_t *main_context = ecs_singleton_get_mut(it->world, main_context_t);
+    camera_follow_t *follow = ecs_singleton_get_mut(it->world, camera_follow_t);
+    if (!main_context || !follow) return;
+
+    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
+        if (IsCursorHidden()) EnableCursor();
+        else DisableCursor();
+    }
+    if (IsCursorHidden() && IsWindowFocused()) {
+        follow->yaw += GetMouseDelta().x * MOUSE_SENSITIVITY;
+    }
+
+    for (int i = 0; i < it->count; i++) {
+        Vector3 forward = { cosf(follow->yaw), 0.0f, sinf(follow->yaw) };
+        Vector3 target = transform[i].position;
+        main_context->camera.target = target;
+        main_context->camera.position = Vector3Add(Vector3Subtract(target, Vector3Scale(forward, CAMERA_DISTANCE)), (Vector3){0.0f, CAMERA_HEIGHT, 0.0f});
+    }
+}
+
+// draw raylib grid
+void render_3d_grid(ecs_iter_t *it){
+    DrawGrid(20, 1.0f);
+}
+
+void render_2d_info_system(ecs_iter_t *it){
+    DrawText("S server, C client, WASD + SPACE move, RMB mouse look", 2, 2 + 25 * 3, 20, GRAY);
+}
+
+int main(void) {
+    InitWindow(800, 600, "Client Prediction with Flecs v4.1.1");
+    SetTargetFPS(60);
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, camera_follow_t);
+
+    // Initialize components and phases
+    module_init_raylib(world);
+    module_init_dev(world);
+    module_init_enet(world);
+    module_init_ode(world);
+    module_init_prediction(world);
+
+    ECS_SYSTEM(world, render_3d_grid, RLRender3DPhase);
+    ECS_SYSTEM(world, render_2d_info_system, RLRender2D1Phase);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "camera_follow_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
+        .query.terms = {
+            { .id = ecs_id(Transform3D) },
+            { .id = ecs_id(predict_client_t) }
+        },
+        .callback = camera_follow_system
+    });
+
+    // setup Camera 3D
+    Camera3D camera = {
+        .position = (Vector3){10.0f, 10.0f, 10.0f},
+        .target = (Vector3){0.0f, 0.0f, 0.0f},
+        .up = (Vector3){0.0f, 1.0f, 0.0f},
+        .fovy = 45.0f,
+        .projection = CAMERA_PERSPECTIVE
+    };
+    ecs_singleton_set(world, main_context_t, {
+        .camera = camera
+    });
+    ecs_singleton_set(world, camera_follow_t, { .yaw = 0.0f });
+
+    ecs_singleton_set(world, NetworkConfig, {
+        .isNetwork = false,
+        .isServer = false,
+        .port = 1234,
+        .maxPeers = 32,
+        .address = "127.0.0.1"
+    });
+    ecs_singleton_set(world, NetworkState, {
+        .host = NULL,
+        .peer = NULL,
+        .serverStarted = false,
+        .clientConnected = false,
+        .isConnected = false,
+        .isServer = false
+    });
+
+    // capsule model, box along z to match the capsule geom before it is stood up
+    Model capsule_model = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 2.0f));
+    ecs_singleton_set(world, predict_config_t, {
+        .move_speed = 5.0f,
+        .jump_speed = 5.0f,
+        .gravity = 9.81f,
+        .ground_height = 1.0f, // radius 0.5 + half length 0.5
+        .correction_epsilon = 0.01f,
+        .spawn = (Vector3){0.0f, 1.0f, 0.0f},
+        .model = &capsule_model
+    });
+
+    const ode_context_t *ode_context = ecs_singleton_get(world, ode_context_t);
+
+    // Create ground as separate entity with OdeGeom
+    ecs_entity_t ground_entity = ecs_entity(world, {.name = "Ground"});
+    dGeomID ground = dCreatePlane(ode_context->space, 0, 1, 0, 0); // Normal (0,1,0), distance 0
+    ecs_set(world, ground_entity, ode_geom_t, { .id = ground });
+
+    //Loop Logic and render
+    while (!WindowShouldClose()) {
+      ecs_progress(world, 0);
+    }
+
+    ecs_fini(world);
+    UnloadModel(capsule_model);
+    CloseWindow();
+    return 0;
+}
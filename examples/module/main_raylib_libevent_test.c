@@ -129,15 +129,8 @@ void render_2d_draw_cross_point(ecs_iter_t *it){
 }
 
 void send_position_update(struct bufferevent *bev, float x, float y, float z) {
-    struct GameMessage *msg = malloc(sizeof(struct GameMessage) + sizeof(float) * 3);
-    msg->type = htons(1); // Position update
-    msg->length = htons(sizeof(float) * 3);
-    float *pos = (float *)(msg->payload);
-    pos[0] = x;
-    pos[1] = y;
-    pos[2] = z;
-    bufferevent_write(bev, msg, sizeof(struct GameMessage) + sizeof(float) * 3);
-    free(msg);
+    float pos[3] = { x, y, z };
+    libevent_frame_write(bufferevent_get_output(bev), LIBEVENT_MSG_POSITION, pos, sizeof(pos));
 }
 
 // draw server and client network
@@ -161,6 +154,19 @@ void render_2d_libevent_system(ecs_iter_t *it){
         }
 
     }
+    if(GuiButton((Rectangle){0,22*5,64,20},"server mt")){
+        printf("server thread\n");
+        const libevent_server_t *libevent_server = ecs_singleton_get(it->world, libevent_server_t);
+        if(!libevent_server){
+            //server setup, event_base_dispatch on its own thread
+            ecs_singleton_set(it->world, libevent_server_t,{
+                .listener = NULL,
+                .port = 8080,
+                .is_init = false,
+                .threaded = true
+            });
+        }
+    }
     if(GuiButton((Rectangle){0,22*2,64,20},"client")){
         printf("client\n");
         const libevent_client_t *libevent_client = ecs_singleton_get(it->world, libevent_client_t);
@@ -179,75 +185,36 @@ void render_2d_libevent_system(ecs_iter_t *it){
         printf("ping\n");
         const libevent_client_t *libevent_client = ecs_singleton_get_mut(it->world, libevent_client_t);
         if(libevent_client){
-            bufferevent_write(libevent_client->client_bev, "PING", 4);
+            libevent_frame_write(bufferevent_get_output(libevent_client->client_bev), LIBEVENT_MSG_CONTROL, "PING", 4);
         }
     }
 
     if(GuiButton((Rectangle){0,22*4,64,20},"get clients")){
         printf("get clients\n");
         const libevent_server_t *libevent_server2 = ecs_singleton_get(it->world, libevent_server_t);
-
-        if(libevent_server2){
-            int client_nums = 0;
-            ecs_query_t *q = ecs_query(it->world, {
-                .terms = {
-                    {  .id = ecs_id(libevent_bev_t) }
-                }
-            });
-            ecs_iter_t qit = ecs_query_iter(it->world, q);
-            while (ecs_query_next(&qit)) {
-                // libevent_bev_t *libevent_bev = ecs_field(&it, libevent_bev_t, 0);
-                client_nums += qit.count;
-                // for (int i = 0; i < it.count; i++) {
-                    // ecs_entity_t client = it.entities[i];
-                    // Do the thing
-                    // if(bev == libevent_bev[i].bev){
-                    //     ecs_delete(app->world, client);
-                    //     printf("[server] remove client.\n");
-                    // }
-                // }
-            }
-            ecs_query_fini(q);
-            printf("client(s) %d\n", client_nums);
+        if(libevent_server2 && app){
+            printf("client(s) %d\n", app->client_count);
         }
     }
 
+    // client count is kept by module_libevent, no query per frame
     const libevent_server_t *libevent_server3 = ecs_singleton_get(it->world, libevent_server_t);
-    if(libevent_server3){
-        int client_nums2 = 0;
-        ecs_query_t *q2 = ecs_query(it->world, {
-            .terms = {
-                {  .id = ecs_id(libevent_bev_t) }
-            }
-        });
-        ecs_iter_t qit2 = ecs_query_iter(it->world, q2);
-        while (ecs_query_next(&qit2)) {
-            // libevent_bev_t *libevent_bev = ecs_field(&it, libevent_bev_t, 0);
-            client_nums2 += qit2.count;
-            // for (int i = 0; i < it.count; i++) {
-                // ecs_entity_t client = it.entities[i];
-                // Do the thing
-                // if(bev == libevent_bev[i].bev){
-                //     ecs_delete(app->world, client);
-                //     printf("[server] remove client.\n");
-                // }
-            // }
-        }
-        ecs_query_fini(q2);
-        // printf("client(s) %d\n", client_nums2);
-        DrawText(TextFormat("client(s) %d\n", client_nums2), 70, 22 * 2, 20, DARKGRAY);
+    if(libevent_server3 && app){
+        DrawText(TextFormat("client(s) %d\n", app->client_count), 70, 22 * 2, 20, DARKGRAY);
     }
 }
 
 // main
 int main(void) {
 
+#ifdef _WIN32
     // Initialize Winsock
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
         printf("WSAStartup failed: %d\n", WSAGetLastError());
         return 1;
     }
+#endif
 
     InitWindow(800, 600, "Raylib LibEvent Flecs v4.1.1");
     SetTargetFPS(60);
@@ -315,8 +282,10 @@ int main(void) {
     }
 
     // UnloadModel(cube);
-    WSACleanup();
     ecs_fini(world);
+#ifdef _WIN32
+    WSACleanup();
+#endif
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,86 @@
+// asset_cook.h
+// cooked asset cache for module_asset. the first load of an image, texture
+// or glTF model writes what the workers decoded (pixels with their mip
+// chain, mesh streams, material colors) to one file per asset, later runs
+// map that file and skip parsing and decoding.
+// the header carries a hash of the source file, a changed source is cooked
+// again. for glTF the path, size and modification time of the external
+// buffers and images are folded into that hash as well. values are stored
+// little endian, as in memory.
+#pragma once
+
+#include "raylib.h"
+#include "file_map.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ASSET_COOK_MAGIC 0x4B4F4341u      // "ACOK"
+#define ASSET_COOK_VERSION 1
+#define ASSET_COOK_ALIGN 16               // image and mesh data offsets
+#define ASSET_COOK_DIR "asset_cache"
+
+#define ASSET_COOK_NORMALS 0x1u
+#define ASSET_COOK_TEXCOORDS 0x2u
+#define ASSET_COOK_INDICES 0x4u
+
+// image entries follow, then mesh entries, then the data
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;                  // asset_kind_t
+    uint32_t image_count;
+    uint64_t key_hash;              // kind and path, tells apart two keys on one file name
+    uint64_t source_hash;
+    uint64_t source_size;
+    uint32_t mesh_count;
+    uint32_t reserved;
+} asset_cook_header_t;
+
+// one image, or one material of a model (no pixels when size is 0)
+typedef struct {
+    int32_t width;
+    int32_t height;
+    int32_t mipmaps;
+    int32_t format;                 // PixelFormat, levels back to back
+    uint32_t color;                 // material tint, r in the low byte
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+} asset_cook_image_t;
+
+// streams back to back in the order of the raylib Mesh fields: positions,
+// normals, texcoords, then 16 bit indices, each only with its flag
+typedef struct {
+    uint32_t vertex_count;
+    uint32_t index_count;
+    int32_t material;               // image entry of the material
+    uint32_t streams;               // ASSET_COOK_* flags
+    uint64_t offset;
+    uint64_t size;
+} asset_cook_mesh_t;
+
+// read only mapping of one cooked file
+typedef struct {
+    file_map_t map;
+    const asset_cook_header_t *header;
+    const asset_cook_image_t *images;
+    const asset_cook_mesh_t *meshes;
+} asset_cook_t;
+
+// hash of a whole file or buffer, 8 bytes per step
+uint64_t asset_cook_hash(const void *data, size_t size);
+// ASSET_COOK_DIR/<key hash>.cook, false when it does not fit
+bool asset_cook_path(char *path, size_t path_size, uint64_t key_hash);
+
+// false when the file is missing, damaged or cooked from another source
+bool asset_cook_open(asset_cook_t *cook, const char *path, uint32_t kind, uint64_t key_hash, uint64_t source_hash, uint64_t source_size);
+void asset_cook_close(asset_cook_t *cook);
+// views into the mapping, valid until asset_cook_close. read only
+Image asset_cook_image(const asset_cook_t *cook, int32_t index, Color *color);
+Mesh asset_cook_mesh(const asset_cook_t *cook, int32_t index, int *material);
+
+// writes path.tmp and swaps it in. colors may be NULL. meshes need 16 bit
+// indices or none, normals and texcoords are optional
+bool asset_cook_write(const char *path, uint32_t kind, uint64_t key_hash, uint64_t source_hash, uint64_t source_size,
+    const Image *images, const Color *colors, int32_t image_count,
+    const Mesh *meshes, const int *materials, int32_t mesh_count);
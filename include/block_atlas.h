@@ -0,0 +1,43 @@
+// block_atlas.h
+// packs square block face tiles into one texture at load time. each tile
+// sits in a cell twice its size, the border is the tile wrapped around so
+// the repeat in the shader and every mip level stay inside the cell. mips
+// are box filtered per level, a cell is exactly two tile periods so even
+// the 1 texel level is the tile average and never its neighbour.
+// the shaders get the tile index per vertex and the cell layout as
+// uniforms, so new tiles or a repack need no remeshing.
+// with GL 3.3 the tiles can go in a sampler2DArray instead, one layer per
+// tile with hardware repeat and mips, no padding.
+#pragma once
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    Texture2D texture;              // the atlas, or a GL_TEXTURE_2D_ARRAY when is_array
+    bool is_array;
+    int32_t tile_size;              // texels
+    int32_t tile_count;
+    int32_t columns;                // cells per row, power of two
+    int32_t rows;                   // power of two
+    int32_t mip_count;
+} block_atlas_t;
+
+// tiles of the given size, row major from a sheet like the 64x64 atlas png
+// (tile_size 16 gives tiles 0..15). UnloadImage each, then MemFree tiles
+Image *block_atlas_split(Image sheet, int32_t tile_size, int32_t *count);
+
+// tiles are converted to RGBA8 and resized to tile_size when they differ,
+// tile_size is rounded up to a power of two. array needs GL 3.3 and falls
+// back to the 2d atlas without it
+bool block_atlas_pack(block_atlas_t *atlas, const Image *tiles, int32_t count, int32_t tile_size, bool array);
+// the padded atlas with its mip chain, for export or the texture upload
+Image block_atlas_pack_image(const Image *tiles, int32_t count, int32_t tile_size, int32_t *columns, int32_t *rows);
+void block_atlas_unload(block_atlas_t *atlas);
+
+// cell layout uniforms for block_atlas.fs, the array shader only needs the sampler
+void block_atlas_set_uniforms(const block_atlas_t *atlas, Shader shader);
+// raylib only binds 2d textures, the array is bound to unit 0 around the draws
+void block_atlas_bind(const block_atlas_t *atlas);
+void block_atlas_unbind(const block_atlas_t *atlas);
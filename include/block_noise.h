@@ -0,0 +1,34 @@
+// block_noise.h
+// seeded gradient noise for terrain, evaluated BLOCK_NOISE_LANES samples per
+// call. lattice gradients come from an integer hash of the seed and cell so
+// the same seed gives the same terrain on every peer, no tables to share.
+// the 2D lane loops have no branches or lookups so the compiler vectorizes
+// them (sse2/neon 4 wide, avx2 8 wide when enabled). the 3D lanes are
+// written with gcc/clang vector extensions, 4 wide, scalar elsewhere.
+#pragma once
+
+#include <stdint.h>
+
+#define BLOCK_NOISE_LANES 8
+
+// about -1..1
+void block_noise2_lanes(uint32_t seed, const float *x, const float *z, float *out);
+void block_noise3_lanes(uint32_t seed, const float *x, const float *y, const float *z, float *out);
+
+// octaves of noise, each twice the frequency and half the amplitude of the
+// last, normalized back to about -1..1
+void block_fbm2_lanes(uint32_t seed, const float *x, const float *z, int32_t octaves, float *out);
+void block_fbm3_lanes(uint32_t seed, const float *x, const float *y, const float *z, int32_t octaves, float *out);
+
+// single sample, same value as the matching lane
+float block_noise2(uint32_t seed, float x, float z);
+float block_noise3(uint32_t seed, float x, float y, float z);
+
+// terrain sampling at integer block coordinates. the float math stays in
+// this file (built without fused multiply-add) so callers only see integers
+// floor(base + scale * fbm2) per column, out[x + z * width]
+void block_noise_heights(uint32_t seed, int32_t x0, int32_t z0, int32_t width, int32_t depth,
+                         float frequency, int32_t octaves, float base, float scale, int32_t *out);
+// 1 where fbm3 > threshold, out[x + z * size_x + y * size_x * size_z]
+void block_noise_mask3(uint32_t seed, int32_t x0, int32_t y0, int32_t z0, int32_t size_x, int32_t size_y, int32_t size_z,
+                       float frequency, int32_t octaves, float threshold, uint8_t *out);
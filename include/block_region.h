@@ -0,0 +1,46 @@
+// block_region.h
+// region files for module_block, BLOCK_REGION_SIZE^3 chunks per file. a
+// fixed offset table in the header locates each chunk, the file is memory
+// mapped and a chunk is read in place only when it is needed.
+// values are stored little endian.
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BLOCK_REGION_SIZE 8
+#define BLOCK_REGION_VOLUME (BLOCK_REGION_SIZE * BLOCK_REGION_SIZE * BLOCK_REGION_SIZE)
+#define BLOCK_REGION_MAGIC 0x524B4C42u    // "BLKR"
+#define BLOCK_REGION_VERSION 1
+#define BLOCK_REGION_ALIGN 8              // payload offsets, packed words are read in place
+
+typedef struct {
+    uint32_t offset;                // from the start of the file
+    uint32_t size;                  // 0 when the chunk is not stored
+} block_region_entry_t;
+
+// chunk index is x + z * SIZE + y * SIZE * SIZE inside the region
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t chunk_count;
+    uint32_t reserved;
+    block_region_entry_t entries[BLOCK_REGION_VOLUME];
+} block_region_header_t;
+
+// read only mapping of one region file
+typedef struct block_region_s block_region_t;
+
+// NULL when the file is missing or not a valid region
+block_region_t *block_region_open(const char *path);
+void block_region_close(block_region_t *region);
+// NULL when the chunk is not stored, the pointer lives until the region is closed
+const void *block_region_chunk(const block_region_t *region, int32_t index, uint32_t *size);
+
+// writes payloads (NULL or size 0 for a missing chunk) to path.tmp and
+// swaps it in. payloads may point into *region, it is closed before the
+// swap and reopened on the new file.
+bool block_region_save(block_region_t **region, const char *path, const void *const payloads[BLOCK_REGION_VOLUME], const uint32_t sizes[BLOCK_REGION_VOLUME]);
+
+// creates the directory, true if it exists afterwards
+bool block_region_make_dir(const char *path);
@@ -6,6 +6,7 @@
 #include "raylib.h"
 #include "raymath.h"
 #include "flecs.h"
+#include "frame_arena.h"
 
 // Global phase entities
 extern ecs_entity_t PreLogicUpdatePhase;
@@ -41,6 +42,30 @@ typedef struct {
 } ModelComponent;
 extern ECS_COMPONENT_DECLARE(ModelComponent);
 
+// per frame scratch, one arena per stage so worker systems get their own.
+// arenas are reset after EndDrawing, the heap counter sees every ecs_os
+// allocation (flecs, module buffers and arena growth) and warns when a
+// frame goes over
+typedef struct {
+    frame_arena_t *arenas;          // by stage id, 0 is the main thread
+    int32_t arena_count;
+    size_t arena_capacity;          // first block of a new arena
+    int64_t frame;
+    int64_t heap_allocations_total;
+    int32_t heap_allocations;       // last frame
+    int32_t alloc_budget;           // per frame after warmup, -1 turns the check off
+    int32_t warmup_frames;          // loading and arena growth are not counted
+    int32_t over_budget_frames;
+} frame_context_t;
+extern ECS_COMPONENT_DECLARE(frame_context_t);
+
+// scratch memory valid until the end of the frame, NULL when out of memory.
+// world can be a stage, a system should pass it->world
+void *frame_alloc(ecs_world_t *world, size_t size);
+frame_arena_t *frame_arena_get(ecs_world_t *world);
+// ecs_os malloc/calloc/realloc calls since module_init_raylib
+int64_t frame_heap_allocation_count(void);
+
 // // PlayerInput_T component
 // typedef struct {
 //     bool isMovementMode;
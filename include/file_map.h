@@ -0,0 +1,25 @@
+// file_map.h
+// read only memory mapping of a whole file, mmap on posix and a file
+// mapping view on windows. pages are read in when they are touched.
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    const uint8_t *data;            // NULL when not open
+    size_t size;
+#ifdef _WIN32
+    void *file;                     // HANDLE
+    void *mapping;                  // HANDLE
+#endif
+} file_map_t;
+
+// false when the file is missing, empty or cannot be mapped
+bool file_map_open(file_map_t *map, const char *path);
+void file_map_close(file_map_t *map);
+
+// moves from over to, replacing to. windows cannot replace a mapped file,
+// close any mapping of to first
+bool file_map_replace(const char *from, const char *to);
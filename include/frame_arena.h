@@ -0,0 +1,32 @@
+// frame_arena.h
+// bump allocator for scratch memory that lives until the end of a frame.
+// an arena starts as one block, what does not fit goes into overflow
+// chunks and the next reset grows the block to the whole frame, so after
+// a few frames a steady frame allocates nothing from the heap.
+// not thread safe, worker systems use the arena of their own stage.
+#pragma once
+
+#include "flecs.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct frame_arena_chunk_t frame_arena_chunk_t;
+
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+    frame_arena_chunk_t *overflow;  // allocations past capacity this frame
+    size_t frame_total;             // bytes asked for this frame, overflow included
+    size_t peak;                    // largest frame_total seen
+    int32_t overflows;              // resets that had to grow the block
+} frame_arena_t;
+
+bool frame_arena_init(frame_arena_t *arena, size_t capacity);
+void frame_arena_fini(frame_arena_t *arena);
+
+// align is a power of two, 0 uses max_align_t. NULL when out of memory
+void *frame_arena_alloc(frame_arena_t *arena, size_t size, size_t align);
+char *frame_arena_strdup(frame_arena_t *arena, const char *str);
+// everything allocated since the last reset is gone after this
+void frame_arena_reset(frame_arena_t *arena);
@@ -0,0 +1,39 @@
+// job_pool.h
+// fixed set of worker threads pulling jobs from one mutex/cond queue.
+// uses the flecs os api for threads, create it after ecs_init.
+#pragma once
+
+#include "flecs.h"
+
+typedef void (*job_fn_t)(void *data);
+
+typedef struct {
+    job_fn_t fn;
+    void *data;
+} job_t;
+
+typedef struct {
+    ecs_os_mutex_t lock;
+    ecs_os_cond_t wake;             // workers wait here for jobs
+    ecs_os_cond_t idle;             // job_pool_wait waits here
+    job_t *jobs;                    // ring of queued jobs
+    int32_t head;
+    int32_t count;
+    int32_t capacity;
+    int32_t active;                 // jobs being run right now
+    bool stop;
+    ecs_os_thread_t *threads;
+    int32_t thread_count;
+} job_pool_t;
+
+// logical cpu count, at least 1
+int32_t job_pool_cpu_count(void);
+
+// thread_count 0 runs every job inline in job_pool_submit
+bool job_pool_init(job_pool_t *pool, int32_t thread_count);
+// queued jobs that did not start are dropped, their data stays with the caller
+void job_pool_fini(job_pool_t *pool);
+
+bool job_pool_submit(job_pool_t *pool, job_fn_t fn, void *data);
+// block until the queue is empty and no job is running
+void job_pool_wait(job_pool_t *pool);
@@ -0,0 +1,41 @@
+// libevent_frame.h
+// length prefixed framing over a bufferevent stream.
+// frame = struct GameMessage header (type, length in network order) + payload.
+// no flecs here so it can be used by plain libevent programs and benches.
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <event2/buffer.h>
+
+#define LIBEVENT_FRAME_HEADER_SIZE 4        // uint16_t type + uint16_t length
+#define LIBEVENT_FRAME_MAX_PAYLOAD 0xFFFF   // length is 16 bit
+
+// message types
+typedef enum {
+    LIBEVENT_MSG_CONTROL = 0,   // payload "PING" or "PONG"
+    LIBEVENT_MSG_POSITION = 1,  // float x, y, z
+    LIBEVENT_MSG_HEALTH = 2,    // int32_t, network order
+    LIBEVENT_MSG_CHAT = 3       // utf8 text, not null terminated
+} libevent_msg_type_t;
+
+// called once per complete frame. frame points at the header inside the
+// evbuffer and is only valid during the call. return false to stop, that
+// frame and the ones after it stay in the buffer.
+typedef bool (*libevent_frame_cb)(uint16_t type, const uint8_t *frame, size_t frame_length, void *user);
+
+// dispatch every complete frame in input and drain them. a partial frame is
+// left in the buffer for the next read. returns the number of frames taken.
+int libevent_frame_dispatch(struct evbuffer *input, libevent_frame_cb callback, void *user);
+
+// append one frame to output, header and payload written in place.
+int libevent_frame_write(struct evbuffer *output, uint16_t type, const void *payload, uint16_t length);
+
+// payload helpers for a frame passed to libevent_frame_cb
+static inline const uint8_t *libevent_frame_payload(const uint8_t *frame){
+    return frame + LIBEVENT_FRAME_HEADER_SIZE;
+}
+static inline uint16_t libevent_frame_payload_length(const uint8_t *frame){
+    return (uint16_t)((frame[2] << 8) | frame[3]);
+}
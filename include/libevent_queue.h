@@ -0,0 +1,57 @@
+// libevent_queue.h
+// single producer single consumer queue, lock free (C11 atomics).
+// the libevent dispatch thread pushes connect/data/disconnect events and the
+// ECS thread drains them once per frame. no flecs here, large frames go
+// through the alloc/free hooks (libc when left NULL) so the owner can count them.
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIBEVENT_QUEUE_INLINE 240   // frames up to this size are stored in the slot
+
+struct bufferevent;
+
+typedef enum {
+    LIBEVENT_QUEUE_CONNECT = 0,     // new connection, bev is ready to use
+    LIBEVENT_QUEUE_DATA = 1,        // one frame (header + payload)
+    LIBEVENT_QUEUE_DISCONNECT = 2,  // bev closed, consumer frees it
+    LIBEVENT_QUEUE_STATUS = 3       // status text for the ECS side, not null terminated
+} libevent_queue_kind_t;
+
+typedef struct {
+    uint8_t kind;                   // libevent_queue_kind_t
+    struct bufferevent *bev;
+    void *ctx;                      // connection context of bev
+    uint32_t length;                // bytes in data
+    uint8_t *data;                  // inline_data or heap for large frames
+    uint8_t inline_data[LIBEVENT_QUEUE_INLINE];
+} libevent_queue_item_t;
+
+typedef struct {
+    libevent_queue_item_t *items;
+    uint32_t capacity;              // power of two
+    void *(*alloc)(size_t size);    // large frame data, set after init
+    void (*free)(void *ptr);
+    char pad0[64];
+    _Atomic uint32_t head;          // next slot to read, written by the consumer
+    char pad1[64];
+    _Atomic uint32_t tail;          // next slot to write, written by the producer
+    char pad2[64];
+} libevent_queue_t;
+
+bool libevent_queue_init(libevent_queue_t *queue, uint32_t capacity);
+void libevent_queue_fini(libevent_queue_t *queue);
+
+// producer: false when the queue is full or allocation failed
+bool libevent_queue_push(libevent_queue_t *queue, uint8_t kind, struct bufferevent *bev, void *ctx, const void *data, uint32_t length);
+
+// consumer: oldest item or NULL, valid until libevent_queue_pop
+libevent_queue_item_t *libevent_queue_front(libevent_queue_t *queue);
+// consumer: position after the newest item, and the oldest item pushed
+// before that mark (NULL once it is reached)
+uint32_t libevent_queue_mark(libevent_queue_t *queue);
+libevent_queue_item_t *libevent_queue_front_until(libevent_queue_t *queue, uint32_t mark);
+void libevent_queue_pop(libevent_queue_t *queue);
@@ -0,0 +1,87 @@
+// module_asset.h
+// asset manager. files are read and decoded on worker threads (images with
+// raylib's stb loaders, glTF meshes with cgltf, shader sources) and the
+// main thread uploads finished ones to the gpu within a time budget per
+// frame, so startup does not wait for every file in turn.
+// assets are deduplicated by kind and path and refcounted, a handle stays
+// valid until its last release. released assets are unloaded in the next
+// upload pass, requesting a failed one loads it again. every call is main
+// thread only.
+// entities with model_asset_t get a ModelComponent once the model is in.
+// images, textures and glTF models are cooked into ASSET_COOK_DIR on their
+// first load (asset_cook.h), later runs map the cooked file instead of
+// decoding the source.
+#pragma once
+
+#include "flecs.h"
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ASSET_UPLOAD_BUDGET_MS 2.0f       // main thread upload time per frame
+#define ASSET_UPLOAD_MAX 8                // uploads per frame
+#define ASSET_MAX_THREADS 4
+#define ASSET_INDEX_BITS 20               // handle is slot + 1 in the low bits, generation above
+
+typedef uint32_t asset_handle_t;          // 0 is no asset
+
+typedef enum {
+    ASSET_IMAGE,            // decoded pixels only, stays on the cpu
+    ASSET_TEXTURE,          // mipmapped on the worker, uploaded with trilinear filtering
+    ASSET_MODEL,            // glTF/glb decoded on the worker, other formats load on upload
+    ASSET_SHADER,           // asset_load_shader
+    ASSET_KIND_COUNT
+} asset_kind_t;
+
+typedef enum {
+    ASSET_NONE,             // stale or 0 handle
+    ASSET_LOADING,          // with the workers or waiting for the upload budget
+    ASSET_READY,
+    ASSET_FAILED
+} asset_state_t;
+
+// slots, lookup, worker pool and the finished queue (module_asset.c)
+typedef struct asset_store_s asset_store_t;
+
+// settings and stats singleton
+typedef struct {
+    asset_store_t *store;           // owned by the model_asset_t hooks
+    float upload_budget_ms;
+    int32_t upload_max;
+    int32_t loading;                // on the workers or waiting for upload
+    int32_t ready;
+    int32_t failed;
+    int32_t cache_hits;             // loaded from a cooked file
+    int32_t uploads_last_frame;
+    float upload_ms_last_frame;
+} asset_manager_t;
+extern ECS_COMPONENT_DECLARE(asset_manager_t);
+
+// holds its own reference, release the one from asset_load after setting it.
+// ModelComponent is added when the model is ready and removed with this
+typedef struct {
+    asset_handle_t handle;
+} model_asset_t;
+extern ECS_COMPONENT_DECLARE(model_asset_t);
+
+// starts loading on the first request, later ones share the asset. the
+// caller owns one reference either way. 0 when the manager is missing
+asset_handle_t asset_load(ecs_world_t *world, asset_kind_t kind, const char *path);
+// either path may be NULL for raylib's default stage
+asset_handle_t asset_load_shader(ecs_world_t *world, const char *vs_path, const char *fs_path);
+void asset_acquire(ecs_world_t *world, asset_handle_t handle);
+void asset_release(ecs_world_t *world, asset_handle_t handle);
+
+asset_state_t asset_state(ecs_world_t *world, asset_handle_t handle);
+// valid while the handle is referenced, NULL or id 0 until ready
+const Image *asset_image(ecs_world_t *world, asset_handle_t handle);
+Texture2D asset_texture(ecs_world_t *world, asset_handle_t handle);
+Model *asset_model(ecs_world_t *world, asset_handle_t handle);
+Shader asset_shader(ecs_world_t *world, asset_handle_t handle);
+
+// blocks until every queued asset is decoded and uploads all of them,
+// no budget. for loading screens and headless tools
+void asset_wait_all(ecs_world_t *world);
+
+// call after module_init_raylib (phases), after InitWindow for uploads
+void module_init_asset(ecs_world_t *world); // module_asset.c
@@ -1,6 +1,238 @@
 // module_block.h
+// chunked voxel blocks. each chunk holds 16^3 block ids as a palette plus
+// bit packed indices and owns one greedy meshed Mesh, so draw calls and
+// vertices follow the surface area. chunks are saved to region files
+// (block_region.h) and streamed in and out around the main_context_t camera,
+// far rings are meshed at a lower level of detail. chunks with nothing
+// stored are generated from a seed on the worker pool.
+// block (x,y,z) is centered on (x,y,z) like the editor cubes.
 #pragma once
 
 #include "flecs.h"
+#include "raylib.h"
+#include "block_atlas.h"
+#include <stdint.h>
 
-void module_init_block(ecs_world_t *world); 
\ No newline at end of file
+#define BLOCK_CHUNK_SIZE 16
+#define BLOCK_CHUNK_AREA (BLOCK_CHUNK_SIZE * BLOCK_CHUNK_SIZE)
+#define BLOCK_CHUNK_VOLUME (BLOCK_CHUNK_SIZE * BLOCK_CHUNK_SIZE * BLOCK_CHUNK_SIZE)
+#define BLOCK_PADDED_SIZE (BLOCK_CHUNK_SIZE + 2)  // chunk plus one block of each neighbour
+#define BLOCK_PADDED_VOLUME (BLOCK_PADDED_SIZE * BLOCK_PADDED_SIZE * BLOCK_PADDED_SIZE)
+#define BLOCK_MAX_TYPES 256
+#define BLOCK_AIR 0
+#define BLOCK_ATLAS_TILES 4                       // tiles per row of a sheet for block_load_resources
+#define BLOCK_UPLOAD_BUDGET_MS 2.0f               // main thread mesh upload time per frame
+#define BLOCK_UPLOAD_MAX_CHUNKS 8                 // mesh uploads per frame
+#define BLOCK_RAYCAST_MAX_DISTANCE 512.0f         // used when max_distance <= 0
+#define BLOCK_SUBMIT_MAX_CHUNKS 64                // chunks meshing or waiting for upload at once
+#define BLOCK_STREAM_LOAD_RADIUS 8                // chunks around the camera read from region files
+#define BLOCK_STREAM_UNLOAD_RADIUS 10             // chunks past this are saved if edited and evicted
+#define BLOCK_STREAM_LOD_RADIUS 4                 // full detail ring, each further ring halves the detail
+#define BLOCK_STREAM_MAX_LOD 2                    // coarsest cells are 4^3 blocks
+#define BLOCK_STREAM_LOADS_PER_FRAME 8
+#define BLOCK_STREAM_CANDIDATES 64                // unloaded chunks ranked per frame
+#define BLOCK_STREAM_MEMORY_CAP (256LL * 1024 * 1024) // chunk storage plus mesh buffers
+#define BLOCK_GEN_MAX_JOBS 32                     // chunks generating on the workers at once
+
+typedef uint8_t block_id_t;
+
+// same face order as GenMeshCubeCustomUV tile indices
+typedef enum {
+    BLOCK_FACE_FRONT,   // +z
+    BLOCK_FACE_BACK,    // -z
+    BLOCK_FACE_LEFT,    // -x
+    BLOCK_FACE_RIGHT,   // +x
+    BLOCK_FACE_TOP,     // +y
+    BLOCK_FACE_BOTTOM,  // -y
+    BLOCK_FACE_COUNT
+} block_face_t;
+
+// registry entry, the unit cube mesh is shared by every block_t of the type
+typedef struct {
+    const char *name;
+    int tiles[BLOCK_FACE_COUNT];    // atlas tile index per face, any number of tiles
+    bool solid;
+    int32_t refcount;               // block_t components using the type
+    bool has_mesh;                  // loaded while refcount > 0
+    Mesh mesh;
+} block_type_t;
+
+// single placed block on a Transform3D entity, drawn instanced per type
+typedef struct {
+    block_id_t type;
+} block_t;
+extern ECS_COMPONENT_DECLARE(block_t);
+
+// one chunk entity, blocks indexed x + z * SIZE + y * AREA. an index of
+// bits (0, 1, 2, 4 or 8) per block into the palette, 64 / bits indices per
+// word so none spans two words. bits 0 is a single block id for the whole
+// chunk, no palette at all reads as air.
+typedef struct {
+    int32_t x, y, z;                // chunk coordinate
+    block_id_t *palette;            // 1 << bits entries
+    uint64_t *data;                 // NULL when bits is 0
+    uint16_t palette_count;
+    uint8_t bits;
+    int32_t solid_count;
+    bool modified;                  // changed since it was loaded or saved
+    uint8_t lod;                    // mesh cells are 1 << lod blocks wide
+    uint32_t last_seen;             // stream frame the chunk was last near and in front of the camera
+    bool dirty;                     // mesh out of date
+    bool meshing;                   // snapshot with the workers or waiting for upload
+    bool has_mesh;
+    Mesh mesh;                      // gpu only, cpu arrays are not kept
+    int32_t vertex_capacity;        // vertices the gpu buffers hold, reused while it fits
+    int32_t quad_count;
+} block_chunk_t;
+extern ECS_COMPONENT_DECLARE(block_chunk_t);
+
+// worker pool, task lists and the finished queue (module_block.c)
+typedef struct block_mesher_s block_mesher_t;
+
+// block world singleton
+typedef struct {
+    block_type_t *types;            // BLOCK_MAX_TYPES entries, freed with the block_t hooks
+    int32_t type_count;
+    ecs_map_t chunks;               // chunk key -> chunk entity
+    char *region_dir;               // NULL until block_world_open
+    ecs_map_t regions;              // region key -> block_region_t*, 0 when there is no file
+    int32_t load_x, load_y, load_z; // chunk block_load_area last ran around
+    int32_t load_radius;            // 0 until the first call
+    int64_t chunk_bytes;            // palettes and packed indices of loaded chunks
+    int64_t mesh_bytes;             // gpu buffers of chunk meshes
+    block_atlas_t atlas;            // owned here, the materials borrow it
+    Shader shader;
+    Material material;
+    bool has_material;              // material owns the shader
+    Shader instanced_shader;        // block_t draws, shares the atlas
+    Material instanced_material;
+    bool has_instanced_material;
+    Matrix *instances;              // per frame block_t transforms grouped by type
+    int32_t instance_capacity;
+    int32_t instance_draws;         // DrawMeshInstanced calls last frame
+    block_mesher_t *mesher;
+    float upload_budget_ms;
+    int32_t upload_max_chunks;
+    int32_t submit_max_chunks;
+    int32_t chunk_count;
+    int32_t quad_count;             // all meshed chunks
+    int32_t jobs_in_flight;         // submitted and not uploaded yet
+    int32_t uploads_last_frame;
+    float upload_ms_last_frame;
+} block_world_t;
+extern ECS_COMPONENT_DECLARE(block_world_t);
+
+// streaming around the main_context_t camera. the nearest unloaded chunks
+// are ranked by distance and view direction and loaded a few per frame,
+// chunks past unload_radius or the least recently seen ones over
+// memory_cap are evicted.
+typedef struct {
+    bool enabled;
+    int32_t load_radius;            // chunks
+    int32_t unload_radius;
+    int32_t lod_radius;
+    int32_t max_loads;              // per frame
+    int64_t memory_cap;             // bytes, chunk_bytes + mesh_bytes
+    int32_t *offsets;               // xyz within load_radius, nearest first
+    int32_t offset_count;
+    int32_t offset_radius;          // load_radius the table was built for
+    int32_t cursor;                 // offsets before it are loaded or have nothing to load
+    int32_t center_x, center_y, center_z;
+    uint32_t frame;
+    int32_t loads_last_frame;
+    int32_t evictions_last_frame;
+} block_stream_t;
+extern ECS_COMPONENT_DECLARE(block_stream_t);
+
+// procedural terrain for chunks the region files do not have. the blocks
+// only depend on the seed and the settings, so peers with the same config
+// generate the same world and only edited chunks need saving or sending.
+// a heightmap of fbm noise gives surface, filler and stone columns, 3d
+// noise above cave_threshold carves caves below the surface.
+typedef struct {
+    bool enabled;
+    uint32_t seed;
+    float base_height;              // blocks, surface where the noise is 0
+    float height_scale;             // blocks the surface moves up or down
+    float frequency;                // heightmap noise per block
+    int32_t octaves;
+    float cave_frequency;
+    int32_t cave_octaves;
+    float cave_threshold;           // 1 or more for no caves
+    int32_t filler_depth;           // filler blocks under the surface block
+    block_id_t surface;
+    block_id_t filler;
+    block_id_t stone;
+    int32_t max_jobs;
+    int32_t jobs_in_flight;
+    int32_t generated_last_frame;
+} block_generator_t;
+extern ECS_COMPONENT_DECLARE(block_generator_t);
+
+// first solid block along a ray
+typedef struct {
+    bool hit;
+    int32_t x, y, z;                // hit block
+    int32_t place_x, place_y, place_z; // empty cell in front of the hit face
+    Vector3 normal;                 // hit face, zero when the ray starts inside a block
+    Vector3 point;
+    float distance;
+    block_id_t id;
+} block_hit_t;
+
+// cpu side mesh output of the mesher, reused between chunks
+typedef struct {
+    float *vertices;                // xyz, chunk local
+    float *normals;
+    float *texcoords;               // in blocks, repeats the tile across a merged quad
+    float *texcoords2;              // atlas tile index, y unused
+    unsigned short *indices;
+    int32_t vertex_count;
+    int32_t index_count;
+    int32_t quad_count;
+    int32_t quad_capacity;
+} block_mesh_data_t;
+
+// atlas and the tiling shaders, call after InitWindow. a sheet of
+// BLOCK_ATLAS_TILES tiles per row, tile i is row major like the tiles in
+// block_register_type
+bool block_load_resources(ecs_world_t *world, const char *atlas_path);
+// same from a sheet that is already decoded (asset manager), sheet stays with the caller
+bool block_load_sheet(ecs_world_t *world, Image sheet);
+// packs any number of tile images (block_atlas.h), array picks the
+// sampler2DArray path when GL 3.3 is available. meshes need no rebuild
+bool block_load_tiles(ecs_world_t *world, const Image *tiles, int32_t count, int32_t tile_size, bool array);
+block_id_t block_register_type(ecs_world_t *world, const char *name, const int tiles[BLOCK_FACE_COUNT]);
+
+block_id_t block_get(const ecs_world_t *world, int32_t x, int32_t y, int32_t z);
+// edits the chunk in place, call it outside deferred mode (an .immediate
+// system or between frames)
+void block_set(ecs_world_t *world, int32_t x, int32_t y, int32_t z, block_id_t id);
+
+// region files in dir, created if missing. loaded chunks are not touched
+bool block_world_open(ecs_world_t *world, const char *dir);
+// rewrites every region with a modified chunk, returns regions written or -1
+int32_t block_world_save(ecs_world_t *world);
+// loads stored chunks within radius chunks of position that are not loaded
+// yet, returns how many. does nothing while position stays in the same chunk
+int32_t block_load_area(ecs_world_t *world, Vector3 position, int32_t radius);
+
+// grid walk (Amanatides-Woo), cost follows the ray length not the block count
+block_hit_t block_raycast(const ecs_world_t *world, Ray ray, float max_distance);
+// max_distances per ray or NULL for max_distance on all, a line of sight
+// test is a ray to the target with the target distance as its limit
+void block_raycast_batch(const ecs_world_t *world, const Ray *rays, const float *max_distances, float max_distance, int count, block_hit_t *hits);
+
+// mesher, no world access so it runs on the worker threads
+void block_chunk_snapshot(const ecs_world_t *world, const block_chunk_t *chunk, block_id_t padded[BLOCK_PADDED_VOLUME]);
+// coarse cells of 2^lod blocks for far rings, before block_mesh_build
+void block_padded_downsample(block_id_t padded[BLOCK_PADDED_VOLUME], const block_type_t *types, int32_t lod);
+void block_mesh_build(const block_id_t padded[BLOCK_PADDED_VOLUME], const block_type_t *types, block_mesh_data_t *out);
+void block_mesh_data_free(block_mesh_data_t *data);
+
+// block_t world matrices grouped by type into block_world_t.instances,
+// counts per type, returns the total. no GL calls, the render system draws
+// each type range
+int32_t block_instances_build(ecs_world_t *world, int32_t counts[BLOCK_MAX_TYPES]);
+
+void module_init_block(ecs_world_t *world); // module_block.c
@@ -0,0 +1,47 @@
+// module_debug_draw.h
+// deferred debug lines. any system or worker thread appends lines, rays,
+// boxes and spheres to a command buffer of its own thread, the flush
+// system in RLRender3DPhase gathers every buffer and draws them all as one
+// run of rlgl lines (one draw call unless the rlgl batch fills up).
+//
+//   debug_draw_box(position, (Vector3){1, 1, 1}, BLUE, 0.0f);   // this frame
+//   debug_draw_ray(ray, 50.0f, MAROON, 2.0f);                    // two seconds
+//
+// duration 0 draws once, a longer one keeps the command for that many
+// seconds of frame time. commands added in RLRender3DPhase after the flush
+// system show up a frame later, append from the logic phases instead.
+// there is one set of buffers per process, the world that ran
+// module_init_debug_draw owns it. stop the job pool workers that draw
+// before that world is freed.
+#pragma once
+
+#include "flecs.h"
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DEBUG_DRAW_MAX_THREADS 64         // threads past this share the last buffer
+#define DEBUG_DRAW_MAX_COMMANDS 65536     // per thread buffer and frame, more are dropped
+#define DEBUG_DRAW_SPHERE_SEGMENTS 24     // per circle, a sphere is three circles
+
+// buffers and retained commands (module_debug_draw.c)
+typedef struct debug_draw_host_s debug_draw_host_t;
+
+// stats singleton
+typedef struct {
+    debug_draw_host_t *host;        // freed with the singleton
+    bool enabled;                   // off still drains the buffers
+    int32_t command_count;          // drawn last frame
+    int32_t line_count;
+    int32_t dropped;                // commands lost to full buffers since init
+} debug_draw_t;
+extern ECS_COMPONENT_DECLARE(debug_draw_t);
+
+// thread safe, no-ops before module_init_debug_draw
+void debug_draw_line(Vector3 start, Vector3 end, Color color, float duration);
+void debug_draw_ray(Ray ray, float length, Color color, float duration);
+void debug_draw_box(Vector3 center, Vector3 size, Color color, float duration);
+void debug_draw_sphere(Vector3 center, float radius, Color color, float duration);
+
+// call after module_init_raylib
+void module_init_debug_draw(ecs_world_t *world); // module_debug_draw.c
@@ -2,4 +2,25 @@
 
 #include "flecs.h"
 
-void module_init_editor(ecs_world_t *world); 
\ No newline at end of file
+// persistent list of Transform3D entities for the editor gui.
+// kept up to date by observers (OnAdd/OnRemove Transform3D, name OnSet) so
+// drawing never queries or allocates. names live in an interned string arena.
+typedef struct {
+    ecs_entity_t *ids;          // list order
+    const char **names;         // into arena, passed straight to GuiListViewEx
+    uint32_t *offsets;          // arena offset per row, rebuilds names when the arena moves
+    int32_t count;
+    int32_t capacity;
+    ecs_map_t index;            // entity -> row
+    ecs_map_t interned;         // name hash -> arena offset
+    char *arena;
+    uint32_t arena_used;
+    uint32_t arena_capacity;
+    uint32_t arena_live;        // arena_used after the last compaction
+} editor_list_t;
+extern ECS_COMPONENT_DECLARE(editor_list_t);
+
+// row of entity or -1
+int32_t editor_list_find(const editor_list_t *list, ecs_entity_t entity);
+
+void module_init_editor(ecs_world_t *world); // module_editor.c
@@ -61,8 +61,11 @@ typedef struct tagMSG *LPMSG;
 // #undef ShowCursor
 
 // enet packet component
+// data points into the received ENetPacket and is only valid during the emit.
 typedef struct {
     void *data;
+    size_t length;              // bytes in data
+    ENetPeer *peer;             // sender
 } enet_packet_t;
 extern ECS_COMPONENT_DECLARE(enet_packet_t);
 
@@ -92,18 +95,59 @@ typedef struct {
 } NetworkState;
 extern ECS_COMPONENT_DECLARE(NetworkState);
 
+// outgoing messages are appended into a per peer batch during the frame and
+// sent once at the end of the tick. ENET_OUTBOX_MTU leaves room for the enet
+// protocol and udp headers under a 1400 byte path mtu.
+#define ENET_OUTBOX_MTU 1200
+
+// one pending datagram: [ENET_MSG_BATCH][u16 length][message]...
+// each message keeps its own type in its first byte.
+typedef struct {
+    uint8_t data[ENET_OUTBOX_MTU];
+    uint16_t length;            // bytes used in data
+    uint16_t messages;          // messages in data
+} enet_batch_t;
+
+// lives next to enet_client_t
+typedef struct {
+    enet_batch_t reliable;      // sent ENET_PACKET_FLAG_RELIABLE
+    enet_batch_t unreliable;    // sent ENET_PACKET_FLAG_UNSEQUENCED
+    uint64_t messages_sent;     // total messages
+    uint64_t datagrams_sent;    // total packets handed to enet
+    uint64_t bytes_sent;        // total payload bytes
+    // this tick so far, reset in EcsOnLoad, whole after the flush
+    uint32_t tick_messages;
+    uint32_t tick_datagrams;
+    uint32_t tick_bytes;
+} enet_outbox_t;
+extern ECS_COMPONENT_DECLARE(enet_outbox_t);
+
 // for filter loop to stop checking init network setup.
 typedef struct {
     int is_start;
 } enet_init_network_tag;
 extern ECS_COMPONENT_DECLARE(enet_init_network_tag);
 
+// binary message ids sit in the first byte of a packet. Text messages start
+// with printable ascii, so anything below 32 is a binary message.
+typedef enum {
+    ENET_MSG_INPUT = 1,         // client -> server input commands (module_prediction)
+    ENET_MSG_STATE = 2,         // server -> client authoritative state (module_prediction)
+    ENET_MSG_BATCH = 3,         // several framed messages in one packet (enet_outbox_t)
+    ENET_MSG_BINARY_MAX = 32
+} enet_msg_type_t;
+
 // Declare event entity as extern for global access
 extern ecs_entity_t event_receive_packed;
 extern ecs_entity_t event_connect_peer;
 extern ecs_entity_t event_disconnect_peer;
 extern ecs_entity_t event_disconnect_timeout;
 
+// queue a message for a peer, sent at the end of the tick
+bool enet_outbox_send(ecs_world_t *world, ENetPeer *peer, const void *data, size_t length, bool reliable);
+// queue a message for every connected peer
+void enet_outbox_broadcast(ecs_world_t *world, const void *data, size_t length, bool reliable);
+
 void module_init_enet(ecs_world_t *world);
 
 #endif // MODULE_ENET_H
\ No newline at end of file
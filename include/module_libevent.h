@@ -11,7 +11,9 @@
     #include <winsock2.h>
     #include <ws2tcpip.h>
 #else
-    #error This code is designed for Windows only
+    #include <arpa/inet.h>   // inet_pton, htons
+    #include <netinet/in.h>  // sockaddr_in, INET_ADDRSTRLEN
+    #include <sys/socket.h>
 #endif
 
 #include "flecs.h"
@@ -19,6 +21,10 @@
 #include <event2/bufferevent.h>
 #include <event2/listener.h>
 #include <stdbool.h>
+#include "libevent_frame.h"
+#include "libevent_queue.h"
+
+#define LIBEVENT_QUEUE_CAPACITY 4096 // dispatch thread -> ECS events in flight
 
 // server network component
 typedef struct {
@@ -26,6 +32,7 @@ typedef struct {
     // int port;
     uint16_t port; // Changed to uint16_t
     bool is_init; //prevent overlap set up
+    bool threaded; // run event_base_dispatch on its own thread
 } libevent_server_t;
 extern ECS_COMPONENT_DECLARE(libevent_server_t);
 
@@ -38,15 +45,22 @@ typedef struct {
 } libevent_client_t;
 extern ECS_COMPONENT_DECLARE(libevent_client_t);
 
+typedef struct libevent_conn_s libevent_conn_t;
+// connect/disconnect events that did not fit the queue (module_libevent.c)
+typedef struct libevent_overflow_s libevent_overflow_t;
+
 // server client handle
 typedef struct {
     struct bufferevent *bev;
+    libevent_conn_t *conn;
 } libevent_bev_t;
 extern ECS_COMPONENT_DECLARE(libevent_bev_t);// server client
 
 // network loop
 typedef struct {
     struct event_base *ev_base;
+    bool threaded; // loop runs on thread, event_base_system drains the queue
+    ecs_os_thread_t thread;
 } libevent_base_t;
 extern ECS_COMPONENT_DECLARE(libevent_base_t);
 
@@ -56,10 +70,26 @@ typedef struct {
     int pings_sent;
     int pongs_received;
     char status[256];
+    libevent_queue_t *queue; // set while the server runs threaded
+    libevent_overflow_t *overflow; // with queue, never drops connect/disconnect
+    int client_count; // connected clients, kept by add/remove
 } libevent_context_t;
 extern ECS_COMPONENT_DECLARE(libevent_context_t);
 
+// per connection callback context, so callbacks find their entity without a search.
+// freed together with the bufferevent.
+struct libevent_conn_s {
+    libevent_context_t *app;
+    struct bufferevent *bev;
+    ecs_entity_t entity; // owner of libevent_bev_t, only touched on the ECS thread
+    // dispatch thread only: reading stops while the queue is full
+    bool blocked;
+    bool paused;
+    libevent_conn_t *next_paused;
+};
+
 // libevent packet component
+// data points into the input evbuffer and is only valid during the emit.
 typedef struct {
     void *data;       // Pointer to the message data (header + payload)
     size_t length;    // Total length of the data
@@ -71,8 +101,9 @@ extern ECS_COMPONENT_DECLARE(libevent_packet_t);
 extern ecs_entity_t libevent_receive_packed;
 
 
+// wire header, both fields in network order (see libevent_frame.h)
 struct GameMessage {
-    uint16_t type;    // Message type (e.g., 1 = Position, 2 = Health, 3 = Chat)
+    uint16_t type;    // Message type (libevent_msg_type_t)
     uint16_t length;  // Length of payload in bytes
     uint8_t payload[]; // Variable-length payload (flexible array member)
 };
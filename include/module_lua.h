@@ -0,0 +1,89 @@
+// module_lua.h
+// lua 5.4 scripting. scripts define flecs systems with ecs.system, the
+// callback runs once per matched table and reads or writes component
+// fields through array views over the ecs_field columns. views and the
+// iterator are created once per system and pointed at the next table, so
+// a frame over 10k entities creates no lua tables or strings.
+//
+//   ecs.system{
+//       name = "bob", phase = "LogicUpdate", query = { "Transform3D" },
+//       callback = function(it)
+//           local y = it:field(1, "position.y")
+//           local dirty = it:field(1, "isDirty")
+//           for i = 1, it.count do
+//               y[i] = y[i] + it.delta_time
+//               dirty[i] = true
+//           end
+//       end
+//   }
+//
+// query terms are registered component names, "!name" for not. phases are
+// the ecs_components.h phase names without "Phase". indexes are 1 based.
+// a system that raises an error is logged and disabled. main thread only.
+// scripts also get ecs.component{ name, fields = { "time", "count:int" } },
+// ecs.set(entity, name, { field = value }), ecs.has and ecs.lookup.
+//
+// watched files run again after the frame they change in (inotify on
+// linux, mtime polling elsewhere). a system defined again by name keeps
+// its entity and gets the new callback, a changed query or phase builds it
+// again, and systems the file stopped defining are deleted. all of that
+// happens once the file ran through, a file with an error changes none of
+// its systems. inside a watched file ecs.system returns 0 for a system that
+// is new or built again, the entity does not exist yet. lua locals and
+// upvalues start over, state that has to survive a reload goes in a script
+// component on the entity. define systems at the top level of a file, not
+// from inside a system callback.
+#pragma once
+
+#include "flecs.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LUA_SCRIPT_MAX_COMPONENTS 64
+#define LUA_SCRIPT_MAX_FIELDS 32          // per component
+#define LUA_SCRIPT_MAX_VIEWS 16           // it:field views kept per system
+#define LUA_SCRIPT_NAME_SIZE 32
+#define LUA_SCRIPT_MAX_FILES 32           // watched files
+#define LUA_SCRIPT_PATH_SIZE 256
+#define LUA_SCRIPT_POLL_SECONDS 0.5f      // mtime polling where inotify is missing
+
+typedef enum {
+    LUA_SCRIPT_FLOAT,
+    LUA_SCRIPT_INT32,
+    LUA_SCRIPT_BOOL
+} lua_script_type_t;
+
+typedef struct {
+    const char *name;               // copied
+    int32_t offset;
+    lua_script_type_t type;
+} lua_script_field_t;
+
+// lua state and component registry (module_lua.c)
+typedef struct lua_script_host_s lua_script_host_t;
+
+// stats singleton
+typedef struct {
+    lua_script_host_t *host;        // freed with the singleton
+    int32_t system_count;
+    int32_t errors;                 // script errors since init
+    int32_t reloads;
+} lua_script_t;
+extern ECS_COMPONENT_DECLARE(lua_script_t);
+
+// makes a component usable in script queries and it:field. false when the
+// registry is full, the name is taken or id is 0
+bool lua_script_register_component(ecs_world_t *world, const char *name, ecs_entity_t id,
+                                   const lua_script_field_t *fields, int32_t field_count);
+
+// runs a script file or source string, false (and logged) on an error
+bool lua_script_load(ecs_world_t *world, const char *path);
+bool lua_script_run(ecs_world_t *world, const char *source, const char *chunk_name);
+// runs the file and reloads it whenever it changes. with
+// LUA_SCRIPT_PRECOMPILED defined it loads the bytecode in path .. "c"
+// (lua_compile tool) once instead and does not watch
+bool lua_script_watch(ecs_world_t *world, const char *path);
+
+// registers Transform3D (position.x, rotation.w, scale.z, isDirty and so on).
+// call after module_init_raylib
+void module_init_lua(ecs_world_t *world); // module_lua.c
@@ -2,6 +2,7 @@
 
 #include "flecs.h"
 #include "ode/ode.h"
+#include "raylib.h"
 
 
 // Components
@@ -15,6 +16,22 @@ typedef struct {
 } ode_geom_t;
 extern ECS_COMPONENT_DECLARE(ode_geom_t);
 
+// body and geom description, plain data so a scene can store it.
+// ode_shape_create builds ode_body_t and ode_geom_t from it
+typedef enum {
+    ODE_SHAPE_BOX,          // size is the full extents
+    ODE_SHAPE_SPHERE,       // size.x radius
+    ODE_SHAPE_CAPSULE,      // size.x radius, size.y length along local z
+    ODE_SHAPE_PLANE         // size is the normal, through the Transform3D position
+} ode_shape_type_t;
+
+typedef struct {
+    int32_t type;           // ode_shape_type_t
+    Vector3 size;
+    float mass;             // 0 is a static geom without a body, planes are always static
+} ode_shape_t;
+extern ECS_COMPONENT_DECLARE(ode_shape_t);
+
 typedef struct {
     dWorldID world;
     dSpaceID space;
@@ -23,4 +40,9 @@ typedef struct {
 extern ECS_COMPONENT_DECLARE(ode_context_t);
 
 
+// geom (and body when it has mass) at the world pose of the Transform3D,
+// parents included, for each entity with ode_shape_t and no ode_geom_t yet.
+// returns how many were created
+int32_t ode_shape_create(ecs_world_t *world, const ecs_entity_t *entities, int32_t count);
+
 void module_init_ode(ecs_world_t *world); // Initialization function
\ No newline at end of file
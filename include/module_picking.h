@@ -0,0 +1,78 @@
+// module_picking.h
+// ray picking over entity AABBs using a uniform grid (spatial hash).
+// entities with pick_bounds_t are in the grid, set it again when they move.
+// entities with Transform3D + pick_shape_t get pick_bounds_t kept for them,
+// refreshed only when update_transform_3d_system moves them.
+#pragma once
+
+#include "flecs.h"
+#include "raylib.h"
+
+#define PICK_DEFAULT_CELL_SIZE 4.0f     // world units per grid cell
+#define PICK_MAX_CELLS_PER_ITEM 512     // larger boxes go in the oversized list
+
+// world space AABB used for picking
+typedef struct {
+    Vector3 min;
+    Vector3 max;
+} pick_bounds_t;
+extern ECS_COMPONENT_DECLARE(pick_bounds_t);
+
+// local half extents, bounds follow the Transform3D world matrix
+typedef struct {
+    Vector3 half_extents;
+} pick_shape_t;
+extern ECS_COMPONENT_DECLARE(pick_shape_t);
+
+// closest hit along a ray
+typedef struct {
+    bool hit;
+    ecs_entity_t entity;
+    Vector3 point;
+    Vector3 normal;
+    float distance;
+} pick_hit_t;
+
+typedef struct {
+    ecs_entity_t entity;        // 0 when the slot is free
+    BoundingBox box;
+    int32_t next_free;          // free list link
+    bool oversized;
+} pick_item_t;
+
+typedef struct {
+    int32_t *items;
+    int32_t count;
+    int32_t capacity;
+} pick_cell_t;
+
+// grid singleton
+typedef struct {
+    float cell_size;
+    float inv_cell_size;
+    pick_item_t *items;
+    uint32_t *stamps;           // per item, skips items seen in an earlier cell
+    uint32_t stamp;
+    int32_t item_count;
+    int32_t item_capacity;
+    int32_t free_head;
+    ecs_map_t entity_items;     // entity -> item
+    ecs_map_t cell_index;       // cell key -> cell
+    pick_cell_t *cells;
+    int32_t cell_count;
+    int32_t cell_capacity;
+    int32_t *oversized;
+    int32_t oversized_count;
+    int32_t oversized_capacity;
+    Vector3 bounds_min;         // union of all boxes (grow only)
+    Vector3 bounds_max;
+    int32_t live_count;
+} pick_grid_t;
+extern ECS_COMPONENT_DECLARE(pick_grid_t);
+
+// closest hit within max_distance
+pick_hit_t pick_ray(ecs_world_t *world, Ray ray, float max_distance);
+// one hit per ray
+void pick_rays(ecs_world_t *world, const Ray *rays, int count, float max_distance, pick_hit_t *hits);
+
+void module_init_picking(ecs_world_t *world); // module_picking.c
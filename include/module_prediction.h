@@ -0,0 +1,75 @@
+// module_prediction.h
+// client side prediction and server reconciliation for the capsule controller.
+// requires module_ode and module_enet.
+#pragma once
+
+#include "flecs.h"
+#include "raylib.h"
+#include <stdint.h>
+
+#define PREDICT_TICK_DT (1.0f / 60.0f)  // must match the step in ode_physics_system
+#define PREDICT_MIN_HISTORY 32          // ring buffer size floor (power of two)
+#define PREDICT_MAX_HISTORY 1024        // ring buffer size cap (~17s at 60hz)
+#define PREDICT_MAX_REDUNDANT 16        // unacked inputs resent in every input packet
+
+// input buttons
+#define PREDICT_BUTTON_FORWARD  (1 << 0)
+#define PREDICT_BUTTON_BACKWARD (1 << 1)
+#define PREDICT_BUTTON_LEFT     (1 << 2)
+#define PREDICT_BUTTON_RIGHT    (1 << 3)
+#define PREDICT_BUTTON_JUMP     (1 << 4)
+
+// one tick of player input
+typedef struct {
+    uint32_t sequence;          // increases by one every tick
+    uint8_t buttons;            // PREDICT_BUTTON_*
+    float yaw;                  // facing in radians, 0 = +x
+} predict_input_t;
+
+// simulated state of the capsule
+typedef struct {
+    Vector3 position;
+    Vector3 velocity;
+} predict_state_t;
+
+// movement settings, must match on client and server
+typedef struct {
+    float move_speed;           // horizontal speed units/s
+    float jump_speed;           // upward velocity on jump
+    float gravity;              // matches dWorldSetGravity
+    float ground_height;        // capsule center height when standing
+    float correction_epsilon;   // error (units) before rewind and replay
+    Vector3 spawn;              // server spawn point for new clients
+    Model *model;               // capsule model for rendering
+} predict_config_t;
+extern ECS_COMPONENT_DECLARE(predict_config_t);
+
+// local player predicted on the client
+typedef struct {
+    predict_input_t *inputs;    // ring of sent inputs indexed by sequence
+    predict_state_t *states;    // ring of predicted states after each input
+    uint32_t capacity;          // ring size, power of two, sized from rtt
+    uint32_t next_sequence;     // sequence for the next sampled input
+    uint32_t last_acked;        // last sequence the server processed
+    uint32_t corrections;       // number of rewinds
+    float last_error;           // position error at the last ack
+} predict_client_t;
+extern ECS_COMPONENT_DECLARE(predict_client_t);
+
+// remote player simulated on the server, lives on the enet_client_t entity
+typedef struct {
+    ecs_entity_t body;          // capsule entity with ode_body_t
+    predict_input_t *inputs;    // ring of received inputs indexed by sequence
+    uint32_t capacity;          // ring size, power of two, sized from rtt
+    uint32_t last_processed;    // last sequence applied to the body
+    uint32_t highest_received;  // newest sequence seen
+    predict_input_t current;    // input held while waiting for the next one
+} predict_server_t;
+extern ECS_COMPONENT_DECLARE(predict_server_t);
+
+// shared movement model
+predict_state_t predict_integrate(predict_state_t state, const predict_input_t *input, const predict_config_t *config, float dt);
+uint32_t predict_history_for_rtt(uint32_t rtt_ms);
+ecs_entity_t predict_spawn_capsule(ecs_world_t *world, Vector3 position);
+
+void module_init_prediction(ecs_world_t *world); // module_prediction.c
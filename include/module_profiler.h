@@ -0,0 +1,74 @@
+// module_profiler.h
+// frame profiler for ecs_progress. profiler_instrument swaps every system
+// callback for a timing wrapper, so each system gets a zone inside a zone
+// for its phase. code inside a system can add nested zones with
+// profiler_zone_begin/end (ode collide and step, enet service).
+// the last PROFILER_FRAMES frames stay in a ring, F3 shows the timeline
+// overlay and F4 writes the ring as a trace for ui.perfetto.dev (binary)
+// and chrome://tracing (json).
+// frames start in ProfilerFramePhase, which EcsOnLoad depends on, so the
+// profiler can be set up before or after the other modules.
+// cheap enough to leave in release builds, a disabled profiler is one
+// extra call and branch per system. zones are main thread only.
+#pragma once
+
+#include "flecs.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROFILER_FRAMES 240             // ring of recorded frames
+#define PROFILER_MAX_ZONES 256          // per frame, later zones are dropped
+#define PROFILER_MAX_DEPTH 16
+#define PROFILER_TRACE_PATH "profile.perfetto-trace"
+#define PROFILER_JSON_PATH "profile.json"
+
+typedef struct {
+    const char *name;                   // must outlive the ring, literals or system names
+    uint64_t begin;                     // ns, ecs_os_now
+    uint64_t end;
+    int32_t depth;                      // 0 phase, 1 system, 2+ zones inside systems
+} profiler_zone_t;
+
+typedef struct {
+    uint64_t id;                        // frames since module_init_profiler
+    uint64_t begin;                     // ns, this frame start to the next one
+    uint64_t end;
+    profiler_zone_t zones[PROFILER_MAX_ZONES];
+    int32_t zone_count;
+    int32_t dropped;
+    bool spike;
+} profiler_frame_t;
+
+// settings and stats singleton
+typedef struct {
+    bool enabled;                       // record frames
+    bool show_overlay;                  // F3
+    bool paused;                        // keep the ring as it is, set by clicking a frame
+    int32_t selected;                   // frames back from the newest, shown in the timeline
+    float spike_ratio;                  // frame time over average * ratio is a spike
+    float average_ms;
+    float last_ms;
+    int32_t spike_count;
+    int32_t instrumented;               // systems wrapped
+} profiler_t;
+extern ECS_COMPONENT_DECLARE(profiler_t);
+
+// nested zone inside the running system, a no-op when not recording
+void profiler_zone_begin(const char *name);
+void profiler_zone_end(void);
+
+// wrap every system registered so far, call once after all modules and
+// app systems are set up. systems with a run callback or an owned
+// callback_ctx are left alone
+int32_t profiler_instrument(ecs_world_t *world);
+
+// a recorded frame, back 0 is the last complete frame. NULL when out of range
+const profiler_frame_t *profiler_frame(int32_t back);
+int32_t profiler_frame_count(void);
+
+// protobuf trace packets, one track with every frame as a slice
+bool profiler_export_perfetto(const char *path);
+// chrome trace event json, complete events
+bool profiler_export_json(const char *path);
+
+void module_init_profiler(ecs_world_t *world); // module_profiler.c
@@ -0,0 +1,82 @@
+// module_scene.h
+// binary scene files. every entity with Transform3D is saved the way flecs
+// stores it: one block per table, each registered component a contiguous
+// column, so loading maps the file and creates a whole block with one
+// ecs_bulk_init straight from the mapped columns.
+// a table has one ChildOf parent, blocks are written parents first and the
+// parent is an index into the entities before it. names are kept.
+// pointers and handles (ModelComponent, ode_body_t) are not saved, ode
+// bodies are built again from ode_shape_t. chunk data stays in the block
+// region files.
+// components are matched by a stable tag and their size, a column the
+// running build does not know is skipped. values are stored as in memory,
+// little endian.
+#pragma once
+
+#include "flecs.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCENE_MAGIC 0x454E4353u           // "SCNE"
+#define SCENE_VERSION 1
+#define SCENE_ALIGN 16                    // blocks and columns start on this
+#define SCENE_MAX_COMPONENTS 64           // one bit each in a block mask
+#define SCENE_TAG(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entity_count;
+    uint32_t block_count;
+    uint32_t component_count;       // scene_component_entry_t after the header
+    uint32_t reserved;
+    uint64_t strings_offset;        // names, the blob starts with an empty string
+    uint64_t strings_size;
+} scene_header_t;
+
+typedef struct {
+    uint32_t tag;
+    uint32_t size;                  // 0 for a tag
+} scene_component_entry_t;
+
+// followed by a column for each mask bit with a size, in entry order, then
+// uint32 name offsets when has_names
+typedef struct {
+    uint64_t mask;                  // bit i is component entry i
+    uint64_t size;                  // to the next block, this header included
+    uint32_t count;
+    int32_t parent;                 // entity index in the file, -1 for none
+    uint32_t has_names;
+    uint32_t reserved;
+} scene_block_t;
+
+typedef struct {
+    uint32_t tag;
+    ecs_id_t id;
+    ecs_size_t size;
+} scene_component_t;
+
+// registry and stats singleton
+typedef struct {
+    scene_component_t components[SCENE_MAX_COMPONENTS];
+    int32_t component_count;
+    int32_t last_entities;          // last save or load
+    int32_t last_blocks;
+    float last_ms;
+} scene_t;
+extern ECS_COMPONENT_DECLARE(scene_t);
+
+// id is a component or a tag. false when the registry is full, the tag is
+// taken or id is 0 (the module that defines it was not initialized)
+bool scene_register(ecs_world_t *world, ecs_id_t id, uint32_t tag);
+
+// entities written or -1. the file goes to path.tmp and is swapped in
+int32_t scene_save(ecs_world_t *world, const char *path);
+// entities created or -1 when the file is missing or not a scene. entities
+// are added next to what the world has, nothing is replaced. bulk creation
+// is not deferred, call it outside ecs_progress
+int32_t scene_load(ecs_world_t *world, const char *path);
+
+// registers Transform3D and the components of the modules initialized
+// before it (block_t, ode_shape_t, pick_shape_t)
+void module_init_scene(ecs_world_t *world); // module_scene.c
@@ -0,0 +1,70 @@
+// module_text3d.h
+// world space text labels. each label is laid out once into glyph quads
+// (cached on the component, laid out again when it is set), every visible
+// label is billboarded into one dynamic vertex buffer per frame and drawn
+// with one font texture bind and one draw call. labels past max_distance
+// or behind the main_context_t camera are skipped.
+//
+//   ecs_set(world, e, text3d_t, {
+//       .text = "cube_1", .offset = {0, 1.0f, 0}, .size = 0.4f, .color = WHITE
+//   });
+//
+// the label is centered on the Transform3D world position plus offset,
+// its bottom edge on that point. main thread only.
+#pragma once
+
+#include "flecs.h"
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TEXT3D_TEXT_SIZE 64               // bytes, utf8
+#define TEXT3D_MAX_DISTANCE 50.0f         // default cull distance
+#define TEXT3D_MIN_VERTICES 1024          // first vertex buffer, grows by doubling
+
+// one glyph quad in label space, x right and y down from the top left
+typedef struct {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+} text3d_glyph_t;
+
+typedef struct {
+    char text[TEXT3D_TEXT_SIZE];
+    Vector3 offset;                 // from the world position
+    float size;                     // line height in world units
+    float spacing;                  // extra space between glyphs
+    Color color;
+    // layout cache, owned by the hooks
+    text3d_glyph_t *glyphs;
+    int32_t glyph_count;
+    float width;
+    float height;
+    bool laid_out;
+} text3d_t;
+extern ECS_COMPONENT_DECLARE(text3d_t);
+
+// font, buffers and stats singleton
+typedef struct {
+    Font font;
+    bool owns_font;                 // unloaded with the singleton
+    Shader shader;                  // discards transparent texels
+    bool has_shader;
+    float max_distance;
+    unsigned int vao;               // 0 without vertex array support
+    unsigned int vbo;
+    int32_t gpu_capacity;           // vertices
+    void *vertices;                 // cpu staging, module_text3d.c vertex layout
+    int32_t vertex_capacity;
+    int32_t labels_drawn;
+    int32_t labels_culled;
+    int32_t glyphs_drawn;
+    int32_t draw_calls;
+} text3d_renderer_t;
+extern ECS_COMPONENT_DECLARE(text3d_renderer_t);
+
+// swaps the font and lays every label out again. owned fonts are unloaded
+// with the singleton or the next text3d_set_font
+void text3d_set_font(ecs_world_t *world, Font font, bool owned);
+
+// call after InitWindow (default font) and module_init_raylib
+void module_init_text3d(ecs_world_t *world); // module_text3d.c
@@ -0,0 +1,31 @@
+-- editor.lua
+-- gameplay script for main_editor_test, saving it reloads it while the
+-- editor runs. the bob state lives in bob_t so it survives a reload, the
+-- tuning below is picked up on the next save.
+local speed = 2.0
+local height = 0.25
+
+ecs.component{ name = "bob_t", fields = { "time", "offset" } }
+
+local cube = ecs.lookup("cube_1")
+if cube ~= 0 and not ecs.has(cube, "bob_t") then
+    ecs.set(cube, "bob_t")
+end
+
+ecs.system{
+    name = "bob_system", phase = "LogicUpdate", query = { "Transform3D", "bob_t" },
+    callback = function(it)
+        local y = it:field(1, "position.y")
+        local dirty = it:field(1, "isDirty")
+        local time = it:field(2, "time")
+        local offset = it:field(2, "offset")
+        local dt = it.delta_time
+        for i = 1, it.count do
+            time[i] = time[i] + dt
+            local bob = math.sin(time[i] * speed) * height
+            y[i] = y[i] - offset[i] + bob
+            offset[i] = bob
+            dirty[i] = true
+        end
+    end
+}
@@ -0,0 +1,30 @@
+#version 100
+
+precision mediump float;
+
+// Input vertex attributes (from vertex shader)
+varying vec2 fragTexCoord;
+varying float fragTile;
+varying float fragShade;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform float atlasColumns; // cells per atlas row
+uniform vec2 cellSize;      // padded cell in atlas uv
+uniform vec2 tileSize;      // tile inside the cell
+uniform vec2 tileOffset;    // padding before the tile
+
+void main()
+{
+    float tile = floor(fragTile + 0.5);
+    vec2 cell = vec2(mod(tile, atlasColumns), floor(tile/atlasColumns));
+    // repeat the tile across a greedy merged quad, no textureGrad here so
+    // the atlas is sampled without mips
+    vec2 uv = cell*cellSize + tileOffset + fract(fragTexCoord)*tileSize;
+    vec4 texelColor = texture2D(texture0, uv);
+
+    if (texelColor.a == 0.0) discard;
+
+    gl_FragColor = vec4(texelColor.rgb*fragShade, texelColor.a)*colDiffuse;
+}
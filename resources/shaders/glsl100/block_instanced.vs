@@ -0,0 +1,26 @@
+#version 100
+
+// Input vertex attributes
+attribute vec3 vertexPosition;
+attribute vec2 vertexTexCoord;      // position on the face in blocks
+attribute vec2 vertexTexCoord2;     // atlas tile index in x
+attribute vec3 vertexNormal;
+attribute mat4 instanceTransform;   // block_t world matrix
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+varying vec2 fragTexCoord;
+varying float fragTile;
+varying float fragShade;
+
+void main()
+{
+    fragTexCoord = vertexTexCoord;
+    fragTile = vertexTexCoord2.x;
+    // same face shading as block_atlas.vs, in world space
+    vec3 normal = normalize(mat3(instanceTransform[0].xyz, instanceTransform[1].xyz, instanceTransform[2].xyz)*vertexNormal);
+    fragShade = 0.75 + 0.25*normal.y - 0.1*abs(normal.x);
+    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);
+}
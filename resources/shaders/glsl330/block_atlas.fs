@@ -0,0 +1,29 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in float fragTile;
+in float fragShade;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform float atlasColumns; // cells per atlas row
+uniform vec2 cellSize;      // padded cell in atlas uv
+uniform vec2 tileSize;      // tile inside the cell
+uniform vec2 tileOffset;    // padding before the tile
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    float tile = floor(fragTile + 0.5);
+    vec2 cell = vec2(mod(tile, atlasColumns), floor(tile/atlasColumns));
+    // repeat the tile across a greedy merged quad
+    vec2 uv = cell*cellSize + tileOffset + fract(fragTexCoord)*tileSize;
+    // gradients of the unwrapped coordinate, the jump at each repeat would pick the smallest mip
+    vec4 texelColor = textureGrad(texture0, uv, dFdx(fragTexCoord)*tileSize, dFdy(fragTexCoord)*tileSize);
+    if (texelColor.a == 0.0) discard;
+    finalColor = vec4(texelColor.rgb*fragShade, texelColor.a)*colDiffuse;
+}
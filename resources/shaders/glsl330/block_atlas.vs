@@ -0,0 +1,24 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;     // position on the face in blocks
+in vec2 vertexTexCoord2;    // atlas tile index in x
+in vec3 vertexNormal;
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out float fragTile;
+out float fragShade;
+
+void main()
+{
+    fragTexCoord = vertexTexCoord;
+    fragTile = vertexTexCoord2.x;
+    // fixed per face shading: top bright, sides mid, bottom dark
+    fragShade = 0.75 + 0.25*vertexNormal.y - 0.1*abs(vertexNormal.x);
+    gl_Position = mvp*vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in float fragTile;
+in float fragShade;
+
+// Input uniform values
+uniform sampler2DArray atlasArray;  // one layer per tile
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // the layer repeats and picks its mip in hardware
+    vec4 texelColor = texture(atlasArray, vec3(fragTexCoord, floor(fragTile + 0.5)));
+    if (texelColor.a == 0.0) discard;
+    finalColor = vec4(texelColor.rgb*fragShade, texelColor.a)*colDiffuse;
+}
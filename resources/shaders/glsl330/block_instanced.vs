@@ -0,0 +1,26 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;     // position on the face in blocks
+in vec2 vertexTexCoord2;    // atlas tile index in x
+in vec3 vertexNormal;
+in mat4 instanceTransform;  // block_t world matrix
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out float fragTile;
+out float fragShade;
+
+void main()
+{
+    fragTexCoord = vertexTexCoord;
+    fragTile = vertexTexCoord2.x;
+    // same face shading as block_atlas.vs, in world space
+    vec3 normal = normalize(mat3(instanceTransform)*vertexNormal);
+    fragShade = 0.75 + 0.25*normal.y - 0.1*abs(normal.x);
+    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);
+}
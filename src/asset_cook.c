@@ -0,0 +1,216 @@
+// asset_cook.c
+#include "asset_cook.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint64_t asset_cook_hash(const void *data, size_t size){
+    const uint8_t *bytes = data;
+    uint64_t hash = 14695981039346656037ull ^ (uint64_t)size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+bool asset_cook_path(char *path, size_t path_size, uint64_t key_hash){
+    int length = snprintf(path, path_size, "%s/%016llx.cook", ASSET_COOK_DIR, (unsigned long long)key_hash);
+    return length > 0 && (size_t)length < path_size;
+}
+
+// every level of the mip chain
+static uint64_t asset_cook_pixels_size(int32_t width, int32_t height, int32_t mipmaps, int32_t format){
+    uint64_t size = 0;
+    for (int32_t level = 0; level < mipmaps; level++) {
+        size += (uint64_t)GetPixelDataSize(width, height, format);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return size;
+}
+
+static uint64_t asset_cook_mesh_size(uint32_t vertex_count, uint32_t index_count, uint32_t streams){
+    uint64_t size = (uint64_t)vertex_count * 3 * sizeof(float);
+    if (streams & ASSET_COOK_NORMALS) size += (uint64_t)vertex_count * 3 * sizeof(float);
+    if (streams & ASSET_COOK_TEXCOORDS) size += (uint64_t)vertex_count * 2 * sizeof(float);
+    if (streams & ASSET_COOK_INDICES) size += (uint64_t)index_count * sizeof(unsigned short);
+    return size;
+}
+
+static bool asset_cook_valid(const uint8_t *data, size_t size){
+    if (size < sizeof(asset_cook_header_t)) return false;
+    const asset_cook_header_t *header = (const asset_cook_header_t *)data;
+    if (header->magic != ASSET_COOK_MAGIC || header->version != ASSET_COOK_VERSION) return false;
+    uint64_t tables = sizeof(asset_cook_header_t) + (uint64_t)header->image_count * sizeof(asset_cook_image_t)
+        + (uint64_t)header->mesh_count * sizeof(asset_cook_mesh_t);
+    if (tables > size) return false;
+    const asset_cook_image_t *images = (const asset_cook_image_t *)(data + sizeof(asset_cook_header_t));
+    for (uint32_t i = 0; i < header->image_count; i++) {
+        const asset_cook_image_t *image = &images[i];
+        if (image->size == 0) continue;
+        if (image->width <= 0 || image->height <= 0 || image->mipmaps <= 0) return false;
+        if (image->offset % ASSET_COOK_ALIGN != 0 || image->offset + image->size > size) return false;
+        if (asset_cook_pixels_size(image->width, image->height, image->mipmaps, image->format) != image->size) return false;
+    }
+    const asset_cook_mesh_t *meshes = (const asset_cook_mesh_t *)(images + header->image_count);
+    for (uint32_t i = 0; i < header->mesh_count; i++) {
+        const asset_cook_mesh_t *mesh = &meshes[i];
+        if (mesh->vertex_count == 0 || mesh->vertex_count > 65535) return false;
+        if (mesh->material < 0 || (uint32_t)mesh->material >= header->image_count) return false;
+        if (mesh->offset % ASSET_COOK_ALIGN != 0 || mesh->offset + mesh->size > size) return false;
+        if (asset_cook_mesh_size(mesh->vertex_count, mesh->index_count, mesh->streams) != mesh->size) return false;
+    }
+    return true;
+}
+
+bool asset_cook_open(asset_cook_t *cook, const char *path, uint32_t kind, uint64_t key_hash, uint64_t source_hash, uint64_t source_size){
+    memset(cook, 0, sizeof(asset_cook_t));
+    if (!file_map_open(&cook->map, path)) return false;
+    const asset_cook_header_t *header = (const asset_cook_header_t *)cook->map.data;
+    if (!asset_cook_valid(cook->map.data, cook->map.size) || header->kind != kind || header->key_hash != key_hash
+        || header->source_hash != source_hash || header->source_size != source_size) {
+        asset_cook_close(cook);
+        return false;
+    }
+    cook->header = header;
+    cook->images = (const asset_cook_image_t *)(cook->map.data + sizeof(asset_cook_header_t));
+    cook->meshes = (const asset_cook_mesh_t *)(cook->images + header->image_count);
+    return true;
+}
+
+void asset_cook_close(asset_cook_t *cook){
+    file_map_close(&cook->map);
+    memset(cook, 0, sizeof(asset_cook_t));
+}
+
+Image asset_cook_image(const asset_cook_t *cook, int32_t index, Color *color){
+    const asset_cook_image_t *entry = &cook->images[index];
+    if (color) {
+        *color = (Color){ entry->color & 0xFF, (entry->color >> 8) & 0xFF, (entry->color >> 16) & 0xFF, entry->color >> 24 };
+    }
+    if (entry->size == 0) return (Image){ 0 };
+    return (Image){
+        .data = (void *)(cook->map.data + entry->offset),
+        .width = entry->width,
+        .height = entry->height,
+        .mipmaps = entry->mipmaps,
+        .format = entry->format
+    };
+}
+
+Mesh asset_cook_mesh(const asset_cook_t *cook, int32_t index, int *material){
+    const asset_cook_mesh_t *entry = &cook->meshes[index];
+    uint8_t *data = (uint8_t *)(cook->map.data + entry->offset);
+    Mesh mesh = { 0 };
+    mesh.vertexCount = (int)entry->vertex_count;
+    mesh.vertices = (float *)data;
+    data += (size_t)entry->vertex_count * 3 * sizeof(float);
+    if (entry->streams & ASSET_COOK_NORMALS) {
+        mesh.normals = (float *)data;
+        data += (size_t)entry->vertex_count * 3 * sizeof(float);
+    }
+    if (entry->streams & ASSET_COOK_TEXCOORDS) {
+        mesh.texcoords = (float *)data;
+        data += (size_t)entry->vertex_count * 2 * sizeof(float);
+    }
+    if (entry->streams & ASSET_COOK_INDICES) {
+        mesh.indices = (unsigned short *)data;
+        mesh.triangleCount = (int)(entry->index_count / 3);
+    } else {
+        mesh.triangleCount = (int)(entry->vertex_count / 3);
+    }
+    if (material) *material = entry->material;
+    return mesh;
+}
+
+static bool asset_cook_put(FILE *file, uint64_t *written, uint64_t offset, const void *data, size_t size){
+    static const uint8_t zero[ASSET_COOK_ALIGN] = {0};
+    size_t pad = (size_t)(offset - *written);
+    if (pad > 0 && fwrite(zero, 1, pad, file) != pad) return false;
+    if (size > 0 && fwrite(data, 1, size, file) != size) return false;
+    *written = offset + size;
+    return true;
+}
+
+bool asset_cook_write(const char *path, uint32_t kind, uint64_t key_hash, uint64_t source_hash, uint64_t source_size,
+    const Image *images, const Color *colors, int32_t image_count,
+    const Mesh *meshes, const int *materials, int32_t mesh_count){
+    char tmp_path[1024];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return false;
+
+    size_t tables_size = sizeof(asset_cook_header_t) + sizeof(asset_cook_image_t) * (size_t)image_count
+        + sizeof(asset_cook_mesh_t) * (size_t)mesh_count;
+    uint8_t *tables = calloc(1, tables_size);
+    if (!tables) return false;
+    asset_cook_header_t *header = (asset_cook_header_t *)tables;
+    asset_cook_image_t *image_entries = (asset_cook_image_t *)(tables + sizeof(asset_cook_header_t));
+    asset_cook_mesh_t *mesh_entries = (asset_cook_mesh_t *)(image_entries + image_count);
+    header->magic = ASSET_COOK_MAGIC;
+    header->version = ASSET_COOK_VERSION;
+    header->kind = kind;
+    header->image_count = (uint32_t)image_count;
+    header->key_hash = key_hash;
+    header->source_hash = source_hash;
+    header->source_size = source_size;
+    header->mesh_count = (uint32_t)mesh_count;
+
+    uint64_t offset = tables_size;
+    for (int32_t i = 0; i < image_count; i++) {
+        asset_cook_image_t *entry = &image_entries[i];
+        Color color = colors ? colors[i] : WHITE;
+        entry->color = (uint32_t)color.r | ((uint32_t)color.g << 8) | ((uint32_t)color.b << 16) | ((uint32_t)color.a << 24);
+        if (!images[i].data) continue;
+        entry->width = images[i].width;
+        entry->height = images[i].height;
+        entry->mipmaps = images[i].mipmaps > 0 ? images[i].mipmaps : 1;
+        entry->format = images[i].format;
+        offset = (offset + ASSET_COOK_ALIGN - 1) & ~(uint64_t)(ASSET_COOK_ALIGN - 1);
+        entry->offset = offset;
+        entry->size = asset_cook_pixels_size(entry->width, entry->height, entry->mipmaps, entry->format);
+        offset += entry->size;
+    }
+    for (int32_t i = 0; i < mesh_count; i++) {
+        asset_cook_mesh_t *entry = &mesh_entries[i];
+        const Mesh *mesh = &meshes[i];
+        entry->vertex_count = (uint32_t)mesh->vertexCount;
+        entry->index_count = mesh->indices ? (uint32_t)mesh->triangleCount * 3 : 0;
+        entry->material = materials ? materials[i] : 0;
+        entry->streams = (mesh->normals ? ASSET_COOK_NORMALS : 0) | (mesh->texcoords ? ASSET_COOK_TEXCOORDS : 0)
+            | (mesh->indices ? ASSET_COOK_INDICES : 0);
+        offset = (offset + ASSET_COOK_ALIGN - 1) & ~(uint64_t)(ASSET_COOK_ALIGN - 1);
+        entry->offset = offset;
+        entry->size = asset_cook_mesh_size(entry->vertex_count, entry->index_count, entry->streams);
+        offset += entry->size;
+    }
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file) {
+        free(tables);
+        return false;
+    }
+    uint64_t written = 0;
+    bool ok = asset_cook_put(file, &written, 0, tables, tables_size);
+    for (int32_t i = 0; ok && i < image_count; i++) {
+        if (image_entries[i].size == 0) continue;
+        ok = asset_cook_put(file, &written, image_entries[i].offset, images[i].data, (size_t)image_entries[i].size);
+    }
+    for (int32_t i = 0; ok && i < mesh_count; i++) {
+        const asset_cook_mesh_t *entry = &mesh_entries[i];
+        const Mesh *mesh = &meshes[i];
+        size_t floats = (size_t)entry->vertex_count * sizeof(float);
+        ok = asset_cook_put(file, &written, entry->offset, mesh->vertices, floats * 3);
+        if (ok && mesh->normals) ok = asset_cook_put(file, &written, written, mesh->normals, floats * 3);
+        if (ok && mesh->texcoords) ok = asset_cook_put(file, &written, written, mesh->texcoords, floats * 2);
+        if (ok && mesh->indices) ok = asset_cook_put(file, &written, written, mesh->indices, (size_t)entry->index_count * sizeof(unsigned short));
+    }
+    if (fclose(file) != 0) ok = false;
+    free(tables);
+    if (ok) ok = file_map_replace(tmp_path, path);
+    if (!ok) remove(tmp_path);
+    return ok;
+}
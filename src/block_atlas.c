@@ -0,0 +1,215 @@
+// block_atlas.c
+#include "block_atlas.h"
+#include <string.h>
+#include "rlgl.h"
+
+// rlgl has no array textures, raylib's own loader has the gl 3.3 calls
+// and InitWindow has loaded them. rlgl.h defaults to gl 3.3 on desktop
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43)
+    #include "external/glad.h"
+    #define BLOCK_ATLAS_ARRAY
+#endif
+
+static int32_t block_atlas_pot(int32_t v){
+    int32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+static int32_t block_atlas_mips(int32_t width, int32_t height){
+    int32_t mips = 1;
+    while ((width >> mips) > 0 || (height >> mips) > 0) mips++;
+    return mips;
+}
+
+// RGBA8 texels of a tile at size x size, nearest resize keeps pixel art sharp
+static void block_atlas_tile_pixels(const Image *tile, int32_t size, unsigned char *out){
+    Image copy = ImageCopy(*tile);
+    if (!copy.data) {
+        memset(out, 0, (size_t)size * size * 4);
+        return;
+    }
+    ImageFormat(&copy, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if (copy.width != size || copy.height != size) ImageResizeNN(&copy, size, size);
+    memcpy(out, copy.data, (size_t)size * size * 4);
+    UnloadImage(copy);
+}
+
+Image *block_atlas_split(Image sheet, int32_t tile_size, int32_t *count){
+    *count = 0;
+    if (!sheet.data || tile_size <= 0) return NULL;
+    int32_t columns = sheet.width / tile_size;
+    int32_t rows = sheet.height / tile_size;
+    if (columns * rows == 0) return NULL;
+    Image *tiles = MemAlloc(sizeof(Image) * (unsigned int)(columns * rows));
+    if (!tiles) return NULL;
+    for (int32_t y = 0; y < rows; y++) {
+        for (int32_t x = 0; x < columns; x++) {
+            Rectangle source = { (float)(x * tile_size), (float)(y * tile_size), (float)tile_size, (float)tile_size };
+            tiles[x + y * columns] = ImageFromImage(sheet, source);
+        }
+    }
+    *count = columns * rows;
+    return tiles;
+}
+
+Image block_atlas_pack_image(const Image *tiles, int32_t count, int32_t tile_size, int32_t *columns, int32_t *rows){
+    Image image = { 0 };
+    if (!tiles || count <= 0 || tile_size <= 0) return image;
+    int32_t size = block_atlas_pot(tile_size);
+    int32_t cell = size * 2;
+    int32_t pad = size / 2;
+    int32_t cols = 1;
+    while (cols * cols < count) cols <<= 1;
+    int32_t rws = 1;
+    while (cols * rws < count) rws <<= 1;
+    int32_t width = cols * cell, height = rws * cell;
+    int32_t mips = block_atlas_mips(width, height);
+
+    size_t bytes = 0;
+    for (int32_t level = 0; level < mips; level++) {
+        int32_t w = width >> level, h = height >> level;
+        bytes += (size_t)(w > 0 ? w : 1) * (h > 0 ? h : 1) * 4;
+    }
+    unsigned char *data = MemAlloc((unsigned int)bytes); // zeroed, unused cells stay clear
+    unsigned char *tile = MemAlloc((unsigned int)(size * size * 4));
+    if (!data || !tile) {
+        MemFree(data);
+        MemFree(tile);
+        return image;
+    }
+
+    // the tile repeated across its cell, shifted so the copy at pad is whole
+    for (int32_t t = 0; t < count; t++) {
+        block_atlas_tile_pixels(&tiles[t], size, tile);
+        int32_t x0 = (t % cols) * cell, y0 = (t / cols) * cell;
+        for (int32_t y = 0; y < cell; y++) {
+            int32_t ty = (y - pad + size) % size;
+            for (int32_t x = 0; x < cell; x++) {
+                int32_t tx = (x - pad + size) % size;
+                memcpy(&data[((size_t)(y0 + y) * width + x0 + x) * 4], &tile[(ty * size + tx) * 4], 4);
+            }
+        }
+    }
+    MemFree(tile);
+
+    // 2x2 box filter, cells are powers of two so a box never spans two cells
+    unsigned char *source = data;
+    int32_t sw = width, sh = height;
+    for (int32_t level = 1; level < mips; level++) {
+        int32_t dw = sw > 1 ? sw / 2 : 1, dh = sh > 1 ? sh / 2 : 1;
+        unsigned char *dest = source + (size_t)sw * sh * 4;
+        for (int32_t y = 0; y < dh; y++) {
+            int32_t y1 = y * 2, y2 = y * 2 + 1 < sh ? y * 2 + 1 : y * 2;
+            for (int32_t x = 0; x < dw; x++) {
+                int32_t x1 = x * 2, x2 = x * 2 + 1 < sw ? x * 2 + 1 : x * 2;
+                for (int32_t c = 0; c < 4; c++) {
+                    int32_t sum = source[((size_t)y1 * sw + x1) * 4 + c] + source[((size_t)y1 * sw + x2) * 4 + c]
+                                + source[((size_t)y2 * sw + x1) * 4 + c] + source[((size_t)y2 * sw + x2) * 4 + c];
+                    dest[((size_t)y * dw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        source = dest;
+        sw = dw;
+        sh = dh;
+    }
+
+    if (columns) *columns = cols;
+    if (rows) *rows = rws;
+    image = (Image){ .data = data, .width = width, .height = height, .mipmaps = mips, .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    return image;
+}
+
+static bool block_atlas_upload_array(block_atlas_t *atlas, const Image *tiles){
+#ifdef BLOCK_ATLAS_ARRAY
+    int version = rlGetVersion();
+    if (version != RL_OPENGL_33 && version != RL_OPENGL_43) return false;
+    int32_t size = atlas->tile_size;
+    size_t layer = (size_t)size * size * 4;
+    unsigned char *pixels = MemAlloc((unsigned int)(layer * atlas->tile_count));
+    if (!pixels) return false;
+    for (int32_t t = 0; t < atlas->tile_count; t++) block_atlas_tile_pixels(&tiles[t], size, pixels + layer * t);
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size, size, atlas->tile_count, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY); // per layer, tiles never blend
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    MemFree(pixels);
+    if (id == 0) return false;
+
+    atlas->texture = (Texture2D){ .id = id, .width = size, .height = size, .mipmaps = block_atlas_mips(size, size), .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    atlas->is_array = true;
+    atlas->columns = 1;
+    atlas->rows = 1;
+    atlas->mip_count = atlas->texture.mipmaps;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool block_atlas_pack(block_atlas_t *atlas, const Image *tiles, int32_t count, int32_t tile_size, bool array){
+    if (!atlas || !tiles || count <= 0 || tile_size <= 0) return false;
+    block_atlas_t packed = { .tile_size = block_atlas_pot(tile_size), .tile_count = count };
+    if (!array || !block_atlas_upload_array(&packed, tiles)) {
+        Image image = block_atlas_pack_image(tiles, count, packed.tile_size, &packed.columns, &packed.rows);
+        if (!image.data) return false;
+        packed.texture = LoadTextureFromImage(image);
+        packed.mip_count = image.mipmaps;
+        UnloadImage(image);
+        if (packed.texture.id == 0) return false;
+        // sharp texels up close, blended mips in the distance
+        rlTextureParameters(packed.texture.id, RL_TEXTURE_MAG_FILTER, RL_TEXTURE_FILTER_NEAREST);
+        rlTextureParameters(packed.texture.id, RL_TEXTURE_MIN_FILTER, RL_TEXTURE_FILTER_NEAREST_MIP_LINEAR);
+        rlTextureParameters(packed.texture.id, RL_TEXTURE_WRAP_S, RL_TEXTURE_WRAP_CLAMP);
+        rlTextureParameters(packed.texture.id, RL_TEXTURE_WRAP_T, RL_TEXTURE_WRAP_CLAMP);
+    }
+    block_atlas_unload(atlas);
+    *atlas = packed;
+    return true;
+}
+
+void block_atlas_unload(block_atlas_t *atlas){
+    if (atlas->texture.id != 0) rlUnloadTexture(atlas->texture.id);
+    memset(atlas, 0, sizeof(block_atlas_t));
+}
+
+void block_atlas_set_uniforms(const block_atlas_t *atlas, Shader shader){
+    if (atlas->is_array) {
+        int unit = 0;
+        SetShaderValue(shader, GetShaderLocation(shader, "atlasArray"), &unit, SHADER_UNIFORM_INT);
+        return;
+    }
+    if (atlas->columns <= 0 || atlas->rows <= 0) return;
+    float columns = (float)atlas->columns;
+    Vector2 cell = { 1.0f / atlas->columns, 1.0f / atlas->rows };
+    Vector2 tile = { cell.x * 0.5f, cell.y * 0.5f };
+    Vector2 offset = { cell.x * 0.25f, cell.y * 0.25f };
+    SetShaderValue(shader, GetShaderLocation(shader, "atlasColumns"), &columns, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "cellSize"), &cell, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, GetShaderLocation(shader, "tileSize"), &tile, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, GetShaderLocation(shader, "tileOffset"), &offset, SHADER_UNIFORM_VEC2);
+}
+
+void block_atlas_bind(const block_atlas_t *atlas){
+#ifdef BLOCK_ATLAS_ARRAY
+    if (!atlas->is_array) return;
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas->texture.id);
+#endif
+}
+
+void block_atlas_unbind(const block_atlas_t *atlas){
+#ifdef BLOCK_ATLAS_ARRAY
+    if (!atlas->is_array) return;
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+#endif
+}
@@ -0,0 +1,257 @@
+// block_noise.c
+#include "block_noise.h"
+#include <string.h>
+
+// keeps the result about -1..1 for cube corner gradients
+#define BLOCK_NOISE2_SCALE 0.7071f
+#define BLOCK_NOISE3_SCALE 0.7f
+
+static inline uint32_t block_noise_hash(uint32_t seed, int32_t x, int32_t y, int32_t z){
+    uint32_t h = seed;
+    h ^= (uint32_t)x * 0x8DA6B343u;
+    h ^= (uint32_t)y * 0xD8163841u;
+    h ^= (uint32_t)z * 0xCB1AB31Fu;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 15;
+    h *= 0x297A2D39u;
+    h ^= h >> 13;
+    return h;
+}
+
+// floorf without a libm call so the lane loops vectorize
+static inline int32_t block_noise_floor(float v){
+    int32_t i = (int32_t)v;
+    return i - (v < (float)i);
+}
+
+static inline float block_noise_fade(float t){
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static inline float block_noise_lerp(float a, float b, float t){
+    return a + t * (b - a);
+}
+
+// one hash bit per axis picks the gradient sign
+static inline float block_noise_sign(uint32_t h, int bit){
+    return (float)((int32_t)((h >> bit) & 1u) * 2 - 1);
+}
+
+static inline float block_noise_grad2(uint32_t h, float x, float z){
+    return block_noise_sign(h, 0) * x + block_noise_sign(h, 1) * z;
+}
+
+static inline float block_noise_grad3(uint32_t h, float x, float y, float z){
+    return block_noise_sign(h, 0) * x + block_noise_sign(h, 1) * y + block_noise_sign(h, 2) * z;
+}
+
+static inline float block_noise2_sample(uint32_t seed, float x, float z){
+    int32_t ix = block_noise_floor(x), iz = block_noise_floor(z);
+    float tx = x - (float)ix, tz = z - (float)iz;
+    float n00 = block_noise_grad2(block_noise_hash(seed, ix, 0, iz), tx, tz);
+    float n10 = block_noise_grad2(block_noise_hash(seed, ix + 1, 0, iz), tx - 1.0f, tz);
+    float n01 = block_noise_grad2(block_noise_hash(seed, ix, 0, iz + 1), tx, tz - 1.0f);
+    float n11 = block_noise_grad2(block_noise_hash(seed, ix + 1, 0, iz + 1), tx - 1.0f, tz - 1.0f);
+    float u = block_noise_fade(tx), w = block_noise_fade(tz);
+    return block_noise_lerp(block_noise_lerp(n00, n10, u), block_noise_lerp(n01, n11, u), w) * BLOCK_NOISE2_SCALE;
+}
+
+static inline float block_noise3_sample(uint32_t seed, float x, float y, float z){
+    int32_t ix = block_noise_floor(x), iy = block_noise_floor(y), iz = block_noise_floor(z);
+    float tx = x - (float)ix, ty = y - (float)iy, tz = z - (float)iz;
+    float n000 = block_noise_grad3(block_noise_hash(seed, ix, iy, iz), tx, ty, tz);
+    float n100 = block_noise_grad3(block_noise_hash(seed, ix + 1, iy, iz), tx - 1.0f, ty, tz);
+    float n010 = block_noise_grad3(block_noise_hash(seed, ix, iy + 1, iz), tx, ty - 1.0f, tz);
+    float n110 = block_noise_grad3(block_noise_hash(seed, ix + 1, iy + 1, iz), tx - 1.0f, ty - 1.0f, tz);
+    float n001 = block_noise_grad3(block_noise_hash(seed, ix, iy, iz + 1), tx, ty, tz - 1.0f);
+    float n101 = block_noise_grad3(block_noise_hash(seed, ix + 1, iy, iz + 1), tx - 1.0f, ty, tz - 1.0f);
+    float n011 = block_noise_grad3(block_noise_hash(seed, ix, iy + 1, iz + 1), tx, ty - 1.0f, tz - 1.0f);
+    float n111 = block_noise_grad3(block_noise_hash(seed, ix + 1, iy + 1, iz + 1), tx - 1.0f, ty - 1.0f, tz - 1.0f);
+    float u = block_noise_fade(tx), v = block_noise_fade(ty), w = block_noise_fade(tz);
+    float x00 = block_noise_lerp(n000, n100, u), x10 = block_noise_lerp(n010, n110, u);
+    float x01 = block_noise_lerp(n001, n101, u), x11 = block_noise_lerp(n011, n111, u);
+    return block_noise_lerp(block_noise_lerp(x00, x10, v), block_noise_lerp(x01, x11, v), w) * BLOCK_NOISE3_SCALE;
+}
+
+void block_noise2_lanes(uint32_t seed, const float *x, const float *z, float *out){
+    for (int l = 0; l < BLOCK_NOISE_LANES; l++) out[l] = block_noise2_sample(seed, x[l], z[l]);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+// the 3D lattice has too many live values for the auto vectorizer, so the
+// lanes are written with vector extensions, 4 wide (one sse2/neon register).
+// same operations in the same order as block_noise3_sample, the results
+// match it bit for bit
+#define BLOCK_NOISE_VECTOR 4
+typedef float block_noise_vf __attribute__((vector_size(BLOCK_NOISE_VECTOR * 4)));
+typedef int32_t block_noise_vi __attribute__((vector_size(BLOCK_NOISE_VECTOR * 4)));
+typedef uint32_t block_noise_vu __attribute__((vector_size(BLOCK_NOISE_VECTOR * 4)));
+
+static inline block_noise_vf block_noise_load(const float *p){
+    block_noise_vf v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline block_noise_vu block_noise_hash_v(uint32_t seed, block_noise_vi x, block_noise_vi y, block_noise_vi z){
+    block_noise_vu h = (block_noise_vu){0} + seed;
+    h ^= (block_noise_vu)x * 0x8DA6B343u;
+    h ^= (block_noise_vu)y * 0xD8163841u;
+    h ^= (block_noise_vu)z * 0xCB1AB31Fu;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 15;
+    h *= 0x297A2D39u;
+    h ^= h >> 13;
+    return h;
+}
+
+// comparisons give -1 for true, so adding the mask subtracts one
+static inline block_noise_vi block_noise_floor_v(block_noise_vf v){
+    block_noise_vi i = __builtin_convertvector(v, block_noise_vi);
+    return i + (v < __builtin_convertvector(i, block_noise_vf));
+}
+
+static inline block_noise_vf block_noise_fade_v(block_noise_vf t){
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static inline block_noise_vf block_noise_lerp_v(block_noise_vf a, block_noise_vf b, block_noise_vf t){
+    return a + t * (b - a);
+}
+
+static inline block_noise_vf block_noise_sign_v(block_noise_vu h, int bit){
+    return __builtin_convertvector((block_noise_vi)((h >> bit) & 1u) * 2 - 1, block_noise_vf);
+}
+
+static inline block_noise_vf block_noise_grad3_v(block_noise_vu h, block_noise_vf x, block_noise_vf y, block_noise_vf z){
+    return block_noise_sign_v(h, 0) * x + block_noise_sign_v(h, 1) * y + block_noise_sign_v(h, 2) * z;
+}
+
+static inline block_noise_vf block_noise3_sample_v(uint32_t seed, block_noise_vf x, block_noise_vf y, block_noise_vf z){
+    block_noise_vi ix = block_noise_floor_v(x), iy = block_noise_floor_v(y), iz = block_noise_floor_v(z);
+    block_noise_vf tx = x - __builtin_convertvector(ix, block_noise_vf);
+    block_noise_vf ty = y - __builtin_convertvector(iy, block_noise_vf);
+    block_noise_vf tz = z - __builtin_convertvector(iz, block_noise_vf);
+    block_noise_vf n000 = block_noise_grad3_v(block_noise_hash_v(seed, ix, iy, iz), tx, ty, tz);
+    block_noise_vf n100 = block_noise_grad3_v(block_noise_hash_v(seed, ix + 1, iy, iz), tx - 1.0f, ty, tz);
+    block_noise_vf n010 = block_noise_grad3_v(block_noise_hash_v(seed, ix, iy + 1, iz), tx, ty - 1.0f, tz);
+    block_noise_vf n110 = block_noise_grad3_v(block_noise_hash_v(seed, ix + 1, iy + 1, iz), tx - 1.0f, ty - 1.0f, tz);
+    block_noise_vf n001 = block_noise_grad3_v(block_noise_hash_v(seed, ix, iy, iz + 1), tx, ty, tz - 1.0f);
+    block_noise_vf n101 = block_noise_grad3_v(block_noise_hash_v(seed, ix + 1, iy, iz + 1), tx - 1.0f, ty, tz - 1.0f);
+    block_noise_vf n011 = block_noise_grad3_v(block_noise_hash_v(seed, ix, iy + 1, iz + 1), tx, ty - 1.0f, tz - 1.0f);
+    block_noise_vf n111 = block_noise_grad3_v(block_noise_hash_v(seed, ix + 1, iy + 1, iz + 1), tx - 1.0f, ty - 1.0f, tz - 1.0f);
+    block_noise_vf u = block_noise_fade_v(tx), v = block_noise_fade_v(ty), w = block_noise_fade_v(tz);
+    block_noise_vf x00 = block_noise_lerp_v(n000, n100, u), x10 = block_noise_lerp_v(n010, n110, u);
+    block_noise_vf x01 = block_noise_lerp_v(n001, n101, u), x11 = block_noise_lerp_v(n011, n111, u);
+    return block_noise_lerp_v(block_noise_lerp_v(x00, x10, v), block_noise_lerp_v(x01, x11, v), w) * BLOCK_NOISE3_SCALE;
+}
+
+void block_noise3_lanes(uint32_t seed, const float *x, const float *y, const float *z, float *out){
+    for (int l = 0; l < BLOCK_NOISE_LANES; l += BLOCK_NOISE_VECTOR) {
+        block_noise_vf n = block_noise3_sample_v(seed, block_noise_load(x + l), block_noise_load(y + l), block_noise_load(z + l));
+        memcpy(out + l, &n, sizeof(n));
+    }
+}
+#else
+void block_noise3_lanes(uint32_t seed, const float *x, const float *y, const float *z, float *out){
+    for (int l = 0; l < BLOCK_NOISE_LANES; l++) out[l] = block_noise3_sample(seed, x[l], y[l], z[l]);
+}
+#endif
+
+void block_fbm2_lanes(uint32_t seed, const float *x, const float *z, int32_t octaves, float *out){
+    float sum[BLOCK_NOISE_LANES] = {0};
+    float amplitude = 1.0f, frequency = 1.0f, total = 0.0f;
+    for (int32_t o = 0; o < octaves; o++) {
+        // a different seed per octave so the lattices do not line up
+        uint32_t octave_seed = seed + (uint32_t)o * 0x9E3779B9u;
+        for (int l = 0; l < BLOCK_NOISE_LANES; l++) {
+            sum[l] += amplitude * block_noise2_sample(octave_seed, x[l] * frequency, z[l] * frequency);
+        }
+        total += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+    float inv = total > 0.0f ? 1.0f / total : 0.0f;
+    for (int l = 0; l < BLOCK_NOISE_LANES; l++) out[l] = sum[l] * inv;
+}
+
+void block_fbm3_lanes(uint32_t seed, const float *x, const float *y, const float *z, int32_t octaves, float *out){
+    float amplitude = 1.0f, frequency = 1.0f, total = 0.0f;
+#if defined(__GNUC__) || defined(__clang__)
+    block_noise_vf sum[BLOCK_NOISE_LANES / BLOCK_NOISE_VECTOR] = {{0}};
+    for (int32_t o = 0; o < octaves; o++) {
+        uint32_t octave_seed = seed + (uint32_t)o * 0x9E3779B9u;
+        for (int v = 0; v < BLOCK_NOISE_LANES / BLOCK_NOISE_VECTOR; v++) {
+            int l = v * BLOCK_NOISE_VECTOR;
+            sum[v] += amplitude * block_noise3_sample_v(octave_seed, block_noise_load(x + l) * frequency,
+                block_noise_load(y + l) * frequency, block_noise_load(z + l) * frequency);
+        }
+        total += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+    float inv = total > 0.0f ? 1.0f / total : 0.0f;
+    for (int v = 0; v < BLOCK_NOISE_LANES / BLOCK_NOISE_VECTOR; v++) {
+        block_noise_vf n = sum[v] * inv;
+        memcpy(out + v * BLOCK_NOISE_VECTOR, &n, sizeof(n));
+    }
+#else
+    float sum[BLOCK_NOISE_LANES] = {0};
+    for (int32_t o = 0; o < octaves; o++) {
+        uint32_t octave_seed = seed + (uint32_t)o * 0x9E3779B9u;
+        for (int l = 0; l < BLOCK_NOISE_LANES; l++) {
+            sum[l] += amplitude * block_noise3_sample(octave_seed, x[l] * frequency, y[l] * frequency, z[l] * frequency);
+        }
+        total += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+    float inv = total > 0.0f ? 1.0f / total : 0.0f;
+    for (int l = 0; l < BLOCK_NOISE_LANES; l++) out[l] = sum[l] * inv;
+#endif
+}
+
+float block_noise2(uint32_t seed, float x, float z){
+    return block_noise2_sample(seed, x, z);
+}
+
+float block_noise3(uint32_t seed, float x, float y, float z){
+    return block_noise3_sample(seed, x, y, z);
+}
+
+void block_noise_heights(uint32_t seed, int32_t x0, int32_t z0, int32_t width, int32_t depth,
+                         float frequency, int32_t octaves, float base, float scale, int32_t *out){
+    float x[BLOCK_NOISE_LANES], z[BLOCK_NOISE_LANES], n[BLOCK_NOISE_LANES];
+    int32_t count = width * depth;
+    for (int32_t i = 0; i < count; i += BLOCK_NOISE_LANES) {
+        // the last group repeats its final column when count is not a lane multiple
+        for (int l = 0; l < BLOCK_NOISE_LANES; l++) {
+            int32_t c = i + l < count ? i + l : count - 1;
+            x[l] = (float)(x0 + c % width) * frequency;
+            z[l] = (float)(z0 + c / width) * frequency;
+        }
+        block_fbm2_lanes(seed, x, z, octaves, n);
+        for (int l = 0; l < BLOCK_NOISE_LANES && i + l < count; l++) {
+            out[i + l] = block_noise_floor(base + scale * n[l]);
+        }
+    }
+}
+
+void block_noise_mask3(uint32_t seed, int32_t x0, int32_t y0, int32_t z0, int32_t size_x, int32_t size_y, int32_t size_z,
+                       float frequency, int32_t octaves, float threshold, uint8_t *out){
+    float x[BLOCK_NOISE_LANES], y[BLOCK_NOISE_LANES], z[BLOCK_NOISE_LANES], n[BLOCK_NOISE_LANES];
+    int32_t area = size_x * size_z;
+    int32_t count = area * size_y;
+    for (int32_t i = 0; i < count; i += BLOCK_NOISE_LANES) {
+        for (int l = 0; l < BLOCK_NOISE_LANES; l++) {
+            int32_t c = i + l < count ? i + l : count - 1;
+            x[l] = (float)(x0 + c % size_x) * frequency;
+            z[l] = (float)(z0 + (c % area) / size_x) * frequency;
+            y[l] = (float)(y0 + c / area) * frequency;
+        }
+        block_fbm3_lanes(seed, x, y, z, octaves, n);
+        for (int l = 0; l < BLOCK_NOISE_LANES && i + l < count; l++) {
+            out[i + l] = n[l] > threshold;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+// block_region.c
+#include "block_region.h"
+#include "file_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <direct.h>
+#else
+    #include <errno.h>
+    #include <sys/stat.h>
+#endif
+
+struct block_region_s {
+    file_map_t map;
+};
+
+static bool block_region_valid(const uint8_t *data, size_t size){
+    if (size < sizeof(block_region_header_t)) return false;
+    const block_region_header_t *header = (const block_region_header_t *)data;
+    if (header->magic != BLOCK_REGION_MAGIC || header->version != BLOCK_REGION_VERSION) return false;
+    for (int32_t i = 0; i < BLOCK_REGION_VOLUME; i++) {
+        const block_region_entry_t *entry = &header->entries[i];
+        if (entry->size == 0) continue;
+        if (entry->offset % BLOCK_REGION_ALIGN != 0) return false;
+        if ((uint64_t)entry->offset + entry->size > size) return false;
+    }
+    return true;
+}
+
+block_region_t *block_region_open(const char *path){
+    block_region_t *region = calloc(1, sizeof(block_region_t));
+    if (!region) return NULL;
+    if (!file_map_open(&region->map, path) || !block_region_valid(region->map.data, region->map.size)) {
+        block_region_close(region);
+        return NULL;
+    }
+    return region;
+}
+
+void block_region_close(block_region_t *region){
+    if (!region) return;
+    file_map_close(&region->map);
+    free(region);
+}
+
+const void *block_region_chunk(const block_region_t *region, int32_t index, uint32_t *size){
+    if (!region || index < 0 || index >= BLOCK_REGION_VOLUME) return NULL;
+    const block_region_entry_t *entry = &((const block_region_header_t *)region->map.data)->entries[index];
+    if (entry->size == 0) return NULL;
+    if (size) *size = entry->size;
+    return region->map.data + entry->offset;
+}
+
+bool block_region_save(block_region_t **region, const char *path, const void *const payloads[BLOCK_REGION_VOLUME], const uint32_t sizes[BLOCK_REGION_VOLUME]){
+    static const uint8_t zero[BLOCK_REGION_ALIGN] = {0};
+    char tmp_path[1024];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return false;
+
+    block_region_header_t *header = calloc(1, sizeof(block_region_header_t));
+    if (!header) return false;
+    header->magic = BLOCK_REGION_MAGIC;
+    header->version = BLOCK_REGION_VERSION;
+    uint64_t offset = sizeof(block_region_header_t);
+    for (int32_t i = 0; i < BLOCK_REGION_VOLUME; i++) {
+        if (!payloads[i] || sizes[i] == 0) continue;
+        offset = (offset + BLOCK_REGION_ALIGN - 1) & ~(uint64_t)(BLOCK_REGION_ALIGN - 1);
+        header->entries[i].offset = (uint32_t)offset;
+        header->entries[i].size = sizes[i];
+        header->chunk_count++;
+        offset += sizes[i];
+    }
+    if (offset > UINT32_MAX) {
+        free(header);
+        return false;
+    }
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file) {
+        free(header);
+        return false;
+    }
+    bool ok = fwrite(header, sizeof(block_region_header_t), 1, file) == 1;
+    uint64_t written = sizeof(block_region_header_t);
+    for (int32_t i = 0; ok && i < BLOCK_REGION_VOLUME; i++) {
+        if (header->entries[i].size == 0) continue;
+        size_t pad = (size_t)(header->entries[i].offset - written);
+        if (pad > 0) ok = fwrite(zero, 1, pad, file) == pad;
+        if (ok) ok = fwrite(payloads[i], 1, sizes[i], file) == sizes[i];
+        written = header->entries[i].offset + (uint64_t)sizes[i];
+    }
+    if (fclose(file) != 0) ok = false;
+    free(header);
+    if (!ok) {
+        remove(tmp_path);
+        return false;
+    }
+
+    // windows cannot replace a mapped file
+    block_region_close(*region);
+    *region = NULL;
+    ok = file_map_replace(tmp_path, path);
+    if (!ok) remove(tmp_path);
+    *region = block_region_open(path);
+    return ok;
+}
+
+bool block_region_make_dir(const char *path){
+#ifdef _WIN32
+    if (_mkdir(path) == 0) return true;
+    DWORD attributes = GetFileAttributesA(path);
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    if (mkdir(path, 0755) == 0 || errno == EEXIST) {
+        struct stat st;
+        return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+    }
+    return false;
+#endif
+}
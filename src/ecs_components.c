@@ -21,9 +21,10 @@ ecs_entity_t RLEndDrawingPhase = 0;
 ECS_COMPONENT_DECLARE(main_context_t);
 ECS_COMPONENT_DECLARE(Transform3D);
 ECS_COMPONENT_DECLARE(ModelComponent);
+ECS_COMPONENT_DECLARE(frame_context_t);
 
-// Helper function to update a single transform
-void UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *transform) {
+// Helper function to update a single transform, true when the matrices changed
+bool UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *transform) {
   // Get parent entity
   ecs_entity_t parent = ecs_get_parent(world, entity);
   const char *name = ecs_get_name(world, entity) ? ecs_get_name(world, entity) : "(unnamed)";
@@ -40,7 +41,7 @@ void UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *trans
   // Skip update if neither this transform nor its parent is dirty
   if (!transform->isDirty && !parentIsDirty) {
     //   printf("Skipping update for %s (not dirty)\n", name);
-      return;
+      return false;
   }
 //   printf("( dirty)\n", name);
 
@@ -61,7 +62,7 @@ void UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *trans
         //   printf("Error: Parent %s lacks Transform3D for %s\n",
         //          ecs_get_name(world, parent) ? ecs_get_name(world, parent) : "(unnamed)", name);
           transform->worldMatrix = transform->localMatrix;
-          return;
+          return true;
       }
 
       // Validate parent world matrix
@@ -73,7 +74,7 @@ void UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *trans
         //          ecs_get_name(world, parent) ? ecs_get_name(world, parent) : "(unnamed)",
         //          px, py, pz, name);
           transform->worldMatrix = transform->localMatrix;
-          return;
+          return true;
       }
 
       // Compute world matrix
@@ -107,6 +108,7 @@ void UpdateTransform(ecs_world_t *world, ecs_entity_t entity, Transform3D *trans
 
   // Reset isDirty after updating
   transform->isDirty = false;
+  return true;
 }
 
 // Function to update a single entity and its descendants
@@ -114,9 +116,11 @@ void UpdateChildTransform(ecs_world_t *world, ecs_entity_t entity) {
     Transform3D *transform = ecs_get_mut(world, entity, Transform3D);
     if (!transform) return;
 
-    // Update the entity's transform
-    UpdateTransform(world, entity, transform);
-    // ecs_modified(world, entity, Transform3D);
+    // Update the entity's transform, OnSet observers (picking bounds) only
+    // hear about the ones that moved
+    if (UpdateTransform(world, entity, transform)) {
+        ecs_modified(world, entity, Transform3D);
+    }
 
     // Recursively update descendants
     ecs_iter_t it = ecs_children(world, entity);
@@ -209,6 +213,104 @@ void RLEndDrawingSystem(ecs_iter_t *it) {
   EndDrawing();
 }
 
+//===============================================
+// FRAME ARENA
+//===============================================
+// counting wrappers around the ecs_os allocator. the modules allocate their
+// own buffers through ecs_os_* too, only memory handed to raylib (meshes,
+// images, file data) and the block_region/asset_cook file helpers stay on
+// libc unseen
+static int64_t frame_heap_count = 0;
+static ecs_os_api_malloc_t frame_os_malloc = NULL;
+static ecs_os_api_calloc_t frame_os_calloc = NULL;
+static ecs_os_api_realloc_t frame_os_realloc = NULL;
+
+static void *frame_counted_malloc(ecs_size_t size){
+    ecs_os_lainc(&frame_heap_count);
+    return frame_os_malloc(size);
+}
+
+static void *frame_counted_calloc(ecs_size_t size){
+    ecs_os_lainc(&frame_heap_count);
+    return frame_os_calloc(size);
+}
+
+static void *frame_counted_realloc(void *ptr, ecs_size_t size){
+    ecs_os_lainc(&frame_heap_count);
+    return frame_os_realloc(ptr, size);
+}
+
+static void frame_heap_count_install(void){
+    if (ecs_os_api.malloc_ == frame_counted_malloc) return;
+    frame_os_malloc = ecs_os_api.malloc_;
+    frame_os_calloc = ecs_os_api.calloc_;
+    frame_os_realloc = ecs_os_api.realloc_;
+    ecs_os_api.malloc_ = frame_counted_malloc;
+    ecs_os_api.calloc_ = frame_counted_calloc;
+    ecs_os_api.realloc_ = frame_counted_realloc;
+}
+
+int64_t frame_heap_allocation_count(void){
+    return frame_heap_count;
+}
+
+frame_arena_t *frame_arena_get(ecs_world_t *world){
+    const frame_context_t *ctx = ecs_singleton_get(world, frame_context_t);
+    if (!ctx) return NULL;
+    int32_t stage = ecs_stage_get_id(world);
+    // a stage added since the last reset has no arena until the frame ends
+    if (stage < 0 || stage >= ctx->arena_count) return NULL;
+    return &ctx->arenas[stage];
+}
+
+void *frame_alloc(ecs_world_t *world, size_t size){
+    frame_arena_t *arena = frame_arena_get(world);
+    return arena ? frame_arena_alloc(arena, size, 0) : NULL;
+}
+
+// one arena per stage, the thread count can change between frames
+static void frame_context_ensure(ecs_world_t *world, frame_context_t *ctx){
+    int32_t count = ecs_get_stage_count(world);
+    if (count <= ctx->arena_count) return;
+    frame_arena_t *arenas = ecs_os_realloc(ctx->arenas, (ecs_size_t)(sizeof(frame_arena_t) * (size_t)count));
+    if (!arenas) return;
+    for (int32_t i = ctx->arena_count; i < count; i++) {
+        frame_arena_init(&arenas[i], ctx->arena_capacity);
+    }
+    ctx->arenas = arenas;
+    ctx->arena_count = count;
+}
+
+// after EndDrawing nothing from this frame is used anymore
+void frame_context_reset_system(ecs_iter_t *it){
+    frame_context_t *ctx = ecs_field(it, frame_context_t, 0);
+    // counted before the reset, arena growth shows up in the next frame
+    int64_t total = frame_heap_allocation_count();
+    ctx->heap_allocations = (int32_t)(total - ctx->heap_allocations_total);
+    ctx->heap_allocations_total = total;
+    ctx->frame++;
+    if (ctx->alloc_budget >= 0 && ctx->frame > ctx->warmup_frames && ctx->heap_allocations > ctx->alloc_budget) {
+        ctx->over_budget_frames++;
+        // 1st, 2nd, 4th, 8th... over budget frame, a leak does not flood the log
+        if ((ctx->over_budget_frames & (ctx->over_budget_frames - 1)) == 0) {
+            TraceLog(LOG_WARNING, "FRAME: %d heap allocations in frame %lld, budget %d (%d frames over)",
+                ctx->heap_allocations, (long long)ctx->frame, ctx->alloc_budget, ctx->over_budget_frames);
+        }
+    }
+    for (int32_t i = 0; i < ctx->arena_count; i++) frame_arena_reset(&ctx->arenas[i]);
+    frame_context_ensure(it->world, ctx);
+}
+
+void on_remove_frame_context(ecs_iter_t *it){
+    frame_context_t *ctx = ecs_field(it, frame_context_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        for (int32_t a = 0; a < ctx[i].arena_count; a++) frame_arena_fini(&ctx[i].arenas[a]);
+        ecs_os_free(ctx[i].arenas);
+        ctx[i].arenas = NULL;
+        ctx[i].arena_count = 0;
+    }
+}
+
 // setup phase for pipeline loop
 void setup_phases(ecs_world_t *world){
     // Define custom phases
@@ -248,6 +350,7 @@ void setup_components(ecs_world_t *world){
     ECS_COMPONENT_DEFINE(world, Transform3D);
     ECS_COMPONENT_DEFINE(world, ModelComponent);
     ECS_COMPONENT_DEFINE(world, main_context_t);
+    ECS_COMPONENT_DEFINE(world, frame_context_t);
 
 }
 
@@ -321,6 +424,24 @@ void setup_systems(ecs_world_t *world){
         .callback = RLEndDrawingSystem
     });
 
+    // frame arenas, after EndDrawing
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+          .name = "frame_context_reset_system",
+          .add = ecs_ids(ecs_dependson(RLEndDrawingPhase))
+        }),
+        .query.terms = {
+          { .id = ecs_id(frame_context_t), .src.id = ecs_id(frame_context_t) } // Singleton
+        },
+        .callback = frame_context_reset_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(frame_context_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_frame_context
+    });
+
 }
 
 // Initialize Raylib-related components and phases
@@ -331,4 +452,13 @@ void module_init_raylib(ecs_world_t *world) {
     setup_components(world);
     //systems
     setup_systems(world);
+
+    frame_heap_count_install();
+    frame_context_t ctx = {
+        .arena_capacity = 64 * 1024,
+        .alloc_budget = 0,
+        .warmup_frames = 120
+    };
+    frame_context_ensure(world, &ctx);
+    ecs_singleton_set_ptr(world, frame_context_t, &ctx);
 }
@@ -0,0 +1,67 @@
+// file_map.c
+#include "file_map.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool file_map_open(file_map_t *map, const char *path){
+    memset(map, 0, sizeof(file_map_t));
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    map->file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        file_map_close(map);
+        return false;
+    }
+    map->size = (size_t)size.QuadPart;
+    map->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    map->data = map->mapping ? MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    map->size = (size_t)st.st_size;
+    void *data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file
+    map->data = data == MAP_FAILED ? NULL : data;
+#endif
+    if (!map->data) {
+        file_map_close(map);
+        return false;
+    }
+    return true;
+}
+
+void file_map_close(file_map_t *map){
+#ifdef _WIN32
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle(map->mapping);
+    if (map->file) CloseHandle(map->file);
+#else
+    if (map->data) munmap((void *)map->data, map->size);
+#endif
+    memset(map, 0, sizeof(file_map_t));
+}
+
+bool file_map_replace(const char *from, const char *to){
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
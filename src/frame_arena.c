@@ -0,0 +1,90 @@
+// frame_arena.c
+#include "frame_arena.h"
+#include <stdint.h>
+#include <string.h>
+
+struct frame_arena_chunk_t {
+    frame_arena_chunk_t *next;
+    max_align_t data[];
+};
+
+static size_t frame_arena_pot(size_t v){
+    size_t p = 1024;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+bool frame_arena_init(frame_arena_t *arena, size_t capacity){
+    memset(arena, 0, sizeof(frame_arena_t));
+    if (capacity == 0) return true;
+    arena->base = ecs_os_malloc((ecs_size_t)capacity);
+    if (!arena->base) return false;
+    arena->capacity = capacity;
+    return true;
+}
+
+static void frame_arena_free_overflow(frame_arena_t *arena){
+    frame_arena_chunk_t *chunk = arena->overflow;
+    while (chunk) {
+        frame_arena_chunk_t *next = chunk->next;
+        ecs_os_free(chunk);
+        chunk = next;
+    }
+    arena->overflow = NULL;
+}
+
+void frame_arena_fini(frame_arena_t *arena){
+    frame_arena_free_overflow(arena);
+    ecs_os_free(arena->base);
+    memset(arena, 0, sizeof(frame_arena_t));
+}
+
+void *frame_arena_alloc(frame_arena_t *arena, size_t size, size_t align){
+    if (align == 0) align = _Alignof(max_align_t);
+    if (size == 0) size = 1;
+    arena->frame_total += size + align - 1;
+
+    if (arena->base) {
+        uintptr_t start = (uintptr_t)arena->base;
+        size_t offset = (size_t)(((start + arena->used + align - 1) & ~(uintptr_t)(align - 1)) - start);
+        if (offset + size <= arena->capacity) {
+            arena->used = offset + size;
+            return arena->base + offset;
+        }
+    }
+
+    // the block is full, this frame gets a chunk of its own
+    if (align > _Alignof(max_align_t)) size += align;
+    frame_arena_chunk_t *chunk = ecs_os_malloc((ecs_size_t)(sizeof(frame_arena_chunk_t) + size));
+    if (!chunk) return NULL;
+    chunk->next = arena->overflow;
+    arena->overflow = chunk;
+    uintptr_t data = (uintptr_t)chunk->data;
+    return (void *)((data + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+char *frame_arena_strdup(frame_arena_t *arena, const char *str){
+    if (!str) return NULL;
+    size_t length = strlen(str) + 1;
+    char *copy = frame_arena_alloc(arena, length, 1);
+    if (copy) memcpy(copy, str, length);
+    return copy;
+}
+
+void frame_arena_reset(frame_arena_t *arena){
+    if (arena->frame_total > arena->peak) arena->peak = arena->frame_total;
+    if (arena->overflow) {
+        // one block big enough for this frame, the old one goes with the chunks
+        frame_arena_free_overflow(arena);
+        size_t capacity = frame_arena_pot(arena->frame_total);
+        unsigned char *base = ecs_os_malloc((ecs_size_t)capacity);
+        if (base) {
+            ecs_os_free(arena->base);
+            arena->base = base;
+            arena->capacity = capacity;
+        }
+        arena->overflows++;
+    }
+    arena->used = 0;
+    arena->frame_total = 0;
+}
@@ -0,0 +1,134 @@
+// job_pool.c
+#include "job_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+int32_t job_pool_cpu_count(void){
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int32_t count = (int32_t)info.dwNumberOfProcessors;
+#else
+    int32_t count = (int32_t)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+static void *job_pool_worker(void *arg){
+    job_pool_t *pool = (job_pool_t *)arg;
+    ecs_os_mutex_lock(pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->count == 0) {
+            ecs_os_cond_wait(pool->wake, pool->lock);
+        }
+        if (pool->stop) break;
+
+        job_t job = pool->jobs[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->count--;
+        pool->active++;
+        ecs_os_mutex_unlock(pool->lock);
+
+        job.fn(job.data);
+
+        ecs_os_mutex_lock(pool->lock);
+        pool->active--;
+        if (pool->count == 0 && pool->active == 0) ecs_os_cond_broadcast(pool->idle);
+    }
+    ecs_os_mutex_unlock(pool->lock);
+    return NULL;
+}
+
+bool job_pool_init(job_pool_t *pool, int32_t thread_count){
+    memset(pool, 0, sizeof(job_pool_t));
+    if (thread_count <= 0) return true;
+
+    pool->capacity = 256;
+    pool->jobs = ecs_os_malloc(sizeof(job_t) * pool->capacity);
+    pool->threads = ecs_os_calloc(sizeof(ecs_os_thread_t) * thread_count);
+    if (!pool->jobs || !pool->threads) {
+        ecs_os_free(pool->jobs);
+        ecs_os_free(pool->threads);
+        memset(pool, 0, sizeof(job_pool_t));
+        return false;
+    }
+    pool->lock = ecs_os_mutex_new();
+    pool->wake = ecs_os_cond_new();
+    pool->idle = ecs_os_cond_new();
+    for (int32_t i = 0; i < thread_count; i++) {
+        pool->threads[i] = ecs_os_thread_new(job_pool_worker, pool);
+        if (!pool->threads[i]) break;
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0) {
+        // no worker started, free the queue so an inline init can follow
+        job_pool_fini(pool);
+        return false;
+    }
+    return true;
+}
+
+void job_pool_fini(job_pool_t *pool){
+    if (pool->thread_count > 0) {
+        ecs_os_mutex_lock(pool->lock);
+        pool->stop = true;
+        ecs_os_cond_broadcast(pool->wake);
+        ecs_os_mutex_unlock(pool->lock);
+        for (int32_t i = 0; i < pool->thread_count; i++) {
+            ecs_os_thread_join(pool->threads[i]);
+        }
+    }
+    if (pool->lock) {
+        ecs_os_cond_free(pool->idle);
+        ecs_os_cond_free(pool->wake);
+        ecs_os_mutex_free(pool->lock);
+    }
+    ecs_os_free(pool->jobs);
+    ecs_os_free(pool->threads);
+    memset(pool, 0, sizeof(job_pool_t));
+}
+
+bool job_pool_submit(job_pool_t *pool, job_fn_t fn, void *data){
+    if (pool->thread_count == 0) {
+        fn(data);
+        return true;
+    }
+    ecs_os_mutex_lock(pool->lock);
+    if (pool->count == pool->capacity) {
+        // unwrap the ring into a larger buffer
+        int32_t capacity = pool->capacity * 2;
+        job_t *jobs = ecs_os_malloc(sizeof(job_t) * capacity);
+        if (!jobs) {
+            ecs_os_mutex_unlock(pool->lock);
+            return false;
+        }
+        for (int32_t i = 0; i < pool->count; i++) {
+            jobs[i] = pool->jobs[(pool->head + i) % pool->capacity];
+        }
+        ecs_os_free(pool->jobs);
+        pool->jobs = jobs;
+        pool->head = 0;
+        pool->capacity = capacity;
+    }
+    pool->jobs[(pool->head + pool->count) % pool->capacity] = (job_t){ fn, data };
+    pool->count++;
+    ecs_os_cond_signal(pool->wake);
+    ecs_os_mutex_unlock(pool->lock);
+    return true;
+}
+
+void job_pool_wait(job_pool_t *pool){
+    if (pool->thread_count == 0) return;
+    ecs_os_mutex_lock(pool->lock);
+    while (pool->count > 0 || pool->active > 0) {
+        ecs_os_cond_wait(pool->idle, pool->lock);
+    }
+    ecs_os_mutex_unlock(pool->lock);
+}
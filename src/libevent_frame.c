@@ -0,0 +1,90 @@
+// libevent_frame.c
+// parse GameMessage frames straight out of the evbuffer chain. frames that fit
+// in the first chain are handed out in place, a frame that straddles chains is
+// removed into a scratch buffer with one copy. evbuffer_pullup would move the
+// chain data around to linearize it, which costs more for large frames.
+#include "libevent_frame.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LIBEVENT_FRAME_STACK_SCRATCH 4096 // straddling frames up to this size skip the heap
+
+static uint16_t read_u16_be(const uint8_t *src){
+    return (uint16_t)((src[0] << 8) | src[1]);
+}
+
+int libevent_frame_dispatch(struct evbuffer *input, libevent_frame_cb callback, void *user){
+    int frames = 0;
+    // straddling frames, on the heap only when larger than the stack part
+    uint8_t stack[LIBEVENT_FRAME_STACK_SCRATCH];
+    uint8_t *scratch = stack;
+    size_t scratch_size = sizeof(stack);
+    for (;;) {
+        // walk the frames in the first contiguous chunk
+        struct evbuffer_iovec vec;
+        if (evbuffer_peek(input, -1, NULL, &vec, 1) < 1) break;
+        const uint8_t *chunk = (const uint8_t *)vec.iov_base;
+        size_t avail = vec.iov_len;
+        size_t used = 0;
+        while (avail - used >= LIBEVENT_FRAME_HEADER_SIZE) {
+            const uint8_t *frame = chunk + used;
+            size_t frame_length = LIBEVENT_FRAME_HEADER_SIZE + read_u16_be(frame + 2);
+            if (avail - used < frame_length) break;
+            if (!callback(read_u16_be(frame), frame, frame_length, user)) {
+                evbuffer_drain(input, used);
+                if (scratch != stack) free(scratch);
+                return frames;
+            }
+            used += frame_length;
+            frames++;
+        }
+        if (used > 0) {
+            evbuffer_drain(input, used);
+            continue;
+        }
+
+        // next frame straddles chains, or is not complete yet
+        size_t total = evbuffer_get_length(input);
+        if (total < LIBEVENT_FRAME_HEADER_SIZE) break;
+        uint8_t header[LIBEVENT_FRAME_HEADER_SIZE];
+        if (evbuffer_copyout(input, header, sizeof(header)) != (ev_ssize_t)sizeof(header)) break;
+        size_t frame_length = LIBEVENT_FRAME_HEADER_SIZE + read_u16_be(header + 2);
+        if (total < frame_length) break;
+        if (scratch_size < frame_length) {
+            uint8_t *grown = realloc(scratch == stack ? NULL : scratch, frame_length);
+            if (!grown) break;
+            scratch = grown;
+            scratch_size = frame_length;
+        }
+        if (evbuffer_remove(input, scratch, frame_length) != (int)frame_length) break;
+        if (!callback(read_u16_be(scratch), scratch, frame_length, user)) {
+            // stopped, the frame goes back in front of the rest
+            evbuffer_prepend(input, scratch, frame_length);
+            break;
+        }
+        frames++;
+    }
+    if (scratch != stack) free(scratch);
+    return frames;
+}
+
+int libevent_frame_write(struct evbuffer *output, uint16_t type, const void *payload, uint16_t length){
+    size_t frame_length = LIBEVENT_FRAME_HEADER_SIZE + (size_t)length;
+    struct evbuffer_iovec vec;
+    // reserve and commit as one step when another thread also writes
+    evbuffer_lock(output);
+    if (evbuffer_reserve_space(output, (ev_ssize_t)frame_length, &vec, 1) < 1) {
+        evbuffer_unlock(output);
+        return -1;
+    }
+    uint8_t *dst = (uint8_t *)vec.iov_base;
+    dst[0] = (uint8_t)(type >> 8);
+    dst[1] = (uint8_t)(type);
+    dst[2] = (uint8_t)(length >> 8);
+    dst[3] = (uint8_t)(length);
+    if (length > 0) memcpy(dst + LIBEVENT_FRAME_HEADER_SIZE, payload, length);
+    vec.iov_len = frame_length;
+    int result = evbuffer_commit_space(output, &vec, 1);
+    evbuffer_unlock(output);
+    return result;
+}
@@ -0,0 +1,77 @@
+// libevent_queue.c
+#include "libevent_queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool libevent_queue_init(libevent_queue_t *queue, uint32_t capacity){
+    uint32_t size = 1;
+    while (size < capacity) size <<= 1;
+    memset(queue, 0, sizeof(*queue));
+    queue->items = calloc(size, sizeof(libevent_queue_item_t));
+    if (!queue->items) return false;
+    queue->capacity = size;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    return true;
+}
+
+void libevent_queue_fini(libevent_queue_t *queue){
+    if (!queue->items) return;
+    while (libevent_queue_front(queue)) {
+        libevent_queue_pop(queue);
+    }
+    free(queue->items);
+    queue->items = NULL;
+    queue->capacity = 0;
+}
+
+bool libevent_queue_push(libevent_queue_t *queue, uint8_t kind, struct bufferevent *bev, void *ctx, const void *data, uint32_t length){
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head >= queue->capacity) return false;
+
+    libevent_queue_item_t *item = &queue->items[tail & (queue->capacity - 1)];
+    item->kind = kind;
+    item->bev = bev;
+    item->ctx = ctx;
+    item->length = length;
+    item->data = item->inline_data;
+    if (length > LIBEVENT_QUEUE_INLINE) {
+        item->data = queue->alloc ? queue->alloc(length) : malloc(length);
+        if (!item->data) return false;
+    }
+    if (length > 0) memcpy(item->data, data, length);
+
+    // publish the slot
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+libevent_queue_item_t *libevent_queue_front(libevent_queue_t *queue){
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == tail) return NULL;
+    return &queue->items[head & (queue->capacity - 1)];
+}
+
+uint32_t libevent_queue_mark(libevent_queue_t *queue){
+    return atomic_load_explicit(&queue->tail, memory_order_acquire);
+}
+
+libevent_queue_item_t *libevent_queue_front_until(libevent_queue_t *queue, uint32_t mark){
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (head == mark) return NULL;
+    return &queue->items[head & (queue->capacity - 1)];
+}
+
+void libevent_queue_pop(libevent_queue_t *queue){
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    libevent_queue_item_t *item = &queue->items[head & (queue->capacity - 1)];
+    if (item->data && item->data != item->inline_data) {
+        if (queue->free) queue->free(item->data);
+        else free(item->data);
+    }
+    item->data = NULL;
+    // hand the slot back to the producer
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+}
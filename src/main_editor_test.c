@@ -6,6 +6,15 @@
 #include <stdio.h>
 #include "ecs_components.h"
 #include "module_dev.h"
+#include "module_editor.h"
+#include "module_picking.h"
+#include "module_block.h"
+#include "module_profiler.h"
+#include "module_scene.h"
+#include "module_asset.h"
+#include "module_lua.h"
+#include "module_text3d.h"
+#include "module_debug_draw.h"
 #include "raygui.h"
 
 int WINDOW_WIDTH = 800;
@@ -16,6 +25,7 @@ int WINDOW_HEIGHT = 600;
 #define CAMERA_FOV 60.0f
 #define CAMERA_MIN_DISTANCE 0.1f
 #define MAX_PITCH 89.0f * DEG2RAD
+#define EDITOR_SCENE_PATH "editor.scene"
 
 //===============================================
 // COMPONENTS
@@ -39,6 +49,7 @@ ECS_COMPONENT_DECLARE(select_transform_3d_t);
 typedef struct {
     Ray ray;
     RayCollision collision;
+    ecs_entity_t entity;    // last hit, highlighted
 } picking_t;
 ECS_COMPONENT_DECLARE(picking_t);
 
@@ -54,117 +65,11 @@ ECS_COMPONENT_DECLARE(cube_wire_t);
 typedef struct {
     ecs_entity_t id;  // Entity to edit (e.g., cube with CubeWire)
     int selectedIndex; // Index of the selected entity in the list
+    int scrollIndex;   // first visible row, kept between frames
     // Later: Add fields for other GUI controls
 } transform_3d_gui_t;
 ECS_COMPONENT_DECLARE(transform_3d_gui_t);
 
-typedef struct {
-    Model* model;             // Pointer to Model
-} block_t;
-ECS_COMPONENT_DECLARE(block_t);
-
-typedef struct {
-    Model *grass;
-    Model *dirt;
-    Model *stone;
-    Model *rock;
-} blocks_t;
-ECS_COMPONENT_DECLARE(blocks_t);
-
-//===============================================
-// CUBE HELPER
-//===============================================
-
-// Function to create a cube mesh with custom UVs for different textures per face
-Mesh GenMeshCubeCustomUV(float width, float height, float length, int tileIndices[6]){
-    Mesh mesh = { 0 };
-    mesh.vertexCount = 24;  // 4 vertices per face × 6 faces
-    mesh.triangleCount = 12;  // 2 triangles per face × 6 faces
-    mesh.vertices = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
-    mesh.texcoords = (float*)MemAlloc(mesh.vertexCount * 2 * sizeof(float));
-    mesh.indices = (unsigned short*)MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short));
-
-    float w = width * 0.5f;
-    float h = height * 0.5f;
-    float l = length * 0.5f;
-
-    // Atlas is 64x64, tiles are 16x16, so UVs are in [0,1] normalized coords
-    float tileSize = 16.0f / 64.0f;  // 16/64 = 0.25 (normalized tile size)
-
-    // Vertex data for each face (x, y, z)
-    float vertices[] = {
-        // Front (+Z)
-        -w, -h, l,  -w, h, l,   w, h, l,    w, -h, l,
-        // Back (-Z)
-        w, -h, -l,  w, h, -l,   -w, h, -l,  -w, -h, -l,
-        // Left (-X)
-        -w, -h, -l, -w, h, -l,  -w, h, l,   -w, -h, l,
-        // Right (+X)
-        w, -h, l,   w, h, l,    w, h, -l,   w, -h, -l,
-        // Top (+Y)
-        -w, h, l,   -w, h, -l,  w, h, -l,   w, h, l,
-        // Bottom (-Y)
-        -w, -h, -l, -w, -h, l,  w, -h, l,   w, -h, -l
-    };
-
-    // UVs: Map each face to a specific 16x16 tile based on tileIndices
-    float texcoords[48];
-    for (int face = 0; face < 6; face++) {
-        int tileIndex = tileIndices[face];
-        if (tileIndex < 0 || tileIndex > 15) tileIndex = 0;  // Fallback to tile 0
-        float u0 = (tileIndex % 4) * tileSize;  // Left edge of tile
-        float v0 = (tileIndex / 4) * tileSize;  // Top edge of tile
-        float u1 = u0 + tileSize;               // Right edge
-        float v1 = v0 + tileSize;               // Bottom edge
-        int i = face * 8;  // 4 vertices × 2 coords (u,v)
-        texcoords[i + 0] = u0; texcoords[i + 1] = v1;  // Bottom-left
-        texcoords[i + 2] = u0; texcoords[i + 3] = v0;  // Top-left
-        texcoords[i + 4] = u1; texcoords[i + 5] = v0;  // Top-right
-        texcoords[i + 6] = u1; texcoords[i + 7] = v1;  // Bottom-right
-    }
-
-    // Indices: Two triangles per face, reversed for correct winding (clockwise)
-    unsigned short indices[] = {
-        0, 3, 1,  1, 3, 2,      // Front
-        4, 7, 5,  5, 7, 6,      // Back
-        8, 11, 9, 9, 11, 10,    // Left
-        12, 15, 13, 13, 15, 14, // Right
-        16, 19, 17, 17, 19, 18, // Top
-        20, 23, 21, 21, 23, 22  // Bottom
-    };
-
-    memcpy(mesh.vertices, vertices, mesh.vertexCount * 3 * sizeof(float));
-    memcpy(mesh.texcoords, texcoords, mesh.vertexCount * 2 * sizeof(float));
-    memcpy(mesh.indices, indices, mesh.triangleCount * 3 * sizeof(unsigned short));
-
-    UploadMesh(&mesh, false);  // Upload to GPU
-    return mesh;
-}
-
-// Update UVs for an existing mesh without rebuilding
-void UpdateMeshUVs(Mesh* mesh, int tileIndices[6]){
-    float tileSize = 16.0f / 64.0f;  // 16/64 = 0.25
-    float* texcoords = (float*)MemAlloc(mesh->vertexCount * 2 * sizeof(float));
-    
-    for (int face = 0; face < 6; face++) {
-        int tileIndex = tileIndices[face];
-        if (tileIndex < 0 || tileIndex > 15) tileIndex = 0;
-        float u0 = (tileIndex % 4) * tileSize;
-        float v0 = (tileIndex / 4) * tileSize;
-        float u1 = u0 + tileSize;
-        float v1 = v0 + tileSize;
-        int i = face * 8;
-        texcoords[i + 0] = u0; texcoords[i + 1] = v1;
-        texcoords[i + 2] = u0; texcoords[i + 3] = v0;
-        texcoords[i + 4] = u1; texcoords[i + 5] = v0;
-        texcoords[i + 6] = u1; texcoords[i + 7] = v1;
-    }
-
-    memcpy(mesh->texcoords, texcoords, mesh->vertexCount * 2 * sizeof(float));
-    MemFree(texcoords);
-    UpdateMeshBuffer(*mesh, 1, mesh->texcoords, mesh->vertexCount * 2 * sizeof(float), 0);  // Update UVs
-}
-
 //===============================================
 // SYSTEMS
 //===============================================
@@ -266,73 +171,78 @@ void camera_input_system(ecs_iter_t *it){
     // }
 }
 
-// render 3d draw cube wires
-void render_3d_draw_cube_wires(ecs_iter_t *it){
+// cube wires, queued for the debug draw batch
+void debug_cube_wires_system(ecs_iter_t *it){
     cube_wire_t *cube_wire = ecs_field(it, cube_wire_t, 0);
     // Iterate matched entities
     for (int i = 0; i < it->count; i++) {
-        DrawCubeWires(cube_wire[i].position, cube_wire[i].width,cube_wire[i].height,cube_wire[i].length,cube_wire[i].color);
+        debug_draw_box(cube_wire[i].position, (Vector3){ cube_wire[i].width, cube_wire[i].height, cube_wire[i].length }, cube_wire[i].color, 0.0f);
     }
 }
 
-// picking raycast
+// picking raycast, nearest cube from the picking grid
 void cube_wires_picking_system(ecs_iter_t *it){
     main_context_t *main_context = ecs_field(it, main_context_t, 0);
     picking_t *picking = ecs_field(it, picking_t, 1);
-    cube_wire_t *cube_wire = ecs_field(it, cube_wire_t, 2);
-
-    // Ray ray = { 0 };                    // Picking line ray
-    // RayCollision collision = { 0 };     // Ray collision hit info
-
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)){
-        picking->ray = GetScreenToWorldRay(GetMousePosition(), main_context->camera);
-        // Iterate matched entities
-        for (int i = 0; i < it->count; i++) {
-            DrawCubeWires(cube_wire[i].position, cube_wire[i].width,cube_wire[i].height,cube_wire[i].length, cube_wire[i].color);
-            picking->collision = GetRayCollisionBox(picking->ray,
-                (BoundingBox){(Vector3){ cube_wire[i].position.x - cube_wire[i].width/2, cube_wire[i].position.y - cube_wire[i].height/2, cube_wire[i].position.z - cube_wire[i].length/2 },
-                            (Vector3){ cube_wire[i].position.x + cube_wire[i].width/2, cube_wire[i].position.y + cube_wire[i].height/2, cube_wire[i].position.z + cube_wire[i].length/2 }} );
-            if (picking->collision.hit){
-                cube_wire[i].color = GREEN;
-                Vector3 place = Vector3Add(cube_wire[i].position, Vector3Scale(picking->collision.normal, 1.0f));
-
-                ecs_entity_t cube = ecs_new(it->world);
-                ecs_set(it->world, cube, cube_wire_t, {
-                    .position = place,
-                    .width = 1.0f,
-                    .height = 1.0f,
-                    .length = 1.0f,
-                    .color = BLUE
-                });
-
-            }else{
-                cube_wire[i].color = GRAY;
-            }
-            // DrawRay(ray, MAROON);
+
+    bool place = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    bool remove = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
+    if (!place && !remove) return;
+
+    picking->ray = GetScreenToWorldRay(GetMousePosition(), main_context->camera);
+    pick_hit_t hit = pick_ray(it->world, picking->ray, 0.0f);
+    picking->collision = (RayCollision){ .hit = hit.hit, .distance = hit.distance, .point = hit.point, .normal = hit.normal };
+
+    // terrain blocks in front of the nearest cube take the click
+    block_hit_t block = block_raycast(it->world, picking->ray, hit.hit ? hit.distance : 0.0f);
+    if (block.hit && (!hit.hit || block.distance < hit.distance)) {
+        picking->collision = (RayCollision){ .hit = true, .distance = block.distance, .point = block.point, .normal = block.normal };
+        if (remove) {
+            block_set(it->world, block.x, block.y, block.z, BLOCK_AIR);
+        } else if (Vector3LengthSqr(block.normal) > 0.0f) {
+            block_set(it->world, block.place_x, block.place_y, block.place_z, block.id);
         }
+        return;
     }
 
-    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)){
-        picking->ray = GetScreenToWorldRay(GetMousePosition(), main_context->camera);
-        // Iterate matched entities
-        for (int i = 0; i < it->count; i++) {
-            DrawCubeWires(cube_wire[i].position, cube_wire[i].width,cube_wire[i].height,cube_wire[i].length, cube_wire[i].color);
-            picking->collision = GetRayCollisionBox(picking->ray,
-                (BoundingBox){(Vector3){ cube_wire[i].position.x - cube_wire[i].width/2, cube_wire[i].position.y - cube_wire[i].height/2, cube_wire[i].position.z - cube_wire[i].length/2 },
-                            (Vector3){ cube_wire[i].position.x + cube_wire[i].width/2, cube_wire[i].position.y + cube_wire[i].height/2, cube_wire[i].position.z + cube_wire[i].length/2 }} );
-            // if (picking->collision.hit && cube_wire[i].position.x != 0 && cube_wire[i].position.y != 0 && cube_wire[i].position.z != 0){
-            if (picking->collision.hit){
-                // cube_wire[i].color = YELLOW;
-                if (cube_wire[i].position.x == 0.0f && cube_wire[i].position.y == 0.0f && cube_wire[i].position.z == 0.0f){
-
-                }else{
-                    ecs_delete(it->world ,it->entities[i]);
-                }
-            }else{
-                // cube_wire[i].color = GRAY;
-            }
-            // DrawRay(ray, MAROON);
-        }
+    // clear the previous highlight
+    if (picking->entity && picking->entity != hit.entity && ecs_is_alive(it->world, picking->entity)) {
+        cube_wire_t *last = ecs_get_mut(it->world, picking->entity, cube_wire_t);
+        if (last) last->color = GRAY;
+    }
+    picking->entity = hit.entity;
+    if (!hit.hit) return;
+
+    cube_wire_t *cube_wire = ecs_get_mut(it->world, hit.entity, cube_wire_t);
+    if (!cube_wire) return;
+    // flash the clicked cube for a moment
+    debug_draw_box(cube_wire->position, (Vector3){ cube_wire->width * 1.1f, cube_wire->height * 1.1f, cube_wire->length * 1.1f }, YELLOW, 0.3f);
+
+    if (place) {
+        cube_wire->color = GREEN;
+        ecs_entity_t cube = ecs_new(it->world);
+        ecs_set(it->world, cube, cube_wire_t, {
+            .position = Vector3Add(cube_wire->position, hit.normal),
+            .width = 1.0f,
+            .height = 1.0f,
+            .length = 1.0f,
+            .color = BLUE
+        });
+    } else if (cube_wire->position.x != 0.0f || cube_wire->position.y != 0.0f || cube_wire->position.z != 0.0f) {
+        ecs_delete(it->world, hit.entity);
+        picking->entity = 0;
+    }
+}
+
+// keep the picking bounds on the cube box
+void on_set_cube_wire_bounds(ecs_iter_t *it){
+    cube_wire_t *cube_wire = ecs_field(it, cube_wire_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        Vector3 half = { cube_wire[i].width / 2, cube_wire[i].height / 2, cube_wire[i].length / 2 };
+        ecs_set(it->world, it->entities[i], pick_bounds_t, {
+            .min = Vector3Subtract(cube_wire[i].position, half),
+            .max = Vector3Add(cube_wire[i].position, half)
+        });
     }
 }
 
@@ -351,14 +261,17 @@ void on_remove_entity(ecs_iter_t *it){
 // draw raylib grid
 void render_3d_grid(ecs_iter_t *it){
     DrawGrid(10, 1.0f);
+}
+
+// last picking ray, queued for the debug draw batch
+void debug_picking_system(ecs_iter_t *it){
     const picking_t *picking = ecs_singleton_get(it->world,picking_t);
     if(picking){
-        // printf("picking\n");
-        DrawRay(picking->ray, MAROON);
+        debug_draw_ray(picking->ray, 1000.0f, MAROON, 0.0f);
         if(picking->collision.hit){
             // Draw a line representing the normal at the hit point
-            DrawLine3D(picking->collision.point, Vector3Add(picking->collision.point, Vector3Scale(picking->collision.normal, 1.0f)), RED);
-            DrawSphere(picking->collision.point, 0.1f, RED); // Mark the hit point
+            debug_draw_line(picking->collision.point, Vector3Add(picking->collision.point, Vector3Scale(picking->collision.normal, 1.0f)), RED, 0.0f);
+            debug_draw_sphere(picking->collision.point, 0.1f, RED, 0.0f); // Mark the hit point
         }
     }
 }
@@ -369,52 +282,28 @@ void render_3d_grid(ecs_iter_t *it){
 
 void transform_3D_gui_list_system(ecs_iter_t *it) {
     transform_3d_gui_t *gui = ecs_field(it, transform_3d_gui_t, 0);
+    // kept up to date by module_editor observers, nothing to build per frame
+    const editor_list_t *list = ecs_singleton_get(it->world, editor_list_t);
+    if (!list) return;
 
-    // Create a query for all entities with Transform3D
-    ecs_query_t *query = ecs_query(it->world, {
-        .terms = {{ ecs_id(Transform3D) }}
-    });
-
-    int entity_count = 0;
-    ecs_iter_t transform_it = ecs_query_iter(it->world, query);
-    while (ecs_query_next(&transform_it)) {
-        entity_count += transform_it.count;
-    }
-
-    // Allocate buffers for entity names and IDs
-    ecs_entity_t *entity_ids = (ecs_entity_t *)RL_MALLOC(entity_count * sizeof(ecs_entity_t));
-    char **entity_names = (char **)RL_MALLOC(entity_count * sizeof(char *));
-    int index = 0;
-
-    // Populate entity names and IDs
-    transform_it = ecs_query_iter(it->world, query);
-    while (ecs_query_next(&transform_it)) {
-        for (int j = 0; j < transform_it.count; j++) {
-            const char *name = ecs_get_name(it->world, transform_it.entities[j]);
-            entity_names[index] = (char *)RL_MALLOC(256 * sizeof(char));
-            snprintf(entity_names[index], 256, "%s", name ? name : "(unnamed)");
-            entity_ids[index] = transform_it.entities[j];
-            index++;
-        }
-    }
-
-    // Create a single string for GuiListView
-    char *name_list = (char *)RL_MALLOC(entity_count * 256 * sizeof(char));
-    name_list[0] = '\0';
-    for (int j = 0; j < entity_count; j++) {
-        if (j > 0) strcat(name_list, ";");
-        strcat(name_list, entity_names[j]);
+    // keep the selection on the same entity when rows move (swap remove)
+    if (gui->id) {
+        gui->selectedIndex = ecs_is_alive(it->world, gui->id) ? editor_list_find(list, gui->id) : -1;
     }
 
     // Draw the list view on the right side
+    // GuiListViewEx only reads the rows inside the scroll window
     Rectangle list_rect = {520, 18, 240, 200}; // Reduced height for more controls
-    int scroll_index = 0;
-    
-    GuiListView(list_rect, name_list, &scroll_index, &gui->selectedIndex);
+    int selected = gui->selectedIndex;
+    GuiListViewEx(list_rect, list->names, list->count, &gui->scrollIndex, &selected, NULL);
+    if (selected != gui->selectedIndex) {
+        gui->selectedIndex = selected;
+        gui->id = (selected >= 0 && selected < list->count) ? list->ids[selected] : 0;
+    }
 
     // Draw transform controls if an entity is selected
-    if (gui->selectedIndex >= 0 && gui->selectedIndex < entity_count && ecs_is_valid(it->world, entity_ids[gui->selectedIndex])) {
-        gui->id = entity_ids[gui->selectedIndex];
+    if (gui->selectedIndex >= 0 && gui->selectedIndex < list->count && ecs_is_valid(it->world, list->ids[gui->selectedIndex])) {
+        gui->id = list->ids[gui->selectedIndex];
         Transform3D *transform = ecs_get_mut(it->world, gui->id, Transform3D);
         bool modified = false;
 
@@ -493,75 +382,34 @@ void transform_3D_gui_list_system(ecs_iter_t *it) {
     }
     list_rect.y -= 8.0f;
     list_rect.height += 8.0f;
-    GuiGroupBox(list_rect, "Entity List");
-
-    // Clean up
-    for (int j = 0; j < entity_count; j++) {
-        RL_FREE(entity_names[j]);
-    }
-    RL_FREE(entity_names);
-    RL_FREE(entity_ids);
-    RL_FREE(name_list);
-    ecs_query_fini(query);
+    GuiGroupBox(list_rect, TextFormat("Entity List (%d)", list->count));
 }
 
 
-//===============================================
-// BLOCKS systems
-//===============================================
-
-
-// Camera3d system for 3d model
-void render_3d_blocks_system(ecs_iter_t *it) {
-    //filter components from entities
-    Transform3D *t = ecs_field(it, Transform3D, 0);
-    block_t *block = ecs_field(it, block_t, 1);
-
-    for (int i = 0; i < it->count; i++) {
-        ecs_entity_t entity = it->entities[i];
-        if (!ecs_is_valid(it->world, entity)) {
-            //printf("Skipping invalid entity ID: %llu\n", (unsigned long long)entity);
-            continue;
-        }
-        const char *name = ecs_get_name(it->world, entity) ? ecs_get_name(it->world, entity) : "(unnamed)";
-        if (!ecs_has(it->world, entity, Transform3D) || !ecs_has(it->world, entity, block_t)) {
-            //printf("Skipping entity %s: missing Transform3D or block_t\n", name);
-            continue;
-        }
-        // Check for garbage values in world matrix
-        if (fabs(t[i].worldMatrix.m12) > 1e6 || fabs(t[i].worldMatrix.m13) > 1e6 || fabs(t[i].worldMatrix.m14) > 1e6) {
-            // printf("Skipping entity %s: invalid world matrix (%.2f, %.2f, %.2f)\n",
-            //        name, t[i].worldMatrix.m12, t[i].worldMatrix.m13, t[i].worldMatrix.m14);
-            continue;
-        }
-        // printf("Rendering entity %s at world pos (%.2f, %.2f, %.2f)\n",
-        //        name, t[i].worldMatrix.m12, t[i].worldMatrix.m13, t[i].worldMatrix.m14);
-        if (!block[i].model) {
-            // printf("Skipping entity %s: null model\n", name);
-            continue;
-        }
-        block[i].model->transform = t[i].worldMatrix;
-        bool isChild = ecs_has_pair(it->world, entity, EcsChildOf, EcsWildcard);
-        DrawModel(*(block[i].model), (Vector3){0, 0, 0}, 1.0f, WHITE);
-        //   DrawModelWires(*(block[i].model), (Vector3){0, 0, 0}, 1.0f, GREEN); 
+// F5 saves the edited chunks and the scene entities, module_block streams
+// the rest around the camera
+void block_save_key_system(ecs_iter_t *it){
+    if (IsKeyPressed(KEY_F5)) {
+        int32_t regions = block_world_save(it->world);
+        TraceLog(regions < 0 ? LOG_WARNING : LOG_INFO, "block world save: %d regions", (int)regions);
+        int32_t entities = scene_save(it->world, EDITOR_SCENE_PATH);
+        TraceLog(entities < 0 ? LOG_WARNING : LOG_INFO, "scene save: %d entities", (int)entities);
     }
 }
 
-// clean up for blocks
-void on_remove_block_system(ecs_iter_t *it){
-    // block_t *block = ecs_field(it, block_t, 0);
-    for (int i = 0; i < it->count; i ++) {
-        ecs_entity_t current_entity = it->entities[i];
-        const block_t *block = ecs_get(it->world, current_entity, block_t);
-        if(block){
-            printf("remove block_t\n");
-            // this handle clean up
-            // dBodyDestroy(ode_body->id);
-            if(block->model){
-                UnloadModel(*(block->model));
-            }
-        }
+// the block atlas decodes on the asset workers, tiles are packed once it is in
+static asset_handle_t block_sheet = 0;
+
+void block_atlas_asset_system(ecs_iter_t *it){
+    if (block_sheet == 0) return;
+    asset_state_t state = asset_state(it->world, block_sheet);
+    if (state == ASSET_LOADING) return;
+    if (state == ASSET_READY) {
+        const Image *sheet = asset_image(it->world, block_sheet);
+        if (!block_load_sheet(it->world, *sheet)) TraceLog(LOG_WARNING, "block atlas: could not pack the sheet");
     }
+    asset_release(it->world, block_sheet);
+    block_sheet = 0;
 }
 
 //===============================================
@@ -575,7 +423,16 @@ int main(void) {
 
     // Initialize components and phases
     module_init_raylib(world);
+    module_init_profiler(world);
     module_init_dev(world);
+    module_init_editor(world);
+    module_init_picking(world);
+    module_init_block(world);
+    module_init_scene(world); // after the modules whose components it saves
+    module_init_asset(world);
+    module_init_lua(world);
+    module_init_text3d(world);
+    module_init_debug_draw(world);
 
     ECS_COMPONENT_DEFINE(world, camera_controller_t);
     ECS_COMPONENT_DEFINE(world, cube_wire_t);
@@ -583,9 +440,6 @@ int main(void) {
     ECS_COMPONENT_DEFINE(world, select_transform_3d_t);
     ECS_COMPONENT_DEFINE(world, transform_3d_gui_t);
 
-    ECS_COMPONENT_DEFINE(world, blocks_t);
-    ECS_COMPONENT_DEFINE(world, block_t);
-
     ECS_SYSTEM(world, render_3d_grid, RLRender3DPhase);
 
     // camera input
@@ -598,43 +452,52 @@ int main(void) {
         .callback = camera_input_system
     });
 
-    // Render 3D Cube
+    // cube wires, drawn by debug_draw_flush_system
     ecs_system(world, {
-        .entity = ecs_entity(world, { .name = "render_3d_draw_cube_wires", .add = ecs_ids(ecs_dependson(RLRender3DPhase)) }),
+        .entity = ecs_entity(world, { .name = "debug_cube_wires_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
         .query.terms = {
-            { .id = ecs_id(cube_wire_t) }, //
+            { .id = ecs_id(cube_wire_t), .inout = EcsIn }, //
         },
-        .callback = render_3d_draw_cube_wires
+        .callback = debug_cube_wires_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "block_atlas_asset_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .callback = block_atlas_asset_system
     });
 
-    // picking raycast system
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "block_save_key_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
+        .callback = block_save_key_system
+    });
+
+    // picking raycast system, immediate because block_set edits chunks in place
     ecs_system(world, {
         .entity = ecs_entity(world, { .name = "cube_wires_picking_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
         .query.terms = {
             { .id = ecs_id(main_context_t), .src.id = ecs_id(main_context_t) }, // Singleton
             { .id = ecs_id(picking_t), .src.id = ecs_id(picking_t) }, // Singleton
-            { .id = ecs_id(cube_wire_t) },   //
         },
-        .callback = cube_wires_picking_system
+        .callback = cube_wires_picking_system,
+        .immediate = true
     });
 
-    // draw center crosshair
+    // after the raycast so the ray shows the frame it is cast
     ecs_system(world, {
-        .entity = ecs_entity(world, { .name = "render_2d_draw_cross_point", .add = ecs_ids(ecs_dependson(RLRender2D1Phase)) }),
-        .callback = render_2d_draw_cross_point
+        .entity = ecs_entity(world, { .name = "debug_picking_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
+        .callback = debug_picking_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(cube_wire_t) }},
+        .events = { EcsOnSet },
+        .callback = on_set_cube_wire_bounds
     });
 
-    // render 3d mesh
+    // draw center crosshair
     ecs_system(world, {
-        .entity = ecs_entity(world, {
-          .name = "render_3d_blocks_system", 
-          .add = ecs_ids(ecs_dependson(RLRender3DPhase))
-        }),
-        .query.terms = {
-            { .id = ecs_id(Transform3D), .src.id = EcsSelf },
-            { .id = ecs_id(block_t), .src.id = EcsSelf }
-        },
-        .callback = render_3d_blocks_system
+        .entity = ecs_entity(world, { .name = "render_2d_draw_cross_point", .add = ecs_ids(ecs_dependson(RLRender2D1Phase)) }),
+        .callback = render_2d_draw_cross_point
     });
 
     // Register GUI list system in the 2D rendering phase
@@ -653,13 +516,6 @@ int main(void) {
         .callback = on_add_entity
     });
 
-    // Create observer that is invoked whenever block_t model is remove
-    ecs_observer(world, {
-        .query.terms = {{ ecs_id(block_t) }},
-        .events = { EcsOnRemove },
-        .callback = on_remove_block_system
-    });
-
     //===========================================
     // CAMERA and others
     //===========================================
@@ -694,31 +550,22 @@ int main(void) {
 
 
 
-    // Load texture atlas (ensure resources/simple_color64x64.png exists)
-    Image atlasImage = LoadImage("resources/altas_texture64x64.png");
-    if (atlasImage.data == NULL) {
-        TraceLog(LOG_ERROR, "Failed to load texture: resources/altas_texture64x64.png");
-        CloseWindow();
-        return 1;
-    }
-    ImageFormat(&atlasImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);  // Ensure RGBA
-    Texture2D atlasTexture = LoadTextureFromImage(atlasImage);
-    UnloadImage(atlasImage);  // Free image
-
-    // Tile indices for each face (front, back, left, right, top, bottom)
-    // int tileIndices[6] = { 0, 1, 2, 3, 4, 5 };  // Example: different tiles per face
-    int tileIndices[6] = { 1, 1, 1, 1, 0, 2 };  // Example: different tiles per face
-    // 1 = side
-    // 2 = side
-    // 3 = side
-    // 4 = side
-    // 5 = top
-    // 6 = bottom
-
-    // Create cube mesh and model
-    Mesh cubeMesh = GenMeshCubeCustomUV(1.0f, 1.0f, 1.0f, tileIndices);
-    Model cubeModel = LoadModelFromMesh(cubeMesh);
-    SetMaterialTexture(&cubeModel.materials[0], MATERIAL_MAP_DIFFUSE, atlasTexture);
+    // chunked terrain, one greedy meshed draw per chunk
+    block_sheet = asset_load(world, ASSET_IMAGE, "resources/altas_texture64x64.png");
+    block_id_t block_grass = block_register_type(world, "grass", (int[BLOCK_FACE_COUNT]){ 1, 1, 1, 1, 0, 2 });
+    block_id_t block_dirt = block_register_type(world, "dirt", (int[BLOCK_FACE_COUNT]){ 2, 2, 2, 2, 2, 2 });
+    block_id_t block_stone = block_register_type(world, "stone", (int[BLOCK_FACE_COUNT]){ 3, 3, 3, 3, 3, 3 });
+    // saved chunks are loaded around the camera, the rest is generated from the seed
+    block_world_open(world, "world");
+    block_generator_t *generator = ecs_singleton_ensure(world, block_generator_t);
+    generator->enabled = true;
+    generator->seed = 1337;
+    generator->base_height = -4.0f;
+    generator->height_scale = 12.0f;
+    generator->surface = block_grass;
+    generator->filler = block_dirt;
+    generator->stone = block_stone;
+    ecs_singleton_modified(world, block_generator_t);
 
 
 
@@ -737,26 +584,45 @@ int main(void) {
         .color = BLUE
     });
 
-    ecs_entity_t cube_1 = ecs_entity(world, {
-      .name = "cube_1"
-    });
-    ecs_set(world, cube_1, Transform3D, {
-        .position = (Vector3){1.0f, 0.0f, 0.0f},
-        .rotation = QuaternionIdentity(),
-        .scale = (Vector3){1.0f, 1.0f, 1.0f},
-        .localMatrix = MatrixIdentity(),
-        .worldMatrix = MatrixIdentity(),
-        .isDirty = true
-    });
-    // ecs_set(world, cube_1, ModelComponent, {&model_cube});
-    // ecs_set(world, cube_1, block_t, {&model_cube});
-    ecs_set(world, cube_1, block_t, {&cubeModel});
+    // the scene saved with F5, built by hand the first time
+    ecs_entity_t cube_1 = 0;
+    if (scene_load(world, EDITOR_SCENE_PATH) >= 0) {
+        cube_1 = ecs_lookup(world, "cube_1");
+    } else {
+        cube_1 = ecs_entity(world, {
+          .name = "cube_1"
+        });
+        ecs_set(world, cube_1, Transform3D, {
+            .position = (Vector3){1.0f, 0.0f, 0.0f},
+            .rotation = QuaternionIdentity(),
+            .scale = (Vector3){1.0f, 1.0f, 1.0f},
+            .localMatrix = MatrixIdentity(),
+            .worldMatrix = MatrixIdentity(),
+            .isDirty = true
+        });
+        // ecs_set(world, cube_1, ModelComponent, {&model_cube});
+        // one byte per block, drawn instanced with the other blocks of its type
+        ecs_set(world, cube_1, block_t, { .type = block_grass });
+    }
+    // name label, not saved with the scene
+    if (cube_1) {
+        ecs_set(world, cube_1, text3d_t, {
+            .text = "cube_1",
+            .offset = (Vector3){0.0f, 0.75f, 0.0f},
+            .size = 0.3f,
+            .spacing = 0.03f,
+            .color = WHITE
+        });
+    }
 
 
     ecs_singleton_set(world, transform_3d_gui_t, {
         .id = cube_1  // Reference the id entity
     });
 
+    // gameplay script, reloaded when it is saved
+    lua_script_watch(world, "resources/scripts/editor.lua");
+
 
 
 
@@ -836,12 +702,16 @@ int main(void) {
     //     .id = node1  // Reference the id entity
     // });
 
+    // every system is registered, time them from here on (F3 overlay, F4 trace)
+    profiler_instrument(world);
+
     //Loop Logic and render
     while (!WindowShouldClose()) {
       ecs_progress(world, 0);
     }
 
     // UnloadModel(cube);
+    block_world_save(world);
     ecs_fini(world);
     CloseWindow();
     return 0;
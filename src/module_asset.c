@@ -0,0 +1,936 @@
+// module_asset.c
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecs_components.h"
+#include "module_asset.h"
+#include "job_pool.h"
+#include "asset_cook.h"
+#include "block_region.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/cgltf.h" // raylib builds the implementation
+
+ECS_COMPONENT_DECLARE(asset_manager_t);
+ECS_COMPONENT_DECLARE(model_asset_t);
+
+#define ASSET_INDEX_MASK ((1u << ASSET_INDEX_BITS) - 1)
+#define ASSET_GENERATION_MASK (0xFFFFFFFFu >> ASSET_INDEX_BITS)
+
+//===============================================
+// STORE
+//===============================================
+// worker output, moved into the slot by the upload pass
+typedef struct {
+    Image image;
+    Mesh *meshes;                       // cpu arrays, uploaded on the main thread
+    int *mesh_materials;
+    int32_t mesh_count;
+    Image *material_images;             // base color, data NULL for none
+    Color *material_colors;
+    int32_t material_count;             // [0] is for primitives without a material
+    char *vs;
+    char *fs;
+    asset_cook_t cook;                  // open while a texture uploads straight from it
+    bool cached;                        // from the cooked file
+    bool ok;
+} asset_decoded_t;
+
+typedef struct asset_job_s {
+    asset_store_t *store;
+    int32_t index;
+    uint32_t generation;
+    asset_kind_t kind;
+    uint64_t hash;                      // key hash, names the cooked file
+    char *path;                         // vertex shader for ASSET_SHADER
+    char *fs_path;
+    asset_decoded_t decoded;
+    struct asset_job_s *next;           // done list
+} asset_job_t;
+
+typedef struct {
+    char *key;                          // path, "vs\nfs" for shaders
+    uint64_t hash;
+    asset_kind_t kind;
+    asset_state_t state;
+    int32_t refcount;
+    uint32_t generation;                // bumped when the slot is freed
+    bool in_use;
+    int32_t next_free;
+    Image image;
+    Texture2D texture;
+    Model *model;                       // allocated so ModelComponent can point at it
+    Shader shader;
+} asset_slot_t;
+
+struct asset_store_s {
+    asset_slot_t *slots;
+    int32_t slot_count;
+    int32_t slot_capacity;
+    int32_t free_head;                  // -1 when empty
+    int32_t *released;                  // refcount reached 0, unloaded in the next upload pass
+    int32_t released_count;
+    int32_t released_capacity;
+    ecs_map_t lookup;                   // key hash to slot
+    job_pool_t pool;
+    ecs_os_mutex_t lock;                // guards the done list
+    asset_job_t *done_head;             // decoded, oldest first
+    asset_job_t *done_tail;
+    int32_t jobs_in_flight;             // main thread
+    int32_t ready;
+    int32_t failed;
+    int32_t cache_hits;
+    bool cook;                          // ASSET_COOK_DIR is there
+};
+
+static uint64_t asset_hash(asset_kind_t kind, const char *key){
+    uint64_t hash = 14695981039346656037ull ^ (uint64_t)kind;
+    for (const char *c = key; *c; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static asset_handle_t asset_handle(const asset_store_t *store, int32_t index){
+    return ((uint32_t)(index + 1) & ASSET_INDEX_MASK) | (store->slots[index].generation << ASSET_INDEX_BITS);
+}
+
+static asset_slot_t *asset_slot(asset_store_t *store, asset_handle_t handle){
+    if (!store || handle == 0) return NULL;
+    int32_t index = (int32_t)(handle & ASSET_INDEX_MASK) - 1;
+    if (index < 0 || index >= store->slot_count) return NULL;
+    asset_slot_t *slot = &store->slots[index];
+    if (!slot->in_use || (slot->generation & ASSET_GENERATION_MASK) != handle >> ASSET_INDEX_BITS) return NULL;
+    return slot;
+}
+
+static int32_t asset_find(const asset_store_t *store, asset_kind_t kind, const char *key, uint64_t hash){
+    ecs_map_val_t *found = ecs_map_get(&store->lookup, hash);
+    if (found) {
+        const asset_slot_t *slot = &store->slots[*found];
+        if (slot->in_use && slot->kind == kind && strcmp(slot->key, key) == 0) return (int32_t)*found;
+    }
+    // another key with the same hash holds the map entry
+    for (int32_t i = 0; found && i < store->slot_count; i++) {
+        const asset_slot_t *slot = &store->slots[i];
+        if (slot->in_use && slot->hash == hash && slot->kind == kind && strcmp(slot->key, key) == 0) return i;
+    }
+    return -1;
+}
+
+static int32_t asset_slot_new(asset_store_t *store){
+    if (store->free_head >= 0) {
+        int32_t index = store->free_head;
+        store->free_head = store->slots[index].next_free;
+        return index;
+    }
+    if (store->slot_count >= (int32_t)ASSET_INDEX_MASK) return -1;
+    if (store->slot_count == store->slot_capacity) {
+        int32_t capacity = store->slot_capacity ? store->slot_capacity * 2 : 64;
+        asset_slot_t *slots = ecs_os_realloc(store->slots, sizeof(asset_slot_t) * (size_t)capacity);
+        if (!slots) return -1;
+        store->slots = slots;
+        store->slot_capacity = capacity;
+    }
+    memset(&store->slots[store->slot_count], 0, sizeof(asset_slot_t));
+    return store->slot_count++;
+}
+
+static void asset_mesh_free(Mesh *mesh){
+    MemFree(mesh->vertices);
+    MemFree(mesh->normals);
+    MemFree(mesh->texcoords);
+    MemFree(mesh->indices);
+}
+
+static void asset_decoded_free(asset_decoded_t *decoded){
+    if (decoded->cook.header) decoded->image.data = NULL; // points into the mapping
+    asset_cook_close(&decoded->cook);
+    UnloadImage(decoded->image);
+    for (int32_t i = 0; decoded->meshes && i < decoded->mesh_count; i++) asset_mesh_free(&decoded->meshes[i]);
+    MemFree(decoded->meshes);
+    MemFree(decoded->mesh_materials);
+    for (int32_t i = 0; decoded->material_images && i < decoded->material_count; i++) UnloadImage(decoded->material_images[i]);
+    MemFree(decoded->material_images);
+    MemFree(decoded->material_colors);
+    UnloadFileText(decoded->vs);
+    UnloadFileText(decoded->fs);
+    memset(decoded, 0, sizeof(asset_decoded_t));
+}
+
+static void asset_job_free(asset_job_t *job){
+    asset_decoded_free(&job->decoded);
+    ecs_os_free(job->path);
+    ecs_os_free(job->fs_path);
+    ecs_os_free(job);
+}
+
+// gpu resources and the key, the slot goes back on the free list
+static void asset_slot_free(asset_store_t *store, int32_t index){
+    asset_slot_t *slot = &store->slots[index];
+    if (slot->state == ASSET_READY) store->ready--;
+    if (slot->state == ASSET_FAILED) store->failed--;
+    UnloadImage(slot->image);
+    if (slot->texture.id != 0) UnloadTexture(slot->texture);
+    if (slot->model) {
+        UnloadModel(*slot->model);
+        MemFree(slot->model);
+    }
+    if (slot->shader.id != 0) UnloadShader(slot->shader);
+    ecs_map_val_t *found = ecs_map_get(&store->lookup, slot->hash);
+    if (found && *found == (ecs_map_val_t)index) ecs_map_remove(&store->lookup, slot->hash);
+    ecs_os_free(slot->key);
+    uint32_t generation = slot->generation + 1;
+    memset(slot, 0, sizeof(asset_slot_t));
+    slot->generation = generation;
+    slot->next_free = store->free_head;
+    store->free_head = index;
+}
+
+static void asset_store_acquire(asset_store_t *store, asset_handle_t handle){
+    asset_slot_t *slot = asset_slot(store, handle);
+    if (slot) slot->refcount++;
+}
+
+static void asset_store_release(asset_store_t *store, asset_handle_t handle){
+    asset_slot_t *slot = asset_slot(store, handle);
+    if (!slot || slot->refcount <= 0) return;
+    if (--slot->refcount > 0) return;
+    if (store->released_count == store->released_capacity) {
+        int32_t capacity = store->released_capacity ? store->released_capacity * 2 : 64;
+        int32_t *released = ecs_os_realloc(store->released, sizeof(int32_t) * (size_t)capacity);
+        if (!released) return; // stays loaded until the store goes
+        store->released = released;
+        store->released_capacity = capacity;
+    }
+    store->released[store->released_count++] = (int32_t)(slot - store->slots);
+}
+
+// released slots nobody picked up again, loading ones are freed when their job is back
+static void asset_collect_released(asset_store_t *store){
+    for (int32_t i = 0; i < store->released_count; i++) {
+        asset_slot_t *slot = &store->slots[store->released[i]];
+        if (slot->in_use && slot->refcount == 0 && slot->state != ASSET_LOADING) asset_slot_free(store, store->released[i]);
+    }
+    store->released_count = 0;
+}
+
+static void asset_store_free(void *ptr){
+    asset_store_t *store = ptr;
+    if (!store) return;
+    // jobs that did not start would be dropped by job_pool_fini
+    job_pool_wait(&store->pool);
+    job_pool_fini(&store->pool);
+    ecs_os_mutex_free(store->lock);
+    asset_job_t *job = store->done_head;
+    while (job) {
+        asset_job_t *next = job->next;
+        asset_job_free(job);
+        job = next;
+    }
+    for (int32_t i = 0; i < store->slot_count; i++) {
+        if (store->slots[i].in_use) asset_slot_free(store, i);
+    }
+    ecs_os_free(store->slots);
+    ecs_os_free(store->released);
+    ecs_map_fini(&store->lookup);
+    ecs_os_free(store);
+}
+
+static asset_store_t *asset_store_get(ecs_world_t *world){
+    const asset_manager_t *manager = ecs_singleton_get(world, asset_manager_t);
+    return manager ? manager->store : NULL;
+}
+
+//===============================================
+// DECODE (workers)
+//===============================================
+// IsFileExtension lowers into a static buffer, not safe on the workers
+static bool asset_has_extension(const char *path, const char *extension){
+    const char *dot = strrchr(path, '.');
+    if (!dot) return false;
+    size_t i = 0;
+    for (; dot[i] && extension[i]; i++) {
+        if (tolower((unsigned char)dot[i]) != extension[i]) return false;
+    }
+    return dot[i] == '\0' && extension[i] == '\0';
+}
+
+// a relative uri is next to the gltf
+static bool asset_gltf_uri_path(const char *gltf_path, const char *uri, char *path, size_t path_size){
+    const char *slash = strrchr(gltf_path, '/');
+    const char *backslash = strrchr(gltf_path, '\\');
+    if (backslash > slash) slash = backslash;
+    int dir = slash ? (int)(slash - gltf_path + 1) : 0;
+    return snprintf(path, path_size, "%.*s%s", dir, gltf_path, uri) < (int)path_size;
+}
+
+// embedded (buffer view or data uri) or a file next to the gltf
+static Image asset_gltf_image(const cgltf_image *image, const char *gltf_path){
+    Image result = { 0 };
+    const char *type = (image->mime_type && strstr(image->mime_type, "jpeg")) ? ".jpg" : ".png";
+    if (image->buffer_view) {
+        const uint8_t *data = cgltf_buffer_view_data(image->buffer_view);
+        if (data) result = LoadImageFromMemory(type, data, (int)image->buffer_view->size);
+    } else if (image->uri && strncmp(image->uri, "data:", 5) == 0) {
+        const char *base64 = strchr(image->uri, ',');
+        if (!base64) return result;
+        base64++;
+        size_t length = strlen(base64);
+        size_t padding = 0;
+        while (padding < 2 && length > padding && base64[length - 1 - padding] == '=') padding++;
+        size_t size = length * 3 / 4 - padding;
+        cgltf_options options = { 0 };
+        void *data = NULL;
+        if (cgltf_load_buffer_base64(&options, size, base64, &data) == cgltf_result_success) {
+            if (image->mime_type == NULL && strncmp(image->uri, "data:image/jpeg", 15) == 0) type = ".jpg";
+            result = LoadImageFromMemory(type, data, (int)size);
+            MemFree(data);
+        }
+    } else if (image->uri) {
+        char path[1024];
+        if (asset_gltf_uri_path(gltf_path, image->uri, path, sizeof(path))) result = LoadImage(path);
+    }
+    return result;
+}
+
+static float *asset_gltf_floats(const cgltf_accessor *accessor, int32_t components, cgltf_size count){
+    if (!accessor || accessor->count != count || cgltf_num_components(accessor->type) != (cgltf_size)components) return NULL;
+    float *values = MemAlloc((unsigned int)(sizeof(float) * (size_t)components * count));
+    if (values) cgltf_accessor_unpack_floats(accessor, values, (cgltf_size)components * count);
+    return values;
+}
+
+// triangle primitives of every node with a mesh, node transforms baked in
+static bool asset_decode_gltf(const char *path, asset_decoded_t *decoded){
+    cgltf_options options = { 0 };
+    cgltf_data *data = NULL;
+    if (cgltf_parse_file(&options, path, &data) != cgltf_result_success) return false;
+    if (cgltf_load_buffers(&options, data, path) != cgltf_result_success) {
+        cgltf_free(data);
+        return false;
+    }
+
+    decoded->material_count = (int32_t)data->materials_count + 1;
+    decoded->material_images = MemAlloc((unsigned int)(sizeof(Image) * (size_t)decoded->material_count));
+    decoded->material_colors = MemAlloc((unsigned int)(sizeof(Color) * (size_t)decoded->material_count));
+    int32_t primitives = 0;
+    for (cgltf_size n = 0; n < data->nodes_count; n++) {
+        if (data->nodes[n].mesh) primitives += (int32_t)data->nodes[n].mesh->primitives_count;
+    }
+    decoded->meshes = primitives ? MemAlloc((unsigned int)(sizeof(Mesh) * (size_t)primitives)) : NULL;
+    decoded->mesh_materials = primitives ? MemAlloc((unsigned int)(sizeof(int) * (size_t)primitives)) : NULL;
+    if (!decoded->material_images || !decoded->material_colors || (primitives && (!decoded->meshes || !decoded->mesh_materials))) {
+        cgltf_free(data);
+        return false;
+    }
+
+    decoded->material_colors[0] = WHITE;
+    for (cgltf_size m = 0; m < data->materials_count; m++) {
+        const cgltf_material *material = &data->materials[m];
+        Color color = WHITE;
+        if (material->has_pbr_metallic_roughness) {
+            const cgltf_float *factor = material->pbr_metallic_roughness.base_color_factor;
+            color = (Color){ (unsigned char)(factor[0] * 255.0f), (unsigned char)(factor[1] * 255.0f),
+                             (unsigned char)(factor[2] * 255.0f), (unsigned char)(factor[3] * 255.0f) };
+            const cgltf_texture *texture = material->pbr_metallic_roughness.base_color_texture.texture;
+            if (texture && texture->image) decoded->material_images[m + 1] = asset_gltf_image(texture->image, path);
+        }
+        decoded->material_colors[m + 1] = color;
+    }
+
+    for (cgltf_size n = 0; n < data->nodes_count; n++) {
+        const cgltf_node *node = &data->nodes[n];
+        if (!node->mesh) continue;
+        float w[16];
+        cgltf_node_transform_world(node, w);
+        Matrix transform = {
+            w[0], w[4], w[8], w[12],
+            w[1], w[5], w[9], w[13],
+            w[2], w[6], w[10], w[14],
+            w[3], w[7], w[11], w[15]
+        };
+        Matrix normal_transform = MatrixTranspose(MatrixInvert(transform));
+        for (cgltf_size p = 0; p < node->mesh->primitives_count; p++) {
+            const cgltf_primitive *primitive = &node->mesh->primitives[p];
+            if (primitive->type != cgltf_primitive_type_triangles) continue;
+            const cgltf_accessor *positions = NULL, *normals = NULL, *texcoords = NULL;
+            for (cgltf_size a = 0; a < primitive->attributes_count; a++) {
+                const cgltf_attribute *attribute = &primitive->attributes[a];
+                if (attribute->type == cgltf_attribute_type_position) positions = attribute->data;
+                else if (attribute->type == cgltf_attribute_type_normal) normals = attribute->data;
+                else if (attribute->type == cgltf_attribute_type_texcoord && attribute->index == 0) texcoords = attribute->data;
+            }
+            // raylib meshes have 16 bit indices
+            if (!positions || positions->count == 0 || positions->count > 65535) continue;
+            cgltf_size count = positions->count;
+
+            Mesh mesh = { 0 };
+            mesh.vertexCount = (int)count;
+            mesh.vertices = asset_gltf_floats(positions, 3, count);
+            mesh.normals = asset_gltf_floats(normals, 3, count);
+            mesh.texcoords = asset_gltf_floats(texcoords, 2, count);
+            if (!mesh.vertices) {
+                asset_mesh_free(&mesh);
+                continue;
+            }
+            for (cgltf_size v = 0; v < count; v++) {
+                Vector3 *position = (Vector3 *)&mesh.vertices[v * 3];
+                *position = Vector3Transform(*position, transform);
+                if (!mesh.normals) continue;
+                Vector3 *normal = (Vector3 *)&mesh.normals[v * 3];
+                Vector3 n3 = {
+                    normal_transform.m0 * normal->x + normal_transform.m4 * normal->y + normal_transform.m8 * normal->z,
+                    normal_transform.m1 * normal->x + normal_transform.m5 * normal->y + normal_transform.m9 * normal->z,
+                    normal_transform.m2 * normal->x + normal_transform.m6 * normal->y + normal_transform.m10 * normal->z
+                };
+                *normal = Vector3Normalize(n3);
+            }
+            if (primitive->indices) {
+                cgltf_size index_count = primitive->indices->count;
+                mesh.indices = MemAlloc((unsigned int)(sizeof(unsigned short) * index_count));
+                if (!mesh.indices) {
+                    asset_mesh_free(&mesh);
+                    continue;
+                }
+                for (cgltf_size i = 0; i < index_count; i++) {
+                    cgltf_size index = cgltf_accessor_read_index(primitive->indices, i);
+                    mesh.indices[i] = (unsigned short)(index < count ? index : 0);
+                }
+                mesh.triangleCount = (int)(index_count / 3);
+            } else {
+                mesh.triangleCount = (int)(count / 3);
+            }
+            int32_t slot = decoded->mesh_count++;
+            decoded->meshes[slot] = mesh;
+            decoded->mesh_materials[slot] = primitive->material ? (int)cgltf_material_index(data, primitive->material) + 1 : 0;
+        }
+    }
+    cgltf_free(data);
+    return decoded->mesh_count > 0;
+}
+
+static void asset_decode_done(asset_job_t *job);
+
+//===============================================
+// COOKED CACHE (workers)
+//===============================================
+static bool asset_cookable(const asset_job_t *job){
+    if (!job->store->cook || !job->path) return false;
+    if (job->kind == ASSET_IMAGE || job->kind == ASSET_TEXTURE) return true;
+    return job->kind == ASSET_MODEL && (asset_has_extension(job->path, ".gltf") || asset_has_extension(job->path, ".glb"));
+}
+
+// path, size and modification time of the external buffers and images, so
+// editing a .bin or a texture next to the gltf cooks it again
+static uint64_t asset_gltf_files_hash(const char *path, const void *source, size_t size, uint64_t hash){
+    cgltf_options options = { 0 };
+    cgltf_data *data = NULL;
+    if (cgltf_parse(&options, source, size, &data) != cgltf_result_success) return hash;
+    cgltf_size count = data->buffers_count + data->images_count;
+    for (cgltf_size i = 0; i < count; i++) {
+        const char *uri = i < data->buffers_count ? data->buffers[i].uri : data->images[i - data->buffers_count].uri;
+        if (!uri || strncmp(uri, "data:", 5) == 0) continue;
+        char file[1024];
+        if (!asset_gltf_uri_path(path, uri, file, sizeof(file))) continue;
+        int64_t stamp[2] = { FileExists(file) ? GetFileLength(file) : -1, (int64_t)GetFileModTime(file) };
+        hash = (hash ^ asset_cook_hash(file, strlen(file))) * 1099511628211ull;
+        hash = (hash ^ asset_cook_hash(stamp, sizeof(stamp))) * 1099511628211ull;
+    }
+    cgltf_free(data);
+    return hash;
+}
+
+static bool asset_source_hash(const asset_job_t *job, uint64_t *hash, uint64_t *size){
+    file_map_t map;
+    if (!file_map_open(&map, job->path)) return false;
+    *hash = asset_cook_hash(map.data, map.size);
+    *size = map.size;
+    if (job->kind == ASSET_MODEL) *hash = asset_gltf_files_hash(job->path, map.data, map.size, *hash);
+    file_map_close(&map);
+    return true;
+}
+
+static bool asset_mesh_copy(Mesh *dst, const Mesh *src){
+    memset(dst, 0, sizeof(Mesh));
+    dst->vertexCount = src->vertexCount;
+    dst->triangleCount = src->triangleCount;
+    size_t floats = sizeof(float) * (size_t)src->vertexCount;
+    dst->vertices = MemAlloc((unsigned int)(floats * 3));
+    if (src->normals) dst->normals = MemAlloc((unsigned int)(floats * 3));
+    if (src->texcoords) dst->texcoords = MemAlloc((unsigned int)(floats * 2));
+    if (src->indices) dst->indices = MemAlloc((unsigned int)(sizeof(unsigned short) * (size_t)src->triangleCount * 3));
+    if (!dst->vertices || (src->normals && !dst->normals) || (src->texcoords && !dst->texcoords) || (src->indices && !dst->indices)) {
+        asset_mesh_free(dst);
+        return false;
+    }
+    memcpy(dst->vertices, src->vertices, floats * 3);
+    if (src->normals) memcpy(dst->normals, src->normals, floats * 3);
+    if (src->texcoords) memcpy(dst->texcoords, src->texcoords, floats * 2);
+    if (src->indices) memcpy(dst->indices, src->indices, sizeof(unsigned short) * (size_t)src->triangleCount * 3);
+    return true;
+}
+
+// model meshes and images are copied out so the slot owns them like a
+// decoded one, texture pixels are uploaded from the mapping and it is
+// closed with the job
+static bool asset_cook_load(asset_job_t *job, const char *cook_path, uint64_t source_hash, uint64_t source_size){
+    asset_decoded_t *decoded = &job->decoded;
+    asset_cook_t *cook = &decoded->cook;
+    if (!asset_cook_open(cook, cook_path, (uint32_t)job->kind, job->hash, source_hash, source_size)) return false;
+    const asset_cook_header_t *header = cook->header;
+
+    if (job->kind != ASSET_MODEL) {
+        Image image = header->image_count == 1 ? asset_cook_image(cook, 0, NULL) : (Image){ 0 };
+        if (image.data && job->kind == ASSET_IMAGE) decoded->image = ImageCopy(image);
+        else if (image.data) decoded->image = image;
+        if (job->kind == ASSET_IMAGE || !decoded->image.data) asset_cook_close(cook);
+        return decoded->image.data != NULL;
+    }
+
+    bool ok = header->image_count > 0 && header->mesh_count > 0;
+    decoded->material_count = (int32_t)header->image_count;
+    decoded->material_images = ok ? MemAlloc((unsigned int)(sizeof(Image) * header->image_count)) : NULL;
+    decoded->material_colors = ok ? MemAlloc((unsigned int)(sizeof(Color) * header->image_count)) : NULL;
+    decoded->meshes = ok ? MemAlloc((unsigned int)(sizeof(Mesh) * header->mesh_count)) : NULL;
+    decoded->mesh_materials = ok ? MemAlloc((unsigned int)(sizeof(int) * header->mesh_count)) : NULL;
+    ok = decoded->material_images && decoded->material_colors && decoded->meshes && decoded->mesh_materials;
+    for (int32_t i = 0; ok && i < decoded->material_count; i++) {
+        Image image = asset_cook_image(cook, i, &decoded->material_colors[i]);
+        if (image.data) decoded->material_images[i] = ImageCopy(image);
+    }
+    for (int32_t i = 0; ok && i < (int32_t)header->mesh_count; i++) {
+        Mesh mesh = asset_cook_mesh(cook, i, &decoded->mesh_materials[i]);
+        ok = asset_mesh_copy(&decoded->meshes[i], &mesh);
+        if (ok) decoded->mesh_count++;
+    }
+    asset_cook_close(cook);
+    if (!ok) asset_decoded_free(decoded);
+    return ok;
+}
+
+// a write that fails leaves the asset as decoded, it is cooked on a later run
+static void asset_cook_save(asset_job_t *job, const char *cook_path, uint64_t source_hash, uint64_t source_size){
+    const asset_decoded_t *decoded = &job->decoded;
+    if (job->kind == ASSET_MODEL) {
+        asset_cook_write(cook_path, (uint32_t)job->kind, job->hash, source_hash, source_size,
+            decoded->material_images, decoded->material_colors, decoded->material_count,
+            decoded->meshes, decoded->mesh_materials, decoded->mesh_count);
+    } else {
+        asset_cook_write(cook_path, (uint32_t)job->kind, job->hash, source_hash, source_size,
+            &decoded->image, NULL, 1, NULL, NULL, 0);
+    }
+}
+
+static void asset_decode_job(void *data){
+    asset_job_t *job = data;
+    asset_decoded_t *decoded = &job->decoded;
+    char cook_path[256];
+    uint64_t source_hash = 0;
+    uint64_t source_size = 0;
+    bool cookable = asset_cookable(job) && asset_cook_path(cook_path, sizeof(cook_path), job->hash)
+        && asset_source_hash(job, &source_hash, &source_size);
+    if (cookable && asset_cook_load(job, cook_path, source_hash, source_size)) {
+        decoded->cached = true;
+        decoded->ok = true;
+        asset_decode_done(job);
+        return;
+    }
+
+    switch (job->kind) {
+    case ASSET_IMAGE:
+        decoded->image = LoadImage(job->path);
+        decoded->ok = decoded->image.data != NULL;
+        break;
+    case ASSET_TEXTURE:
+        decoded->image = LoadImage(job->path);
+        if (decoded->image.data) ImageMipmaps(&decoded->image);
+        decoded->ok = decoded->image.data != NULL;
+        break;
+    case ASSET_MODEL:
+        // anything else goes through LoadModel on the main thread
+        if (asset_has_extension(job->path, ".gltf") || asset_has_extension(job->path, ".glb")) {
+            decoded->ok = asset_decode_gltf(job->path, decoded);
+        } else {
+            decoded->ok = true;
+        }
+        break;
+    case ASSET_SHADER:
+        decoded->vs = job->path ? LoadFileText(job->path) : NULL;
+        decoded->fs = job->fs_path ? LoadFileText(job->fs_path) : NULL;
+        decoded->ok = (!job->path || decoded->vs) && (!job->fs_path || decoded->fs);
+        break;
+    default:
+        break;
+    }
+    if (cookable && decoded->ok && (job->kind != ASSET_MODEL || decoded->meshes)) {
+        asset_cook_save(job, cook_path, source_hash, source_size);
+    }
+    asset_decode_done(job);
+}
+
+static void asset_decode_done(asset_job_t *job){
+    asset_store_t *store = job->store;
+    ecs_os_mutex_lock(store->lock);
+    job->next = NULL;
+    if (store->done_tail) store->done_tail->next = job;
+    else store->done_head = job;
+    store->done_tail = job;
+    ecs_os_mutex_unlock(store->lock);
+}
+
+//===============================================
+// UPLOAD (main thread)
+//===============================================
+static asset_job_t *asset_pop_done(asset_store_t *store){
+    ecs_os_mutex_lock(store->lock);
+    asset_job_t *job = store->done_head;
+    if (job) {
+        store->done_head = job->next;
+        if (!store->done_head) store->done_tail = NULL;
+    }
+    ecs_os_mutex_unlock(store->lock);
+    return job;
+}
+
+static Model *asset_model_upload(asset_decoded_t *decoded){
+    Model *model = MemAlloc(sizeof(Model));
+    Material *materials = MemAlloc((unsigned int)(sizeof(Material) * (size_t)decoded->material_count));
+    if (!model || !materials) {
+        MemFree(model);
+        MemFree(materials);
+        return NULL;
+    }
+    for (int32_t m = 0; m < decoded->material_count; m++) {
+        materials[m] = LoadMaterialDefault();
+        materials[m].maps[MATERIAL_MAP_DIFFUSE].color = decoded->material_colors[m];
+        if (decoded->material_images[m].data) {
+            Texture2D texture = LoadTextureFromImage(decoded->material_images[m]);
+            if (texture.id != 0) materials[m].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+        }
+    }
+    for (int32_t i = 0; i < decoded->mesh_count; i++) UploadMesh(&decoded->meshes[i], false);
+    model->transform = MatrixIdentity();
+    model->meshCount = decoded->mesh_count;
+    model->meshes = decoded->meshes;
+    model->meshMaterial = decoded->mesh_materials;
+    model->materialCount = decoded->material_count;
+    model->materials = materials;
+    // the model owns the meshes now, UnloadModel frees them
+    decoded->meshes = NULL;
+    decoded->mesh_materials = NULL;
+    decoded->mesh_count = 0;
+    return model;
+}
+
+static bool asset_upload(asset_slot_t *slot, asset_job_t *job){
+    asset_decoded_t *decoded = &job->decoded;
+    if (!decoded->ok) return false;
+    switch (job->kind) {
+    case ASSET_IMAGE:
+        slot->image = decoded->image;
+        decoded->image = (Image){ 0 };
+        return true;
+    case ASSET_TEXTURE:
+        slot->texture = LoadTextureFromImage(decoded->image);
+        if (slot->texture.id != 0) {
+            SetTextureFilter(slot->texture, slot->texture.mipmaps > 1 ? TEXTURE_FILTER_TRILINEAR : TEXTURE_FILTER_BILINEAR);
+        }
+        return slot->texture.id != 0;
+    case ASSET_MODEL:
+        if (decoded->meshes) {
+            slot->model = asset_model_upload(decoded);
+        } else {
+            Model model = LoadModel(job->path);
+            if (model.meshCount > 0) {
+                slot->model = MemAlloc(sizeof(Model));
+                if (slot->model) *slot->model = model;
+                else UnloadModel(model);
+            }
+        }
+        return slot->model != NULL;
+    case ASSET_SHADER:
+        slot->shader = LoadShaderFromMemory(decoded->vs, decoded->fs);
+        // a failed compile falls back to the default shader
+        if (slot->shader.id == rlGetShaderIdDefault() && (decoded->vs || decoded->fs)) {
+            slot->shader = (Shader){ 0 };
+            return false;
+        }
+        return slot->shader.id != 0;
+    default:
+        return false;
+    }
+}
+
+// true when something went to the gpu
+static bool asset_finish_job(asset_store_t *store, asset_job_t *job){
+    store->jobs_in_flight--;
+    asset_slot_t *slot = &store->slots[job->index];
+    bool uploaded = false;
+    if (slot->in_use && slot->generation == job->generation) {
+        if (slot->refcount == 0) {
+            // released while it was decoding
+            asset_slot_free(store, job->index);
+        } else {
+            if (job->decoded.cached) store->cache_hits++;
+            bool ok = asset_upload(slot, job);
+            slot->state = ok ? ASSET_READY : ASSET_FAILED;
+            if (ok) store->ready++;
+            else store->failed++;
+            if (!ok) TraceLog(LOG_WARNING, "ASSET: could not load %s", slot->key);
+            uploaded = true;
+        }
+    }
+    asset_job_free(job);
+    return uploaded;
+}
+
+static void asset_manager_stats(asset_manager_t *manager, const asset_store_t *store){
+    manager->loading = store->jobs_in_flight;
+    manager->ready = store->ready;
+    manager->failed = store->failed;
+    manager->cache_hits = store->cache_hits;
+}
+
+//===============================================
+// API
+//===============================================
+// decode on a worker for the slot, the upload pass fills it in
+static void asset_submit(asset_store_t *store, int32_t index, asset_job_t *job, const char *path, const char *fs_path){
+    const asset_slot_t *slot = &store->slots[index];
+    job->store = store;
+    job->index = index;
+    job->generation = slot->generation;
+    job->kind = slot->kind;
+    job->hash = slot->hash;
+    job->path = path ? ecs_os_strdup(path) : NULL;
+    job->fs_path = fs_path ? ecs_os_strdup(fs_path) : NULL;
+    store->jobs_in_flight++;
+    if (!job_pool_submit(&store->pool, asset_decode_job, job)) asset_decode_job(job);
+}
+
+static asset_handle_t asset_request(ecs_world_t *world, asset_kind_t kind, const char *key, const char *path, const char *fs_path){
+    asset_store_t *store = asset_store_get(world);
+    if (!store || !key) return 0;
+    uint64_t hash = asset_hash(kind, key);
+    int32_t index = asset_find(store, kind, key, hash);
+    if (index >= 0) {
+        asset_slot_t *slot = &store->slots[index];
+        slot->refcount++;
+        // a failed load is a miss, the file may be there by now
+        if (slot->state == ASSET_FAILED) {
+            asset_job_t *job = ecs_os_calloc(sizeof(asset_job_t));
+            if (job) {
+                store->failed--;
+                slot->state = ASSET_LOADING;
+                asset_submit(store, index, job, path, fs_path);
+            }
+        }
+        return asset_handle(store, index);
+    }
+
+    asset_job_t *job = ecs_os_calloc(sizeof(asset_job_t));
+    char *key_copy = ecs_os_strdup(key);
+    index = job && key_copy ? asset_slot_new(store) : -1;
+    if (index < 0) {
+        ecs_os_free(job);
+        ecs_os_free(key_copy);
+        return 0;
+    }
+    asset_slot_t *slot = &store->slots[index];
+    slot->key = key_copy;
+    slot->hash = hash;
+    slot->kind = kind;
+    slot->state = ASSET_LOADING;
+    slot->refcount = 1;
+    slot->in_use = true;
+    if (!ecs_map_get(&store->lookup, hash)) ecs_map_insert(&store->lookup, hash, (ecs_map_val_t)index);
+    asset_submit(store, index, job, path, fs_path);
+    return asset_handle(store, index);
+}
+
+asset_handle_t asset_load(ecs_world_t *world, asset_kind_t kind, const char *path){
+    if (kind == ASSET_SHADER) return asset_load_shader(world, path, NULL);
+    return asset_request(world, kind, path, path, NULL);
+}
+
+asset_handle_t asset_load_shader(ecs_world_t *world, const char *vs_path, const char *fs_path){
+    char key[2048];
+    if (snprintf(key, sizeof(key), "%s\n%s", vs_path ? vs_path : "", fs_path ? fs_path : "") >= (int)sizeof(key)) return 0;
+    return asset_request(world, ASSET_SHADER, key, vs_path, fs_path);
+}
+
+void asset_acquire(ecs_world_t *world, asset_handle_t handle){
+    asset_store_acquire(asset_store_get(world), handle);
+}
+
+void asset_release(ecs_world_t *world, asset_handle_t handle){
+    asset_store_release(asset_store_get(world), handle);
+}
+
+asset_state_t asset_state(ecs_world_t *world, asset_handle_t handle){
+    const asset_slot_t *slot = asset_slot(asset_store_get(world), handle);
+    return slot ? slot->state : ASSET_NONE;
+}
+
+const Image *asset_image(ecs_world_t *world, asset_handle_t handle){
+    const asset_slot_t *slot = asset_slot(asset_store_get(world), handle);
+    return slot && slot->state == ASSET_READY && slot->image.data ? &slot->image : NULL;
+}
+
+Texture2D asset_texture(ecs_world_t *world, asset_handle_t handle){
+    const asset_slot_t *slot = asset_slot(asset_store_get(world), handle);
+    return slot && slot->state == ASSET_READY ? slot->texture : (Texture2D){ 0 };
+}
+
+Model *asset_model(ecs_world_t *world, asset_handle_t handle){
+    const asset_slot_t *slot = asset_slot(asset_store_get(world), handle);
+    return slot && slot->state == ASSET_READY ? slot->model : NULL;
+}
+
+Shader asset_shader(ecs_world_t *world, asset_handle_t handle){
+    const asset_slot_t *slot = asset_slot(asset_store_get(world), handle);
+    return slot && slot->state == ASSET_READY ? slot->shader : (Shader){ 0 };
+}
+
+void asset_wait_all(ecs_world_t *world){
+    asset_manager_t *manager = ecs_singleton_get_mut(world, asset_manager_t);
+    if (!manager || !manager->store) return;
+    asset_store_t *store = manager->store;
+    while (store->jobs_in_flight > 0) {
+        job_pool_wait(&store->pool);
+        asset_job_t *job;
+        while ((job = asset_pop_done(store)) != NULL) asset_finish_job(store, job);
+    }
+    asset_collect_released(store);
+    asset_manager_stats(manager, store);
+}
+
+//===============================================
+// SYSTEMS
+//===============================================
+// decoded assets go to the gpu until the time or count budget is used
+void asset_upload_system(ecs_iter_t *it){
+    asset_manager_t *manager = ecs_field(it, asset_manager_t, 0);
+    asset_store_t *store = manager->store;
+    if (!store) return;
+    asset_collect_released(store);
+    double start = GetTime();
+    int32_t uploads = 0;
+    while (uploads < manager->upload_max && (GetTime() - start) * 1000.0 < manager->upload_budget_ms) {
+        asset_job_t *job = asset_pop_done(store);
+        if (!job) break;
+        if (asset_finish_job(store, job)) uploads++;
+    }
+    manager->uploads_last_frame = uploads;
+    manager->upload_ms_last_frame = (float)((GetTime() - start) * 1000.0);
+    asset_manager_stats(manager, store);
+}
+
+// ModelComponent as soon as the model is uploaded
+void model_asset_system(ecs_iter_t *it){
+    model_asset_t *asset = ecs_field(it, model_asset_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        Model *model = asset_model(it->world, asset[i].handle);
+        if (model) ecs_set(it->world, it->entities[i], ModelComponent, { model });
+    }
+}
+
+void on_remove_model_asset(ecs_iter_t *it){
+    for (int i = 0; i < it->count; i++) {
+        ecs_remove(it->world, it->entities[i], ModelComponent);
+    }
+}
+
+// model_asset_t hooks keep the asset refcount like the block_t hooks
+static void model_asset_t_ctor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    memset(ptr, 0, sizeof(model_asset_t) * (size_t)count);
+}
+
+static void model_asset_t_dtor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    model_asset_t *asset = ptr;
+    for (int32_t i = 0; i < count; i++) asset_store_release(type_info->hooks.ctx, asset[i].handle);
+}
+
+static void model_asset_t_copy(void *dst_ptr, const void *src_ptr, int32_t count, const ecs_type_info_t *type_info){
+    model_asset_t *dst = dst_ptr;
+    const model_asset_t *src = src_ptr;
+    for (int32_t i = 0; i < count; i++) {
+        if (dst[i].handle == src[i].handle) continue;
+        asset_store_acquire(type_info->hooks.ctx, src[i].handle);
+        asset_store_release(type_info->hooks.ctx, dst[i].handle);
+        dst[i].handle = src[i].handle;
+    }
+}
+
+static void model_asset_t_move(void *dst_ptr, void *src_ptr, int32_t count, const ecs_type_info_t *type_info){
+    model_asset_t *dst = dst_ptr;
+    model_asset_t *src = src_ptr;
+    for (int32_t i = 0; i < count; i++) {
+        asset_store_release(type_info->hooks.ctx, dst[i].handle);
+        dst[i].handle = src[i].handle;
+        src[i].handle = 0;
+    }
+}
+
+void setup_systems_asset(ecs_world_t *world){
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "asset_upload_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .query.terms = {
+            { .id = ecs_id(asset_manager_t), .src.id = ecs_id(asset_manager_t) } // Singleton
+        },
+        .callback = asset_upload_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "model_asset_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .query.terms = {
+            { .id = ecs_id(model_asset_t), .inout = EcsIn },
+            { .id = ecs_id(ModelComponent), .oper = EcsNot }
+        },
+        .callback = model_asset_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(model_asset_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_model_asset
+    });
+}
+
+void setup_components_asset(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, asset_manager_t);
+    ECS_COMPONENT_DEFINE(world, model_asset_t);
+
+    asset_store_t *store = ecs_os_calloc(sizeof(asset_store_t));
+    if (!store) return;
+    store->free_head = -1;
+    store->cook = block_region_make_dir(ASSET_COOK_DIR);
+    // leave a core for the main thread
+    int32_t threads = job_pool_cpu_count() - 1;
+    if (threads > ASSET_MAX_THREADS) threads = ASSET_MAX_THREADS;
+    if (!job_pool_init(&store->pool, threads)) job_pool_init(&store->pool, 0);
+    store->lock = ecs_os_mutex_new();
+    ecs_map_init(&store->lookup, NULL);
+    // the hooks own the store so the last model_asset_t can still release into it
+    ecs_set_hooks(world, model_asset_t, {
+        .ctor = model_asset_t_ctor,
+        .dtor = model_asset_t_dtor,
+        .copy = model_asset_t_copy,
+        .move = model_asset_t_move,
+        .ctx = store,
+        .ctx_free = asset_store_free
+    });
+    ecs_singleton_set(world, asset_manager_t, {
+        .store = store,
+        .upload_budget_ms = ASSET_UPLOAD_BUDGET_MS,
+        .upload_max = ASSET_UPLOAD_MAX
+    });
+}
+
+void module_init_asset(ecs_world_t *world){
+    setup_components_asset(world);
+    setup_systems_asset(world);
+}
@@ -1,18 +1,1796 @@
 // module_block.c
 // for voxel blocks
+// chunks are meshed with hidden face culling and greedy quad merging. a
+// merged quad keeps texcoords in block units and the atlas tile index in
+// texcoords2, the block_atlas shader finds the tile and repeats it with
+// fract(), so meshes stay valid when the atlas is repacked.
+// dirty chunks are snapshotted on the main thread and meshed on the job
+// pool, finished meshes are uploaded within a per frame budget.
+// single block_t entities share one cube mesh per type and are drawn with
+// one instanced call per type.
+// chunk storage is a palette plus bit packed indices, compacted on save.
+// the stream system loads and evicts chunks around the camera and sets the
+// mesh detail per ring, the workers downsample far chunks before meshing.
+// chunks with nothing stored are generated on the same workers, noise in
+// block_noise.c, and packed there so the main thread only inserts them.
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "ecs_components.h"
 #include "module_block.h"
+#include "job_pool.h"
+#include "block_region.h"
+#include "block_noise.h"
+#include "block_atlas.h"
+#include "rlgl.h"
 
+ECS_COMPONENT_DECLARE(block_chunk_t);
+ECS_COMPONENT_DECLARE(block_world_t);
+ECS_COMPONENT_DECLARE(block_t);
+ECS_COMPONENT_DECLARE(block_stream_t);
+ECS_COMPONENT_DECLARE(block_generator_t);
+
+#define BLOCK_CHUNK_BITS 21
+#define BLOCK_CHUNK_LIMIT ((1 << (BLOCK_CHUNK_BITS - 1)) - 1)
+
+static ecs_query_t *block_instance_query = NULL;
+
+//===============================================
+// CHUNK STORAGE
+//===============================================
+static int32_t block_chunk_words(uint8_t bits){
+    return bits ? BLOCK_CHUNK_VOLUME * bits / 64 : 0;
+}
+
+static uint8_t block_bits_for(int32_t palette_count){
+    if (palette_count <= 1) return 0;
+    if (palette_count <= 2) return 1;
+    if (palette_count <= 4) return 2;
+    if (palette_count <= 16) return 4;
+    return 8;
+}
+
+static int64_t block_chunk_bytes(const block_chunk_t *chunk){
+    if (!chunk->palette) return 0;
+    return (int64_t)sizeof(block_id_t) * (1 << chunk->bits) + (int64_t)sizeof(uint64_t) * block_chunk_words(chunk->bits);
+}
+
+static uint32_t block_index_get(const uint64_t *data, uint8_t bits, int32_t index){
+    uint32_t bit = (uint32_t)index * bits;
+    return (uint32_t)(data[bit >> 6] >> (bit & 63)) & ((1u << bits) - 1);
+}
+
+static void block_index_put(uint64_t *data, uint8_t bits, int32_t index, uint32_t value){
+    uint32_t bit = (uint32_t)index * bits;
+    uint64_t mask = (((uint64_t)1 << bits) - 1) << (bit & 63);
+    data[bit >> 6] = (data[bit >> 6] & ~mask) | ((uint64_t)value << (bit & 63));
+}
+
+static block_id_t block_chunk_read(const block_chunk_t *chunk, int32_t index){
+    if (chunk->bits == 0) return chunk->palette ? chunk->palette[0] : BLOCK_AIR;
+    return chunk->palette[block_index_get(chunk->data, chunk->bits, index)];
+}
+
+// indices rewritten at a new width, remap NULL keeps the palette order
+static bool block_chunk_repack(block_chunk_t *chunk, uint8_t bits, const uint8_t *remap){
+    uint64_t *data = NULL;
+    if (bits > 0) {
+        data = ecs_os_calloc(sizeof(uint64_t) * block_chunk_words(bits));
+        if (!data) return false;
+        for (int32_t i = 0; i < BLOCK_CHUNK_VOLUME; i++) {
+            uint32_t value = chunk->bits ? block_index_get(chunk->data, chunk->bits, i) : 0;
+            block_index_put(data, bits, i, remap ? remap[value] : value);
+        }
+    }
+    ecs_os_free(chunk->data);
+    chunk->data = data;
+    chunk->bits = bits;
+    return true;
+}
+
+static bool block_chunk_write(block_chunk_t *chunk, int32_t index, block_id_t id){
+    if (!chunk->palette) {
+        chunk->palette = ecs_os_malloc(sizeof(block_id_t));
+        if (!chunk->palette) return false;
+        chunk->palette[0] = BLOCK_AIR;
+        chunk->palette_count = 1;
+        chunk->bits = 0;
+    }
+    int32_t entry = 0;
+    while (entry < chunk->palette_count && chunk->palette[entry] != id) entry++;
+    if (entry == chunk->palette_count) {
+        if (entry == (1 << chunk->bits)) {
+            uint8_t bits = block_bits_for(entry + 1);
+            block_id_t *palette = ecs_os_realloc(chunk->palette, sizeof(block_id_t) * (1 << bits));
+            if (!palette) return false;
+            chunk->palette = palette;
+            if (!block_chunk_repack(chunk, bits, NULL)) return false;
+        }
+        chunk->palette[chunk->palette_count++] = id;
+    }
+    if (chunk->bits > 0) block_index_put(chunk->data, chunk->bits, index, (uint32_t)entry);
+    return true;
+}
+
+// drops palette entries no block uses anymore and narrows the indices
+static void block_chunk_compact(block_chunk_t *chunk){
+    if (!chunk->palette || chunk->bits == 0) return;
+    int32_t used[BLOCK_MAX_TYPES] = {0};
+    for (int32_t i = 0; i < BLOCK_CHUNK_VOLUME; i++) used[block_index_get(chunk->data, chunk->bits, i)]++;
+    uint8_t remap[BLOCK_MAX_TYPES];
+    block_id_t palette[BLOCK_MAX_TYPES];
+    int32_t count = 0;
+    for (int32_t p = 0; p < chunk->palette_count; p++) {
+        if (!used[p]) continue;
+        remap[p] = (uint8_t)count;
+        palette[count++] = chunk->palette[p];
+    }
+    uint8_t bits = block_bits_for(count);
+    if (count == chunk->palette_count && bits == chunk->bits) return;
+    if (!block_chunk_repack(chunk, bits, remap)) return;
+    block_id_t *shrunk = ecs_os_realloc(chunk->palette, sizeof(block_id_t) * (1 << bits));
+    if (shrunk) chunk->palette = shrunk;
+    memcpy(chunk->palette, palette, sizeof(block_id_t) * count);
+    chunk->palette_count = (uint16_t)count;
+}
+
+static void block_chunk_free_storage(block_chunk_t *chunk){
+    ecs_os_free(chunk->palette);
+    ecs_os_free(chunk->data);
+    chunk->palette = NULL;
+    chunk->data = NULL;
+    chunk->palette_count = 0;
+    chunk->bits = 0;
+}
+
+static bool block_chunk_is_empty(const block_chunk_t *chunk){
+    return !chunk->palette || (chunk->palette_count == 1 && chunk->palette[0] == BLOCK_AIR);
+}
+
+// palette and indices for a whole chunk of ids in one pass, no world access
+static bool block_chunk_pack(block_chunk_t *chunk, const block_id_t ids[BLOCK_CHUNK_VOLUME], const block_type_t *types){
+    int16_t entry[BLOCK_MAX_TYPES];
+    memset(entry, -1, sizeof(entry));
+    block_id_t palette[BLOCK_MAX_TYPES];
+    int32_t count = 0;
+    int32_t solid = 0;
+    for (int32_t i = 0; i < BLOCK_CHUNK_VOLUME; i++) {
+        block_id_t id = ids[i];
+        if (entry[id] < 0) {
+            entry[id] = (int16_t)count;
+            palette[count++] = id;
+        }
+        solid += types[id].solid;
+    }
+    uint8_t bits = block_bits_for(count);
+    chunk->palette = ecs_os_malloc(sizeof(block_id_t) * (1 << bits));
+    chunk->data = bits ? ecs_os_calloc(sizeof(uint64_t) * block_chunk_words(bits)) : NULL;
+    if (!chunk->palette || (bits && !chunk->data)) {
+        block_chunk_free_storage(chunk);
+        return false;
+    }
+    memcpy(chunk->palette, palette, sizeof(block_id_t) * count);
+    if (bits > 0) {
+        for (int32_t i = 0; i < BLOCK_CHUNK_VOLUME; i++) block_index_put(chunk->data, bits, i, (uint32_t)entry[ids[i]]);
+    }
+    chunk->palette_count = (uint16_t)count;
+    chunk->bits = bits;
+    chunk->solid_count = solid;
+    return true;
+}
+
+// region payload: this header, the palette padded to 8 bytes, then the
+// packed words exactly as they are in memory
+typedef struct {
+    uint16_t palette_count;
+    uint8_t bits;
+    uint8_t reserved;
+    int32_t solid_count;
+} block_chunk_disk_t;
+
+static uint32_t block_chunk_disk_size(int32_t palette_count, uint8_t bits){
+    return (uint32_t)(sizeof(block_chunk_disk_t) + ((palette_count + 7) & ~7) + sizeof(uint64_t) * block_chunk_words(bits));
+}
+
+static uint8_t *block_chunk_serialize(const block_chunk_t *chunk, uint32_t *size){
+    *size = block_chunk_disk_size(chunk->palette_count, chunk->bits);
+    uint8_t *payload = ecs_os_calloc(*size);
+    if (!payload) return NULL;
+    block_chunk_disk_t header = { .palette_count = chunk->palette_count, .bits = chunk->bits, .solid_count = chunk->solid_count };
+    memcpy(payload, &header, sizeof(header));
+    memcpy(payload + sizeof(header), chunk->palette, sizeof(block_id_t) * chunk->palette_count);
+    if (chunk->bits > 0) {
+        memcpy(payload + block_chunk_disk_size(chunk->palette_count, 0), chunk->data, sizeof(uint64_t) * block_chunk_words(chunk->bits));
+    }
+    return payload;
+}
+
+static bool block_chunk_deserialize(block_chunk_t *chunk, const uint8_t *payload, uint32_t size){
+    block_chunk_disk_t header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, payload, sizeof(header));
+    if (header.palette_count == 0 || header.palette_count > BLOCK_MAX_TYPES) return false;
+    bool bits_valid = header.bits == 0 || header.bits == 1 || header.bits == 2 || header.bits == 4 || header.bits == 8;
+    if (!bits_valid || header.palette_count > (1 << header.bits)) return false;
+    if (size != block_chunk_disk_size(header.palette_count, header.bits)) return false;
+
+    chunk->palette = ecs_os_malloc(sizeof(block_id_t) * (1 << header.bits));
+    chunk->data = header.bits ? ecs_os_malloc(sizeof(uint64_t) * block_chunk_words(header.bits)) : NULL;
+    if (!chunk->palette || (header.bits && !chunk->data)) {
+        block_chunk_free_storage(chunk);
+        return false;
+    }
+    memcpy(chunk->palette, payload + sizeof(header), sizeof(block_id_t) * header.palette_count);
+    if (header.bits > 0) {
+        memcpy(chunk->data, payload + block_chunk_disk_size(header.palette_count, 0), sizeof(uint64_t) * block_chunk_words(header.bits));
+        // a corrupt index past the palette would read garbage ids
+        uint32_t limit = header.palette_count;
+        for (int32_t i = 0; i < BLOCK_CHUNK_VOLUME; i++) {
+            if (block_index_get(chunk->data, header.bits, i) >= limit) {
+                block_chunk_free_storage(chunk);
+                return false;
+            }
+        }
+    }
+    chunk->palette_count = header.palette_count;
+    chunk->bits = header.bits;
+    chunk->solid_count = header.solid_count;
+    return true;
+}
+
+//===============================================
+// CHUNK LOOKUP
+//===============================================
+static int32_t block_floor_div(int32_t v){
+    return v >= 0 ? v / BLOCK_CHUNK_SIZE : (v + 1) / BLOCK_CHUNK_SIZE - 1;
+}
+
+static uint64_t block_chunk_key(int32_t x, int32_t y, int32_t z){
+    const uint64_t mask = (1ULL << BLOCK_CHUNK_BITS) - 1;
+    return ((uint64_t)(x + BLOCK_CHUNK_LIMIT) & mask)
+        | (((uint64_t)(y + BLOCK_CHUNK_LIMIT) & mask) << BLOCK_CHUNK_BITS)
+        | (((uint64_t)(z + BLOCK_CHUNK_LIMIT) & mask) << (BLOCK_CHUNK_BITS * 2));
+}
+
+static int32_t block_index(int32_t x, int32_t y, int32_t z){
+    return x + z * BLOCK_CHUNK_SIZE + y * BLOCK_CHUNK_AREA;
+}
+
+static ecs_entity_t block_chunk_find(const block_world_t *bw, int32_t cx, int32_t cy, int32_t cz){
+    ecs_map_val_t *found = ecs_map_get(&bw->chunks, block_chunk_key(cx, cy, cz));
+    return found ? (ecs_entity_t)*found : 0;
+}
+
+static const block_chunk_t *block_chunk_get(const ecs_world_t *world, const block_world_t *bw, int32_t cx, int32_t cy, int32_t cz){
+    ecs_entity_t e = block_chunk_find(bw, cx, cy, cz);
+    return e ? ecs_get(world, e, block_chunk_t) : NULL;
+}
+
+static void block_mark_dirty(ecs_world_t *world, const block_world_t *bw, int32_t cx, int32_t cy, int32_t cz){
+    ecs_entity_t e = block_chunk_find(bw, cx, cy, cz);
+    if (!e) return;
+    block_chunk_t *chunk = ecs_ensure(world, e, block_chunk_t);
+    chunk->dirty = true;
+}
+
+// new chunk entity taking over the storage of a loaded or generated chunk
+static ecs_entity_t block_chunk_insert(ecs_world_t *world, block_world_t *bw, block_chunk_t *chunk){
+    int32_t cx = chunk->x, cy = chunk->y, cz = chunk->z;
+    chunk->dirty = true;
+    ecs_entity_t e = ecs_new(world);
+    ecs_map_insert(&bw->chunks, block_chunk_key(cx, cy, cz), (ecs_map_val_t)e);
+    bw->chunk_count++;
+    bw->chunk_bytes += block_chunk_bytes(chunk);
+    ecs_set_ptr(world, e, block_chunk_t, chunk);
+    // neighbour meshes were built with this chunk as air
+    block_mark_dirty(world, bw, cx - 1, cy, cz);
+    block_mark_dirty(world, bw, cx + 1, cy, cz);
+    block_mark_dirty(world, bw, cx, cy - 1, cz);
+    block_mark_dirty(world, bw, cx, cy + 1, cz);
+    block_mark_dirty(world, bw, cx, cy, cz - 1);
+    block_mark_dirty(world, bw, cx, cy, cz + 1);
+    return e;
+}
+
+//===============================================
+// REGION FILES
+//===============================================
+static int32_t block_region_div(int32_t v){
+    return v >= 0 ? v / BLOCK_REGION_SIZE : (v + 1) / BLOCK_REGION_SIZE - 1;
+}
+
+static void block_key_coords(uint64_t key, int32_t out[3]){
+    const uint64_t mask = (1ULL << BLOCK_CHUNK_BITS) - 1;
+    out[0] = (int32_t)(key & mask) - BLOCK_CHUNK_LIMIT;
+    out[1] = (int32_t)((key >> BLOCK_CHUNK_BITS) & mask) - BLOCK_CHUNK_LIMIT;
+    out[2] = (int32_t)((key >> (BLOCK_CHUNK_BITS * 2)) & mask) - BLOCK_CHUNK_LIMIT;
+}
+
+static void block_region_path(const block_world_t *bw, int32_t rx, int32_t ry, int32_t rz, char *path, size_t size){
+    snprintf(path, size, "%s/r.%d.%d.%d.blkr", bw->region_dir, (int)rx, (int)ry, (int)rz);
+}
+
+// opened on first use and kept mapped, a missing file is remembered as 0
+static block_region_t *block_region_get(block_world_t *bw, int32_t rx, int32_t ry, int32_t rz){
+    if (!bw->region_dir) return NULL;
+    uint64_t key = block_chunk_key(rx, ry, rz);
+    ecs_map_val_t *found = ecs_map_get(&bw->regions, key);
+    if (found) return (block_region_t *)(uintptr_t)*found;
+    char path[1024];
+    block_region_path(bw, rx, ry, rz, path, sizeof(path));
+    block_region_t *region = block_region_open(path);
+    ecs_map_insert(&bw->regions, key, (ecs_map_val_t)(uintptr_t)region);
+    return region;
+}
+
+static void block_regions_close(block_world_t *bw){
+    ecs_map_iter_t it = ecs_map_iter(&bw->regions);
+    while (ecs_map_next(&it)) {
+        block_region_close((block_region_t *)(uintptr_t)ecs_map_value(&it));
+    }
+    ecs_map_clear(&bw->regions);
+}
+
+static int32_t block_region_index(int32_t cx, int32_t cy, int32_t cz){
+    int32_t lx = cx - block_region_div(cx) * BLOCK_REGION_SIZE;
+    int32_t ly = cy - block_region_div(cy) * BLOCK_REGION_SIZE;
+    int32_t lz = cz - block_region_div(cz) * BLOCK_REGION_SIZE;
+    return lx + lz * BLOCK_REGION_SIZE + ly * BLOCK_REGION_SIZE * BLOCK_REGION_SIZE;
+}
+
+// stored payload of a chunk, NULL when its region has none
+static const uint8_t *block_chunk_payload(block_world_t *bw, int32_t cx, int32_t cy, int32_t cz, uint32_t *size){
+    block_region_t *region = block_region_get(bw, block_region_div(cx), block_region_div(cy), block_region_div(cz));
+    return region ? block_region_chunk(region, block_region_index(cx, cy, cz), size) : NULL;
+}
+
+// chunk entity from its stored payload, 0 when the region has none
+static ecs_entity_t block_chunk_load(ecs_world_t *world, block_world_t *bw, int32_t cx, int32_t cy, int32_t cz){
+    uint32_t size = 0;
+    const uint8_t *payload = block_chunk_payload(bw, cx, cy, cz, &size);
+    if (!payload) return 0;
+    block_chunk_t loaded = { .x = cx, .y = cy, .z = cz };
+    if (!block_chunk_deserialize(&loaded, payload, size)) return 0;
+    return block_chunk_insert(world, bw, &loaded);
+}
+
+bool block_world_open(ecs_world_t *world, const char *dir){
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw || !dir || !block_region_make_dir(dir)) return false;
+    block_regions_close(bw);
+    ecs_os_free(bw->region_dir);
+    bw->region_dir = ecs_os_strdup(dir);
+    bw->load_radius = 0;
+    return bw->region_dir != NULL;
+}
+
+// loaded chunks are written from memory, the others are copied from the
+// old mapping, so a region holds everything ever saved into it
+int32_t block_world_save(ecs_world_t *world){
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw || !bw->region_dir) return -1;
+
+    ecs_map_t pending;
+    ecs_map_init(&pending, NULL);
+    ecs_map_iter_t it = ecs_map_iter(&bw->chunks);
+    while (ecs_map_next(&it)) {
+        const block_chunk_t *chunk = ecs_get(world, (ecs_entity_t)ecs_map_value(&it), block_chunk_t);
+        if (chunk && chunk->modified) {
+            ecs_map_ensure(&pending, block_chunk_key(block_region_div(chunk->x), block_region_div(chunk->y), block_region_div(chunk->z)));
+        }
+    }
+
+    int32_t written = 0;
+    bool failed = false;
+    it = ecs_map_iter(&pending);
+    while (ecs_map_next(&it)) {
+        int32_t r[3];
+        block_key_coords(ecs_map_key(&it), r);
+        block_region_t *region = block_region_get(bw, r[0], r[1], r[2]);
+        const void *payloads[BLOCK_REGION_VOLUME] = {0};
+        uint32_t sizes[BLOCK_REGION_VOLUME] = {0};
+        uint8_t *owned[BLOCK_REGION_VOLUME] = {0};
+        block_chunk_t *chunks[BLOCK_REGION_VOLUME] = {0};
+        bool ok = true;
+        for (int32_t i = 0; i < BLOCK_REGION_VOLUME; i++) {
+            int32_t cx = r[0] * BLOCK_REGION_SIZE + i % BLOCK_REGION_SIZE;
+            int32_t cz = r[2] * BLOCK_REGION_SIZE + (i / BLOCK_REGION_SIZE) % BLOCK_REGION_SIZE;
+            int32_t cy = r[1] * BLOCK_REGION_SIZE + i / (BLOCK_REGION_SIZE * BLOCK_REGION_SIZE);
+            ecs_entity_t e = block_chunk_find(bw, cx, cy, cz);
+            if (!e) {
+                payloads[i] = block_region_chunk(region, i, &sizes[i]);
+                continue;
+            }
+            block_chunk_t *chunk = ecs_get_mut(world, e, block_chunk_t);
+            chunks[i] = chunk;
+            int64_t bytes = block_chunk_bytes(chunk);
+            block_chunk_compact(chunk);
+            bw->chunk_bytes += block_chunk_bytes(chunk) - bytes;
+            if (block_chunk_is_empty(chunk)) continue;
+            owned[i] = block_chunk_serialize(chunk, &sizes[i]);
+            payloads[i] = owned[i];
+            if (!owned[i]) ok = false;
+        }
+
+        char path[1024];
+        block_region_path(bw, r[0], r[1], r[2], path, sizeof(path));
+        ok = ok && block_region_save(&region, path, payloads, sizes);
+        *ecs_map_ensure(&bw->regions, ecs_map_key(&it)) = (ecs_map_val_t)(uintptr_t)region;
+        for (int32_t i = 0; i < BLOCK_REGION_VOLUME; i++) {
+            ecs_os_free(owned[i]);
+            if (ok && chunks[i]) chunks[i]->modified = false;
+        }
+        if (ok) written++;
+        else failed = true;
+    }
+    ecs_map_fini(&pending);
+    return failed ? -1 : written;
+}
+
+int32_t block_load_area(ecs_world_t *world, Vector3 position, int32_t radius){
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw || !bw->region_dir || radius <= 0) return 0;
+    // cells are shifted by half a block, block (x,y,z) is floor(p + 0.5)
+    int32_t cx = block_floor_div((int32_t)floorf(position.x + 0.5f));
+    int32_t cy = block_floor_div((int32_t)floorf(position.y + 0.5f));
+    int32_t cz = block_floor_div((int32_t)floorf(position.z + 0.5f));
+    if (bw->load_radius == radius && bw->load_x == cx && bw->load_y == cy && bw->load_z == cz) return 0;
+    bw->load_x = cx;
+    bw->load_y = cy;
+    bw->load_z = cz;
+    bw->load_radius = radius;
+
+    int32_t loaded = 0;
+    for (int32_t dy = -radius; dy <= radius; dy++)
+    for (int32_t dz = -radius; dz <= radius; dz++)
+    for (int32_t dx = -radius; dx <= radius; dx++) {
+        if (dx * dx + dy * dy + dz * dz > radius * radius) continue;
+        if (block_chunk_find(bw, cx + dx, cy + dy, cz + dz)) continue;
+        if (block_chunk_load(world, bw, cx + dx, cy + dy, cz + dz)) loaded++;
+    }
+    return loaded;
+}
+
+//===============================================
+// TERRAIN
+//===============================================
+static bool block_gen_covers(const block_generator_t *gen, int32_t cy){
+    // chunks above the highest possible surface stay air and are not created
+    return gen && gen->enabled && cy * BLOCK_CHUNK_SIZE <= (int32_t)ceilf(gen->base_height + fabsf(gen->height_scale));
+}
+
+// blocks of chunk x,y,z from the generator settings, no world access so it
+// runs on the workers
+static bool block_gen_fill(const block_generator_t *g, const block_type_t *types, block_chunk_t *chunk){
+    int32_t x0 = chunk->x * BLOCK_CHUNK_SIZE, y0 = chunk->y * BLOCK_CHUNK_SIZE, z0 = chunk->z * BLOCK_CHUNK_SIZE;
+    int32_t heights[BLOCK_CHUNK_AREA];
+    block_noise_heights(g->seed, x0, z0, BLOCK_CHUNK_SIZE, BLOCK_CHUNK_SIZE, g->frequency, g->octaves, g->base_height, g->height_scale, heights);
+    int32_t top = INT32_MIN;
+    for (int32_t i = 0; i < BLOCK_CHUNK_AREA; i++) if (heights[i] > top) top = heights[i];
+
+    // cave noise only for the layers that hold blocks, the rest is air anyway
+    uint8_t caves[BLOCK_CHUNK_VOLUME];
+    int32_t layers = top - y0 + 1;
+    if (layers > BLOCK_CHUNK_SIZE) layers = BLOCK_CHUNK_SIZE;
+    if (layers > 0 && g->cave_threshold < 1.0f) {
+        block_noise_mask3(g->seed ^ 0x5BD1E995u, x0, y0, z0, BLOCK_CHUNK_SIZE, layers, BLOCK_CHUNK_SIZE,
+                          g->cave_frequency, g->cave_octaves, g->cave_threshold, caves);
+    } else if (layers > 0) {
+        memset(caves, 0, BLOCK_CHUNK_AREA * layers);
+    }
+
+    block_id_t ids[BLOCK_CHUNK_VOLUME];
+    for (int32_t y = 0; y < BLOCK_CHUNK_SIZE; y++) {
+        for (int32_t i = 0; i < BLOCK_CHUNK_AREA; i++) {
+            int32_t index = i + y * BLOCK_CHUNK_AREA;
+            int32_t height = heights[i];
+            int32_t wy = y0 + y;
+            block_id_t id = BLOCK_AIR;
+            if (y < layers && wy <= height && !caves[index]) {
+                id = wy == height ? g->surface : (wy >= height - g->filler_depth ? g->filler : g->stone);
+            }
+            ids[index] = id;
+        }
+    }
+    return block_chunk_pack(chunk, ids, types);
+}
+
+// edits in a chunk that was never stored start from the generated blocks
+static ecs_entity_t block_chunk_generate(ecs_world_t *world, block_world_t *bw, int32_t cx, int32_t cy, int32_t cz){
+    const block_generator_t *gen = ecs_singleton_get(world, block_generator_t);
+    if (!block_gen_covers(gen, cy)) return 0;
+    block_chunk_t generated = { .x = cx, .y = cy, .z = cz };
+    if (!block_gen_fill(gen, bw->types, &generated)) return 0;
+    return block_chunk_insert(world, bw, &generated);
+}
+
+//===============================================
+// BLOCKS
+//===============================================
+block_id_t block_get(const ecs_world_t *world, int32_t x, int32_t y, int32_t z){
+    const block_world_t *bw = ecs_singleton_get(world, block_world_t);
+    if (!bw) return BLOCK_AIR;
+    int32_t cx = block_floor_div(x), cy = block_floor_div(y), cz = block_floor_div(z);
+    const block_chunk_t *chunk = block_chunk_get(world, bw, cx, cy, cz);
+    if (!chunk) return BLOCK_AIR;
+    return block_chunk_read(chunk, block_index(x - cx * BLOCK_CHUNK_SIZE, y - cy * BLOCK_CHUNK_SIZE, z - cz * BLOCK_CHUNK_SIZE));
+}
+
+// chunks are created on the first solid block, a stored chunk is loaded
+// first so the edit does not hide it. a border edit also dirties the neighbour
+void block_set(ecs_world_t *world, int32_t x, int32_t y, int32_t z, block_id_t id){
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw) return;
+    int32_t cx = block_floor_div(x), cy = block_floor_div(y), cz = block_floor_div(z);
+    int32_t lx = x - cx * BLOCK_CHUNK_SIZE, ly = y - cy * BLOCK_CHUNK_SIZE, lz = z - cz * BLOCK_CHUNK_SIZE;
+
+    ecs_entity_t e = block_chunk_find(bw, cx, cy, cz);
+    if (!e) e = block_chunk_load(world, bw, cx, cy, cz);
+    if (!e) e = block_chunk_generate(world, bw, cx, cy, cz);
+    if (!e) {
+        if (id == BLOCK_AIR) return;
+        e = ecs_new(world);
+        ecs_map_insert(&bw->chunks, block_chunk_key(cx, cy, cz), (ecs_map_val_t)e);
+        bw->chunk_count++;
+        block_chunk_t *created = ecs_ensure(world, e, block_chunk_t);
+        created->x = cx;
+        created->y = cy;
+        created->z = cz;
+    }
+    block_chunk_t *chunk = ecs_ensure(world, e, block_chunk_t);
+    int32_t index = block_index(lx, ly, lz);
+    block_id_t previous = block_chunk_read(chunk, index);
+    if (previous == id) return;
+    int64_t bytes = block_chunk_bytes(chunk);
+    if (!block_chunk_write(chunk, index, id)) return;
+    bw->chunk_bytes += block_chunk_bytes(chunk) - bytes;
+    bool was_solid = bw->types[previous].solid;
+    bool is_solid = bw->types[id].solid;
+    chunk->solid_count += (int32_t)is_solid - (int32_t)was_solid;
+    chunk->dirty = true;
+    chunk->modified = true;
+
+    if (lx == 0) block_mark_dirty(world, bw, cx - 1, cy, cz);
+    if (lx == BLOCK_CHUNK_SIZE - 1) block_mark_dirty(world, bw, cx + 1, cy, cz);
+    if (ly == 0) block_mark_dirty(world, bw, cx, cy - 1, cz);
+    if (ly == BLOCK_CHUNK_SIZE - 1) block_mark_dirty(world, bw, cx, cy + 1, cz);
+    if (lz == 0) block_mark_dirty(world, bw, cx, cy, cz - 1);
+    if (lz == BLOCK_CHUNK_SIZE - 1) block_mark_dirty(world, bw, cx, cy, cz + 1);
+}
+
+block_id_t block_register_type(ecs_world_t *world, const char *name, const int tiles[BLOCK_FACE_COUNT]){
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw || bw->type_count >= BLOCK_MAX_TYPES) return BLOCK_AIR;
+    block_id_t id = (block_id_t)bw->type_count++;
+    block_type_t *type = &bw->types[id];
+    type->name = name;
+    type->solid = true;
+    memcpy(type->tiles, tiles, sizeof(type->tiles));
+    return id;
+}
+
+//===============================================
+// MESHER
+//===============================================
+static int32_t block_padded_index(int32_t x, int32_t y, int32_t z){
+    return x + z * BLOCK_PADDED_SIZE + y * BLOCK_PADDED_SIZE * BLOCK_PADDED_SIZE;
+}
+
+// chunk copy with a one block border from the 26 neighbours, missing ones read as air
+void block_chunk_snapshot(const ecs_world_t *world, const block_chunk_t *chunk, block_id_t padded[BLOCK_PADDED_VOLUME]){
+    const block_world_t *bw = ecs_singleton_get(world, block_world_t);
+    const block_chunk_t *near[27] = {0};
+    for (int32_t dy = -1; dy <= 1; dy++)
+    for (int32_t dz = -1; dz <= 1; dz++)
+    for (int32_t dx = -1; dx <= 1; dx++) {
+        int32_t n = (dx + 1) + (dz + 1) * 3 + (dy + 1) * 9;
+        near[n] = (dx | dy | dz) == 0 ? chunk : (bw ? block_chunk_get(world, bw, chunk->x + dx, chunk->y + dy, chunk->z + dz) : NULL);
+    }
+
+    for (int32_t py = 0; py < BLOCK_PADDED_SIZE; py++)
+    for (int32_t pz = 0; pz < BLOCK_PADDED_SIZE; pz++)
+    for (int32_t px = 0; px < BLOCK_PADDED_SIZE; px++) {
+        int32_t lx = px - 1, ly = py - 1, lz = pz - 1;
+        int32_t dx = lx < 0 ? -1 : (lx >= BLOCK_CHUNK_SIZE ? 1 : 0);
+        int32_t dy = ly < 0 ? -1 : (ly >= BLOCK_CHUNK_SIZE ? 1 : 0);
+        int32_t dz = lz < 0 ? -1 : (lz >= BLOCK_CHUNK_SIZE ? 1 : 0);
+        const block_chunk_t *src = near[(dx + 1) + (dz + 1) * 3 + (dy + 1) * 9];
+        padded[block_padded_index(px, py, pz)] = src
+            ? block_chunk_read(src, block_index(lx - dx * BLOCK_CHUNK_SIZE, ly - dy * BLOCK_CHUNK_SIZE, lz - dz * BLOCK_CHUNK_SIZE))
+            : BLOCK_AIR;
+    }
+}
+
+// lod cells of 2^lod blocks inside the chunk, solid when at least half the
+// blocks are, with the id of the topmost solid block. cells are written back
+// at full resolution so the greedy mesher merges them into the coarse shape.
+// the border stays at full detail, rings of different lod may show cracks
+void block_padded_downsample(block_id_t padded[BLOCK_PADDED_VOLUME], const block_type_t *types, int32_t lod){
+    int32_t step = 1 << lod;
+    int32_t half = (step * step * step + 1) / 2;
+    for (int32_t y0 = 0; y0 < BLOCK_CHUNK_SIZE; y0 += step)
+    for (int32_t z0 = 0; z0 < BLOCK_CHUNK_SIZE; z0 += step)
+    for (int32_t x0 = 0; x0 < BLOCK_CHUNK_SIZE; x0 += step) {
+        int32_t solid = 0;
+        block_id_t top = BLOCK_AIR;
+        for (int32_t y = y0 + step - 1; y >= y0; y--)
+        for (int32_t z = z0; z < z0 + step; z++)
+        for (int32_t x = x0; x < x0 + step; x++) {
+            block_id_t id = padded[block_padded_index(x + 1, y + 1, z + 1)];
+            if (!types[id].solid) continue;
+            if (solid++ == 0) top = id;
+        }
+        block_id_t id = solid >= half ? top : BLOCK_AIR;
+        for (int32_t y = y0; y < y0 + step; y++)
+        for (int32_t z = z0; z < z0 + step; z++)
+        for (int32_t x = x0; x < x0 + step; x++) {
+            padded[block_padded_index(x + 1, y + 1, z + 1)] = id;
+        }
+    }
+}
+
+static bool block_mesh_reserve(block_mesh_data_t *out, int32_t quads){
+    if (quads <= out->quad_capacity) return true;
+    int32_t capacity = out->quad_capacity ? out->quad_capacity * 2 : 1024;
+    while (capacity < quads) capacity *= 2;
+    float *vertices = ecs_os_realloc(out->vertices, sizeof(float) * 12 * capacity);
+    if (vertices) out->vertices = vertices;
+    float *normals = ecs_os_realloc(out->normals, sizeof(float) * 12 * capacity);
+    if (normals) out->normals = normals;
+    float *texcoords = ecs_os_realloc(out->texcoords, sizeof(float) * 8 * capacity);
+    if (texcoords) out->texcoords = texcoords;
+    float *texcoords2 = ecs_os_realloc(out->texcoords2, sizeof(float) * 8 * capacity);
+    if (texcoords2) out->texcoords2 = texcoords2;
+    unsigned short *indices = ecs_os_realloc(out->indices, sizeof(unsigned short) * 6 * capacity);
+    if (indices) out->indices = indices;
+    if (!vertices || !normals || !texcoords || !texcoords2 || !indices) return false;
+    out->quad_capacity = capacity;
+    return true;
+}
+
+void block_mesh_data_free(block_mesh_data_t *data){
+    ecs_os_free(data->vertices);
+    ecs_os_free(data->normals);
+    ecs_os_free(data->texcoords);
+    ecs_os_free(data->texcoords2);
+    ecs_os_free(data->indices);
+    memset(data, 0, sizeof(block_mesh_data_t));
+}
+
+static block_face_t block_face_for(int axis, int sign){
+    if (axis == 0) return sign > 0 ? BLOCK_FACE_RIGHT : BLOCK_FACE_LEFT;
+    if (axis == 1) return sign > 0 ? BLOCK_FACE_TOP : BLOCK_FACE_BOTTOM;
+    return sign > 0 ? BLOCK_FACE_FRONT : BLOCK_FACE_BACK;
+}
+
+// texture space of a face, u to the right and v down as seen from outside
+static void block_face_uv(block_face_t face, const float p[3], float *u, float *v){
+    switch (face) {
+        case BLOCK_FACE_FRONT:  *u = p[0];  *v = -p[1]; break;
+        case BLOCK_FACE_BACK:   *u = -p[0]; *v = -p[1]; break;
+        case BLOCK_FACE_LEFT:   *u = p[2];  *v = -p[1]; break;
+        case BLOCK_FACE_RIGHT:  *u = -p[2]; *v = -p[1]; break;
+        case BLOCK_FACE_TOP:    *u = p[0];  *v = p[2];  break;
+        default:                *u = p[0];  *v = -p[2]; break;
+    }
+}
+
+static void block_emit_quad(block_mesh_data_t *out, const block_type_t *type, int axis, int sign, const int32_t base[3], int32_t w, int32_t h){
+    if (!block_mesh_reserve(out, out->quad_count + 1)) return;
+    int u_axis = (axis + 1) % 3;
+    int v_axis = (axis + 2) % 3;
+    block_face_t face = block_face_for(axis, sign);
+    int tile = type->tiles[face] > 0 ? type->tiles[face] : 0;
+
+    int32_t v0 = out->vertex_count;
+    for (int corner = 0; corner < 4; corner++) {
+        float p[3] = { (float)base[0], (float)base[1], (float)base[2] };
+        if (corner == 1 || corner == 2) p[u_axis] += (float)w;
+        if (corner == 2 || corner == 3) p[v_axis] += (float)h;
+        int32_t vi = v0 + corner;
+        memcpy(&out->vertices[vi * 3], p, sizeof(p));
+        out->normals[vi * 3 + 0] = axis == 0 ? (float)sign : 0.0f;
+        out->normals[vi * 3 + 1] = axis == 1 ? (float)sign : 0.0f;
+        out->normals[vi * 3 + 2] = axis == 2 ? (float)sign : 0.0f;
+        block_face_uv(face, p, &out->texcoords[vi * 2 + 0], &out->texcoords[vi * 2 + 1]);
+        out->texcoords2[vi * 2 + 0] = (float)tile;
+        out->texcoords2[vi * 2 + 1] = 0.0f;
+    }
+
+    // u x v points along +axis, flip the winding for the negative faces
+    static const unsigned short front[6] = { 0, 1, 2, 0, 2, 3 };
+    static const unsigned short back[6] = { 0, 2, 1, 0, 3, 2 };
+    const unsigned short *order = sign > 0 ? front : back;
+    for (int i = 0; i < 6; i++) {
+        out->indices[out->index_count++] = (unsigned short)(v0 + order[i]);
+    }
+    out->vertex_count += 4;
+    out->quad_count++;
+}
+
+// per face direction and slice: mask the visible faces, then grow each
+// unvisited face into the widest then tallest rectangle of the same block
+void block_mesh_build(const block_id_t padded[BLOCK_PADDED_VOLUME], const block_type_t *types, block_mesh_data_t *out){
+    out->vertex_count = 0;
+    out->index_count = 0;
+    out->quad_count = 0;
+    block_id_t mask[BLOCK_CHUNK_AREA];
+
+    for (int axis = 0; axis < 3; axis++) {
+        int u_axis = (axis + 1) % 3;
+        int v_axis = (axis + 2) % 3;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            for (int32_t slice = 0; slice < BLOCK_CHUNK_SIZE; slice++) {
+                int32_t p[3];
+                p[axis] = slice;
+                for (int32_t v = 0; v < BLOCK_CHUNK_SIZE; v++) {
+                    p[v_axis] = v;
+                    for (int32_t u = 0; u < BLOCK_CHUNK_SIZE; u++) {
+                        p[u_axis] = u;
+                        block_id_t id = padded[block_padded_index(p[0] + 1, p[1] + 1, p[2] + 1)];
+                        int32_t q[3] = { p[0] + 1, p[1] + 1, p[2] + 1 };
+                        q[axis] += sign;
+                        block_id_t next = padded[block_padded_index(q[0], q[1], q[2])];
+                        mask[u + v * BLOCK_CHUNK_SIZE] = (types[id].solid && !types[next].solid) ? id : BLOCK_AIR;
+                    }
+                }
+
+                for (int32_t v = 0; v < BLOCK_CHUNK_SIZE; v++) {
+                    for (int32_t u = 0; u < BLOCK_CHUNK_SIZE;) {
+                        block_id_t id = mask[u + v * BLOCK_CHUNK_SIZE];
+                        if (id == BLOCK_AIR) { u++; continue; }
+                        int32_t w = 1;
+                        while (u + w < BLOCK_CHUNK_SIZE && mask[u + w + v * BLOCK_CHUNK_SIZE] == id) w++;
+                        int32_t h = 1;
+                        for (; v + h < BLOCK_CHUNK_SIZE; h++) {
+                            int32_t k = 0;
+                            while (k < w && mask[u + k + (v + h) * BLOCK_CHUNK_SIZE] == id) k++;
+                            if (k < w) break;
+                        }
+                        int32_t base[3];
+                        base[axis] = slice + (sign > 0 ? 1 : 0);
+                        base[u_axis] = u;
+                        base[v_axis] = v;
+                        block_emit_quad(out, &types[id], axis, sign, base, w, h);
+                        for (int32_t y = 0; y < h; y++) {
+                            memset(&mask[u + (v + y) * BLOCK_CHUNK_SIZE], BLOCK_AIR, (size_t)w);
+                        }
+                        u += w;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//===============================================
+// RAYCAST
+//===============================================
+// last chunk looked up, a ray stays in one chunk for up to 16 steps
+typedef struct {
+    int32_t cx, cy, cz;
+    const block_chunk_t *chunk;     // NULL for a missing chunk
+    bool valid;
+} block_ray_cache_t;
+
+static block_id_t block_ray_lookup(const ecs_world_t *world, const block_world_t *bw, block_ray_cache_t *cache, const int32_t cell[3]){
+    int32_t cx = block_floor_div(cell[0]), cy = block_floor_div(cell[1]), cz = block_floor_div(cell[2]);
+    if (!cache->valid || cache->cx != cx || cache->cy != cy || cache->cz != cz) {
+        cache->cx = cx;
+        cache->cy = cy;
+        cache->cz = cz;
+        cache->chunk = block_chunk_get(world, bw, cx, cy, cz);
+        cache->valid = true;
+    }
+    if (!cache->chunk) return BLOCK_AIR;
+    return block_chunk_read(cache->chunk, block_index(cell[0] - cx * BLOCK_CHUNK_SIZE, cell[1] - cy * BLOCK_CHUNK_SIZE, cell[2] - cz * BLOCK_CHUNK_SIZE));
+}
+
+static block_hit_t block_raycast_walk(const ecs_world_t *world, const block_world_t *bw, block_ray_cache_t *cache, Ray ray, float max_distance){
+    block_hit_t hit = {0};
+    float length = Vector3Length(ray.direction);
+    if (length <= 0.0f) return hit;
+    if (max_distance <= 0.0f) max_distance = BLOCK_RAYCAST_MAX_DISTANCE;
+
+    // cells are shifted by half a block so block (x,y,z) is floor(p + 0.5)
+    float origin[3] = { ray.position.x + 0.5f, ray.position.y + 0.5f, ray.position.z + 0.5f };
+    float dir[3] = { ray.direction.x / length, ray.direction.y / length, ray.direction.z / length };
+    int32_t cell[3], step[3], prev[3];
+    float t_max[3], t_delta[3];
+    for (int a = 0; a < 3; a++) {
+        cell[a] = (int32_t)floorf(origin[a]);
+        if (dir[a] > 0.0f) {
+            step[a] = 1;
+            t_max[a] = ((float)(cell[a] + 1) - origin[a]) / dir[a];
+            t_delta[a] = 1.0f / dir[a];
+        } else if (dir[a] < 0.0f) {
+            step[a] = -1;
+            t_max[a] = ((float)cell[a] - origin[a]) / dir[a];
+            t_delta[a] = -1.0f / dir[a];
+        } else {
+            step[a] = 0;
+            t_max[a] = FLT_MAX;
+            t_delta[a] = FLT_MAX;
+        }
+    }
+
+    float t = 0.0f;
+    int axis = -1; // axis crossed into the current cell
+    memcpy(prev, cell, sizeof(prev));
+    for (;;) {
+        block_id_t id = block_ray_lookup(world, bw, cache, cell);
+        if (bw->types[id].solid) {
+            hit.hit = true;
+            hit.id = id;
+            hit.x = cell[0];
+            hit.y = cell[1];
+            hit.z = cell[2];
+            hit.place_x = prev[0];
+            hit.place_y = prev[1];
+            hit.place_z = prev[2];
+            hit.distance = t;
+            hit.point = (Vector3){ ray.position.x + dir[0] * t, ray.position.y + dir[1] * t, ray.position.z + dir[2] * t };
+            if (axis >= 0) {
+                float *n = &hit.normal.x;
+                n[axis] = (float)-step[axis];
+            }
+            return hit;
+        }
+        axis = t_max[0] < t_max[1] ? (t_max[0] < t_max[2] ? 0 : 2) : (t_max[1] < t_max[2] ? 1 : 2);
+        t = t_max[axis];
+        if (t > max_distance) return hit;
+        memcpy(prev, cell, sizeof(prev));
+        cell[axis] += step[axis];
+        t_max[axis] += t_delta[axis];
+    }
+}
+
+block_hit_t block_raycast(const ecs_world_t *world, Ray ray, float max_distance){
+    const block_world_t *bw = ecs_singleton_get(world, block_world_t);
+    if (!bw) return (block_hit_t){0};
+    block_ray_cache_t cache = {0};
+    return block_raycast_walk(world, bw, &cache, ray, max_distance);
+}
+
+// one singleton lookup and a shared chunk cache, rays from one agent tend
+// to start in the same chunk
+void block_raycast_batch(const ecs_world_t *world, const Ray *rays, const float *max_distances, float max_distance, int count, block_hit_t *hits){
+    const block_world_t *bw = ecs_singleton_get(world, block_world_t);
+    block_ray_cache_t cache = {0};
+    for (int i = 0; i < count; i++) {
+        hits[i] = bw ? block_raycast_walk(world, bw, &cache, rays[i], max_distances ? max_distances[i] : max_distance) : (block_hit_t){0};
+    }
+}
+
+//===============================================
+// GPU
+//===============================================
+// gpu buffers are sized to a power of two of quads, later meshes that fit
+// are written in place instead of a new vao/vbo set
+static int32_t block_quad_capacity(int32_t quads){
+    int32_t capacity = 16;
+    while (capacity < quads) capacity <<= 1;
+    return capacity;
+}
+
+// xyz, normal, uv, uv2 and 1.5 indices per vertex
+static int64_t block_mesh_bytes(int32_t vertex_capacity){
+    return (int64_t)vertex_capacity * (sizeof(float) * 10 + sizeof(unsigned short) * 3 / 2);
+}
+
+static void block_chunk_upload(block_world_t *bw, block_chunk_t *chunk, const block_mesh_data_t *data){
+    chunk->quad_count = data->quad_count;
+    if (data->quad_count == 0) {
+        bw->mesh_bytes -= block_mesh_bytes(chunk->vertex_capacity);
+        if (chunk->has_mesh) UnloadMesh(chunk->mesh);
+        chunk->mesh = (Mesh){0};
+        chunk->has_mesh = false;
+        chunk->vertex_capacity = 0;
+        return;
+    }
+
+    if (chunk->has_mesh && data->vertex_count <= chunk->vertex_capacity) {
+        int32_t count = data->vertex_count;
+        UpdateMeshBuffer(chunk->mesh, 0, data->vertices, (int)(sizeof(float) * 3 * count), 0);
+        UpdateMeshBuffer(chunk->mesh, 1, data->texcoords, (int)(sizeof(float) * 2 * count), 0);
+        UpdateMeshBuffer(chunk->mesh, 2, data->normals, (int)(sizeof(float) * 3 * count), 0);
+        UpdateMeshBuffer(chunk->mesh, 5, data->texcoords2, (int)(sizeof(float) * 2 * count), 0);
+        rlUpdateVertexBufferElements(chunk->mesh.vboId[6], data->indices, (int)(sizeof(unsigned short) * data->index_count), 0);
+        chunk->mesh.triangleCount = data->index_count / 3;
+        return;
+    }
+
+    if (chunk->has_mesh) UnloadMesh(chunk->mesh);
+    bw->mesh_bytes -= block_mesh_bytes(chunk->vertex_capacity);
+    // the mesher buffers hold at least quad_capacity quads, the tail is unused
+    int32_t quads = block_quad_capacity(data->quad_count);
+    Mesh mesh = {0};
+    mesh.vertexCount = quads * 4;
+    mesh.triangleCount = quads * 2;
+    mesh.vertices = data->vertices;
+    mesh.normals = data->normals;
+    mesh.texcoords = data->texcoords;
+    mesh.texcoords2 = data->texcoords2;
+    mesh.indices = data->indices;
+    UploadMesh(&mesh, true);
+    mesh.vertices = NULL; // borrowed, UnloadMesh must not free them
+    mesh.normals = NULL;
+    mesh.texcoords = NULL;
+    mesh.texcoords2 = NULL;
+    mesh.indices = NULL;
+    mesh.triangleCount = data->index_count / 3;
+    chunk->mesh = mesh;
+    chunk->has_mesh = true;
+    chunk->vertex_capacity = quads * 4;
+    bw->mesh_bytes += block_mesh_bytes(chunk->vertex_capacity);
+}
+
+// materials only borrow the atlas, UnloadMaterial would free it twice
+static void block_material_unload(Material *material){
+    UnloadShader(material->shader); // the default shader is skipped
+    MemFree(material->maps);
+    *material = (Material){0};
+}
+
+static void block_resources_unload(block_world_t *bw){
+    if (bw->has_instanced_material) block_material_unload(&bw->instanced_material);
+    if (bw->has_material) block_material_unload(&bw->material);
+    bw->instanced_shader = (Shader){0};
+    bw->shader = (Shader){0};
+    bw->has_instanced_material = false;
+    bw->has_material = false;
+    block_atlas_unload(&bw->atlas);
+}
+
+static Material block_atlas_material(const block_atlas_t *atlas, Shader shader){
+    Material material = LoadMaterialDefault();
+    material.shader = shader;
+    // the array is bound by block_atlas_bind, raylib would bind it as a 2d texture
+    material.maps[MATERIAL_MAP_DIFFUSE].texture = atlas->is_array ? (Texture2D){0} : atlas->texture;
+    block_atlas_set_uniforms(atlas, shader);
+    return material;
+}
+
+bool block_load_tiles(ecs_world_t *world, const Image *tiles, int32_t count, int32_t tile_size, bool array){
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw) return false;
+    block_atlas_t atlas = {0};
+    if (!block_atlas_pack(&atlas, tiles, count, tile_size, array)) return false;
+    block_resources_unload(bw);
+    bw->atlas = atlas;
+
+    // PLATFORM_DESKTOP is only defined inside raylib, ask the context instead
+    int version = rlGetVersion();
+    int glsl = (version == RL_OPENGL_33 || version == RL_OPENGL_43) ? 330 : 100;
+    const char *fs = atlas.is_array ? "resources/shaders/glsl330/block_atlas_array.fs" : TextFormat("resources/shaders/glsl%i/block_atlas.fs", glsl);
+    if (glsl == 100 && atlas.mip_count > 1) {
+        // no textureGrad in glsl 100, mips would show a seam at every tile repeat
+        rlTextureParameters(atlas.texture.id, RL_TEXTURE_MIN_FILTER, RL_TEXTURE_FILTER_NEAREST);
+    }
+
+    Shader shader = LoadShader(TextFormat("resources/shaders/glsl%i/block_atlas.vs", glsl), fs);
+    bw->shader = shader;
+    bw->material = block_atlas_material(&atlas, shader);
+    bw->has_material = true;
+
+    // same fragment shader, the vertex shader reads instanceTransform
+    Shader instanced = LoadShader(TextFormat("resources/shaders/glsl%i/block_instanced.vs", glsl), fs);
+    if (instanced.id != rlGetShaderIdDefault()) {
+        instanced.locs[SHADER_LOC_VERTEX_INSTANCE_TX] = GetShaderLocationAttrib(instanced, "instanceTransform");
+        bw->instanced_shader = instanced;
+        bw->instanced_material = block_atlas_material(&atlas, instanced);
+        bw->has_instanced_material = true;
+    }
+    return true;
+}
+
+bool block_load_sheet(ecs_world_t *world, Image sheet){
+    if (!sheet.data) return false;
+    int32_t count = 0;
+    Image *tiles = block_atlas_split(sheet, sheet.width / BLOCK_ATLAS_TILES, &count);
+    bool loaded = tiles && block_load_tiles(world, tiles, count, sheet.width / BLOCK_ATLAS_TILES, false);
+    for (int32_t i = 0; i < count; i++) UnloadImage(tiles[i]);
+    MemFree(tiles);
+    return loaded;
+}
+
+bool block_load_resources(ecs_world_t *world, const char *atlas_path){
+    Image sheet = LoadImage(atlas_path);
+    bool loaded = block_load_sheet(world, sheet);
+    UnloadImage(sheet);
+    return loaded;
+}
+
+//===============================================
+// BLOCK TYPES
+//===============================================
+// block_t hooks keep the per type refcount. copy and move see the old and
+// new value so changing the type of a placed block moves the reference.
+static void block_type_acquire(block_type_t *types, block_id_t type){
+    if (type != BLOCK_AIR) types[type].refcount++;
+}
+
+static void block_type_release(block_type_t *types, block_id_t type){
+    if (type != BLOCK_AIR && types[type].refcount > 0) types[type].refcount--;
+}
+
+static void block_t_ctor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    memset(ptr, 0, sizeof(block_t) * (size_t)count);
+}
+
+static void block_t_dtor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    block_t *block = ptr;
+    for (int32_t i = 0; i < count; i++) {
+        block_type_release(type_info->hooks.ctx, block[i].type);
+    }
+}
+
+static void block_t_copy(void *dst_ptr, const void *src_ptr, int32_t count, const ecs_type_info_t *type_info){
+    block_t *dst = dst_ptr;
+    const block_t *src = src_ptr;
+    for (int32_t i = 0; i < count; i++) {
+        if (dst[i].type == src[i].type) continue;
+        block_type_release(type_info->hooks.ctx, dst[i].type);
+        block_type_acquire(type_info->hooks.ctx, src[i].type);
+        dst[i].type = src[i].type;
+    }
+}
+
+// the reference moves with the value, the source is left as air
+static void block_t_move(void *dst_ptr, void *src_ptr, int32_t count, const ecs_type_info_t *type_info){
+    block_t *dst = dst_ptr;
+    block_t *src = src_ptr;
+    for (int32_t i = 0; i < count; i++) {
+        block_type_release(type_info->hooks.ctx, dst[i].type);
+        dst[i].type = src[i].type;
+        src[i].type = BLOCK_AIR;
+    }
+}
+
+// the type table is ecs_os memory, freed with the hooks
+static void block_types_free(void *ctx){
+    ecs_os_free(ctx);
+}
+
+// unit cube from the chunk mesher, centered on the origin
+static void block_type_load_mesh(block_type_t *types, block_id_t id){
+    static block_id_t padded[BLOCK_PADDED_VOLUME];
+    block_mesh_data_t data = {0};
+    memset(padded, 0, sizeof(padded));
+    padded[block_padded_index(1, 1, 1)] = id;
+    block_mesh_build(padded, types, &data);
+    if (data.quad_count > 0) {
+        for (int32_t i = 0; i < data.vertex_count * 3; i++) data.vertices[i] -= 0.5f;
+        Mesh mesh = {0};
+        mesh.vertexCount = data.vertex_count;
+        mesh.triangleCount = data.index_count / 3;
+        mesh.vertices = data.vertices;
+        mesh.normals = data.normals;
+        mesh.texcoords = data.texcoords;
+        mesh.texcoords2 = data.texcoords2;
+        mesh.indices = data.indices;
+        UploadMesh(&mesh, false);
+        mesh.vertices = NULL; // freed with the mesher buffers below
+        mesh.normals = NULL;
+        mesh.texcoords = NULL;
+        mesh.texcoords2 = NULL;
+        mesh.indices = NULL;
+        types[id].mesh = mesh;
+        types[id].has_mesh = true;
+    }
+    block_mesh_data_free(&data);
+}
+
+static void block_type_unload_mesh(block_type_t *type){
+    if (!type->has_mesh) return;
+    UnloadMesh(type->mesh);
+    type->mesh = (Mesh){0};
+    type->has_mesh = false;
+}
+
+//===============================================
+// MESH JOBS
+//===============================================
+typedef struct block_mesh_task_s {
+    ecs_entity_t chunk;
+    const block_type_t *types;
+    block_mesher_t *mesher;
+    block_id_t padded[BLOCK_PADDED_VOLUME];
+    uint8_t lod;
+    block_mesh_data_t data;             // buffers are kept when the task is reused
+    struct block_mesh_task_s *next;     // free or done list
+    struct block_mesh_task_s *next_all;
+} block_mesh_task_t;
+
+typedef struct block_gen_task_s {
+    int32_t x, y, z;
+    block_generator_t config;           // copied so edits apply to the next jobs only
+    const block_type_t *types;
+    block_mesher_t *mesher;
+    block_chunk_t chunk;                // generated storage, moved into the entity
+    struct block_gen_task_s *next;      // free or done list
+    struct block_gen_task_s *next_all;
+} block_gen_task_t;
+
+struct block_mesher_s {
+    job_pool_t pool;
+    ecs_os_mutex_t lock;                // guards the done lists
+    block_mesh_task_t *done_head;       // finished, oldest first
+    block_mesh_task_t *done_tail;
+    block_mesh_task_t *free_tasks;      // main thread only
+    block_mesh_task_t *all_tasks;       // main thread only, for teardown
+    block_gen_task_t *gen_done_head;
+    block_gen_task_t *gen_done_tail;
+    block_gen_task_t *gen_free;         // main thread only
+    block_gen_task_t *gen_all;          // main thread only, for teardown
+    ecs_map_t gen_pending;              // chunk key of every submitted generation
+};
+
+static block_mesher_t *block_mesher_new(void){
+    block_mesher_t *mesher = ecs_os_calloc(sizeof(block_mesher_t));
+    if (!mesher) return NULL;
+    // leave a core for the main thread
+    int32_t threads = job_pool_cpu_count() - 1;
+    if (threads > 4) threads = 4;
+    if (!job_pool_init(&mesher->pool, threads)) job_pool_init(&mesher->pool, 0);
+    mesher->lock = ecs_os_mutex_new();
+    ecs_map_init(&mesher->gen_pending, NULL);
+    return mesher;
+}
+
+static void block_mesher_free(block_mesher_t *mesher){
+    if (!mesher) return;
+    job_pool_fini(&mesher->pool);
+    ecs_os_mutex_free(mesher->lock);
+    block_mesh_task_t *task = mesher->all_tasks;
+    while (task) {
+        block_mesh_task_t *next = task->next_all;
+        block_mesh_data_free(&task->data);
+        ecs_os_free(task);
+        task = next;
+    }
+    block_gen_task_t *gen = mesher->gen_all;
+    while (gen) {
+        block_gen_task_t *next = gen->next_all;
+        block_chunk_free_storage(&gen->chunk);
+        ecs_os_free(gen);
+        gen = next;
+    }
+    ecs_map_fini(&mesher->gen_pending);
+    ecs_os_free(mesher);
+}
+
+static block_mesh_task_t *block_mesher_task(block_mesher_t *mesher){
+    block_mesh_task_t *task = mesher->free_tasks;
+    if (task) {
+        mesher->free_tasks = task->next;
+        return task;
+    }
+    task = ecs_os_calloc(sizeof(block_mesh_task_t));
+    if (!task) return NULL;
+    task->mesher = mesher;
+    task->next_all = mesher->all_tasks;
+    mesher->all_tasks = task;
+    return task;
+}
+
+// worker thread
+static void block_mesh_job(void *data){
+    block_mesh_task_t *task = (block_mesh_task_t *)data;
+    if (task->lod > 0) block_padded_downsample(task->padded, task->types, task->lod);
+    block_mesh_build(task->padded, task->types, &task->data);
+    block_mesher_t *mesher = task->mesher;
+    task->next = NULL;
+    ecs_os_mutex_lock(mesher->lock);
+    if (mesher->done_tail) mesher->done_tail->next = task;
+    else mesher->done_head = task;
+    mesher->done_tail = task;
+    ecs_os_mutex_unlock(mesher->lock);
+}
+
+static block_mesh_task_t *block_mesher_pop_done(block_mesher_t *mesher){
+    ecs_os_mutex_lock(mesher->lock);
+    block_mesh_task_t *task = mesher->done_head;
+    if (task) {
+        mesher->done_head = task->next;
+        if (!mesher->done_head) mesher->done_tail = NULL;
+    }
+    ecs_os_mutex_unlock(mesher->lock);
+    return task;
+}
+
+//===============================================
+// GENERATION JOBS
+//===============================================
+static bool block_gen_pending(const block_mesher_t *mesher, int32_t cx, int32_t cy, int32_t cz){
+    return ecs_map_get(&mesher->gen_pending, block_chunk_key(cx, cy, cz)) != NULL;
+}
+
+// worker thread
+static void block_gen_job(void *data){
+    block_gen_task_t *task = (block_gen_task_t *)data;
+    task->chunk = (block_chunk_t){ .x = task->x, .y = task->y, .z = task->z };
+    block_gen_fill(&task->config, task->types, &task->chunk); // left without a palette on failure, retried later
+
+    block_mesher_t *mesher = task->mesher;
+    task->next = NULL;
+    ecs_os_mutex_lock(mesher->lock);
+    if (mesher->gen_done_tail) mesher->gen_done_tail->next = task;
+    else mesher->gen_done_head = task;
+    mesher->gen_done_tail = task;
+    ecs_os_mutex_unlock(mesher->lock);
+}
+
+static bool block_gen_submit(block_world_t *bw, block_generator_t *gen, int32_t cx, int32_t cy, int32_t cz){
+    block_mesher_t *mesher = bw->mesher;
+    block_gen_task_t *task = mesher->gen_free;
+    if (task) {
+        mesher->gen_free = task->next;
+    } else {
+        task = ecs_os_calloc(sizeof(block_gen_task_t));
+        if (!task) return false;
+        task->mesher = mesher;
+        task->next_all = mesher->gen_all;
+        mesher->gen_all = task;
+    }
+    task->x = cx;
+    task->y = cy;
+    task->z = cz;
+    task->config = *gen;
+    task->types = bw->types;
+    ecs_map_insert(&mesher->gen_pending, block_chunk_key(cx, cy, cz), 1);
+    gen->jobs_in_flight++;
+    // a queue that cannot grow generates it here, collected like the others
+    if (!job_pool_submit(&mesher->pool, block_gen_job, task)) block_gen_job(task);
+    return true;
+}
+
+// finished chunks become entities, unless an edit created the chunk meanwhile
+static int32_t block_gen_collect(ecs_world_t *world, block_world_t *bw, block_generator_t *gen){
+    block_mesher_t *mesher = bw->mesher;
+    int32_t inserted = 0;
+    for (;;) {
+        ecs_os_mutex_lock(mesher->lock);
+        block_gen_task_t *task = mesher->gen_done_head;
+        if (task) {
+            mesher->gen_done_head = task->next;
+            if (!mesher->gen_done_head) mesher->gen_done_tail = NULL;
+        }
+        ecs_os_mutex_unlock(mesher->lock);
+        if (!task) break;
+        gen->jobs_in_flight--;
+        ecs_map_remove(&mesher->gen_pending, block_chunk_key(task->x, task->y, task->z));
+        if (!block_chunk_find(bw, task->x, task->y, task->z) && task->chunk.palette) {
+            block_chunk_insert(world, bw, &task->chunk);
+            inserted++;
+        } else {
+            block_chunk_free_storage(&task->chunk);
+        }
+        task->chunk = (block_chunk_t){0};
+        task->next = mesher->gen_free;
+        mesher->gen_free = task;
+    }
+    return inserted;
+}
+
+//===============================================
+// STREAMING
+//===============================================
+typedef struct {
+    int32_t offset;                 // index into stream->offsets
+    float score;
+} block_stream_candidate_t;
+
+typedef struct {
+    ecs_entity_t entity;
+    uint32_t last_seen;
+} block_stream_resident_t;
+
+static int block_offset_compare(const void *a, const void *b){
+    const int32_t *oa = a, *ob = b;
+    int32_t da = oa[0] * oa[0] + oa[1] * oa[1] + oa[2] * oa[2];
+    int32_t db = ob[0] * ob[0] + ob[1] * ob[1] + ob[2] * ob[2];
+    return (da > db) - (da < db);
+}
+
+static int block_resident_compare(const void *a, const void *b){
+    const block_stream_resident_t *ra = a, *rb = b;
+    return (ra->last_seen > rb->last_seen) - (ra->last_seen < rb->last_seen);
+}
+
+// every chunk offset inside the load sphere, nearest first
+static bool block_stream_build_offsets(block_stream_t *stream){
+    int32_t r = stream->load_radius;
+    int32_t side = 2 * r + 1;
+    int32_t *offsets = ecs_os_realloc(stream->offsets, sizeof(int32_t) * 3 * side * side * side);
+    if (!offsets) return false;
+    int32_t count = 0;
+    for (int32_t y = -r; y <= r; y++)
+    for (int32_t z = -r; z <= r; z++)
+    for (int32_t x = -r; x <= r; x++) {
+        if (x * x + y * y + z * z > r * r) continue;
+        offsets[count * 3 + 0] = x;
+        offsets[count * 3 + 1] = y;
+        offsets[count * 3 + 2] = z;
+        count++;
+    }
+    qsort(offsets, (size_t)count, sizeof(int32_t) * 3, block_offset_compare);
+    stream->offsets = offsets;
+    stream->offset_count = count;
+    stream->offset_radius = r;
+    stream->cursor = 0;
+    return true;
+}
+
+static float block_chunk_facing(const int32_t d[3], Vector3 view){
+    float length = sqrtf((float)(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]));
+    if (length <= 0.0f) return 1.0f;
+    return (d[0] * view.x + d[1] * view.y + d[2] * view.z) / length;
+}
+
+// up to max_loads of the best ranked missing chunks, ranked by distance and
+// weighted 1x ahead of the camera up to 3x behind it. stored chunks are
+// loaded, the others are queued for the generator
+static int32_t block_stream_load(ecs_world_t *world, block_world_t *bw, block_stream_t *stream, block_generator_t *gen, Vector3 view){
+    block_stream_candidate_t candidates[BLOCK_STREAM_CANDIDATES];
+    int32_t count = 0;
+    for (int32_t i = stream->cursor; i < stream->offset_count && count < BLOCK_STREAM_CANDIDATES; i++) {
+        const int32_t *d = &stream->offsets[i * 3];
+        int32_t cx = stream->center_x + d[0], cy = stream->center_y + d[1], cz = stream->center_z + d[2];
+        bool missing = !block_chunk_find(bw, cx, cy, cz);
+        bool stored = missing && block_chunk_payload(bw, cx, cy, cz, NULL);
+        if (!stored && !(missing && block_gen_covers(gen, cy))) {
+            if (i == stream->cursor) stream->cursor++;
+            continue;
+        }
+        // still generating, the cursor waits for it
+        if (!stored && block_gen_pending(bw->mesher, cx, cy, cz)) continue;
+        float distance = (float)(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        candidates[count++] = (block_stream_candidate_t){ i, distance * (2.0f - block_chunk_facing(d, view)) };
+    }
+
+    int32_t loaded = 0;
+    int32_t tries = 0;
+    while (tries < stream->max_loads && count > 0) {
+        int32_t best = 0;
+        for (int32_t i = 1; i < count; i++) {
+            if (candidates[i].score < candidates[best].score) best = i;
+        }
+        const int32_t *d = &stream->offsets[candidates[best].offset * 3];
+        int32_t cx = stream->center_x + d[0], cy = stream->center_y + d[1], cz = stream->center_z + d[2];
+        candidates[best] = candidates[--count];
+        if (block_chunk_payload(bw, cx, cy, cz, NULL)) {
+            if (block_chunk_load(world, bw, cx, cy, cz)) loaded++;
+        } else if (gen->jobs_in_flight < gen->max_jobs) {
+            block_gen_submit(bw, gen, cx, cy, cz);
+        } else {
+            continue; // generator is full, loads can still go ahead
+        }
+        tries++;
+    }
+    return loaded;
+}
+
+static int64_t block_resident_bytes(const block_world_t *bw){
+    return bw->chunk_bytes + bw->mesh_bytes;
+}
+
+// runs immediate so loads and evictions are visible to the mesher this frame
+void block_stream_system(ecs_iter_t *it){
+    block_stream_t *stream = ecs_singleton_get_mut(it->world, block_stream_t);
+    block_world_t *bw = ecs_singleton_get_mut(it->world, block_world_t);
+    const main_context_t *main_context = ecs_singleton_get(it->world, main_context_t);
+    if (!stream || !bw || !main_context || !stream->enabled) return;
+    stream->frame++;
+    stream->loads_last_frame = 0;
+    stream->evictions_last_frame = 0;
+
+    Camera3D camera = main_context->camera;
+    Vector3 view = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    int32_t cx = block_floor_div((int32_t)floorf(camera.position.x + 0.5f));
+    int32_t cy = block_floor_div((int32_t)floorf(camera.position.y + 0.5f));
+    int32_t cz = block_floor_div((int32_t)floorf(camera.position.z + 0.5f));
+    if (stream->offset_radius != stream->load_radius || !stream->offsets) {
+        if (!block_stream_build_offsets(stream)) return;
+    }
+    if (cx != stream->center_x || cy != stream->center_y || cz != stream->center_z) {
+        stream->center_x = cx;
+        stream->center_y = cy;
+        stream->center_z = cz;
+        stream->cursor = 0;
+    }
+    // generation runs on the mesher workers, without them only stored chunks load
+    block_generator_t *gen = bw->mesher ? ecs_singleton_get_mut(it->world, block_generator_t) : NULL;
+    if (gen) gen->generated_last_frame = block_gen_collect(it->world, bw, gen);
+    if (bw->region_dir || (gen && gen->enabled)) {
+        stream->loads_last_frame = block_stream_load(it->world, bw, stream, gen, view);
+    }
+
+    // detail rings, last seen stamps and eviction candidates, frame scratch
+    block_stream_resident_t *residents = frame_alloc(it->world, sizeof(block_stream_resident_t) * (size_t)(bw->chunk_count + 1));
+    if (!residents) return;
+    int32_t resident_count = 0;
+    ecs_entity_t *evict = frame_alloc(it->world, sizeof(ecs_entity_t) * (size_t)(bw->chunk_count + 1));
+    int32_t evict_count = 0;
+    bool evict_modified = false;
+    int32_t unload2 = stream->unload_radius * stream->unload_radius;
+    int32_t load2 = stream->load_radius * stream->load_radius;
+    ecs_map_iter_t mit = ecs_map_iter(&bw->chunks);
+    while (evict && ecs_map_next(&mit)) {
+        ecs_entity_t e = (ecs_entity_t)ecs_map_value(&mit);
+        block_chunk_t *chunk = ecs_get_mut(it->world, e, block_chunk_t);
+        if (!chunk) continue;
+        int32_t d[3] = { chunk->x - cx, chunk->y - cy, chunk->z - cz };
+        int32_t distance2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (distance2 > unload2) {
+            evict[evict_count++] = e;
+            evict_modified |= chunk->modified;
+            continue;
+        }
+        int32_t lod = stream->lod_radius > 0 ? (int32_t)(sqrtf((float)distance2) / (float)stream->lod_radius) : 0;
+        if (lod > BLOCK_STREAM_MAX_LOD) lod = BLOCK_STREAM_MAX_LOD;
+        if (chunk->lod != lod) {
+            chunk->lod = (uint8_t)lod;
+            chunk->dirty = true;
+        }
+        if (distance2 <= load2 && (distance2 <= 2 || block_chunk_facing(d, view) > -0.25f)) chunk->last_seen = stream->frame;
+        residents[resident_count++] = (block_stream_resident_t){ e, chunk->last_seen };
+    }
+
+    // over the cap, least recently seen first, never what is in view now
+    int64_t over = block_resident_bytes(bw) - stream->memory_cap;
+    if (evict && over > 0) {
+        qsort(residents, (size_t)resident_count, sizeof(block_stream_resident_t), block_resident_compare);
+        for (int32_t i = 0; i < resident_count && over > 0; i++) {
+            if (residents[i].last_seen == stream->frame) break;
+            const block_chunk_t *chunk = ecs_get(it->world, residents[i].entity, block_chunk_t);
+            over -= block_chunk_bytes(chunk) + block_mesh_bytes(chunk->vertex_capacity);
+            evict[evict_count++] = residents[i].entity;
+            evict_modified |= chunk->modified;
+        }
+    }
+
+    // edited chunks are written back first, without a region dir they stay
+    if (evict_modified && bw->region_dir) block_world_save(it->world);
+    for (int32_t i = 0; i < evict_count; i++) {
+        const block_chunk_t *chunk = ecs_get(it->world, evict[i], block_chunk_t);
+        if (!chunk || chunk->modified) continue;
+        ecs_delete(it->world, evict[i]);
+        stream->evictions_last_frame++;
+    }
+    // evicted chunks inside the load sphere come back once the camera moves
+}
+
+void on_remove_block_stream(ecs_iter_t *it){
+    block_stream_t *stream = ecs_field(it, block_stream_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        ecs_os_free(stream[i].offsets);
+        stream[i].offsets = NULL;
+    }
+}
+
+//===============================================
+// SYSTEMS
+//===============================================
+// upload finished meshes until the time or chunk budget is used, the rest
+// waits for the next frame
+void block_mesh_upload_system(ecs_iter_t *it){
+    block_world_t *bw = ecs_singleton_get_mut(it->world, block_world_t);
+    if (!bw || !bw->mesher) return;
+    double start = GetTime();
+    int32_t uploads = 0;
+    while (uploads < bw->upload_max_chunks && (GetTime() - start) * 1000.0 < bw->upload_budget_ms) {
+        block_mesh_task_t *task = block_mesher_pop_done(bw->mesher);
+        if (!task) break;
+        bw->jobs_in_flight--;
+        // the chunk may have been deleted while it was meshed
+        block_chunk_t *chunk = ecs_is_alive(it->world, task->chunk) ? ecs_get_mut(it->world, task->chunk, block_chunk_t) : NULL;
+        if (chunk) {
+            int32_t quads_before = chunk->quad_count;
+            block_chunk_upload(bw, chunk, &task->data);
+            chunk->meshing = false;
+            bw->quad_count += chunk->quad_count - quads_before;
+            uploads++;
+        }
+        task->next = bw->mesher->free_tasks;
+        bw->mesher->free_tasks = task;
+    }
+    bw->uploads_last_frame = uploads;
+    bw->upload_ms_last_frame = (float)((GetTime() - start) * 1000.0);
+}
+
+// snapshot dirty chunks for the workers, one job per chunk at a time. edits
+// made while a chunk is meshing keep it dirty for the next round
+void block_mesh_submit_system(ecs_iter_t *it){
+    block_chunk_t *chunk = ecs_field(it, block_chunk_t, 0);
+    block_world_t *bw = ecs_singleton_get_mut(it->world, block_world_t);
+    if (!bw || !bw->mesher) return;
+    for (int i = 0; i < it->count; i++) {
+        if (!chunk[i].dirty || chunk[i].meshing) continue;
+        if (bw->jobs_in_flight >= bw->submit_max_chunks) return;
+        block_mesh_task_t *task = block_mesher_task(bw->mesher);
+        if (!task) return;
+        task->chunk = it->entities[i];
+        task->types = bw->types;
+        block_chunk_snapshot(it->world, &chunk[i], task->padded);
+        task->lod = chunk[i].lod;
+        chunk[i].dirty = false;
+        chunk[i].meshing = true;
+        bw->jobs_in_flight++;
+        // a queue that cannot grow meshes it here, uploaded next frame
+        if (!job_pool_submit(&bw->mesher->pool, block_mesh_job, task)) block_mesh_job(task);
+    }
+}
+
+void render_3d_block_chunks_system(ecs_iter_t *it){
+    const block_chunk_t *chunk = ecs_field(it, block_chunk_t, 0);
+    block_world_t *bw = ecs_singleton_get_mut(it->world, block_world_t);
+    if (!bw) return;
+    if (!bw->has_material) { // no atlas loaded, plain default material
+        bw->material = LoadMaterialDefault();
+        bw->has_material = true;
+    }
+    // chunks whose bounding sphere is behind the camera are skipped
+    const main_context_t *main_context = ecs_singleton_get(it->world, main_context_t);
+    Vector3 eye = main_context ? main_context->camera.position : (Vector3){ 0 };
+    Vector3 view = main_context ? Vector3Normalize(Vector3Subtract(main_context->camera.target, eye)) : (Vector3){ 0 };
+    const float radius = BLOCK_CHUNK_SIZE * 0.8661f; // half the chunk diagonal
+    block_atlas_bind(&bw->atlas);
+    for (int i = 0; i < it->count; i++) {
+        if (!chunk[i].has_mesh) continue;
+        Vector3 center = {
+            chunk[i].x * BLOCK_CHUNK_SIZE + (BLOCK_CHUNK_SIZE - 1) * 0.5f,
+            chunk[i].y * BLOCK_CHUNK_SIZE + (BLOCK_CHUNK_SIZE - 1) * 0.5f,
+            chunk[i].z * BLOCK_CHUNK_SIZE + (BLOCK_CHUNK_SIZE - 1) * 0.5f
+        };
+        if (Vector3DotProduct(Vector3Subtract(center, eye), view) < -radius) continue;
+        // -0.5 puts block centers on integer coordinates
+        Matrix transform = MatrixTranslate(
+            (float)(chunk[i].x * BLOCK_CHUNK_SIZE) - 0.5f,
+            (float)(chunk[i].y * BLOCK_CHUNK_SIZE) - 0.5f,
+            (float)(chunk[i].z * BLOCK_CHUNK_SIZE) - 0.5f);
+        DrawMesh(chunk[i].mesh, bw->material, transform);
+    }
+    block_atlas_unbind(&bw->atlas);
+}
+
+static bool block_instances_reserve(block_world_t *bw, int32_t count){
+    if (count <= bw->instance_capacity) return true;
+    int32_t capacity = bw->instance_capacity ? bw->instance_capacity * 2 : 256;
+    while (capacity < count) capacity *= 2;
+    Matrix *instances = ecs_os_realloc(bw->instances, sizeof(Matrix) * capacity);
+    if (!instances) return false;
+    bw->instances = instances;
+    bw->instance_capacity = capacity;
+    return true;
+}
+
+// counting pass then a fill pass, each type ends up as one contiguous range
+int32_t block_instances_build(ecs_world_t *world, int32_t counts[BLOCK_MAX_TYPES]){
+    memset(counts, 0, sizeof(int32_t) * BLOCK_MAX_TYPES);
+    block_world_t *bw = ecs_singleton_get_mut(world, block_world_t);
+    if (!bw || !block_instance_query) return 0;
+
+    int32_t total = 0;
+    ecs_iter_t qit = ecs_query_iter(world, block_instance_query);
+    while (ecs_query_next(&qit)) {
+        const block_t *block = ecs_field(&qit, block_t, 1);
+        for (int i = 0; i < qit.count; i++) counts[block[i].type]++;
+        total += qit.count;
+    }
+    if (total == 0 || !block_instances_reserve(bw, total)) return 0;
+
+    int32_t offsets[BLOCK_MAX_TYPES];
+    int32_t offset = 0;
+    for (int32_t type = 0; type < BLOCK_MAX_TYPES; type++) {
+        offsets[type] = offset;
+        offset += counts[type];
+    }
+    qit = ecs_query_iter(world, block_instance_query);
+    while (ecs_query_next(&qit)) {
+        const Transform3D *transform = ecs_field(&qit, Transform3D, 0);
+        const block_t *block = ecs_field(&qit, block_t, 1);
+        for (int i = 0; i < qit.count; i++) {
+            bw->instances[offsets[block[i].type]++] = transform[i].worldMatrix;
+        }
+    }
+    return total;
+}
+
+// block_t entities grouped by type, one DrawMeshInstanced per type in use
+void render_3d_blocks_system(ecs_iter_t *it){
+    block_world_t *bw = ecs_singleton_get_mut(it->world, block_world_t);
+    if (!bw) return;
+
+    // type meshes follow the refcount, loaded on first use and freed when unused
+    for (int32_t type = 1; type < bw->type_count; type++) {
+        block_type_t *entry = &bw->types[type];
+        if (entry->refcount > 0 && !entry->has_mesh) block_type_load_mesh(bw->types, (block_id_t)type);
+        if (entry->refcount == 0 && entry->has_mesh) block_type_unload_mesh(entry);
+    }
+
+    int32_t counts[BLOCK_MAX_TYPES];
+    if (block_instances_build(it->world, counts) == 0) {
+        bw->instance_draws = 0;
+        return;
+    }
+
+    int32_t draws = 0;
+    int32_t offset = counts[BLOCK_AIR]; // air blocks are not drawn
+    block_atlas_bind(&bw->atlas);
+    for (int32_t type = 1; type < bw->type_count; type++) {
+        const block_type_t *entry = &bw->types[type];
+        if (counts[type] > 0 && entry->has_mesh) {
+            if (bw->has_instanced_material) {
+                DrawMeshInstanced(entry->mesh, bw->instanced_material, &bw->instances[offset], counts[type]);
+                draws++;
+            } else if (bw->has_material) { // no instancing shader, one draw per block
+                for (int32_t i = 0; i < counts[type]; i++) DrawMesh(entry->mesh, bw->material, bw->instances[offset + i]);
+                draws += counts[type];
+            }
+        }
+        offset += counts[type];
+    }
+    block_atlas_unbind(&bw->atlas);
+    bw->instance_draws = draws;
+}
+
+void on_remove_block_chunk(ecs_iter_t *it){
+    block_chunk_t *chunk = ecs_field(it, block_chunk_t, 0);
+    block_world_t *bw = ecs_singleton_get_mut(it->world, block_world_t);
+    for (int i = 0; i < it->count; i++) {
+        if (chunk[i].has_mesh) UnloadMesh(chunk[i].mesh);
+        chunk[i].has_mesh = false;
+        if (bw) bw->chunk_bytes -= block_chunk_bytes(&chunk[i]);
+        if (bw) bw->mesh_bytes -= block_mesh_bytes(chunk[i].vertex_capacity);
+        block_chunk_free_storage(&chunk[i]);
+        if (!bw) continue;
+        bw->quad_count -= chunk[i].quad_count;
+        uint64_t key = block_chunk_key(chunk[i].x, chunk[i].y, chunk[i].z);
+        ecs_map_val_t *found = ecs_map_get(&bw->chunks, key);
+        if (found && *found == it->entities[i]) {
+            ecs_map_remove(&bw->chunks, key);
+            bw->chunk_count--;
+        }
+    }
+}
+
+void on_remove_block_world(ecs_iter_t *it){
+    block_world_t *bw = ecs_field(it, block_world_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        block_resources_unload(&bw[i]);
+        block_mesher_free(bw[i].mesher); // joins the workers before the tasks are freed
+        // types stay with the block_t hooks, remaining block_t dtors still release into it
+        for (int32_t type = 0; type < bw[i].type_count; type++) block_type_unload_mesh(&bw[i].types[type]);
+        ecs_os_free(bw[i].instances);
+        ecs_map_fini(&bw[i].chunks);
+        block_regions_close(&bw[i]);
+        ecs_map_fini(&bw[i].regions);
+        ecs_os_free(bw[i].region_dir);
+        memset(&bw[i], 0, sizeof(block_world_t));
+    }
+}
 
 void setup_systems_blocks(ecs_world_t *world){
+    // streaming first so loads, evictions and detail changes are meshed this frame
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "block_stream_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .callback = block_stream_system,
+        .immediate = true
+    });
+
+    // upload first so last frame's jobs show up before new ones are queued
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "block_mesh_upload_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .callback = block_mesh_upload_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "block_mesh_submit_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .query.terms = {
+            { .id = ecs_id(block_chunk_t) }
+        },
+        .callback = block_mesh_submit_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "render_3d_block_chunks_system", .add = ecs_ids(ecs_dependson(RLRender3DPhase)) }),
+        .query.terms = {
+            { .id = ecs_id(block_chunk_t), .inout = EcsIn }
+        },
+        .callback = render_3d_block_chunks_system
+    });
 
+    block_instance_query = ecs_query(world, {
+        .terms = {
+            { .id = ecs_id(Transform3D), .inout = EcsIn },
+            { .id = ecs_id(block_t), .inout = EcsIn }
+        },
+        .cache_kind = EcsQueryCacheAuto
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "render_3d_blocks_system", .add = ecs_ids(ecs_dependson(RLRender3DPhase)) }),
+        .callback = render_3d_blocks_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(block_chunk_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_block_chunk
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(block_world_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_block_world
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(block_stream_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_block_stream
+    });
 }
 
 void setup_components_blocks(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, block_chunk_t);
+    ECS_COMPONENT_DEFINE(world, block_world_t);
+    ECS_COMPONENT_DEFINE(world, block_t);
+    ECS_COMPONENT_DEFINE(world, block_stream_t);
+    ECS_COMPONENT_DEFINE(world, block_generator_t);
 
+    ecs_singleton_set(world, block_stream_t, {
+        .enabled = true,
+        .load_radius = BLOCK_STREAM_LOAD_RADIUS,
+        .unload_radius = BLOCK_STREAM_UNLOAD_RADIUS,
+        .lod_radius = BLOCK_STREAM_LOD_RADIUS,
+        .max_loads = BLOCK_STREAM_LOADS_PER_FRAME,
+        .memory_cap = BLOCK_STREAM_MEMORY_CAP
+    });
+
+    // off until the app registers its block types and sets the ids
+    ecs_singleton_set(world, block_generator_t, {
+        .enabled = false,
+        .base_height = 0.0f,
+        .height_scale = 16.0f,
+        .frequency = 1.0f / 128.0f,
+        .octaves = 5,
+        .cave_frequency = 1.0f / 32.0f,
+        .cave_octaves = 2,
+        .cave_threshold = 0.2f,
+        .filler_depth = 3,
+        .max_jobs = BLOCK_GEN_MAX_JOBS
+    });
+
+    block_world_t bw = {
+        .upload_budget_ms = BLOCK_UPLOAD_BUDGET_MS,
+        .upload_max_chunks = BLOCK_UPLOAD_MAX_CHUNKS,
+        .submit_max_chunks = BLOCK_SUBMIT_MAX_CHUNKS
+    };
+    bw.types = ecs_os_calloc(sizeof(block_type_t) * BLOCK_MAX_TYPES);
+    if (!bw.types) return;
+    bw.types[BLOCK_AIR] = (block_type_t){ .name = "air", .solid = false };
+    bw.type_count = 1;
+    // the hooks own the type table so refcounts stay valid until the last block_t is gone
+    ecs_set_hooks(world, block_t, {
+        .ctor = block_t_ctor,
+        .dtor = block_t_dtor,
+        .copy = block_t_copy,
+        .move = block_t_move,
+        .ctx = bw.types,
+        .ctx_free = block_types_free
+    });
+    bw.mesher = block_mesher_new();
+    ecs_map_init(&bw.chunks, NULL);
+    ecs_map_init(&bw.regions, NULL);
+    ecs_singleton_set_ptr(world, block_world_t, &bw);
 }
 
+// call after module_init_raylib (phases)
 void module_init_block(ecs_world_t *world){
     setup_components_blocks(world);
     setup_systems_blocks(world);
-}
\ No newline at end of file
+}
@@ -0,0 +1,300 @@
+// module_debug_draw.c
+// deferred debug lines
+// every thread gets its own command buffer on first use, found again
+// through a thread local pointer, so appending only takes that buffer's
+// lock and never waits on another thread. the flush system swaps each
+// buffer out once a frame, keeps commands with time left across frames and
+// emits everything as rlgl lines with one mode and texture, which rlgl
+// merges into a single draw call. DrawSphere would switch to triangles and
+// break the batch, spheres here are three line circles.
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecs_components.h"
+#include "module_debug_draw.h"
+#include "rlgl.h"
+
+ECS_COMPONENT_DECLARE(debug_draw_t);
+
+typedef enum {
+    DEBUG_DRAW_LINE,
+    DEBUG_DRAW_BOX,
+    DEBUG_DRAW_SPHERE
+} debug_draw_kind_t;
+
+// line a to b, box center a and size b, sphere center a and radius b.x
+typedef struct {
+    Vector3 a;
+    Vector3 b;
+    Color color;
+    float time;                     // seconds left
+    int32_t kind;                   // debug_draw_kind_t
+} debug_draw_cmd_t;
+
+typedef struct {
+    ecs_os_mutex_t lock;            // guards the commands, taken by the owner and the flush
+    debug_draw_cmd_t *commands;
+    int32_t count;
+    int32_t capacity;
+    int32_t dropped;
+} debug_draw_buffer_t;
+
+struct debug_draw_host_s {
+    ecs_os_mutex_t lock;            // guards buffer_count
+    debug_draw_buffer_t buffers[DEBUG_DRAW_MAX_THREADS];
+    int32_t buffer_count;
+    uint32_t generation;            // tells a thread its cached buffer is from an older host
+    debug_draw_cmd_t *retained;     // main thread only
+    int32_t retained_count;
+    int32_t retained_capacity;
+};
+
+static debug_draw_host_t *debug_draw_active = NULL;
+static uint32_t debug_draw_generation = 0;
+static _Thread_local debug_draw_buffer_t *debug_draw_local = NULL;
+static _Thread_local uint32_t debug_draw_local_generation = 0;
+
+static float debug_draw_circle[DEBUG_DRAW_SPHERE_SEGMENTS + 1][2];
+
+//===============================================
+// COMMANDS
+//===============================================
+static debug_draw_buffer_t *debug_draw_buffer_acquire(debug_draw_host_t *host){
+    ecs_os_mutex_lock(host->lock);
+    debug_draw_buffer_t *buffer = NULL;
+    if (host->buffer_count < DEBUG_DRAW_MAX_THREADS) {
+        buffer = &host->buffers[host->buffer_count];
+        buffer->lock = ecs_os_mutex_new();
+        host->buffer_count++;
+    } else {
+        buffer = &host->buffers[DEBUG_DRAW_MAX_THREADS - 1];
+    }
+    ecs_os_mutex_unlock(host->lock);
+    return buffer;
+}
+
+static void debug_draw_push(debug_draw_kind_t kind, Vector3 a, Vector3 b, Color color, float duration){
+    debug_draw_host_t *host = debug_draw_active;
+    if (!host) return;
+    if (!debug_draw_local || debug_draw_local_generation != host->generation) {
+        debug_draw_local = debug_draw_buffer_acquire(host);
+        debug_draw_local_generation = host->generation;
+    }
+    debug_draw_buffer_t *buffer = debug_draw_local;
+    ecs_os_mutex_lock(buffer->lock);
+    if (buffer->count == buffer->capacity && buffer->capacity < DEBUG_DRAW_MAX_COMMANDS) {
+        int32_t capacity = buffer->capacity > 0 ? buffer->capacity * 2 : 256;
+        if (capacity > DEBUG_DRAW_MAX_COMMANDS) capacity = DEBUG_DRAW_MAX_COMMANDS;
+        debug_draw_cmd_t *commands = ecs_os_realloc(buffer->commands, sizeof(debug_draw_cmd_t) * (size_t)capacity);
+        if (commands) {
+            buffer->commands = commands;
+            buffer->capacity = capacity;
+        }
+    }
+    if (buffer->count < buffer->capacity) {
+        buffer->commands[buffer->count++] = (debug_draw_cmd_t){
+            .a = a, .b = b, .color = color, .time = duration > 0.0f ? duration : 0.0f, .kind = kind
+        };
+    } else {
+        buffer->dropped++;
+    }
+    ecs_os_mutex_unlock(buffer->lock);
+}
+
+void debug_draw_line(Vector3 start, Vector3 end, Color color, float duration){
+    debug_draw_push(DEBUG_DRAW_LINE, start, end, color, duration);
+}
+
+void debug_draw_ray(Ray ray, float length, Color color, float duration){
+    debug_draw_push(DEBUG_DRAW_LINE, ray.position, Vector3Add(ray.position, Vector3Scale(ray.direction, length)), color, duration);
+}
+
+void debug_draw_box(Vector3 center, Vector3 size, Color color, float duration){
+    debug_draw_push(DEBUG_DRAW_BOX, center, size, color, duration);
+}
+
+void debug_draw_sphere(Vector3 center, float radius, Color color, float duration){
+    debug_draw_push(DEBUG_DRAW_SPHERE, center, (Vector3){ radius, 0.0f, 0.0f }, color, duration);
+}
+
+// moves what every thread appended since the last frame to the retained list
+static int32_t debug_draw_gather(debug_draw_host_t *host){
+    int32_t dropped = 0;
+    ecs_os_mutex_lock(host->lock);
+    int32_t buffer_count = host->buffer_count;
+    ecs_os_mutex_unlock(host->lock);
+    for (int32_t i = 0; i < buffer_count; i++) {
+        debug_draw_buffer_t *buffer = &host->buffers[i];
+        ecs_os_mutex_lock(buffer->lock);
+        int32_t needed = host->retained_count + buffer->count;
+        if (needed > host->retained_capacity) {
+            int32_t capacity = host->retained_capacity > 0 ? host->retained_capacity : 256;
+            while (capacity < needed) capacity *= 2;
+            debug_draw_cmd_t *retained = ecs_os_realloc(host->retained, sizeof(debug_draw_cmd_t) * (size_t)capacity);
+            if (retained) {
+                host->retained = retained;
+                host->retained_capacity = capacity;
+            }
+        }
+        if (needed <= host->retained_capacity) {
+            memcpy(&host->retained[host->retained_count], buffer->commands, sizeof(debug_draw_cmd_t) * (size_t)buffer->count);
+            host->retained_count = needed;
+        } else {
+            dropped += buffer->count;
+        }
+        dropped += buffer->dropped;
+        buffer->count = 0;
+        buffer->dropped = 0;
+        ecs_os_mutex_unlock(buffer->lock);
+    }
+    return dropped;
+}
+
+//===============================================
+// RENDER
+//===============================================
+static int32_t debug_draw_vertex_count(const debug_draw_cmd_t *cmd){
+    switch (cmd->kind) {
+        case DEBUG_DRAW_BOX: return 24;
+        case DEBUG_DRAW_SPHERE: return DEBUG_DRAW_SPHERE_SEGMENTS * 6;
+        default: return 2;
+    }
+}
+
+static void debug_draw_vertex(Vector3 v){
+    rlVertex3f(v.x, v.y, v.z);
+}
+
+static void debug_draw_emit_box(const debug_draw_cmd_t *cmd){
+    Vector3 h = Vector3Scale(cmd->b, 0.5f);
+    Vector3 c[8];
+    for (int32_t i = 0; i < 8; i++) {
+        c[i] = (Vector3){
+            cmd->a.x + ((i & 1) ? h.x : -h.x),
+            cmd->a.y + ((i & 2) ? h.y : -h.y),
+            cmd->a.z + ((i & 4) ? h.z : -h.z)
+        };
+    }
+    // corners i and i ^ axis bit share an edge
+    for (int32_t i = 0; i < 8; i++) {
+        for (int32_t bit = 1; bit < 8; bit <<= 1) {
+            if (i & bit) continue;
+            debug_draw_vertex(c[i]);
+            debug_draw_vertex(c[i | bit]);
+        }
+    }
+}
+
+static void debug_draw_emit_sphere(const debug_draw_cmd_t *cmd){
+    float r = cmd->b.x;
+    Vector3 p = cmd->a;
+    for (int32_t s = 0; s < DEBUG_DRAW_SPHERE_SEGMENTS; s++) {
+        float c0 = debug_draw_circle[s][0] * r, s0 = debug_draw_circle[s][1] * r;
+        float c1 = debug_draw_circle[s + 1][0] * r, s1 = debug_draw_circle[s + 1][1] * r;
+        rlVertex3f(p.x + c0, p.y + s0, p.z);
+        rlVertex3f(p.x + c1, p.y + s1, p.z);
+        rlVertex3f(p.x + c0, p.y, p.z + s0);
+        rlVertex3f(p.x + c1, p.y, p.z + s1);
+        rlVertex3f(p.x, p.y + c0, p.z + s0);
+        rlVertex3f(p.x, p.y + c1, p.z + s1);
+    }
+}
+
+// consecutive RL_LINES runs on the default texture stay one draw call,
+// rlCheckRenderBatchLimit only flushes when the rlgl batch is full
+static void debug_draw_emit(const debug_draw_cmd_t *cmd){
+    rlCheckRenderBatchLimit(debug_draw_vertex_count(cmd));
+    rlBegin(RL_LINES);
+    rlColor4ub(cmd->color.r, cmd->color.g, cmd->color.b, cmd->color.a);
+    switch (cmd->kind) {
+        case DEBUG_DRAW_BOX: debug_draw_emit_box(cmd); break;
+        case DEBUG_DRAW_SPHERE: debug_draw_emit_sphere(cmd); break;
+        default:
+            debug_draw_vertex(cmd->a);
+            debug_draw_vertex(cmd->b);
+            break;
+    }
+    rlEnd();
+}
+
+void debug_draw_flush_system(ecs_iter_t *it){
+    debug_draw_t *dd = ecs_singleton_get_mut(it->world, debug_draw_t);
+    if (!dd || !dd->host) return;
+    debug_draw_host_t *host = dd->host;
+    dd->dropped += debug_draw_gather(host);
+    dd->command_count = 0;
+    dd->line_count = 0;
+
+    if (dd->enabled) {
+        for (int32_t i = 0; i < host->retained_count; i++) {
+            debug_draw_emit(&host->retained[i]);
+            dd->line_count += debug_draw_vertex_count(&host->retained[i]) / 2;
+        }
+        dd->command_count = host->retained_count;
+    }
+
+    // drawn at least once, then kept while time is left
+    int32_t kept = 0;
+    for (int32_t i = 0; i < host->retained_count; i++) {
+        debug_draw_cmd_t *cmd = &host->retained[i];
+        cmd->time -= it->delta_time;
+        if (cmd->time > 0.0f) host->retained[kept++] = *cmd;
+    }
+    host->retained_count = kept;
+}
+
+void on_remove_debug_draw(ecs_iter_t *it){
+    debug_draw_t *dd = ecs_field(it, debug_draw_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        debug_draw_host_t *host = dd[i].host;
+        if (!host) continue;
+        if (debug_draw_active == host) debug_draw_active = NULL;
+        for (int32_t b = 0; b < host->buffer_count; b++) {
+            ecs_os_mutex_free(host->buffers[b].lock);
+            ecs_os_free(host->buffers[b].commands);
+        }
+        ecs_os_mutex_free(host->lock);
+        ecs_os_free(host->retained);
+        ecs_os_free(host);
+        dd[i].host = NULL;
+    }
+}
+
+void setup_systems_debug_draw(ecs_world_t *world){
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "debug_draw_flush_system", .add = ecs_ids(ecs_dependson(RLRender3DPhase)) }),
+        .callback = debug_draw_flush_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(debug_draw_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_debug_draw
+    });
+}
+
+void setup_components_debug_draw(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, debug_draw_t);
+
+    for (int32_t s = 0; s <= DEBUG_DRAW_SPHERE_SEGMENTS; s++) {
+        float angle = 2.0f * PI * (float)s / (float)DEBUG_DRAW_SPHERE_SEGMENTS;
+        debug_draw_circle[s][0] = cosf(angle);
+        debug_draw_circle[s][1] = sinf(angle);
+    }
+
+    debug_draw_host_t *host = ecs_os_calloc(sizeof(debug_draw_host_t));
+    if (!host) return;
+    host->lock = ecs_os_mutex_new();
+    host->generation = ++debug_draw_generation;
+    debug_draw_active = host;
+    ecs_singleton_set(world, debug_draw_t, {
+        .host = host,
+        .enabled = true
+    });
+}
+
+// call after module_init_raylib (phases)
+void module_init_debug_draw(ecs_world_t *world){
+    setup_components_debug_draw(world);
+    setup_systems_debug_draw(world);
+}
@@ -1,9 +1,190 @@
 // module_editor.c
 // for editor gui and others
+#include <stdlib.h>
+#include <string.h>
 #include "ecs_components.h"
 #include "module_editor.h"
 #include "raygui.h"
 
+ECS_COMPONENT_DECLARE(editor_list_t);
+
+#define EDITOR_UNNAMED "(unnamed)"
+#define EDITOR_ARENA_SLACK (64 * 1024) // stale bytes allowed before compaction
+
+//===============================================
+// EDITOR LIST MODEL
+//===============================================
+static uint64_t editor_hash_name(const char *name){
+    // fnv-1a
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++) {
+        hash ^= *c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static const char *editor_entity_name(ecs_world_t *world, ecs_entity_t e){
+    const char *name = ecs_get_name(world, e);
+    return name ? name : EDITOR_UNNAMED;
+}
+
+// names hold pointers into the arena, refresh them after it moved
+static void editor_list_rebase(editor_list_t *list){
+    for (int32_t i = 0; i < list->count; i++) {
+        list->names[i] = list->arena + list->offsets[i];
+    }
+}
+
+// offset of name in the arena, appended once per distinct string
+static uint32_t editor_list_intern(editor_list_t *list, const char *name){
+    uint64_t hash = editor_hash_name(name);
+    ecs_map_val_t *found = ecs_map_get(&list->interned, hash);
+    if (found && strcmp(list->arena + *found, name) == 0) {
+        return (uint32_t)*found;
+    }
+
+    uint32_t length = (uint32_t)strlen(name) + 1;
+    if (list->arena_used + length > list->arena_capacity) {
+        uint32_t capacity = list->arena_capacity ? list->arena_capacity * 2 : 4096;
+        while (capacity < list->arena_used + length) capacity *= 2;
+        char *arena = ecs_os_realloc(list->arena, capacity);
+        if (!arena) return 0; // offset 0 is EDITOR_UNNAMED
+        bool moved = arena != list->arena;
+        list->arena = arena;
+        list->arena_capacity = capacity;
+        if (moved) editor_list_rebase(list);
+    }
+    uint32_t offset = list->arena_used;
+    memcpy(list->arena + offset, name, length);
+    list->arena_used += length;
+    if (!found) ecs_map_insert(&list->interned, hash, offset); // on a hash clash the string is just not shared
+    return offset;
+}
+
+// renames leave stale strings behind, rebuild the arena from live rows
+static void editor_list_compact(editor_list_t *list){
+    if (list->arena_used < list->arena_live * 2 + EDITOR_ARENA_SLACK) return;
+
+    char *old = list->arena;
+    list->arena = NULL;
+    list->arena_used = 0;
+    list->arena_capacity = 0;
+    ecs_map_clear(&list->interned);
+    editor_list_intern(list, EDITOR_UNNAMED);
+    for (int32_t i = 0; i < list->count; i++) {
+        list->offsets[i] = editor_list_intern(list, old + list->offsets[i]);
+    }
+    ecs_os_free(old);
+    editor_list_rebase(list);
+    list->arena_live = list->arena_used;
+}
+
+static bool editor_list_reserve(editor_list_t *list, int32_t count){
+    if (count <= list->capacity) return true;
+    int32_t capacity = list->capacity ? list->capacity * 2 : 256;
+    while (capacity < count) capacity *= 2;
+    ecs_entity_t *ids = ecs_os_realloc(list->ids, sizeof(ecs_entity_t) * capacity);
+    if (ids) list->ids = ids;
+    const char **names = ecs_os_realloc((void *)list->names, sizeof(const char *) * capacity);
+    if (names) list->names = names;
+    uint32_t *offsets = ecs_os_realloc(list->offsets, sizeof(uint32_t) * capacity);
+    if (offsets) list->offsets = offsets;
+    if (!ids || !names || !offsets) return false;
+    list->capacity = capacity;
+    return true;
+}
+
+int32_t editor_list_find(const editor_list_t *list, ecs_entity_t entity){
+    ecs_map_val_t *row = ecs_map_get(&list->index, entity);
+    return row ? (int32_t)*row : -1;
+}
+
+static void editor_list_add(editor_list_t *list, ecs_world_t *world, ecs_entity_t e){
+    if (editor_list_find(list, e) >= 0) return;
+    if (!editor_list_reserve(list, list->count + 1)) return;
+    int32_t row = list->count++;
+    list->ids[row] = e;
+    list->offsets[row] = editor_list_intern(list, editor_entity_name(world, e));
+    list->names[row] = list->arena + list->offsets[row];
+    ecs_map_insert(&list->index, e, (ecs_map_val_t)row);
+}
+
+// swap remove, the last row takes the removed slot
+static void editor_list_remove(editor_list_t *list, ecs_entity_t e){
+    int32_t row = editor_list_find(list, e);
+    if (row < 0) return;
+    ecs_map_remove(&list->index, e);
+    int32_t last = --list->count;
+    if (row != last) {
+        list->ids[row] = list->ids[last];
+        list->offsets[row] = list->offsets[last];
+        list->names[row] = list->names[last];
+        ecs_map_val_t *moved = ecs_map_get(&list->index, list->ids[row]);
+        if (moved) *moved = (ecs_map_val_t)row;
+    }
+}
+
+static void editor_list_rename(editor_list_t *list, ecs_world_t *world, ecs_entity_t e){
+    int32_t row = editor_list_find(list, e);
+    if (row < 0) return;
+    list->offsets[row] = editor_list_intern(list, editor_entity_name(world, e));
+    list->names[row] = list->arena + list->offsets[row];
+    editor_list_compact(list);
+}
+
+void on_add_transform_editor_list(ecs_iter_t *it){
+    editor_list_t *list = ecs_singleton_get_mut(it->world, editor_list_t);
+    if (!list) return;
+    for (int i = 0; i < it->count; i++) {
+        editor_list_add(list, it->world, it->entities[i]);
+    }
+}
+
+void on_remove_transform_editor_list(ecs_iter_t *it){
+    editor_list_t *list = ecs_singleton_get_mut(it->world, editor_list_t);
+    if (!list) return;
+    for (int i = 0; i < it->count; i++) {
+        editor_list_remove(list, it->entities[i]);
+    }
+}
+
+void on_set_name_editor_list(ecs_iter_t *it){
+    editor_list_t *list = ecs_singleton_get_mut(it->world, editor_list_t);
+    if (!list) return;
+    for (int i = 0; i < it->count; i++) {
+        editor_list_rename(list, it->world, it->entities[i]);
+    }
+}
+
+void on_remove_editor_list(ecs_iter_t *it){
+    editor_list_t *list = ecs_field(it, editor_list_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        ecs_os_free(list[i].ids);
+        ecs_os_free((void *)list[i].names);
+        ecs_os_free(list[i].offsets);
+        ecs_os_free(list[i].arena);
+        ecs_map_fini(&list[i].index);
+        ecs_map_fini(&list[i].interned);
+        memset(&list[i], 0, sizeof(editor_list_t));
+    }
+}
+
+// list entities that had Transform3D before the module was set up
+static void editor_list_populate(ecs_world_t *world){
+    editor_list_t *list = ecs_singleton_get_mut(world, editor_list_t);
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Transform3D) }}
+    });
+    ecs_iter_t qit = ecs_query_iter(world, q);
+    while (ecs_query_next(&qit)) {
+        for (int i = 0; i < qit.count; i++) {
+            editor_list_add(list, world, qit.entities[i]);
+        }
+    }
+    ecs_query_fini(q);
+}
+
 // non transform 3d example config, game logic, event, props
 void render_2d_entity_scene_list_system(ecs_iter_t *it){
 
@@ -37,13 +218,47 @@ void setup_systems_editor(ecs_world_t *world){
       //},
       .callback = render_2d_menu_bar_editor_system
     });
+
+    // editor list model
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Transform3D) }},
+        .events = { EcsOnAdd },
+        .callback = on_add_transform_editor_list
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Transform3D) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_transform_editor_list
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_pair(ecs_id(EcsIdentifier), EcsName) }},
+        .events = { EcsOnSet },
+        .callback = on_set_name_editor_list
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(editor_list_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_editor_list
+    });
 }
 
 void setup_components_editor(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, editor_list_t);
 
+    editor_list_t list = {0};
+    ecs_map_init(&list.index, NULL);
+    ecs_map_init(&list.interned, NULL);
+    editor_list_intern(&list, EDITOR_UNNAMED); // offset 0, fallback on allocation failure
+    list.arena_live = list.arena_used;
+    ecs_singleton_set_ptr(world, editor_list_t, &list);
 }
 
+// call after module_init_raylib (Transform3D)
 void module_init_editor(ecs_world_t *world){
     setup_components_editor(world);
     setup_systems_editor(world);
+    editor_list_populate(world);
 } 
\ No newline at end of file
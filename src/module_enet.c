@@ -10,6 +10,7 @@
 
 #include "ecs_components.h" // phase
 #include "module_enet.h"
+#include "module_profiler.h"
 // #include "raylib.h"
 #include "raygui.h"
 
@@ -19,6 +20,7 @@ ECS_COMPONENT_DECLARE(NetworkConfig);
 ECS_COMPONENT_DECLARE(NetworkState);
 ECS_COMPONENT_DECLARE(enet_client_t);
 ECS_COMPONENT_DECLARE(enet_init_network_tag);
+ECS_COMPONENT_DECLARE(enet_outbox_t);
 
 // Declare event entity (defined in setup_components_enet)
 // ecs_entity_t event_receive_packed = 0;
@@ -29,6 +31,159 @@ ecs_entity_t event_disconnect_timeout;
 
 ENetHost *g_host = NULL;  // Global for simplicity (or store in singleton)
 
+static ecs_query_t *enet_outbox_query = NULL;
+
+//===============================================
+// OUTBOX
+//===============================================
+// hand the batch to enet as one packet. a batch holding a single message is
+// sent bare, the receiver handles both.
+static void enet_batch_seal(ENetPeer *peer, enet_outbox_t *outbox, enet_batch_t *batch, enet_uint32 flags){
+    if (batch->messages == 0) return;
+    ENetPacket *packet;
+    if (batch->messages == 1) {
+        packet = enet_packet_create(batch->data + 3, batch->length - 3, flags);
+    } else {
+        packet = enet_packet_create(batch->data, batch->length, flags);
+    }
+    if (packet && enet_peer_send(peer, 0, packet) == 0) {
+        outbox->tick_messages += batch->messages;
+        outbox->tick_datagrams++;
+        outbox->tick_bytes += (uint32_t)packet->dataLength;
+    } else if (packet) {
+        enet_packet_destroy(packet);
+    }
+    batch->length = 0;
+    batch->messages = 0;
+}
+
+bool enet_outbox_send(ecs_world_t *world, ENetPeer *peer, const void *data, size_t length, bool reliable){
+    if (!peer || !data || length == 0) return false;
+    enet_uint32 flags = reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED;
+
+    ecs_entity_t e = (ecs_entity_t)(uintptr_t)peer->data;
+    enet_outbox_t *outbox = (e && ecs_is_alive(world, e)) ? ecs_get_mut(world, e, enet_outbox_t) : NULL;
+    if (!outbox) {
+        // no entity yet (connect still deferred), send it on its own
+        ENetPacket *packet = enet_packet_create(data, length, flags);
+        if (!packet) return false;
+        if (enet_peer_send(peer, 0, packet) != 0) {
+            enet_packet_destroy(packet);
+            return false;
+        }
+        return true;
+    }
+
+    enet_batch_t *batch = reliable ? &outbox->reliable : &outbox->unreliable;
+    if (length + 3 > ENET_OUTBOX_MTU - 1) {
+        // too big to batch, keep ordering and let enet fragment it
+        enet_batch_seal(peer, outbox, batch, flags);
+        ENetPacket *packet = enet_packet_create(data, length, flags);
+        if (!packet) return false;
+        if (enet_peer_send(peer, 0, packet) != 0) {
+            enet_packet_destroy(packet);
+            return false;
+        }
+        outbox->tick_messages++;
+        outbox->tick_datagrams++;
+        outbox->tick_bytes += (uint32_t)length;
+        return true;
+    }
+    if (batch->length + 3 + length > ENET_OUTBOX_MTU) {
+        enet_batch_seal(peer, outbox, batch, flags);
+    }
+    if (batch->length == 0) {
+        batch->data[0] = ENET_MSG_BATCH;
+        batch->length = 1;
+    }
+    uint8_t *dst = batch->data + batch->length;
+    dst[0] = (uint8_t)(length);
+    dst[1] = (uint8_t)(length >> 8);
+    memcpy(dst + 2, data, length);
+    batch->length += (uint16_t)(length + 2);
+    batch->messages++;
+    return true;
+}
+
+void enet_outbox_broadcast(ecs_world_t *world, const void *data, size_t length, bool reliable){
+    ecs_iter_t qit = ecs_query_iter(world, enet_outbox_query);
+    while (ecs_query_next(&qit)) {
+        enet_client_t *client = ecs_field(&qit, enet_client_t, 0);
+        for (int i = 0; i < qit.count; i++) {
+            if (client[i].peer && client[i].peer->state == ENET_PEER_STATE_CONNECTED) {
+                enet_outbox_send(world, client[i].peer, data, length, reliable);
+            }
+        }
+    }
+}
+
+// split a received packet back into messages for the enet_packet_t observers
+static void enet_emit_message(ecs_world_t *world, ENetPeer *peer, uint8_t *data, size_t length){
+    // observers read the packet in place, it is destroyed after the emit
+    enet_packet_t packet = {
+        .data = data,
+        .length = length,
+        .peer = peer
+    };
+    ecs_emit(world, &(ecs_event_desc_t) {
+        .event = ecs_id(enet_packet_t),
+        .entity = event_receive_packed,
+        .param = &packet
+    });
+}
+
+static void enet_emit_packet(ecs_world_t *world, ENetPeer *peer, uint8_t *data, size_t length){
+    if (length == 0) return;
+    if (data[0] != ENET_MSG_BATCH) {
+        enet_emit_message(world, peer, data, length);
+        return;
+    }
+    size_t offset = 1;
+    while (offset + 2 <= length) {
+        size_t size = (size_t)data[offset] | ((size_t)data[offset + 1] << 8);
+        offset += 2;
+        if (size == 0 || offset + size > length) {
+            printf("Malformed batch from peer %u\n", peer->incomingPeerID);
+            return;
+        }
+        enet_emit_message(world, peer, data + offset, size);
+        offset += size;
+    }
+}
+
+// start of tick: batches sealed early (mtu overflow, oversized messages)
+// count toward this tick as well as the ones sealed by the flush
+void enet_outbox_tick_system(ecs_iter_t *it){
+    enet_outbox_t *outbox = ecs_field(it, enet_outbox_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        outbox[i].tick_messages = 0;
+        outbox[i].tick_datagrams = 0;
+        outbox[i].tick_bytes = 0;
+    }
+}
+
+// end of tick: seal every batch and push it all out in one flush
+void enet_outbox_flush_system(ecs_iter_t *it){
+    enet_client_t *client = ecs_field(it, enet_client_t, 0);
+    enet_outbox_t *outbox = ecs_field(it, enet_outbox_t, 1);
+    const NetworkState *state = ecs_singleton_get(it->world, NetworkState);
+
+    for (int i = 0; i < it->count; i++) {
+        enet_outbox_t *o = &outbox[i];
+        if (client[i].peer) {
+            enet_batch_seal(client[i].peer, o, &o->reliable, ENET_PACKET_FLAG_RELIABLE);
+            enet_batch_seal(client[i].peer, o, &o->unreliable, ENET_PACKET_FLAG_UNSEQUENCED);
+        }
+        o->messages_sent += o->tick_messages;
+        o->datagrams_sent += o->tick_datagrams;
+        o->bytes_sent += o->tick_bytes;
+    }
+
+    if (state && state->host) {
+        enet_host_flush(state->host);
+    }
+}
+
 // Render HUD system
 void render2d_hud_enet_system(ecs_iter_t *it) {
     const NetworkConfig *config = ecs_singleton_get(it->world, NetworkConfig);
@@ -65,16 +220,36 @@ void render2d_hud_enet_system(ecs_iter_t *it) {
     } else {
         DrawText("Client: Disconnected", 2, y_offset, font_size, DARKGRAY);
     }
+    y_offset += spacing;
+
+    // outbox counters over all peers
+    int peers = 0;
+    uint64_t messages = 0, datagrams = 0, bytes = 0;
+    ecs_iter_t qit = ecs_query_iter(it->world, enet_outbox_query);
+    while (ecs_query_next(&qit)) {
+        enet_outbox_t *outbox = ecs_field(&qit, enet_outbox_t, 1);
+        for (int i = 0; i < qit.count; i++) {
+            peers++;
+            messages += outbox[i].messages_sent;
+            datagrams += outbox[i].datagrams_sent;
+            bytes += outbox[i].bytes_sent;
+        }
+    }
+    if (peers > 0) {
+        DrawText(TextFormat("Out: %.1f msg/datagram, %llu bytes/peer", datagrams ? (double)messages / (double)datagrams : 0.0, (unsigned long long)(bytes / (uint64_t)peers)), 2, y_offset, font_size, DARKGRAY);
+    }
 }
 
 // enet packet for string data
 void on_receive_packed(ecs_iter_t *it) {
-    printf("event on_receive_packed\n");
     enet_packet_t *p = it->param;
     if (p && p->data) {
-        char *str = (char*)p->data;
-        printf("Received string: %s\n", str);
-        free(str); // Free the dynamically allocated string
+        const char *str = (const char*)p->data;
+        if (p->length > 0 && (unsigned char)str[0] < ENET_MSG_BINARY_MAX) {
+            return; // binary message, handled by other observers
+        }
+        // data is owned by network_service_system, do not free here
+        printf("Received string: %.*s\n", (int)p->length, str);
     } else {
         printf("No valid string data received\n");
     }
@@ -82,14 +257,13 @@ void on_receive_packed(ecs_iter_t *it) {
 
 void test_input_enet_system(ecs_iter_t *it){
     if (IsKeyDown(KEY_R)) {
-        char *str = strdup("hello"); // Dynamically allocate string
-        enet_packet_t packet = { .data = str };
+        static char str[] = "hello";
+        enet_packet_t packet = { .data = str, .length = sizeof(str), .peer = NULL };
         ecs_emit(it->world, &(ecs_event_desc_t) {
             .event = ecs_id(enet_packet_t),
             .entity = event_receive_packed,
             .param = &packet
         });
-        // Note: str must be freed later, e.g., in the observer or a cleanup system
     }
 }
 
@@ -184,8 +358,9 @@ void network_service_system(ecs_iter_t *it) {
     }
 
     ENetEvent event;
+    profiler_zone_begin("enet_service");
     while (enet_host_service(state->host, &event, 0) > 0) {
-        printf("Network event: %d\n", event.type);
+        if (event.type != ENET_EVENT_TYPE_RECEIVE) printf("Network event: %d\n", event.type);
         switch (event.type) {
             case ENET_EVENT_TYPE_CONNECT:
                 // printf("Connected! Peer ID: %u\n", event.peer->incomingPeerID);
@@ -203,34 +378,25 @@ void network_service_system(ecs_iter_t *it) {
 
                 // add either server or client peer when connected
                 ecs_entity_t new_peer = ecs_new(it->world);
+                // peer->data maps the peer back to its entity
+                event.peer->data = (void *)(uintptr_t)new_peer;
                 ecs_set(it->world, new_peer, enet_client_t, {
                     .peer = event.peer
                 });
+                ecs_set(it->world, new_peer, enet_outbox_t, { 0 });
                 
                 break;
             case ENET_EVENT_TYPE_DISCONNECT:
                 printf("Disconnected! Peer ID: %d\n", event.peer->connectID);
 
-                ecs_query_t *q = ecs_query(it->world, {
-                    .terms = {
-                        { .id = ecs_id(enet_client_t) }
-                    }
-                });
-
-                ecs_iter_t qit = ecs_query_iter(it->world, q);
-                while (ecs_query_next(&qit)) {
-                    enet_client_t *peer = ecs_field(&qit, enet_client_t, 0);
-                    for (int i = 0; i < qit.count; i++) {
-                        // Do the thing
-                        if (peer[i].peer->connectID == event.peer->connectID){
-                            printf("found peer! remove!\n");
-                            ecs_delete(it->world, qit.entities[i]);
-                            break;
-                        }
+                if (event.peer->data) {
+                    ecs_entity_t peer_entity = (ecs_entity_t)(uintptr_t)event.peer->data;
+                    if (ecs_is_alive(it->world, peer_entity)) {
+                        printf("found peer! remove!\n");
+                        ecs_delete(it->world, peer_entity);
                     }
+                    event.peer->data = NULL;
                 }
-                //clean up query
-                ecs_query_fini(q);
 
                 break;
             case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
@@ -243,48 +409,31 @@ void network_service_system(ecs_iter_t *it) {
                 }
                 ecs_singleton_modified(it->world, NetworkState);
 
-                ecs_query_t *qd = ecs_query(it->world, {
-                    .terms = {
-                        { .id = ecs_id(enet_client_t) }
-                    }
-                });
-
-                ecs_iter_t qdit = ecs_query_iter(it->world, qd);
-                while (ecs_query_next(&qdit)) {
-                    enet_client_t *peer = ecs_field(&qdit, enet_client_t, 0);
-                    for (int i = 0; i < qdit.count; i++) {
-                        // Do the thing
-                        if (peer[i].peer->connectID == event.peer->connectID){
-                            printf("found peer! remove!\n");
-                            printf("entity id: %d\n", qdit.entities[i]);
-                            ecs_delete(it->world, qdit.entities[i]);
-                            break;
-                        }
+                if (event.peer->data) {
+                    ecs_entity_t peer_entity = (ecs_entity_t)(uintptr_t)event.peer->data;
+                    if (ecs_is_alive(it->world, peer_entity)) {
+                        printf("found peer! remove!\n");
+                        printf("entity id: %llu\n", (unsigned long long)peer_entity);
+                        ecs_delete(it->world, peer_entity);
                     }
+                    event.peer->data = NULL;
                 }
-                //clean up query
-                ecs_query_fini(qd);
 
                 break;
             case ENET_EVENT_TYPE_RECEIVE:
-                printf("Received packet from peer %u, channel %u, size %zu\n",
-                       event.peer->incomingPeerID, event.channelID, event.packet->dataLength);
-                if (event.packet->dataLength > 0) {
-                    // Copy data to avoid use-after-free
-                    char *data_copy = strdup((char *)event.packet->data);
-                    enet_packet_t packet = { .data = data_copy };
-                    ecs_emit(it->world, &(ecs_event_desc_t) {
-                        .event = ecs_id(enet_packet_t),
-                        .entity = event_receive_packed,
-                        .param = &packet
-                    });
+                // binary messages arrive every tick, only log text
+                if (event.packet->dataLength > 0 && event.packet->data[0] >= ENET_MSG_BINARY_MAX) {
+                    printf("Received packet from peer %u, channel %u, size %zu\n",
+                           event.peer->incomingPeerID, event.channelID, event.packet->dataLength);
                 }
+                enet_emit_packet(it->world, event.peer, event.packet->data, event.packet->dataLength);
                 enet_packet_destroy(event.packet);
                 break;
             default:
                 break;
         }
     }
+    profiler_zone_end();
 
     // // test
     // // Send periodic packets (like standalone code)
@@ -347,16 +496,12 @@ void network_input_system(ecs_iter_t *it) {
     if (IsKeyPressed(KEY_T)) {
         // client
         if(state->isServer == false && state->clientConnected && state->peer){
-            ENetPacket *packet = enet_packet_create("test message", strlen("test message") + 1, ENET_PACKET_FLAG_RELIABLE);
-            enet_peer_send(state->peer, 0, packet);
-            enet_host_flush(state->host);
+            enet_outbox_send(it->world, state->peer, "test message", strlen("test message") + 1, true);
             printf("Sent test packet\n");
         }
         // server
         if(config->isNetwork == true && state->isServer == true && state->peer){
-            ENetPacket *packet = enet_packet_create("test message", strlen("test message") + 1, ENET_PACKET_FLAG_RELIABLE);
-            enet_peer_send(state->peer, 0, packet);
-            enet_host_flush(state->host);
+            enet_outbox_send(it->world, state->peer, "test message", strlen("test message") + 1, true);
             printf("Sent test packet\n");
         }
     }
@@ -369,9 +514,7 @@ void network_input_system(ecs_iter_t *it) {
     if (IsKeyPressed(KEY_B)) {
         //for peer we need to check if peer exist for client connect else error i think.
         if(config->isNetwork == true && state->isServer == true){
-            ENetPacket *packet = enet_packet_create("[server] test message", strlen("[server] test message") + 1, ENET_PACKET_FLAG_RELIABLE);
-            enet_host_broadcast(state->host,0,packet);
-            enet_host_flush(state->host);
+            enet_outbox_broadcast(it->world, "[server] test message", strlen("[server] test message") + 1, true);
         }
     }
 
@@ -384,13 +527,7 @@ void network_input_system(ecs_iter_t *it) {
             // enet_host_flush(state->host);
             // printf("Sent test packet\n");
 
-            ecs_query_t *q = ecs_query(it->world, {
-                .terms = {
-                    { .id = ecs_id(enet_client_t) }
-                }
-            });
-
-            ecs_iter_t qit = ecs_query_iter(it->world, q);
+            ecs_iter_t qit = ecs_query_iter(it->world, enet_outbox_query);
             while (ecs_query_next(&qit)) {
                 enet_client_t *client = ecs_field(&qit, enet_client_t, 0);
                 for (int i = 0; i < qit.count; i++) {
@@ -402,9 +539,8 @@ void network_input_system(ecs_iter_t *it) {
                     // }
 
                     if (client[i].peer){
-                        ENetPacket *packet = enet_packet_create("[server] test message", strlen("[server] test message") + 1, ENET_PACKET_FLAG_RELIABLE);
-                        enet_peer_send(client[i].peer, 0, packet);
-                        enet_host_flush(state->host);
+                        // batched, one datagram per peer at the end of the tick
+                        enet_outbox_send(it->world, client[i].peer, "[server] test message", strlen("[server] test message") + 1, true);
                         printf("Sent test packet\n");
                     }
 
@@ -412,8 +548,6 @@ void network_input_system(ecs_iter_t *it) {
 
                 }
             }
-            //clean up query
-            ecs_query_fini(q);
 
         }
     }
@@ -431,6 +565,14 @@ void network_input_system(ecs_iter_t *it) {
 
 void setup_systems_enet(ecs_world_t *world){
 
+    enet_outbox_query = ecs_query(world, {
+        .terms = {
+            { .id = ecs_id(enet_client_t) },
+            { .id = ecs_id(enet_outbox_t) }
+        },
+        .cache_kind = EcsQueryCacheAuto
+    });
+
     // Input
     ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "test_input_enet_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
@@ -473,6 +615,15 @@ void setup_systems_enet(ecs_world_t *world){
         .callback = network_init_system
     });
 
+    // first phase, before anything is sent this tick
+    ecs_system_init(world, &(ecs_system_desc_t){
+        .entity = ecs_entity(world, { .name = "enet_outbox_tick_system", .add = ecs_ids(ecs_dependson(EcsOnLoad)) }),
+        .query.terms = {
+            { .id = ecs_id(enet_outbox_t) }
+        },
+        .callback = enet_outbox_tick_system
+    });
+
     // Service in logic update
     ecs_system_init(world, &(ecs_system_desc_t){
         .entity = ecs_entity(world, { .name = "network_service_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
@@ -489,6 +640,16 @@ void setup_systems_enet(ecs_world_t *world){
         },
         .callback = network_input_system
     });
+
+    // after gameplay and network sends (PostUpdate), before drawing finishes
+    ecs_system_init(world, &(ecs_system_desc_t){
+        .entity = ecs_entity(world, { .name = "enet_outbox_flush_system", .add = ecs_ids(ecs_dependson(EcsOnStore)) }),
+        .query.terms = {
+            { .id = ecs_id(enet_client_t) },
+            { .id = ecs_id(enet_outbox_t) }
+        },
+        .callback = enet_outbox_flush_system
+    });
 }
 
 // component definitions
@@ -499,6 +660,7 @@ void setup_components_enet(ecs_world_t *world){
     ECS_COMPONENT_DEFINE(world, NetworkState);
     ECS_COMPONENT_DEFINE(world, enet_client_t);
     ECS_COMPONENT_DEFINE(world, enet_init_network_tag);
+    ECS_COMPONENT_DEFINE(world, enet_outbox_t);
 
     // Define the event entity network type
     event_receive_packed = ecs_entity(world, { .name = "receive_packed" });
@@ -4,6 +4,7 @@
 #include "module_libevent.h"
 #include <string.h>
 #include <stdlib.h>
+#include <event2/thread.h>
 
 // Define global constants and storage for connected clients
 int MAX_CLIENTS = 10;
@@ -24,147 +25,259 @@ ECS_COMPONENT_DECLARE(libevent_packet_t);
 // event dispatch for network get data...
 ecs_entity_t libevent_receive_packed;
 
+static ecs_query_t *libevent_client_query = NULL;
+
 //===============================================
 // CALLBACKS
 //===============================================
-// Server: Handle client read
-void server_read_cb(struct bufferevent *bev, void *ctx) {
-    libevent_context_t *app = (libevent_context_t *)ctx;
-    char buf[256];
-    size_t n = bufferevent_read(bev, buf, sizeof(buf) - 1);
-    buf[n] = '\0';
-    if (strcmp(buf, "PING") == 0) {
-        bufferevent_write(bev, "PONG", 4);
-        snprintf(app->status, sizeof(app->status), "Server: Received PING, sent PONG");
-        printf("[server] ping\n");
-    } else if (strcmp(buf, "PONG") == 0) {
+// read callback state for libevent_frame_dispatch
+typedef struct {
+    libevent_context_t *app;
+    struct bufferevent *bev;
+    bool is_server;
+} libevent_read_t;
+
+// one complete frame, frame points into the input evbuffer
+static bool libevent_handle_frame(uint16_t type, const uint8_t *frame, size_t frame_length, void *user){
+    libevent_read_t *read = (libevent_read_t *)user;
+    libevent_context_t *app = read->app;
+    const char *role = read->is_server ? "Server" : "Client";
+    const uint8_t *payload = libevent_frame_payload(frame);
+    uint16_t length = libevent_frame_payload_length(frame);
+
+    if (type == LIBEVENT_MSG_CONTROL && length == 4 && memcmp(payload, "PING", 4) == 0) {
+        libevent_frame_write(bufferevent_get_output(read->bev), LIBEVENT_MSG_CONTROL, "PONG", 4);
+        snprintf(app->status, sizeof(app->status), "%s: Received PING, sent PONG", role);
+        printf("[%s] ping\n", role);
+    } else if (type == LIBEVENT_MSG_CONTROL && length == 4 && memcmp(payload, "PONG", 4) == 0) {
         app->pongs_received++;
-        snprintf(app->status, sizeof(app->status), "Server: Received PONG (%d)", app->pongs_received);
-        printf("[server] pong\n");
+        snprintf(app->status, sizeof(app->status), "%s: Received PONG (%d)", role, app->pongs_received);
+        printf("[%s] pong\n", role);
     } else {
-        printf("[server] unknown\n");
-        snprintf(app->status, sizeof(app->status), "Server: Unknown message: %s", buf);
+        switch (type) {
+            case LIBEVENT_MSG_POSITION:
+                if (length == sizeof(float) * 3) {
+                    snprintf(app->status, sizeof(app->status), "%s: Received position update", role);
+                }
+                break;
+            case LIBEVENT_MSG_HEALTH:
+                if (length == sizeof(int32_t)) {
+                    snprintf(app->status, sizeof(app->status), "%s: Received health update", role);
+                }
+                break;
+            case LIBEVENT_MSG_CHAT:
+                snprintf(app->status, sizeof(app->status), "%s: %.*s", role, (int)length, (const char *)payload);
+                break;
+            default:
+                snprintf(app->status, sizeof(app->status), "%s: Unknown message type: %d", role, type);
+        }
     }
-    //ecs_singleton_modified(app->world, libevent_context_t);
-    // Emit the received data as an ECS event
-    if (app->world) {
-        // Create a libevent_packet_t instance
+
+    // Emit the received frame as an ECS event, only valid during the emit
+    if (read->is_server && app->world) {
         libevent_packet_t packet = {
-            .data = strdup(buf), // Dynamically allocate a copy of buf
-            .bev = bev
+            .data = (void *)frame,
+            .length = frame_length,
+            .bev = read->bev
         };
-        if (packet.data) { // Check if strdup succeeded
-            ecs_emit(app->world, &(ecs_event_desc_t) {
-                .event = ecs_id(libevent_packet_t),
-                .entity = libevent_receive_packed,
-                .param = &packet
-            });
-        } else {
-            printf("[server] Failed to allocate memory for packet data\n");
-        }
+        ecs_emit(app->world, &(ecs_event_desc_t) {
+            .event = ecs_id(libevent_packet_t),
+            .entity = libevent_receive_packed,
+            .param = &packet
+        });
     }
+    return true;
 }
 
-/*
-void server_read_cb(struct bufferevent *bev, void *ctx) {
-    libevent_context_t *app = (libevent_context_t *)ctx;
-    struct evbuffer *input = bufferevent_get_input(bev);
-    size_t len = evbuffer_get_length(input); // Get available data size
+// threaded server. frames go through the lock free queue, connect,
+// disconnect and status events never wait or get dropped: when the queue
+// is full they go to the overflow list, and while that list holds anything
+// frames wait too so the ECS sees every connection's events in order. a
+// connection whose frame does not fit stops reading (TCP pushes back on the
+// peer) and reads again when the ECS has drained the queue.
+typedef struct libevent_overflow_item_s {
+    struct libevent_overflow_item_s *next;
+    uint8_t kind;                       // libevent_queue_kind_t
+    libevent_conn_t *conn;
+    uint32_t length;
+    uint8_t data[];
+} libevent_overflow_item_t;
+
+struct libevent_overflow_s {
+    ecs_os_mutex_t lock;                // guards the list, control pushes and the drain mark
+    libevent_overflow_item_t *head;
+    libevent_overflow_item_t *tail;
+    _Atomic bool pending;               // list is not empty
+    _Atomic bool resume_wanted;         // a connection stopped reading
+    struct event *resume;               // dispatch thread, reads paused connections again
+    libevent_conn_t *paused;            // dispatch thread only
+};
+
+// large queued frames go through the counted ecs_os allocator
+static void *libevent_queue_alloc(size_t size){
+    return ecs_os_malloc((ecs_size_t)size);
+}
 
-    if (len < sizeof(uint16_t) * 2) {
-        // Not enough data for header (type + length)
-        return;
+static void libevent_queue_free(void *ptr){
+    ecs_os_free(ptr);
+}
+
+static libevent_overflow_t *libevent_overflow_new(void){
+    libevent_overflow_t *overflow = ecs_os_calloc(sizeof(libevent_overflow_t));
+    if (!overflow) return NULL;
+    overflow->lock = ecs_os_mutex_new();
+    atomic_init(&overflow->pending, false);
+    atomic_init(&overflow->resume_wanted, false);
+    return overflow;
+}
+
+static void libevent_overflow_free(libevent_overflow_t *overflow){
+    if (!overflow) return;
+    libevent_overflow_item_t *item = overflow->head;
+    while (item) {
+        libevent_overflow_item_t *next = item->next;
+        ecs_os_free(item);
+        item = next;
     }
+    if (overflow->resume) event_free(overflow->resume);
+    ecs_os_mutex_free(overflow->lock);
+    ecs_os_free(overflow);
+}
 
-    // Peek at the header to get the message length
-    struct GameMessage header;
-    if (evbuffer_copyout(input, &header, sizeof(header)) != sizeof(header)) {
-        printf("[server] Failed to read header\n");
+// dispatch thread: queue it, or append it to the overflow list
+static void libevent_push_control(libevent_context_t *app, uint8_t kind, libevent_conn_t *conn, const void *data, uint32_t length){
+    libevent_overflow_t *overflow = app->overflow;
+    ecs_os_mutex_lock(overflow->lock);
+    if (!overflow->head && libevent_queue_push(app->queue, kind, conn ? conn->bev : NULL, conn, data, length)) {
+        ecs_os_mutex_unlock(overflow->lock);
         return;
     }
-    header.type = ntohs(header.type); // Convert to host byte order
-    header.length = ntohs(header.length);
-
-    // Ensure enough data is available for the full message
-    if (len < sizeof(header) + header.length) {
-        return; // Wait for more data
+    libevent_overflow_item_t *item = ecs_os_malloc(sizeof(libevent_overflow_item_t) + length);
+    if (item) {
+        item->next = NULL;
+        item->kind = kind;
+        item->conn = conn;
+        item->length = length;
+        if (length > 0) memcpy(item->data, data, length);
+        if (overflow->tail) overflow->tail->next = item;
+        else overflow->head = item;
+        overflow->tail = item;
+        atomic_store(&overflow->pending, true);
     }
+    ecs_os_mutex_unlock(overflow->lock);
+    if (!item) printf("[server] out of memory, lost event %d\n", kind);
+}
 
-    // Allocate buffer for the full message (header + payload)
-    char *buf = malloc(sizeof(header) + header.length);
-    if (!buf) {
-        printf("[server] Failed to allocate memory\n");
-        snprintf(app->status, sizeof(app->status), "Server: Memory allocation failed");
-        ecs_singleton_modified(app->world, libevent_context_t);
+// status text from the dispatch thread goes through the queue, the ECS
+// thread owns app->status
+static void libevent_report(libevent_context_t *app, const char *text){
+    if (app->queue) {
+        libevent_push_control(app, LIBEVENT_QUEUE_STATUS, NULL, text, (uint32_t)strlen(text));
         return;
     }
+    snprintf(app->status, sizeof(app->status), "%s", text);
+}
 
-    // Copy the full message
-    size_t n = evbuffer_copyout(input, buf, sizeof(header) + header.length);
-    if (n != sizeof(header) + header.length) {
-        free(buf);
-        printf("[server] Failed to copy full message\n");
-        return;
+// dispatch thread: copy the frame out for the ECS thread, false leaves it
+// in the input buffer
+static bool libevent_queue_frame(uint16_t type, const uint8_t *frame, size_t frame_length, void *user){
+    libevent_conn_t *conn = (libevent_conn_t *)user;
+    libevent_context_t *app = conn->app;
+    if (atomic_load(&app->overflow->pending)
+        || !libevent_queue_push(app->queue, LIBEVENT_QUEUE_DATA, conn->bev, conn, frame, (uint32_t)frame_length)) {
+        conn->blocked = true;
+        return false;
     }
+    return true;
+}
 
-    // Drain the processed data
-    evbuffer_drain(input, n);
+// dispatch thread: queue every complete frame, false when reading has to wait
+static bool libevent_conn_pump(libevent_conn_t *conn){
+    conn->blocked = false;
+    libevent_frame_dispatch(bufferevent_get_input(conn->bev), libevent_queue_frame, conn);
+    return !conn->blocked;
+}
 
-    // Process legacy PING/PONG for compatibility
-    if (header.type == 0 && header.length == 4 && strncmp(buf + sizeof(header), "PING", 4) == 0) {
-        bufferevent_write(bev, "PONG", 4);
-        snprintf(app->status, sizeof(app->status), "Server: Received PING, sent PONG");
-        printf("[server] ping\n");
-    } else if (header.type == 0 && header.length == 4 && strncmp(buf + sizeof(header), "PONG", 4) == 0) {
-        app->pongs_received++;
-        snprintf(app->status, sizeof(app->status), "Server: Received PONG (%d)", app->pongs_received);
-        printf("[server] pong\n");
-    } else {
-        // Process game object data based on type
-        switch (header.type) {
-            case 1: // Position update
-                if (header.length == sizeof(float) * 3) {
-                    float *pos = (float *)(buf + sizeof(header));
-                    printf("[server] Position update: x=%.2f, y=%.2f, z=%.2f\n", pos[0], pos[1], pos[2]);
-                    snprintf(app->status, sizeof(app->status), "Server: Received position update");
-                }
-                break;
-            case 2: // Health update
-                if (header.length == sizeof(int32_t)) {
-                    int32_t *health = (int32_t *)(buf + sizeof(header));
-                    printf("[server] Health update: %d\n", ntohl(*health));
-                    snprintf(app->status, sizeof(app->status), "Server: Received health update");
-                }
-                break;
-            default:
-                printf("[server] Unknown message type: %d\n", header.type);
-                snprintf(app->status, sizeof(app->status), "Server: Unknown message type: %d", header.type);
+static void libevent_conn_pause(libevent_conn_t *conn){
+    libevent_overflow_t *overflow = conn->app->overflow;
+    bufferevent_disable(conn->bev, EV_READ);
+    if (!conn->paused) {
+        conn->paused = true;
+        conn->next_paused = overflow->paused;
+        overflow->paused = conn;
+    }
+    atomic_store(&overflow->resume_wanted, true);
+}
+
+static void libevent_conn_unpause(libevent_conn_t *conn){
+    libevent_overflow_t *overflow = conn->app->overflow;
+    if (!conn->paused) return;
+    for (libevent_conn_t **link = &overflow->paused; *link; link = &(*link)->next_paused) {
+        if (*link == conn) {
+            *link = conn->next_paused;
+            break;
         }
     }
+    conn->paused = false;
+    conn->next_paused = NULL;
+}
 
-    // Emit ECS event
-    if (app->world) {
-        libevent_packet_t packet = {
-            .data = buf, // Pass ownership to packet
-            .length = n,
-            .bev = bev
-        };
-        ecs_emit(app->world, &(ecs_event_desc_t) {
-            .event = ecs_id(libevent_packet_t),
-            .entity = libevent_receive_packed,
-            .param = &packet
-        });
-    } else {
-        free(buf);
+// dispatch thread, made active by the ECS thread after a drain
+static void libevent_resume_cb(evutil_socket_t fd, short events, void *ctx){
+    libevent_context_t *app = (libevent_context_t *)ctx;
+    libevent_conn_t *conn = app->overflow->paused;
+    app->overflow->paused = NULL;
+    while (conn) {
+        libevent_conn_t *next = conn->next_paused;
+        conn->paused = false;
+        conn->next_paused = NULL;
+        // frames left in the input buffer first, then the socket again
+        if (libevent_conn_pump(conn)) bufferevent_enable(conn->bev, EV_READ);
+        else libevent_conn_pause(conn);
+        conn = next;
     }
+}
 
-    ecs_singleton_modified(app->world, libevent_context_t);
+// Server: Handle client read
+// every complete frame in the input buffer is handled, a partial frame waits
+// for the next read.
+void server_read_cb(struct bufferevent *bev, void *ctx) {
+    libevent_conn_t *conn = (libevent_conn_t *)ctx;
+    if (conn->app->queue) {
+        if (!libevent_conn_pump(conn)) libevent_conn_pause(conn);
+        return;
+    }
+    libevent_read_t read = { .app = conn->app, .bev = bev, .is_server = true };
+    libevent_frame_dispatch(bufferevent_get_input(bev), libevent_handle_frame, &read);
+}
+
+// delete the entity that owns the connection and free it, O(1)
+static void libevent_remove_client(libevent_conn_t *conn){
+    libevent_context_t *app = conn->app;
+    if (app->world && conn->entity && ecs_is_alive(app->world, conn->entity)) {
+        ecs_delete(app->world, conn->entity);
+        printf("[server] remove client.\n");
+    }
+    app->client_count--;
+    bufferevent_free(conn->bev);
+    ecs_os_free(conn);
+}
+
+static void libevent_add_client(libevent_conn_t *conn){
+    libevent_context_t *app = conn->app;
+    app->client_count++;
+    if(!app->world) return;
+    ecs_entity_t e = ecs_new(app->world);
+    ecs_set(app->world, e, libevent_bev_t, {
+        .bev = conn->bev,
+        .conn = conn
+    });
+    conn->entity = e;
 }
-*/
 
 // Server: Handle client errors or disconnection
 void server_error_cb(struct bufferevent *bev, short events, void *ctx) {
-    libevent_context_t *app = (libevent_context_t *)ctx;
+    libevent_conn_t *conn = (libevent_conn_t *)ctx;
     if (events & (BEV_EVENT_EOF | BEV_EVENT_ERROR)) {
         // for (int i = 0; i < num_clients; i++) {
         //     if (connected_clients[i] == bev) {
@@ -178,29 +291,16 @@ void server_error_cb(struct bufferevent *bev, short events, void *ctx) {
         //         break;
         //     }
         // }
-        // handle remove client
-        if(app->world){
-            ecs_query_t *q = ecs_query(app->world, {
-                .terms = {
-                    {  .id = ecs_id(libevent_bev_t) }
-                }
-            });
-            ecs_iter_t it = ecs_query_iter(app->world, q);
-            while (ecs_query_next(&it)) {
-                libevent_bev_t *libevent_bev = ecs_field(&it, libevent_bev_t, 0);
-                for (int i = 0; i < it.count; i++) {
-                    ecs_entity_t entity_client = it.entities[i];
-                    // Do the thing
-                    if(bev == libevent_bev[i].bev){
-                        ecs_delete(app->world, entity_client);
-                        printf("[server] remove client.\n");
-                    }
-
-                }
-            }
-            ecs_query_fini(q);
+        if (conn->app->queue) {
+            // dispatch thread: stop reading, the ECS thread frees bev after
+            // it has handled every frame queued before this
+            bufferevent_disable(bev, EV_READ | EV_WRITE);
+            libevent_conn_unpause(conn);
+            libevent_push_control(conn->app, LIBEVENT_QUEUE_DISCONNECT, conn, NULL, 0);
+            return;
         }
-        bufferevent_free(bev);
+        // handle remove client, frees bev and conn
+        libevent_remove_client(conn);
         // ecs_singleton_modified(app->world, libevent_context_t);
     }
 }
@@ -209,7 +309,6 @@ void server_error_cb(struct bufferevent *bev, short events, void *ctx) {
 void server_accept_cb(struct evconnlistener *listener, evutil_socket_t fd, struct sockaddr *addr, int len, void *ctx) {
     libevent_context_t *app = (libevent_context_t *)ctx;
     struct event_base *base = evconnlistener_get_base(listener);
-    //TODO: need create query here for count.
 
 
     // if (num_clients >= MAX_CLIENTS) {
@@ -218,22 +317,29 @@ void server_accept_cb(struct evconnlistener *listener, evutil_socket_t fd, struc
     //     ecs_singleton_modified(app->world, libevent_context_t);
     //     return;
     // }
-    struct bufferevent *bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+    // threadsafe so the ECS thread can write while the dispatch thread reads
+    int options = BEV_OPT_CLOSE_ON_FREE | (app->queue ? BEV_OPT_THREADSAFE : 0);
+    struct bufferevent *bev = bufferevent_socket_new(base, fd, options);
     if (!bev) {
-        closesocket(fd);
-        snprintf(app->status, sizeof(app->status), "Server: Failed to create bufferevent");
-        ecs_singleton_modified(app->world, libevent_context_t);
+        evutil_closesocket(fd);
+        libevent_report(app, "Server: Failed to create bufferevent");
         return;
     }
-    bufferevent_setcb(bev, server_read_cb, NULL, server_error_cb, app);
+    libevent_conn_t *conn = ecs_os_calloc(sizeof(libevent_conn_t));
+    if (!conn) {
+        bufferevent_free(bev);
+        return;
+    }
+    conn->app = app;
+    conn->bev = bev;
+    bufferevent_setcb(bev, server_read_cb, NULL, server_error_cb, conn);
     bufferevent_enable(bev, EV_READ | EV_WRITE);
     // connected_clients[num_clients++] = bev;
 
-    if(app->world){
-        ecs_entity_t e = ecs_new(app->world);
-        ecs_set(app->world, e, libevent_bev_t, {
-            .bev=bev
-        });
+    if (app->queue) {
+        libevent_push_control(app, LIBEVENT_QUEUE_CONNECT, conn, NULL, 0);
+    } else {
+        libevent_add_client(conn);
     }
 
     // snprintf(app->status, sizeof(app->status), "Server: Client %d connected", num_clients);
@@ -242,34 +348,90 @@ void server_accept_cb(struct evconnlistener *listener, evutil_socket_t fd, struc
 
 // Client: Handle server response
 void client_read_cb(struct bufferevent *bev, void *ctx) {
-    libevent_context_t *app = (libevent_context_t *)ctx;
-    char buf[256];
-    size_t n = bufferevent_read(bev, buf, sizeof(buf) - 1);
-    buf[n] = '\0';
-    if (strcmp(buf, "PING") == 0) {
-        bufferevent_write(bev, "PONG", 4);
-        snprintf(app->status, sizeof(app->status), "Client: Received PING, sent PONG");
-        printf("[client] ping\n");
-    } else if (strcmp(buf, "PONG") == 0) {
-        app->pongs_received++;
-        snprintf(app->status, sizeof(app->status), "Client: Received PONG (%d)", app->pongs_received);
-        printf("[client] pong\n");
-    } else {
-        snprintf(app->status, sizeof(app->status), "Client: Unknown message: %s", buf);
-        printf("[client] unknown\n");
-    }
-    ecs_singleton_modified(app->world, libevent_context_t);
+    libevent_read_t read = { .app = (libevent_context_t *)ctx, .bev = bev, .is_server = false };
+    libevent_frame_dispatch(bufferevent_get_input(bev), libevent_handle_frame, &read);
 }
 
 //===============================================
 // SYSTEMS
 //===============================================
+// dispatch thread body, runs until event_base_loopbreak
+static void *libevent_dispatch_thread(void *arg) {
+    struct event_base *ev_base = (struct event_base *)arg;
+    event_base_loop(ev_base, EVLOOP_NO_EXIT_ON_EMPTY);
+    return NULL;
+}
+
+static void libevent_handle_event(libevent_context_t *app, uint8_t kind, libevent_conn_t *conn, const uint8_t *data, uint32_t length){
+    switch (kind) {
+        case LIBEVENT_QUEUE_CONNECT:
+            libevent_add_client(conn);
+            break;
+        case LIBEVENT_QUEUE_DATA: {
+            libevent_read_t read = { .app = app, .bev = conn->bev, .is_server = true };
+            uint16_t type = (uint16_t)((data[0] << 8) | data[1]);
+            libevent_handle_frame(type, data, length, &read);
+            break;
+        }
+        case LIBEVENT_QUEUE_DISCONNECT:
+            libevent_remove_client(conn);
+            break;
+        case LIBEVENT_QUEUE_STATUS:
+            snprintf(app->status, sizeof(app->status), "%.*s", (int)length, (const char *)data);
+            break;
+    }
+}
+
+// hand everything the dispatch thread queued to the ECS. queue items pushed
+// before the overflow list was taken are older than it, so the queue is
+// drained up to that mark first, newer items wait for the next frame
+static void libevent_drain_queue(libevent_context_t *app) {
+    libevent_overflow_t *overflow = app->overflow;
+    libevent_overflow_item_t *list = NULL;
+    bool marked = false;
+    uint32_t mark = 0;
+    if (atomic_load(&overflow->pending)) {
+        ecs_os_mutex_lock(overflow->lock);
+        mark = libevent_queue_mark(app->queue);
+        list = overflow->head;
+        overflow->head = NULL;
+        overflow->tail = NULL;
+        atomic_store(&overflow->pending, false);
+        ecs_os_mutex_unlock(overflow->lock);
+        marked = true;
+    }
+
+    libevent_queue_item_t *item;
+    while ((item = marked ? libevent_queue_front_until(app->queue, mark) : libevent_queue_front(app->queue)) != NULL) {
+        libevent_handle_event(app, item->kind, (libevent_conn_t *)item->ctx, item->data, item->length);
+        libevent_queue_pop(app->queue);
+    }
+    while (list) {
+        libevent_overflow_item_t *next = list->next;
+        libevent_handle_event(app, list->kind, list->conn, list->data, list->length);
+        ecs_os_free(list);
+        list = next;
+    }
+
+    // there is room again, paused connections read on the dispatch thread
+    if (overflow->resume && atomic_exchange(&overflow->resume_wanted, false)) {
+        event_active(overflow->resume, 0, 0);
+    }
+}
+
 // Event loop system
 void event_base_system(ecs_iter_t *it) {
     libevent_base_t *libevent_base = ecs_field(it, libevent_base_t, 0);
     if (!libevent_base || !libevent_base->ev_base) return;
     // printf("libevent_base_t\n");
 
+    if (libevent_base->threaded) {
+        // loop runs on its own thread, only drain what it queued
+        libevent_context_t *app = ecs_singleton_get_mut(it->world, libevent_context_t);
+        if (app && app->queue) libevent_drain_queue(app);
+        return;
+    }
+
     // Process libevent events
     event_base_loop(libevent_base->ev_base, EVLOOP_NONBLOCK);
 }
@@ -301,6 +463,24 @@ void on_add_setup_server(ecs_iter_t *it) {
         return;
     }
 
+    if (libevent_server->threaded) {
+        app->queue = ecs_os_malloc(sizeof(libevent_queue_t));
+        app->overflow = libevent_overflow_new();
+        if (app->overflow) app->overflow->resume = event_new(ev_base, -1, 0, libevent_resume_cb, app);
+        if (!app->queue || !app->overflow || !app->overflow->resume
+            || !libevent_queue_init(app->queue, LIBEVENT_QUEUE_CAPACITY)) {
+            ecs_os_free(app->queue);
+            app->queue = NULL;
+            libevent_overflow_free(app->overflow);
+            app->overflow = NULL;
+            event_base_free(ev_base);
+            snprintf(app->status, sizeof(app->status), "Server: Failed to create queue");
+            return;
+        }
+        app->queue->alloc = libevent_queue_alloc;
+        app->queue->free = libevent_queue_free;
+    }
+
     struct sockaddr_in sin = {0};
     sin.sin_family = AF_INET;
     sin.sin_addr.s_addr = INADDR_ANY;
@@ -312,6 +492,13 @@ void on_add_setup_server(ecs_iter_t *it) {
         (struct sockaddr *)&sin, sizeof(sin)
     );
     if (!listener) {
+        if (app->queue) {
+            libevent_queue_fini(app->queue);
+            ecs_os_free(app->queue);
+            app->queue = NULL;
+            libevent_overflow_free(app->overflow); // its event goes before the base
+            app->overflow = NULL;
+        }
         event_base_free(ev_base);
         snprintf(app->status, sizeof(app->status), "Server: Failed to create listener");
         // ecs_singleton_modified(it->world, libevent_context_t);
@@ -321,10 +508,17 @@ void on_add_setup_server(ecs_iter_t *it) {
     libevent_server->is_init = true;
     libevent_server->listener = listener;
 
+    ecs_os_thread_t thread = 0;
+    if (libevent_server->threaded) {
+        thread = ecs_os_thread_new(libevent_dispatch_thread, ev_base);
+    }
+
     ecs_singleton_set(it->world, libevent_base_t, {
-        .ev_base = ev_base
+        .ev_base = ev_base,
+        .threaded = libevent_server->threaded,
+        .thread = thread
     });
-    snprintf(app->status, sizeof(app->status), "Server: Initialized on port %d", libevent_server->port);
+    snprintf(app->status, sizeof(app->status), "Server: Initialized on port %d%s", libevent_server->port, libevent_server->threaded ? " (thread)" : "");
     // ecs_singleton_modified(it->world, libevent_context_t);
 }
 
@@ -334,26 +528,47 @@ void on_remove_server(ecs_iter_t *it) {
     libevent_context_t *app = ecs_singleton_get_mut(it->world, libevent_context_t);
     if (!app) return;
 
+    // stop the dispatch thread before touching anything it uses
+    libevent_base_t *libevent_base = ecs_singleton_get_mut(it->world, libevent_base_t);
+    if (libevent_base && libevent_base->threaded && libevent_base->thread) {
+        event_base_loopbreak(libevent_base->ev_base);
+        ecs_os_thread_join(libevent_base->thread);
+        libevent_base->thread = 0;
+    }
+    if (app->queue) {
+        // a drain stops at the overflow mark, the thread is gone so repeat until empty
+        while (libevent_queue_front(app->queue) || atomic_load(&app->overflow->pending)) {
+            libevent_drain_queue(app);
+        }
+        libevent_queue_fini(app->queue);
+        ecs_os_free(app->queue);
+        app->queue = NULL;
+        libevent_overflow_free(app->overflow);
+        app->overflow = NULL;
+    }
+
+    // close every client still connected, before the base goes away
+    ecs_defer_begin(it->world);
+    ecs_iter_t qit = ecs_query_iter(it->world, libevent_client_query);
+    while (ecs_query_next(&qit)) {
+        libevent_bev_t *libevent_bev = ecs_field(&qit, libevent_bev_t, 0);
+        for (int i = 0; i < qit.count; i++) {
+            if (libevent_bev[i].conn) libevent_remove_client(libevent_bev[i].conn);
+        }
+    }
+    ecs_defer_end(it->world);
+    app->client_count = 0;
+
     if (libevent_server->listener) {
         evconnlistener_free(libevent_server->listener);
         libevent_server->listener = NULL;
     }
 
-    libevent_base_t *libevent_base = ecs_singleton_get_mut(it->world, libevent_base_t);
     if (libevent_base && libevent_base->ev_base) {
         event_base_free(libevent_base->ev_base);
         ecs_singleton_remove(it->world, libevent_base_t);
     }
 
-    // TODO:need to add remove event for client.
-    // for (int i = 0; i < num_clients; i++) {
-    //     if (connected_clients[i]) {
-    //         bufferevent_free(connected_clients[i]);
-    //         connected_clients[i] = NULL;
-    //     }
-    // }
-    // num_clients = 0;
-
     snprintf(app->status, sizeof(app->status), "Server: Shut down");
     // ecs_singleton_modified(it->world, libevent_context_t);
 }
@@ -451,16 +666,15 @@ void on_setup_client(ecs_iter_t *it) {
     printf("client set up finished.");
 }
 
-// enet packet for string data
+// libevent packet for framed data
 void on_receive_libevent_packed(ecs_iter_t *it) {
-    printf("event on_receive_libevent_packed\n");
     libevent_packet_t *p = it->param;
-    if (p && p->data) {
-        char *str = (char*)p->data;
-        printf("Received string: %s\n", str);
-        free(str); // Free the dynamically allocated string
+    if (p && p->data && p->length >= LIBEVENT_FRAME_HEADER_SIZE) {
+        // data points into the input evbuffer, do not free here
+        const uint8_t *frame = (const uint8_t *)p->data;
+        printf("Received frame type %d, %d bytes\n", (frame[0] << 8) | frame[1], libevent_frame_payload_length(frame));
     } else {
-        printf("No valid string data received\n");
+        printf("No valid frame received\n");
     }
 }
 
@@ -503,6 +717,13 @@ void on_remove_client(ecs_iter_t *it) {
 // systems
 void setup_systems_libevent(ecs_world_t *world){
 
+    libevent_client_query = ecs_query(world, {
+        .terms = {
+            { .id = ecs_id(libevent_bev_t) }
+        },
+        .cache_kind = EcsQueryCacheAuto
+    });
+
     // loop if add for Singleton
     ecs_system(world, {
         .entity = ecs_entity(world, { .name = "event_base_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
@@ -577,6 +798,13 @@ void setup_components_libevent(ecs_world_t *world){
 }
 
 void module_init_libevent(ecs_world_t *world){
+    // locking for bufferevents shared with the dispatch thread, must run
+    // before any event_base_new
+#if defined(_WIN32) && defined(EVTHREAD_USE_WINDOWS_THREADS_IMPLEMENTED)
+    evthread_use_windows_threads();
+#elif defined(EVTHREAD_USE_PTHREADS_IMPLEMENTED)
+    evthread_use_pthreads();
+#endif
     setup_components_libevent(world);
     setup_systems_libevent(world);
 }
\ No newline at end of file
@@ -0,0 +1,890 @@
+// module_lua.c
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "ecs_components.h"
+#include "module_lua.h"
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+
+#ifdef __linux__
+    #include <errno.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+ECS_COMPONENT_DECLARE(lua_script_t);
+
+#define LUA_SCRIPT_ITER_META "ecs.iter"
+#define LUA_SCRIPT_VIEW_META "ecs.view"
+
+//===============================================
+// HOST
+//===============================================
+typedef struct {
+    char name[LUA_SCRIPT_NAME_SIZE];
+    int32_t offset;
+    lua_script_type_t type;
+} lua_script_field_info_t;
+
+typedef struct {
+    char name[LUA_SCRIPT_NAME_SIZE];
+    ecs_entity_t id;
+    ecs_size_t size;                    // 0 for a tag
+    lua_script_field_info_t fields[LUA_SCRIPT_MAX_FIELDS];
+    int32_t field_count;
+} lua_script_component_t;
+
+typedef struct lua_script_system_s lua_script_system_t;
+
+// ecs.system from a watched file, applied once the whole file ran
+typedef struct {
+    char *name;
+    ecs_entity_t phase;
+    int32_t components[FLECS_TERM_COUNT_MAX];
+    ecs_id_t ids[FLECS_TERM_COUNT_MAX];
+    int32_t term_count;
+    int callback;
+} lua_script_staged_t;
+
+typedef struct {
+    char path[LUA_SCRIPT_PATH_SIZE];
+    int32_t name_offset;                // file name inside path, matched against inotify events
+    int wd;                             // inotify watch, -1 polls the mtime
+    int64_t mtime;
+    bool dirty;
+} lua_script_file_t;
+
+struct lua_script_host_s {
+    lua_State *L;
+    ecs_world_t *world;
+    lua_script_component_t components[LUA_SCRIPT_MAX_COMPONENTS];
+    int32_t component_count;
+    lua_script_system_t **systems;      // owned here, flecs gets them as ctx without ctx_free
+    int32_t system_count;
+    int32_t system_capacity;
+    lua_script_file_t files[LUA_SCRIPT_MAX_FILES];
+    int32_t file_count;
+    int inotify_fd;                     // -1 without inotify
+    float poll_time;                    // seconds since the last mtime poll
+    int32_t loading_file;               // file being run, -1 for lua_script_run/load
+    lua_script_staged_t *staged;        // systems defined by loading_file so far
+    int32_t staged_count;
+    int32_t staged_capacity;
+    uint32_t load_generation;
+    bool reload_pending;
+    int32_t errors;
+    int32_t reloads;
+};
+
+// one column field of the current table, 1 based
+typedef struct {
+    uint8_t *base;                      // first value
+    int32_t stride;                     // 0 for a shared or singleton term
+    int32_t count;                      // 0 outside the system callback
+    lua_script_type_t type;
+    bool readonly;
+    int32_t term;                       // cache key in the system
+    int32_t field;
+} lua_script_view_t;
+
+typedef struct {
+    ecs_iter_t *it;                     // NULL outside the system callback
+    lua_script_system_t *system;
+    int32_t next_view;                  // it:field calls so far on this table
+} lua_script_iter_t;
+
+// system ctx, callback is swapped on reload
+struct lua_script_system_s {
+    lua_script_host_t *host;
+    ecs_entity_t entity;
+    ecs_entity_t phase;
+    int32_t file;                       // defining file, -1 for none
+    uint32_t generation;                // load that last defined it
+    int callback;
+    int iter_ref;
+    lua_script_iter_t *iter;
+    int view_refs[LUA_SCRIPT_MAX_VIEWS];
+    lua_script_view_t *views[LUA_SCRIPT_MAX_VIEWS];
+    int32_t view_count;
+    int32_t components[FLECS_TERM_COUNT_MAX]; // registry index per term, -1 for not terms
+    ecs_id_t ids[FLECS_TERM_COUNT_MAX];
+    int32_t term_count;
+};
+
+static lua_script_host_t *lua_script_host(ecs_world_t *world){
+    const lua_script_t *script = ecs_singleton_get(world, lua_script_t);
+    return script ? script->host : NULL;
+}
+
+static void lua_script_stats(lua_script_host_t *host){
+    lua_script_t *script = ecs_singleton_get_mut(host->world, lua_script_t);
+    if (!script) return;
+    script->system_count = host->system_count;
+    script->errors = host->errors;
+    script->reloads = host->reloads;
+}
+
+static int32_t lua_script_find_component(const lua_script_host_t *host, const char *name){
+    for (int32_t i = 0; i < host->component_count; i++) {
+        if (strcmp(host->components[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static int32_t lua_script_find_field(const lua_script_component_t *component, const char *name){
+    for (int32_t i = 0; i < component->field_count; i++) {
+        if (strcmp(component->fields[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static ecs_entity_t lua_script_phase(const char *name){
+    const struct { const char *name; ecs_entity_t phase; } phases[] = {
+        { "PreLogicUpdate", PreLogicUpdatePhase },
+        { "LogicUpdate", LogicUpdatePhase },
+        { "RLBeginDrawing", RLBeginDrawingPhase },
+        { "RLRender2D0", RLRender2D0Phase },
+        { "RLBeginMode3D", RLBeginMode3DPhase },
+        { "RLRender3D", RLRender3DPhase },
+        { "RLEndMode3D", RLEndMode3DPhase },
+        { "RLRender2D1", RLRender2D1Phase },
+        { "RLEndDrawing", RLEndDrawingPhase }
+    };
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        if (strcmp(phases[i].name, name) == 0) return phases[i].phase;
+    }
+    return 0;
+}
+
+static int lua_script_traceback(lua_State *L){
+    const char *message = lua_tostring(L, 1);
+    luaL_traceback(L, L, message ? message : "error object is not a string", 1);
+    return 1;
+}
+
+//===============================================
+// VIEW
+//===============================================
+// __index and __newindex run per entity, they only check the range
+static int lua_script_view_get(lua_State *L){
+    const lua_script_view_t *view = lua_touserdata(L, 1);
+    lua_Integer i = lua_tointegerx(L, 2, NULL);
+    if (i < 1 || i > view->count) return luaL_error(L, "view index %d out of range (%d)", (int)i, (int)view->count);
+    const uint8_t *value = view->base + (size_t)(i - 1) * (size_t)view->stride;
+    switch (view->type) {
+    case LUA_SCRIPT_FLOAT: lua_pushnumber(L, *(const float *)value); break;
+    case LUA_SCRIPT_INT32: lua_pushinteger(L, *(const int32_t *)value); break;
+    case LUA_SCRIPT_BOOL: lua_pushboolean(L, *(const bool *)value); break;
+    }
+    return 1;
+}
+
+static int lua_script_view_set(lua_State *L){
+    const lua_script_view_t *view = lua_touserdata(L, 1);
+    lua_Integer i = lua_tointegerx(L, 2, NULL);
+    if (i < 1 || i > view->count) return luaL_error(L, "view index %d out of range (%d)", (int)i, (int)view->count);
+    if (view->readonly) return luaL_error(L, "view is read only");
+    uint8_t *value = view->base + (size_t)(i - 1) * (size_t)view->stride;
+    switch (view->type) {
+    case LUA_SCRIPT_FLOAT: *(float *)value = (float)luaL_checknumber(L, 3); break;
+    case LUA_SCRIPT_INT32: *(int32_t *)value = (int32_t)luaL_checkinteger(L, 3); break;
+    case LUA_SCRIPT_BOOL: *(bool *)value = lua_toboolean(L, 3); break;
+    }
+    return 0;
+}
+
+static int lua_script_view_len(lua_State *L){
+    const lua_script_view_t *view = lua_touserdata(L, 1);
+    lua_pushinteger(L, view->count);
+    return 1;
+}
+
+//===============================================
+// ITER
+//===============================================
+// it:field(term, name), the view is reused on the next table of the system
+static int lua_script_iter_field(lua_State *L){
+    lua_script_iter_t *iter = luaL_checkudata(L, 1, LUA_SCRIPT_ITER_META);
+    if (!iter->it) return luaL_error(L, "iterator used outside its system");
+    lua_Integer term = luaL_checkinteger(L, 2);
+    const char *name = luaL_checkstring(L, 3);
+    lua_script_system_t *system = iter->system;
+    if (term < 1 || term > system->term_count || system->components[term - 1] < 0) {
+        return luaL_error(L, "term %d has no data", (int)term);
+    }
+    const lua_script_component_t *component = &system->host->components[system->components[term - 1]];
+    int32_t field = lua_script_find_field(component, name);
+    if (field < 0) return luaL_error(L, "%s has no field %s", component->name, name);
+    ecs_iter_t *it = iter->it;
+    int8_t index = (int8_t)(term - 1);
+    uint8_t *base = ecs_field_w_size(it, (size_t)component->size, index);
+    if (!base) return luaL_error(L, "term %d is not set", (int)term);
+
+    lua_script_view_t *view = NULL;
+    int32_t slot = iter->next_view++;
+    if (slot < system->view_count && system->views[slot]->term == term && system->views[slot]->field == field) {
+        view = system->views[slot];
+        lua_rawgeti(L, LUA_REGISTRYINDEX, system->view_refs[slot]);
+    } else {
+        view = lua_newuserdatauv(L, sizeof(lua_script_view_t), 0);
+        luaL_setmetatable(L, LUA_SCRIPT_VIEW_META);
+        if (slot < LUA_SCRIPT_MAX_VIEWS && slot <= system->view_count) {
+            if (slot < system->view_count) luaL_unref(L, LUA_REGISTRYINDEX, system->view_refs[slot]);
+            lua_pushvalue(L, -1);
+            system->view_refs[slot] = luaL_ref(L, LUA_REGISTRYINDEX);
+            system->views[slot] = view;
+            if (slot == system->view_count) system->view_count++;
+        }
+    }
+    view->base = base + component->fields[field].offset;
+    view->stride = ecs_field_is_self(it, index) ? component->size : 0;
+    view->count = it->count;
+    view->type = component->fields[field].type;
+    view->readonly = ecs_field_is_readonly(it, index);
+    view->term = (int32_t)term;
+    view->field = field;
+    return 1;
+}
+
+static int lua_script_iter_entity(lua_State *L){
+    lua_script_iter_t *iter = luaL_checkudata(L, 1, LUA_SCRIPT_ITER_META);
+    if (!iter->it) return luaL_error(L, "iterator used outside its system");
+    lua_Integer i = luaL_checkinteger(L, 2);
+    if (i < 1 || i > iter->it->count) return luaL_error(L, "entity index %d out of range", (int)i);
+    lua_pushinteger(L, (lua_Integer)iter->it->entities[i - 1]);
+    return 1;
+}
+
+static int lua_script_iter_index(lua_State *L){
+    lua_script_iter_t *iter = lua_touserdata(L, 1);
+    const char *key = luaL_checkstring(L, 2);
+    if (strcmp(key, "count") == 0) {
+        lua_pushinteger(L, iter->it ? iter->it->count : 0);
+    } else if (strcmp(key, "delta_time") == 0) {
+        lua_pushnumber(L, iter->it ? iter->it->delta_time : 0.0f);
+    } else if (strcmp(key, "field") == 0) {
+        lua_pushcfunction(L, lua_script_iter_field);
+    } else if (strcmp(key, "entity") == 0) {
+        lua_pushcfunction(L, lua_script_iter_entity);
+    } else {
+        lua_pushnil(L);
+    }
+    return 1;
+}
+
+//===============================================
+// SYSTEMS
+//===============================================
+static void lua_script_system_run(ecs_iter_t *it){
+    lua_script_system_t *system = it->ctx;
+    lua_script_host_t *host = system->host;
+    lua_State *L = host->L;
+    system->iter->it = it;
+    system->iter->next_view = 0;
+    lua_pushcfunction(L, lua_script_traceback);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, system->callback);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, system->iter_ref);
+    int status = lua_pcall(L, 1, 0, -3);
+    // views kept by the script must not reach the next table
+    system->iter->it = NULL;
+    for (int32_t i = 0; i < system->view_count; i++) system->views[i]->count = 0;
+    if (status != LUA_OK) {
+        TraceLog(LOG_WARNING, "LUA: %s disabled: %s", ecs_get_name(it->world, it->system), lua_tostring(L, -1));
+        lua_pop(L, 1);
+        host->errors++;
+        ecs_enable(it->world, it->system, false);
+        lua_script_stats(host);
+    }
+    lua_pop(L, 1); // traceback
+}
+
+static void lua_script_system_free(lua_script_host_t *host, lua_script_system_t *system){
+    luaL_unref(host->L, LUA_REGISTRYINDEX, system->callback);
+    luaL_unref(host->L, LUA_REGISTRYINDEX, system->iter_ref);
+    for (int32_t i = 0; i < system->view_count; i++) luaL_unref(host->L, LUA_REGISTRYINDEX, system->view_refs[i]);
+    ecs_os_free(system);
+}
+
+// outside ecs_progress only, the system goes at once
+static void lua_script_system_delete(lua_script_host_t *host, int32_t index){
+    lua_script_system_t *system = host->systems[index];
+    if (ecs_is_alive(host->world, system->entity)) ecs_delete(host->world, system->entity);
+    lua_script_system_free(host, system);
+    host->systems[index] = host->systems[--host->system_count];
+}
+
+static int32_t lua_script_find_system(const lua_script_host_t *host, ecs_entity_t entity){
+    for (int32_t i = 0; entity && i < host->system_count; i++) {
+        if (host->systems[i]->entity == entity) return i;
+    }
+    return -1;
+}
+
+static const char *lua_script_opt_string(lua_State *L, int table, const char *key, const char *fallback){
+    lua_getfield(L, table, key);
+    const char *value = lua_isnil(L, -1) ? fallback : luaL_checkstring(L, -1);
+    lua_pop(L, 1); // strings from the desc table stay alive while it is on the stack
+    return value;
+}
+
+static bool lua_script_system_same(const lua_script_system_t *system, ecs_entity_t phase,
+                                   const ecs_id_t *ids, const int32_t *components, int32_t term_count){
+    return system->phase == phase && system->term_count == term_count
+        && memcmp(system->ids, ids, sizeof(ecs_id_t) * (size_t)term_count) == 0
+        && memcmp(system->components, components, sizeof(int32_t) * (size_t)term_count) == 0;
+}
+
+// a name this host defined before gets the new callback in place, or is
+// built again when the query or phase changed. takes the callback ref,
+// 0 when the system could not be created
+static ecs_entity_t lua_script_system_define(lua_script_host_t *host, const char *name, ecs_entity_t phase,
+                                             const ecs_id_t *ids, const int32_t *components, int32_t term_count, int callback){
+    lua_State *L = host->L;
+    ecs_entity_t existing = ecs_lookup(host->world, name);
+    int32_t index = lua_script_find_system(host, existing);
+    if (existing && index < 0) {
+        luaL_unref(L, LUA_REGISTRYINDEX, callback);
+        return 0;
+    }
+    if (index >= 0) {
+        lua_script_system_t *system = host->systems[index];
+        if (lua_script_system_same(system, phase, ids, components, term_count)) {
+            luaL_unref(L, LUA_REGISTRYINDEX, system->callback);
+            system->callback = callback;
+            system->file = host->loading_file;
+            system->generation = host->load_generation;
+            ecs_enable(host->world, system->entity, true); // a fixed error runs again
+            return system->entity;
+        }
+        lua_script_system_delete(host, index);
+    }
+
+    if (host->system_count == host->system_capacity) {
+        int32_t capacity = host->system_capacity ? host->system_capacity * 2 : 16;
+        lua_script_system_t **systems = ecs_os_realloc(host->systems, sizeof(lua_script_system_t *) * (size_t)capacity);
+        if (!systems) {
+            luaL_unref(L, LUA_REGISTRYINDEX, callback);
+            return 0;
+        }
+        host->systems = systems;
+        host->system_capacity = capacity;
+    }
+    lua_script_system_t *system = ecs_os_calloc(sizeof(lua_script_system_t));
+    if (!system) {
+        luaL_unref(L, LUA_REGISTRYINDEX, callback);
+        return 0;
+    }
+    system->host = host;
+    system->phase = phase;
+    system->file = host->loading_file;
+    system->generation = host->load_generation;
+    system->callback = callback;
+    system->term_count = term_count;
+    memcpy(system->components, components, sizeof(int32_t) * (size_t)term_count);
+    memcpy(system->ids, ids, sizeof(ecs_id_t) * (size_t)term_count);
+    system->iter = lua_newuserdatauv(L, sizeof(lua_script_iter_t), 0);
+    luaL_setmetatable(L, LUA_SCRIPT_ITER_META);
+    system->iter->system = system;
+    system->iter_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    ecs_system_desc_t desc = { 0 };
+    for (int32_t i = 0; i < term_count; i++) {
+        desc.query.terms[i].id = ids[i];
+        desc.query.terms[i].oper = components[i] < 0 ? EcsNot : EcsAnd;
+    }
+    desc.entity = ecs_entity(host->world, { .name = name, .add = ecs_ids(ecs_dependson(phase)) });
+    desc.callback = lua_script_system_run;
+    desc.ctx = system;
+    system->entity = ecs_system_init(host->world, &desc);
+    if (!system->entity) {
+        lua_script_system_free(host, system);
+        return 0;
+    }
+    host->systems[host->system_count++] = system;
+    lua_script_stats(host);
+    return system->entity;
+}
+
+// ecs.system{ name, phase, query, callback } returns the system entity.
+// while a watched file runs the definition is only staged, the file's
+// systems change together after it ran without an error. the entity is
+// returned then only for a system that stays in place, 0 otherwise
+static int lua_script_system_new(lua_State *L){
+    lua_script_host_t *host = lua_touserdata(L, lua_upvalueindex(1));
+    luaL_checktype(L, 1, LUA_TTABLE);
+    const char *name = lua_script_opt_string(L, 1, "name", NULL);
+    if (!name) return luaL_error(L, "ecs.system needs a name");
+    const char *phase_name = lua_script_opt_string(L, 1, "phase", "LogicUpdate");
+    ecs_entity_t phase = lua_script_phase(phase_name);
+    if (!phase) return luaL_error(L, "unknown phase %s", phase_name);
+
+    int32_t components[FLECS_TERM_COUNT_MAX];
+    ecs_id_t ids[FLECS_TERM_COUNT_MAX];
+    lua_getfield(L, 1, "query");
+    luaL_checktype(L, -1, LUA_TTABLE);
+    int32_t term_count = (int32_t)lua_rawlen(L, -1);
+    if (term_count < 1 || term_count > FLECS_TERM_COUNT_MAX) return luaL_error(L, "query needs 1 to %d terms", FLECS_TERM_COUNT_MAX);
+    for (int32_t i = 0; i < term_count; i++) {
+        lua_rawgeti(L, -1, i + 1);
+        const char *term = luaL_checkstring(L, -1);
+        bool negate = term[0] == '!';
+        int32_t component = lua_script_find_component(host, negate ? term + 1 : term);
+        if (component < 0) return luaL_error(L, "component %s is not registered", negate ? term + 1 : term);
+        ids[i] = host->components[component].id;
+        components[i] = negate ? -1 : component;
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    lua_getfield(L, 1, "callback");
+    luaL_checktype(L, -1, LUA_TFUNCTION);
+
+    ecs_entity_t existing = ecs_lookup(host->world, name);
+    int32_t index = lua_script_find_system(host, existing);
+    if (existing && index < 0) return luaL_error(L, "name %s is taken", name);
+
+    if (host->loading_file >= 0) {
+        if (host->staged_count == host->staged_capacity) {
+            int32_t capacity = host->staged_capacity ? host->staged_capacity * 2 : 16;
+            lua_script_staged_t *staged = ecs_os_realloc(host->staged, sizeof(lua_script_staged_t) * (size_t)capacity);
+            if (!staged) return luaL_error(L, "out of memory");
+            host->staged = staged;
+            host->staged_capacity = capacity;
+        }
+        char *copy = ecs_os_strdup(name);
+        if (!copy) return luaL_error(L, "out of memory");
+        lua_script_staged_t *staged = &host->staged[host->staged_count++];
+        staged->name = copy;
+        staged->phase = phase;
+        staged->term_count = term_count;
+        memcpy(staged->components, components, sizeof(int32_t) * (size_t)term_count);
+        memcpy(staged->ids, ids, sizeof(ecs_id_t) * (size_t)term_count);
+        staged->callback = luaL_ref(L, LUA_REGISTRYINDEX);
+        bool kept = index >= 0 && lua_script_system_same(host->systems[index], phase, ids, components, term_count);
+        lua_pushinteger(L, kept ? (lua_Integer)existing : 0);
+        return 1;
+    }
+
+    int callback = luaL_ref(L, LUA_REGISTRYINDEX);
+    ecs_entity_t entity = lua_script_system_define(host, name, phase, ids, components, term_count, callback);
+    if (!entity) return luaL_error(L, "could not create system %s", name);
+    lua_pushinteger(L, (lua_Integer)entity);
+    return 1;
+}
+
+//===============================================
+// SCRIPT COMPONENTS
+//===============================================
+static void lua_script_zero_ctor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    memset(ptr, 0, (size_t)type_info->size * (size_t)count);
+}
+
+// ecs.component{ name, fields = { "time", "count:int", "on:bool" } }, four
+// bytes a field. running it again with the same fields returns the same
+// component, so entities keep their values over a reload
+static int lua_script_component_new(lua_State *L){
+    lua_script_host_t *host = lua_touserdata(L, lua_upvalueindex(1));
+    luaL_checktype(L, 1, LUA_TTABLE);
+    const char *name = lua_script_opt_string(L, 1, "name", NULL);
+    if (!name) return luaL_error(L, "ecs.component needs a name");
+    lua_getfield(L, 1, "fields");
+    int32_t field_count = lua_isnil(L, -1) ? 0 : (int32_t)lua_rawlen(L, -1);
+    if (field_count > LUA_SCRIPT_MAX_FIELDS) return luaL_error(L, "%s has more than %d fields", name, LUA_SCRIPT_MAX_FIELDS);
+    char names[LUA_SCRIPT_MAX_FIELDS][LUA_SCRIPT_NAME_SIZE];
+    lua_script_field_t fields[LUA_SCRIPT_MAX_FIELDS];
+    for (int32_t i = 0; i < field_count; i++) {
+        lua_rawgeti(L, -1, i + 1);
+        const char *field = luaL_checkstring(L, -1);
+        const char *colon = strchr(field, ':');
+        size_t length = colon ? (size_t)(colon - field) : strlen(field);
+        if (length == 0 || length >= LUA_SCRIPT_NAME_SIZE) return luaL_error(L, "bad field name %s", field);
+        memcpy(names[i], field, length);
+        names[i][length] = '\0';
+        fields[i].name = names[i];
+        fields[i].offset = i * 4;
+        fields[i].type = LUA_SCRIPT_FLOAT;
+        if (colon && strcmp(colon + 1, "int") == 0) fields[i].type = LUA_SCRIPT_INT32;
+        else if (colon && strcmp(colon + 1, "bool") == 0) fields[i].type = LUA_SCRIPT_BOOL;
+        else if (colon && strcmp(colon + 1, "float") != 0) return luaL_error(L, "unknown field type %s", colon + 1);
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+
+    int32_t existing = lua_script_find_component(host, name);
+    if (existing >= 0) {
+        const lua_script_component_t *component = &host->components[existing];
+        bool same = component->field_count == field_count;
+        for (int32_t i = 0; same && i < field_count; i++) {
+            same = strcmp(component->fields[i].name, fields[i].name) == 0 && component->fields[i].type == fields[i].type
+                && component->fields[i].offset == fields[i].offset;
+        }
+        if (!same) return luaL_error(L, "%s changed its fields, restart to apply", name);
+        lua_pushinteger(L, (lua_Integer)component->id);
+        return 1;
+    }
+    if (ecs_lookup(host->world, name)) return luaL_error(L, "name %s is taken", name);
+
+    ecs_component_desc_t desc = { 0 };
+    desc.entity = ecs_entity(host->world, { .name = name });
+    desc.type.size = field_count * 4;
+    desc.type.alignment = field_count ? 4 : 0;
+    ecs_entity_t id = ecs_component_init(host->world, &desc);
+    if (!id) return luaL_error(L, "could not create component %s", name);
+    if (field_count) ecs_set_hooks_id(host->world, id, &(ecs_type_hooks_t){ .ctor = lua_script_zero_ctor });
+    if (!lua_script_register_component(host->world, name, id, fields, field_count)) {
+        return luaL_error(L, "could not register component %s", name);
+    }
+    lua_pushinteger(L, (lua_Integer)id);
+    return 1;
+}
+
+static const lua_script_component_t *lua_script_check_component(lua_State *L, lua_script_host_t *host, int index){
+    const char *name = luaL_checkstring(L, index);
+    int32_t component = lua_script_find_component(host, name);
+    if (component < 0) luaL_error(L, "component %s is not registered", name);
+    return &host->components[component];
+}
+
+// ecs.set(entity, component, { field = value }), fields left out keep their value
+static int lua_script_set(lua_State *L){
+    lua_script_host_t *host = lua_touserdata(L, lua_upvalueindex(1));
+    ecs_entity_t entity = (ecs_entity_t)luaL_checkinteger(L, 1);
+    const lua_script_component_t *component = lua_script_check_component(L, host, 2);
+    if (!ecs_is_alive(host->world, entity)) return luaL_error(L, "entity is not alive");
+    if (component->size == 0) {
+        ecs_add_id(host->world, entity, component->id);
+        return 0;
+    }
+    uint8_t *value = lua_newuserdatauv(L, (size_t)component->size, 0); // scratch, collected
+    const void *current = ecs_get_id(host->world, entity, component->id);
+    if (current) memcpy(value, current, (size_t)component->size);
+    else memset(value, 0, (size_t)component->size);
+    if (lua_istable(L, 3)) {
+        for (int32_t i = 0; i < component->field_count; i++) {
+            const lua_script_field_info_t *field = &component->fields[i];
+            if (lua_getfield(L, 3, field->name) != LUA_TNIL) {
+                uint8_t *slot = value + field->offset;
+                switch (field->type) {
+                case LUA_SCRIPT_FLOAT: *(float *)slot = (float)luaL_checknumber(L, -1); break;
+                case LUA_SCRIPT_INT32: *(int32_t *)slot = (int32_t)luaL_checkinteger(L, -1); break;
+                case LUA_SCRIPT_BOOL: *(bool *)slot = lua_toboolean(L, -1); break;
+                }
+            }
+            lua_pop(L, 1);
+        }
+    }
+    ecs_set_id(host->world, entity, component->id, (size_t)component->size, value);
+    return 0;
+}
+
+static int lua_script_has(lua_State *L){
+    lua_script_host_t *host = lua_touserdata(L, lua_upvalueindex(1));
+    ecs_entity_t entity = (ecs_entity_t)luaL_checkinteger(L, 1);
+    const lua_script_component_t *component = lua_script_check_component(L, host, 2);
+    lua_pushboolean(L, ecs_is_alive(host->world, entity) && ecs_has_id(host->world, entity, component->id));
+    return 1;
+}
+
+// 0 when there is no entity with the name
+static int lua_script_lookup(lua_State *L){
+    lua_script_host_t *host = lua_touserdata(L, lua_upvalueindex(1));
+    lua_pushinteger(L, (lua_Integer)ecs_lookup(host->world, luaL_checkstring(L, 1)));
+    return 1;
+}
+
+//===============================================
+// API
+//===============================================
+static bool lua_script_exec(lua_script_host_t *host, int status, const char *chunk_name){
+    lua_State *L = host->L;
+    if (status == LUA_OK) {
+        int base = lua_gettop(L);
+        lua_pushcfunction(L, lua_script_traceback);
+        lua_insert(L, base);
+        status = lua_pcall(L, 0, 0, base);
+        lua_remove(L, base);
+    }
+    if (status != LUA_OK) {
+        TraceLog(LOG_WARNING, "LUA: %s: %s", chunk_name, lua_tostring(L, -1));
+        lua_pop(L, 1);
+        host->errors++;
+        lua_script_stats(host);
+    }
+    return status == LUA_OK;
+}
+
+bool lua_script_load(ecs_world_t *world, const char *path){
+    lua_script_host_t *host = lua_script_host(world);
+    if (!host) return false;
+    return lua_script_exec(host, luaL_loadfile(host->L, path), path);
+}
+
+//===============================================
+// WATCH
+//===============================================
+static int64_t lua_script_mtime(const char *path){
+    struct stat st;
+    return stat(path, &st) == 0 ? (int64_t)st.st_mtime : 0;
+}
+
+// runs the file again and applies the systems it staged. systems it no
+// longer defines are deleted. on an error nothing is applied, every system
+// of the file keeps the body it had
+static bool lua_script_load_file(lua_script_host_t *host, int32_t index){
+    lua_script_file_t *file = &host->files[index];
+    file->dirty = false;
+    file->mtime = lua_script_mtime(file->path);
+    host->loading_file = index;
+    uint32_t generation = ++host->load_generation;
+    bool ok = lua_script_exec(host, luaL_loadfile(host->L, file->path), file->path);
+    for (int32_t i = 0; i < host->staged_count; i++) {
+        lua_script_staged_t *staged = &host->staged[i];
+        if (!ok) {
+            luaL_unref(host->L, LUA_REGISTRYINDEX, staged->callback);
+        } else if (!lua_script_system_define(host, staged->name, staged->phase, staged->ids, staged->components,
+                                             staged->term_count, staged->callback)) {
+            TraceLog(LOG_WARNING, "LUA: %s: could not create system %s", file->path, staged->name);
+            host->errors++;
+        }
+        ecs_os_free(staged->name);
+    }
+    host->staged_count = 0;
+    host->loading_file = -1;
+    if (!ok) return false;
+    for (int32_t i = host->system_count - 1; i >= 0; i--) {
+        const lua_script_system_t *system = host->systems[i];
+        if (system->file == index && system->generation != generation) lua_script_system_delete(host, i);
+    }
+    lua_script_stats(host);
+    return true;
+}
+
+static void lua_script_watch_file(lua_script_host_t *host, lua_script_file_t *file){
+    file->wd = -1;
+#ifdef __linux__
+    if (host->inotify_fd < 0) host->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (host->inotify_fd < 0) return;
+    // the directory, editors often save by renaming a new file over the old one
+    char dir[LUA_SCRIPT_PATH_SIZE];
+    if (file->name_offset > 0) snprintf(dir, sizeof(dir), "%.*s", (int)file->name_offset, file->path);
+    else snprintf(dir, sizeof(dir), ".");
+    file->wd = inotify_add_watch(host->inotify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+#endif
+}
+
+static void lua_script_poll(lua_script_host_t *host, float delta_time){
+#ifdef __linux__
+    if (host->inotify_fd >= 0) {
+        _Alignas(struct inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(host->inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (char *p = buffer; p < buffer + length; ) {
+                const struct inotify_event *event = (const struct inotify_event *)p;
+                for (int32_t i = 0; event->len > 0 && i < host->file_count; i++) {
+                    lua_script_file_t *file = &host->files[i];
+                    if (file->wd == event->wd && strcmp(event->name, file->path + file->name_offset) == 0) file->dirty = true;
+                }
+                p += sizeof(struct inotify_event) + event->len;
+            }
+        }
+    }
+#endif
+    // files without a watch
+    host->poll_time += delta_time;
+    if (host->poll_time < LUA_SCRIPT_POLL_SECONDS) return;
+    host->poll_time = 0.0f;
+    for (int32_t i = 0; i < host->file_count; i++) {
+        lua_script_file_t *file = &host->files[i];
+        if (file->wd >= 0) continue;
+        int64_t mtime = lua_script_mtime(file->path);
+        if (mtime != 0 && mtime != file->mtime) file->dirty = true;
+    }
+}
+
+// after the frame, systems can be replaced and deleted outside the pipeline
+static void lua_script_reload(ecs_world_t *world, void *ctx){
+    lua_script_host_t *host = ctx;
+    host->reload_pending = false;
+    for (int32_t i = 0; i < host->file_count; i++) {
+        if (!host->files[i].dirty) continue;
+        uint64_t start = ecs_os_now();
+        bool ok = lua_script_load_file(host, i);
+        host->reloads++;
+        if (ok) TraceLog(LOG_INFO, "LUA: reloaded %s in %.2f ms", host->files[i].path, (double)(ecs_os_now() - start) / 1e6);
+    }
+    lua_script_stats(host);
+}
+
+bool lua_script_watch(ecs_world_t *world, const char *path){
+    lua_script_host_t *host = lua_script_host(world);
+    if (!host || !path) return false;
+#ifdef LUA_SCRIPT_PRECOMPILED
+    char compiled[LUA_SCRIPT_PATH_SIZE];
+    if (snprintf(compiled, sizeof(compiled), "%sc", path) >= (int)sizeof(compiled)) return false;
+    return lua_script_exec(host, luaL_loadfile(host->L, compiled), compiled);
+#else
+    for (int32_t i = 0; i < host->file_count; i++) {
+        if (strcmp(host->files[i].path, path) == 0) return lua_script_load_file(host, i);
+    }
+    if (host->file_count >= LUA_SCRIPT_MAX_FILES || strlen(path) >= LUA_SCRIPT_PATH_SIZE) return false;
+    int32_t index = host->file_count++;
+    lua_script_file_t *file = &host->files[index];
+    memset(file, 0, sizeof(lua_script_file_t));
+    strcpy(file->path, path);
+    const char *slash = strrchr(file->path, '/');
+    const char *backslash = strrchr(file->path, '\\');
+    if (backslash > slash) slash = backslash;
+    file->name_offset = slash ? (int32_t)(slash - file->path + 1) : 0;
+    lua_script_watch_file(host, file);
+    // a file that fails stays watched, saving a fix loads it
+    return lua_script_load_file(host, index);
+#endif
+}
+
+void lua_script_watch_system(ecs_iter_t *it){
+    lua_script_t *script = ecs_field(it, lua_script_t, 0);
+    lua_script_host_t *host = script->host;
+    if (!host || host->file_count == 0) return;
+    lua_script_poll(host, it->delta_time);
+    for (int32_t i = 0; !host->reload_pending && i < host->file_count; i++) {
+        if (!host->files[i].dirty) continue;
+        host->reload_pending = true;
+        ecs_run_post_frame(it->world, lua_script_reload, host);
+    }
+}
+
+bool lua_script_run(ecs_world_t *world, const char *source, const char *chunk_name){
+    lua_script_host_t *host = lua_script_host(world);
+    if (!host || !source) return false;
+    return lua_script_exec(host, luaL_loadbuffer(host->L, source, strlen(source), chunk_name), chunk_name);
+}
+
+bool lua_script_register_component(ecs_world_t *world, const char *name, ecs_entity_t id,
+                                   const lua_script_field_t *fields, int32_t field_count){
+    lua_script_host_t *host = lua_script_host(world);
+    if (!host || !name || id == 0 || field_count < 0 || field_count > LUA_SCRIPT_MAX_FIELDS) return false;
+    if (host->component_count >= LUA_SCRIPT_MAX_COMPONENTS || strlen(name) >= LUA_SCRIPT_NAME_SIZE) return false;
+    if (lua_script_find_component(host, name) >= 0) return false;
+    const ecs_type_info_t *type_info = ecs_get_type_info(world, id);
+    ecs_size_t size = type_info ? type_info->size : 0;
+    static const ecs_size_t type_sizes[] = { sizeof(float), sizeof(int32_t), sizeof(bool) };
+    for (int32_t i = 0; i < field_count; i++) {
+        if (fields[i].offset < 0 || fields[i].offset + type_sizes[fields[i].type] > size) return false;
+        if (strlen(fields[i].name) >= LUA_SCRIPT_NAME_SIZE) return false;
+    }
+    lua_script_component_t *component = &host->components[host->component_count++];
+    memset(component, 0, sizeof(lua_script_component_t));
+    strcpy(component->name, name);
+    component->id = id;
+    component->size = size;
+    component->field_count = field_count;
+    for (int32_t i = 0; i < field_count; i++) {
+        strcpy(component->fields[i].name, fields[i].name);
+        component->fields[i].offset = fields[i].offset;
+        component->fields[i].type = fields[i].type;
+    }
+    return true;
+}
+
+void on_remove_lua_script(ecs_iter_t *it){
+    lua_script_t *script = ecs_field(it, lua_script_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        lua_script_host_t *host = script[i].host;
+        if (!host) continue;
+        for (int32_t s = 0; s < host->system_count; s++) ecs_os_free(host->systems[s]);
+        ecs_os_free(host->systems);
+        ecs_os_free(host->staged);
+#ifdef __linux__
+        if (host->inotify_fd >= 0) close(host->inotify_fd);
+#endif
+        lua_close(host->L);
+        ecs_os_free(host);
+        script[i].host = NULL;
+    }
+}
+
+void setup_systems_lua(ecs_world_t *world){
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "lua_script_watch_system", .add = ecs_ids(ecs_dependson(PreLogicUpdatePhase)) }),
+        .query.terms = {
+            { .id = ecs_id(lua_script_t), .src.id = ecs_id(lua_script_t) } // Singleton
+        },
+        .callback = lua_script_watch_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(lua_script_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_lua_script
+    });
+}
+
+void setup_components_lua(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, lua_script_t);
+
+    lua_script_host_t *host = ecs_os_calloc(sizeof(lua_script_host_t));
+    lua_State *L = host ? luaL_newstate() : NULL;
+    if (!L) {
+        ecs_os_free(host);
+        TraceLog(LOG_WARNING, "LUA: could not create the lua state");
+        return;
+    }
+    host->L = L;
+    host->world = world;
+    host->inotify_fd = -1;
+    host->loading_file = -1;
+    luaL_openlibs(L);
+
+    static const luaL_Reg view_meta[] = {
+        { "__index", lua_script_view_get },
+        { "__newindex", lua_script_view_set },
+        { "__len", lua_script_view_len },
+        { NULL, NULL }
+    };
+    luaL_newmetatable(L, LUA_SCRIPT_VIEW_META);
+    luaL_setfuncs(L, view_meta, 0);
+    lua_pop(L, 1);
+    luaL_newmetatable(L, LUA_SCRIPT_ITER_META);
+    lua_pushcfunction(L, lua_script_iter_index);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+
+    static const luaL_Reg ecs_functions[] = {
+        { "system", lua_script_system_new },
+        { "component", lua_script_component_new },
+        { "set", lua_script_set },
+        { "has", lua_script_has },
+        { "lookup", lua_script_lookup },
+        { NULL, NULL }
+    };
+    lua_newtable(L);
+    lua_pushlightuserdata(L, host);
+    luaL_setfuncs(L, ecs_functions, 1);
+    lua_setglobal(L, "ecs");
+
+    ecs_singleton_set(world, lua_script_t, { .host = host });
+
+    const lua_script_field_t transform_fields[] = {
+        { "position.x", offsetof(Transform3D, position.x), LUA_SCRIPT_FLOAT },
+        { "position.y", offsetof(Transform3D, position.y), LUA_SCRIPT_FLOAT },
+        { "position.z", offsetof(Transform3D, position.z), LUA_SCRIPT_FLOAT },
+        { "rotation.x", offsetof(Transform3D, rotation.x), LUA_SCRIPT_FLOAT },
+        { "rotation.y", offsetof(Transform3D, rotation.y), LUA_SCRIPT_FLOAT },
+        { "rotation.z", offsetof(Transform3D, rotation.z), LUA_SCRIPT_FLOAT },
+        { "rotation.w", offsetof(Transform3D, rotation.w), LUA_SCRIPT_FLOAT },
+        { "scale.x", offsetof(Transform3D, scale.x), LUA_SCRIPT_FLOAT },
+        { "scale.y", offsetof(Transform3D, scale.y), LUA_SCRIPT_FLOAT },
+        { "scale.z", offsetof(Transform3D, scale.z), LUA_SCRIPT_FLOAT },
+        { "isDirty", offsetof(Transform3D, isDirty), LUA_SCRIPT_BOOL }
+    };
+    lua_script_register_component(world, "Transform3D", ecs_id(Transform3D), transform_fields,
+                                  (int32_t)(sizeof(transform_fields) / sizeof(transform_fields[0])));
+}
+
+void module_init_lua(ecs_world_t *world){
+    setup_components_lua(world);
+    setup_systems_lua(world);
+}
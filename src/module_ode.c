@@ -6,6 +6,7 @@
 
 #include "ecs_components.h" // phase
 #include "module_ode.h"
+#include "module_profiler.h"
 #include "raygui.h"
 #include "raymath.h"
 
@@ -13,6 +14,7 @@
 ECS_COMPONENT_DECLARE(ode_body_t);
 ECS_COMPONENT_DECLARE(ode_geom_t);
 ECS_COMPONENT_DECLARE(ode_context_t);
+ECS_COMPONENT_DECLARE(ode_shape_t);
 
 // ECS_COMPONENT_DECLARE(Transform3D);
 // Helper function to convert ODE 4x4 matrix to raylib Matrix
@@ -136,71 +138,130 @@ void ode_physics_system(ecs_iter_t *it) {
     ode_context_t *ctx = ecs_field(it, ode_context_t, 0);// field index 0
 
     // Pass ode_context_t to collision callback
+    profiler_zone_begin("ode_collide");
     dSpaceCollide(ctx->space, ctx, &nearCallback);
+    profiler_zone_end();
+    profiler_zone_begin("ode_step");
     dWorldQuickStep(ctx->world, 1.0f / 60.0f);
+    profiler_zone_end();
     dJointGroupEmpty(ctx->contact_group);
 }
 
+// world pose of the parents above e, ode works in world space while
+// Transform3D is local to the parent. false when e is a root
+static bool ode_parent_pose(ecs_world_t *world, ecs_entity_t e, Vector3 *position, Quaternion *rotation, Vector3 *scale){
+    *position = (Vector3){ 0 };
+    *rotation = QuaternionIdentity();
+    *scale = (Vector3){ 1.0f, 1.0f, 1.0f };
+    bool found = false;
+    // child first, each parent wraps the pose built so far
+    for (ecs_entity_t parent = ecs_get_parent(world, e); parent; parent = ecs_get_parent(world, parent)) {
+        const Transform3D *t = ecs_get(world, parent, Transform3D);
+        if (!t) continue;
+        *position = Vector3Add(t->position, Vector3RotateByQuaternion(Vector3Multiply(*position, t->scale), t->rotation));
+        *rotation = QuaternionMultiply(t->rotation, *rotation);
+        *scale = Vector3Multiply(*scale, t->scale);
+        found = true;
+    }
+    return found;
+}
+
 // Sync transform system
 void sync_transform_3d_system(ecs_iter_t *it){
     ode_body_t *body = ecs_field(it, ode_body_t, 0);
     Transform3D *transform = ecs_field(it, Transform3D, 1);
-    
-    // printf("sync\n");
 
     for (int i = 0; i < it->count; i++) {
-        ecs_entity_t e = it->entities[i];
         const dReal *pos = dBodyGetPosition(body[i].id);
+        const dReal *quat = dBodyGetQuaternion(body[i].id); // w first
+        if (!pos || !quat) continue;
+        Vector3 p = { (float)pos[0], (float)pos[1], (float)pos[2] };
+        Quaternion q = { (float)quat[1], (float)quat[2], (float)quat[3], (float)quat[0] };
 
-        // Update position
-        transform[i].position = (Vector3){
-            .x = (float)pos[0],
-            .y = (float)pos[1],
-            .z = (float)pos[2]
-        };
-
-        // const dReal *rot_matrix = dBodyGetRotation(body[i].id);
-        // dQuaternion ode_quat;
-        const dReal *ode_quat_ptr = dBodyGetQuaternion(body[i].id);
-        // dReal ode_quat[4] = {0}; // Local copy
-        // for (int j = 0; j < 4; j++) {
-        //     ode_quat[j] = ode_quat_ptr[j];
-        // }
-        // // Quaternion x,y,z,w
-        // transform[i].rotation.x = (float)ode_quat[0];
-        // transform[i].rotation.y = (float)ode_quat[1];
-        // transform[i].rotation.z = (float)ode_quat[2];
-        // transform[i].rotation.w = (float)ode_quat[3];
-
-        if (!ode_quat_ptr) return;
-
-        transform[i].rotation.x = (float)ode_quat_ptr[0];
-        transform[i].rotation.y = (float)ode_quat_ptr[1];
-        transform[i].rotation.z = (float)ode_quat_ptr[2];
-        transform[i].rotation.w = (float)ode_quat_ptr[3];
-
-        // printf("y: %f\n", pos[1]);
-        // Apply translation LAST
-        Matrix translation_mat = MatrixTranslate(transform[i].position.x, transform[i].position.y, transform[i].position.z);
+        // back into the parent space
+        Vector3 parent_p, parent_s;
+        Quaternion parent_q;
+        if (ode_parent_pose(it->world, it->entities[i], &parent_p, &parent_q, &parent_s)) {
+            Quaternion inverse = QuaternionInvert(parent_q);
+            p = Vector3RotateByQuaternion(Vector3Subtract(p, parent_p), inverse);
+            if (parent_s.x != 0.0f) p.x /= parent_s.x;
+            if (parent_s.y != 0.0f) p.y /= parent_s.y;
+            if (parent_s.z != 0.0f) p.z /= parent_s.z;
+            q = QuaternionMultiply(inverse, q);
+        }
+        transform[i].position = p;
+        transform[i].rotation = q;
 
-        // // If non-uniform, it WILL distort the cube into an ellipsoid
-        Matrix scale_mat = MatrixScale(transform[i].scale.x, transform[i].scale.y, transform[i].scale.z);
+        // Mark as dirty, the transform system rebuilds the matrices
+        transform[i].isDirty = true;
+    }
+}
 
-        // // Apply rotation to the scaled object
-        Matrix rot_mat = QuaternionToMatrix(transform[i].rotation);
+int32_t ode_shape_create(ecs_world_t *world, const ecs_entity_t *entities, int32_t count){
+    const ode_context_t *ctx = ecs_singleton_get(world, ode_context_t);
+    if (!ctx || !ctx->world || !ctx->space) return 0;
+    int32_t created = 0;
+    for (int32_t i = 0; i < count; i++) {
+        ecs_entity_t e = entities[i];
+        const ode_shape_t *shape = ecs_get(world, e, ode_shape_t);
+        if (!shape || ecs_has(world, e, ode_geom_t)) continue;
+        const Transform3D *transform = ecs_get(world, e, Transform3D);
+        Vector3 p = transform ? transform->position : (Vector3){ 0 };
+        Quaternion q = transform ? transform->rotation : QuaternionIdentity();
+        // parented entities are placed from the parent chain, not from a
+        // worldMatrix that may not have been propagated yet
+        Vector3 parent_p, parent_s;
+        Quaternion parent_q;
+        if (ode_parent_pose(world, e, &parent_p, &parent_q, &parent_s)) {
+            p = Vector3Add(parent_p, Vector3RotateByQuaternion(Vector3Multiply(p, parent_s), parent_q));
+            q = QuaternionMultiply(parent_q, q);
+        }
+        dQuaternion rotation = { q.w, q.x, q.y, q.z }; // ode is w first
 
-        // // Correct order: Translation * Rotation * Scale ??
-        // transform[i].localMatrix = MatrixMultiply(scale_mat, MatrixMultiply(rot_mat, translation_mat));
+        dMass mass;
+        dMassSetZero(&mass);
+        dGeomID geom = NULL;
+        switch (shape->type) {
+        case ODE_SHAPE_BOX:
+            geom = dCreateBox(ctx->space, shape->size.x, shape->size.y, shape->size.z);
+            dMassSetBox(&mass, 1.0, shape->size.x, shape->size.y, shape->size.z);
+            break;
+        case ODE_SHAPE_SPHERE:
+            geom = dCreateSphere(ctx->space, shape->size.x);
+            dMassSetSphere(&mass, 1.0, shape->size.x);
+            break;
+        case ODE_SHAPE_CAPSULE:
+            geom = dCreateCapsule(ctx->space, shape->size.x, shape->size.y);
+            dMassSetCapsule(&mass, 1.0, 3, shape->size.x, shape->size.y);
+            break;
+        case ODE_SHAPE_PLANE: {
+            Vector3 n = Vector3Normalize(shape->size);
+            geom = dCreatePlane(ctx->space, n.x, n.y, n.z, Vector3DotProduct(n, p));
+            break;
+        }
+        default:
+            break;
+        }
+        if (!geom) continue;
 
-        // // For now, assume local == world (no parent hierarchy)
-        // transform[i].worldMatrix = transform[i].localMatrix;
-        
-        // // Mark as dirty
-        transform[i].isDirty = true;
-        
-        // Notify ECS that transform changed // not need since already update.
-        // ecs_modified(it->world, e, Transform3D);
+        if (shape->type == ODE_SHAPE_PLANE) {
+            // planes are non placeable
+        } else if (shape->mass > 0.0f) {
+            dBodyID body = dBodyCreate(ctx->world);
+            dMassAdjust(&mass, shape->mass);
+            dBodySetMass(body, &mass);
+            dGeomSetBody(geom, body);
+            dBodySetPosition(body, p.x, p.y, p.z);
+            dBodySetQuaternion(body, rotation);
+            ecs_set(world, e, ode_body_t, { .id = body });
+        } else {
+            dGeomSetPosition(geom, p.x, p.y, p.z);
+            dGeomSetQuaternion(geom, rotation);
+        }
+        ecs_set(world, e, ode_geom_t, { .id = geom });
+        created++;
     }
+    return created;
 }
 
 // set up systems ode
@@ -237,6 +298,7 @@ void setup_components_ode(ecs_world_t *world){
     ECS_COMPONENT_DEFINE(world, ode_body_t);
     ECS_COMPONENT_DEFINE(world, ode_geom_t);
     ECS_COMPONENT_DEFINE(world, ode_context_t);
+    ECS_COMPONENT_DEFINE(world, ode_shape_t);
 }
 // set up ode
 void module_init_ode(ecs_world_t *world){
@@ -0,0 +1,454 @@
+// module_picking.c
+// uniform grid over entity AABBs. every cell a box overlaps keeps its item
+// index, a ray walks the cells front to back (3D DDA) and stops once the
+// closest hit is nearer than the next cell boundary.
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecs_components.h"
+#include "module_picking.h"
+
+ECS_COMPONENT_DECLARE(pick_bounds_t);
+ECS_COMPONENT_DECLARE(pick_shape_t);
+ECS_COMPONENT_DECLARE(pick_grid_t);
+
+#define PICK_CELL_BITS 21
+#define PICK_CELL_LIMIT ((1 << (PICK_CELL_BITS - 1)) - 1) // cell coordinate range +/-
+#define PICK_MAX_STEPS 65536                              // cells walked per ray at most
+
+typedef struct {
+    int32_t min[3];
+    int32_t max[3];
+} pick_range_t;
+
+//===============================================
+// GRID
+//===============================================
+static int32_t pick_cell_coord(const pick_grid_t *grid, float v){
+    float c = floorf(v * grid->inv_cell_size);
+    if (c < -PICK_CELL_LIMIT) return -PICK_CELL_LIMIT;
+    if (c > PICK_CELL_LIMIT) return PICK_CELL_LIMIT;
+    return (int32_t)c;
+}
+
+static uint64_t pick_cell_key(int32_t x, int32_t y, int32_t z){
+    const uint64_t mask = (1ULL << PICK_CELL_BITS) - 1;
+    return ((uint64_t)(x + PICK_CELL_LIMIT) & mask)
+        | (((uint64_t)(y + PICK_CELL_LIMIT) & mask) << PICK_CELL_BITS)
+        | (((uint64_t)(z + PICK_CELL_LIMIT) & mask) << (PICK_CELL_BITS * 2));
+}
+
+static pick_range_t pick_box_range(const pick_grid_t *grid, BoundingBox box){
+    pick_range_t r;
+    r.min[0] = pick_cell_coord(grid, box.min.x);
+    r.min[1] = pick_cell_coord(grid, box.min.y);
+    r.min[2] = pick_cell_coord(grid, box.min.z);
+    r.max[0] = pick_cell_coord(grid, box.max.x);
+    r.max[1] = pick_cell_coord(grid, box.max.y);
+    r.max[2] = pick_cell_coord(grid, box.max.z);
+    return r;
+}
+
+static int64_t pick_range_cells(const pick_range_t *r){
+    return (int64_t)(r->max[0] - r->min[0] + 1) * (r->max[1] - r->min[1] + 1) * (r->max[2] - r->min[2] + 1);
+}
+
+static bool pick_range_equal(const pick_range_t *a, const pick_range_t *b){
+    return memcmp(a, b, sizeof(pick_range_t)) == 0;
+}
+
+static bool pick_grow(void **data, int32_t *capacity, int32_t count, size_t size, int32_t initial){
+    if (count <= *capacity) return true;
+    int32_t next = *capacity ? *capacity * 2 : initial;
+    while (next < count) next *= 2;
+    void *grown = ecs_os_realloc(*data, size * (size_t)next);
+    if (!grown) return false;
+    *data = grown;
+    *capacity = next;
+    return true;
+}
+
+static pick_cell_t *pick_cell_get(const pick_grid_t *grid, int32_t x, int32_t y, int32_t z){
+    ecs_map_val_t *found = ecs_map_get(&grid->cell_index, pick_cell_key(x, y, z));
+    return found ? &grid->cells[*found] : NULL;
+}
+
+static pick_cell_t *pick_cell_ensure(pick_grid_t *grid, int32_t x, int32_t y, int32_t z){
+    uint64_t key = pick_cell_key(x, y, z);
+    ecs_map_val_t *found = ecs_map_get(&grid->cell_index, key);
+    if (found) return &grid->cells[*found];
+    if (!pick_grow((void **)&grid->cells, &grid->cell_capacity, grid->cell_count + 1, sizeof(pick_cell_t), 1024)) return NULL;
+    int32_t index = grid->cell_count++;
+    grid->cells[index] = (pick_cell_t){0};
+    ecs_map_insert(&grid->cell_index, key, (ecs_map_val_t)index);
+    return &grid->cells[index];
+}
+
+// cells stay allocated once empty, a removed block is usually placed again
+static void pick_cell_push(pick_cell_t *cell, int32_t item){
+    if (!pick_grow((void **)&cell->items, &cell->capacity, cell->count + 1, sizeof(int32_t), 4)) return;
+    cell->items[cell->count++] = item;
+}
+
+static void pick_cell_erase(pick_cell_t *cell, int32_t item){
+    for (int32_t i = 0; i < cell->count; i++) {
+        if (cell->items[i] == item) {
+            cell->items[i] = cell->items[--cell->count];
+            return;
+        }
+    }
+}
+
+static void pick_grid_link(pick_grid_t *grid, int32_t index, const pick_range_t *r){
+    pick_item_t *item = &grid->items[index];
+    item->oversized = pick_range_cells(r) > PICK_MAX_CELLS_PER_ITEM;
+    if (item->oversized) {
+        if (pick_grow((void **)&grid->oversized, &grid->oversized_capacity, grid->oversized_count + 1, sizeof(int32_t), 16)) {
+            grid->oversized[grid->oversized_count++] = index;
+        }
+        return;
+    }
+    for (int32_t z = r->min[2]; z <= r->max[2]; z++)
+    for (int32_t y = r->min[1]; y <= r->max[1]; y++)
+    for (int32_t x = r->min[0]; x <= r->max[0]; x++) {
+        pick_cell_t *cell = pick_cell_ensure(grid, x, y, z);
+        if (cell) pick_cell_push(cell, index);
+    }
+}
+
+static void pick_grid_unlink(pick_grid_t *grid, int32_t index){
+    pick_item_t *item = &grid->items[index];
+    if (item->oversized) {
+        for (int32_t i = 0; i < grid->oversized_count; i++) {
+            if (grid->oversized[i] == index) {
+                grid->oversized[i] = grid->oversized[--grid->oversized_count];
+                break;
+            }
+        }
+        return;
+    }
+    pick_range_t r = pick_box_range(grid, item->box);
+    for (int32_t z = r.min[2]; z <= r.max[2]; z++)
+    for (int32_t y = r.min[1]; y <= r.max[1]; y++)
+    for (int32_t x = r.min[0]; x <= r.max[0]; x++) {
+        pick_cell_t *cell = pick_cell_get(grid, x, y, z);
+        if (cell) pick_cell_erase(cell, index);
+    }
+}
+
+static int32_t pick_grid_alloc(pick_grid_t *grid){
+    if (grid->free_head >= 0) {
+        int32_t index = grid->free_head;
+        grid->free_head = grid->items[index].next_free;
+        return index;
+    }
+    int32_t capacity = grid->item_capacity;
+    if (!pick_grow((void **)&grid->items, &capacity, grid->item_count + 1, sizeof(pick_item_t), 1024)) return -1;
+    if (capacity != grid->item_capacity) {
+        uint32_t *stamps = ecs_os_realloc(grid->stamps, sizeof(uint32_t) * (size_t)capacity);
+        if (!stamps) return -1;
+        memset(stamps + grid->item_capacity, 0, sizeof(uint32_t) * (size_t)(capacity - grid->item_capacity));
+        grid->stamps = stamps;
+        grid->item_capacity = capacity;
+    }
+    return grid->item_count++;
+}
+
+// insert or move, cells are only touched when the covered range changed
+static void pick_grid_update(pick_grid_t *grid, ecs_entity_t e, BoundingBox box){
+    ecs_map_val_t *found = ecs_map_get(&grid->entity_items, e);
+    pick_range_t r = pick_box_range(grid, box);
+    if (found) {
+        int32_t index = (int32_t)*found;
+        pick_item_t *item = &grid->items[index];
+        pick_range_t old = pick_box_range(grid, item->box);
+        bool same = pick_range_equal(&old, &r) || (item->oversized && pick_range_cells(&r) > PICK_MAX_CELLS_PER_ITEM);
+        if (!same) pick_grid_unlink(grid, index);
+        item->box = box;
+        if (!same) pick_grid_link(grid, index, &r);
+    } else {
+        int32_t index = pick_grid_alloc(grid);
+        if (index < 0) return;
+        grid->items[index] = (pick_item_t){ .entity = e, .box = box, .next_free = -1 };
+        grid->stamps[index] = 0;
+        ecs_map_insert(&grid->entity_items, e, (ecs_map_val_t)index);
+        pick_grid_link(grid, index, &r);
+        grid->live_count++;
+    }
+    grid->bounds_min = Vector3Min(grid->bounds_min, box.min);
+    grid->bounds_max = Vector3Max(grid->bounds_max, box.max);
+}
+
+static void pick_grid_remove(pick_grid_t *grid, ecs_entity_t e){
+    ecs_map_val_t *found = ecs_map_get(&grid->entity_items, e);
+    if (!found) return;
+    int32_t index = (int32_t)*found;
+    ecs_map_remove(&grid->entity_items, e);
+    pick_grid_unlink(grid, index);
+    grid->items[index].entity = 0;
+    grid->items[index].next_free = grid->free_head;
+    grid->free_head = index;
+    grid->live_count--;
+}
+
+//===============================================
+// RAY QUERY
+//===============================================
+typedef struct {
+    float origin[3];
+    float dir[3];       // normalized
+    float inv_dir[3];
+    float max_t;
+    float best_t;
+    int32_t best_item;
+    int best_axis;
+} pick_ray_state_t;
+
+static const float *pick_vec(const Vector3 *v){
+    return &v->x;
+}
+
+// slab test, t of the entry face and the axis it lies on
+static bool pick_ray_box(const pick_ray_state_t *s, BoundingBox box, float *out_t, int *out_axis){
+    const float *bmin = pick_vec(&box.min);
+    const float *bmax = pick_vec(&box.max);
+    float t_near = -FLT_MAX;
+    float t_far = FLT_MAX;
+    int axis = 0;
+    for (int a = 0; a < 3; a++) {
+        float t0 = (bmin[a] - s->origin[a]) * s->inv_dir[a];
+        float t1 = (bmax[a] - s->origin[a]) * s->inv_dir[a];
+        if (t0 > t1) { float tmp = t0; t0 = t1; t1 = tmp; }
+        if (isnan(t0)) t0 = -FLT_MAX; // origin on the slab plane with dir 0
+        if (isnan(t1)) t1 = FLT_MAX;
+        if (t0 > t_near) { t_near = t0; axis = a; }
+        if (t1 < t_far) t_far = t1;
+    }
+    if (t_near > t_far || t_far < 0.0f) return false;
+    *out_t = t_near > 0.0f ? t_near : 0.0f; // origin inside counts as a hit at 0
+    *out_axis = axis;
+    return true;
+}
+
+static void pick_test_item(const pick_grid_t *grid, pick_ray_state_t *s, int32_t index){
+    if (grid->stamps[index] == grid->stamp) return;
+    grid->stamps[index] = grid->stamp;
+    float t;
+    int axis;
+    if (pick_ray_box(s, grid->items[index].box, &t, &axis) && t <= s->max_t && t < s->best_t) {
+        s->best_t = t;
+        s->best_item = index;
+        s->best_axis = axis;
+    }
+}
+
+static pick_hit_t pick_grid_ray(pick_grid_t *grid, Ray ray, float max_distance){
+    pick_hit_t hit = {0};
+    if (grid->live_count == 0) return hit;
+    float length = Vector3Length(ray.direction);
+    if (length <= 0.0f) return hit;
+
+    if (++grid->stamp == 0) { // wrapped, old stamps could match again
+        memset(grid->stamps, 0, sizeof(uint32_t) * (size_t)grid->item_capacity);
+        grid->stamp = 1;
+    }
+
+    pick_ray_state_t s = { .max_t = max_distance > 0.0f ? max_distance : FLT_MAX, .best_t = FLT_MAX, .best_item = -1 };
+    const float *o = pick_vec(&ray.position);
+    const float *d = pick_vec(&ray.direction);
+    for (int a = 0; a < 3; a++) {
+        s.origin[a] = o[a];
+        s.dir[a] = d[a] / length;
+        s.inv_dir[a] = 1.0f / s.dir[a];
+    }
+
+    for (int32_t i = 0; i < grid->oversized_count; i++) {
+        pick_test_item(grid, &s, grid->oversized[i]);
+    }
+
+    // clip the walk to the grid bounds
+    float t_enter, t_exit;
+    int entry_axis;
+    BoundingBox bounds = { grid->bounds_min, grid->bounds_max };
+    if (pick_ray_box(&s, bounds, &t_enter, &entry_axis)) {
+        const float *bmax = pick_vec(&bounds.max);
+        t_exit = FLT_MAX;
+        for (int a = 0; a < 3; a++) {
+            if (s.dir[a] > 0.0f) t_exit = fminf(t_exit, (bmax[a] - s.origin[a]) * s.inv_dir[a]);
+            else if (s.dir[a] < 0.0f) t_exit = fminf(t_exit, (pick_vec(&bounds.min)[a] - s.origin[a]) * s.inv_dir[a]);
+        }
+        if (t_exit > s.max_t) t_exit = s.max_t;
+
+        int32_t cell[3], step[3], last[3];
+        float t_max[3], t_delta[3];
+        for (int a = 0; a < 3; a++) {
+            float p = s.origin[a] + s.dir[a] * t_enter;
+            cell[a] = pick_cell_coord(grid, p);
+            int32_t lo = pick_cell_coord(grid, pick_vec(&bounds.min)[a]);
+            int32_t hi = pick_cell_coord(grid, bmax[a]);
+            if (cell[a] < lo) cell[a] = lo; // entry point rounding
+            if (cell[a] > hi) cell[a] = hi;
+            if (s.dir[a] > 0.0f) {
+                step[a] = 1;
+                last[a] = hi;
+                t_max[a] = ((float)(cell[a] + 1) * grid->cell_size - s.origin[a]) * s.inv_dir[a];
+                t_delta[a] = grid->cell_size * s.inv_dir[a];
+            } else if (s.dir[a] < 0.0f) {
+                step[a] = -1;
+                last[a] = lo;
+                t_max[a] = ((float)cell[a] * grid->cell_size - s.origin[a]) * s.inv_dir[a];
+                t_delta[a] = -grid->cell_size * s.inv_dir[a];
+            } else {
+                step[a] = 0;
+                last[a] = cell[a];
+                t_max[a] = FLT_MAX;
+                t_delta[a] = FLT_MAX;
+            }
+        }
+
+        for (int steps = 0; steps < PICK_MAX_STEPS; steps++) {
+            const pick_cell_t *c = pick_cell_get(grid, cell[0], cell[1], cell[2]);
+            if (c) {
+                for (int32_t i = 0; i < c->count; i++) pick_test_item(grid, &s, c->items[i]);
+            }
+            int a = t_max[0] < t_max[1] ? (t_max[0] < t_max[2] ? 0 : 2) : (t_max[1] < t_max[2] ? 1 : 2);
+            // nothing in a later cell can be nearer than this boundary
+            if (s.best_t <= t_max[a] || t_max[a] > t_exit || cell[a] == last[a]) break;
+            cell[a] += step[a];
+            t_max[a] += t_delta[a];
+        }
+    }
+
+    if (s.best_item < 0) return hit;
+    hit.hit = true;
+    hit.entity = grid->items[s.best_item].entity;
+    hit.distance = s.best_t;
+    hit.point = (Vector3){ s.origin[0] + s.dir[0] * s.best_t, s.origin[1] + s.dir[1] * s.best_t, s.origin[2] + s.dir[2] * s.best_t };
+    float *n = &hit.normal.x;
+    n[s.best_axis] = s.dir[s.best_axis] > 0.0f ? -1.0f : 1.0f;
+    return hit;
+}
+
+pick_hit_t pick_ray(ecs_world_t *world, Ray ray, float max_distance){
+    pick_grid_t *grid = ecs_singleton_get_mut(world, pick_grid_t);
+    if (!grid) return (pick_hit_t){0};
+    return pick_grid_ray(grid, ray, max_distance);
+}
+
+// one singleton lookup for the whole batch
+void pick_rays(ecs_world_t *world, const Ray *rays, int count, float max_distance, pick_hit_t *hits){
+    pick_grid_t *grid = ecs_singleton_get_mut(world, pick_grid_t);
+    for (int i = 0; i < count; i++) {
+        hits[i] = grid ? pick_grid_ray(grid, rays[i], max_distance) : (pick_hit_t){0};
+    }
+}
+
+//===============================================
+// SYSTEMS
+//===============================================
+// world AABB of a local box, center moves with the matrix and the extents
+// take the absolute rotation/scale so the box stays conservative
+static pick_bounds_t pick_transform_bounds(const Matrix *m, Vector3 half){
+    Vector3 center = { m->m12, m->m13, m->m14 };
+    Vector3 extent = {
+        fabsf(m->m0) * half.x + fabsf(m->m4) * half.y + fabsf(m->m8) * half.z,
+        fabsf(m->m1) * half.x + fabsf(m->m5) * half.y + fabsf(m->m9) * half.z,
+        fabsf(m->m2) * half.x + fabsf(m->m6) * half.y + fabsf(m->m10) * half.z
+    };
+    return (pick_bounds_t){ Vector3Subtract(center, extent), Vector3Add(center, extent) };
+}
+
+// update_transform_3d_system calls ecs_modified only for transforms it
+// recomputed, so only moved boxes (or a new or changed shape) get here
+void on_set_pick_transform(ecs_iter_t *it){
+    const Transform3D *transform = ecs_field(it, Transform3D, 0);
+    const pick_shape_t *shape = ecs_field(it, pick_shape_t, 1);
+    for (int i = 0; i < it->count; i++) {
+        pick_bounds_t bounds = pick_transform_bounds(&transform[i].worldMatrix, shape[i].half_extents);
+        ecs_set_ptr(it->world, it->entities[i], pick_bounds_t, &bounds);
+    }
+}
+
+void on_set_pick_bounds(ecs_iter_t *it){
+    pick_grid_t *grid = ecs_singleton_get_mut(it->world, pick_grid_t);
+    if (!grid) return;
+    pick_bounds_t *bounds = ecs_field(it, pick_bounds_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        pick_grid_update(grid, it->entities[i], (BoundingBox){ bounds[i].min, bounds[i].max });
+    }
+}
+
+void on_remove_pick_bounds(ecs_iter_t *it){
+    pick_grid_t *grid = ecs_singleton_get_mut(it->world, pick_grid_t);
+    if (!grid) return;
+    for (int i = 0; i < it->count; i++) {
+        pick_grid_remove(grid, it->entities[i]);
+    }
+}
+
+void on_remove_pick_grid(ecs_iter_t *it){
+    pick_grid_t *grid = ecs_field(it, pick_grid_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        for (int32_t c = 0; c < grid[i].cell_count; c++) ecs_os_free(grid[i].cells[c].items);
+        ecs_os_free(grid[i].cells);
+        ecs_os_free(grid[i].items);
+        ecs_os_free(grid[i].stamps);
+        ecs_os_free(grid[i].oversized);
+        ecs_map_fini(&grid[i].entity_items);
+        ecs_map_fini(&grid[i].cell_index);
+        memset(&grid[i], 0, sizeof(pick_grid_t));
+    }
+}
+
+void setup_systems_picking(ecs_world_t *world){
+    ecs_observer(world, {
+        .query.terms = {
+            { .id = ecs_id(Transform3D), .inout = EcsIn },
+            { .id = ecs_id(pick_shape_t), .inout = EcsIn }
+        },
+        .events = { EcsOnSet },
+        .callback = on_set_pick_transform
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(pick_bounds_t) }},
+        .events = { EcsOnSet },
+        .callback = on_set_pick_bounds
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(pick_bounds_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_pick_bounds
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(pick_grid_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_pick_grid
+    });
+}
+
+void setup_components_picking(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, pick_bounds_t);
+    ECS_COMPONENT_DEFINE(world, pick_shape_t);
+    ECS_COMPONENT_DEFINE(world, pick_grid_t);
+
+    pick_grid_t grid = {
+        .cell_size = PICK_DEFAULT_CELL_SIZE,
+        .inv_cell_size = 1.0f / PICK_DEFAULT_CELL_SIZE,
+        .free_head = -1,
+        .bounds_min = { FLT_MAX, FLT_MAX, FLT_MAX },
+        .bounds_max = { -FLT_MAX, -FLT_MAX, -FLT_MAX }
+    };
+    ecs_map_init(&grid.entity_items, NULL);
+    ecs_map_init(&grid.cell_index, NULL);
+    ecs_singleton_set_ptr(world, pick_grid_t, &grid);
+}
+
+// call after module_init_raylib (Transform3D, phases)
+void module_init_picking(ecs_world_t *world){
+    setup_components_picking(world);
+    setup_systems_picking(world);
+}
@@ -0,0 +1,624 @@
+// module_prediction.c
+// client side prediction and server reconciliation for the capsule controller.
+/*
+- client samples input every tick, gives it a sequence number and keeps it in a ring
+- client applies the input to its own capsule right away (prediction)
+- client sends every unacked input each tick (redundant, unsequenced)
+- server applies one input per tick to the capsule of that peer
+- server sends back the capsule state plus the last sequence it applied
+- client compares with what it predicted for that sequence, on error it
+  rewinds to the server state and replays the inputs the server has not seen
+- rings are sized from the peer round trip time
+*/
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ecs_components.h" // phase
+#include "module_enet.h"
+#include "module_ode.h"
+#include "module_prediction.h"
+#include "raymath.h"
+
+ECS_COMPONENT_DECLARE(predict_config_t);
+ECS_COMPONENT_DECLARE(predict_client_t);
+ECS_COMPONENT_DECLARE(predict_server_t);
+
+#define PREDICT_INPUT_WIRE_SIZE 9   // sequence u32, buttons u8, yaw f32
+#define PREDICT_STATE_WIRE_SIZE 29  // type u8, ack u32, position 3 f32, velocity 3 f32
+#define PREDICT_GROUND_SLACK 0.05f  // how close to ground_height counts as grounded
+
+static ecs_query_t *predict_client_query = NULL;
+
+//===============================================
+// WIRE HELPERS (little endian)
+//===============================================
+static void write_u32(uint8_t *dst, uint32_t v){
+    dst[0] = (uint8_t)(v);
+    dst[1] = (uint8_t)(v >> 8);
+    dst[2] = (uint8_t)(v >> 16);
+    dst[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t read_u32(const uint8_t *src){
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static void write_f32(uint8_t *dst, float v){
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    write_u32(dst, bits);
+}
+
+static float read_f32(const uint8_t *src){
+    uint32_t bits = read_u32(src);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+//===============================================
+// MOVEMENT
+//===============================================
+static Vector3 predict_wish_velocity(const predict_input_t *input, float speed){
+    Vector3 forward = { cosf(input->yaw), 0.0f, sinf(input->yaw) };
+    Vector3 right = { -forward.z, 0.0f, forward.x }; // cross(forward, up)
+    Vector3 wish = { 0.0f, 0.0f, 0.0f };
+    if (input->buttons & PREDICT_BUTTON_FORWARD) wish = Vector3Add(wish, forward);
+    if (input->buttons & PREDICT_BUTTON_BACKWARD) wish = Vector3Subtract(wish, forward);
+    if (input->buttons & PREDICT_BUTTON_LEFT) wish = Vector3Subtract(wish, right);
+    if (input->buttons & PREDICT_BUTTON_RIGHT) wish = Vector3Add(wish, right);
+    if (Vector3LengthSqr(wish) > 0.0f) wish = Vector3Scale(Vector3Normalize(wish), speed);
+    return wish;
+}
+
+// same rules as predict_apply_body, integrated the way dWorldQuickStep does
+// (velocity first, then position) so a replay lands where ODE would.
+predict_state_t predict_integrate(predict_state_t state, const predict_input_t *input, const predict_config_t *config, float dt){
+    Vector3 wish = predict_wish_velocity(input, config->move_speed);
+    state.velocity.x = wish.x;
+    state.velocity.z = wish.z;
+    if ((input->buttons & PREDICT_BUTTON_JUMP) && state.position.y <= config->ground_height + PREDICT_GROUND_SLACK) {
+        state.velocity.y = config->jump_speed;
+    }
+    state.velocity.y -= config->gravity * dt;
+    state.position = Vector3Add(state.position, Vector3Scale(state.velocity, dt));
+    if (state.position.y < config->ground_height) {
+        state.position.y = config->ground_height;
+        if (state.velocity.y < 0.0f) state.velocity.y = 0.0f;
+    }
+    return state;
+}
+
+static void predict_apply_body(dBodyID body, const predict_input_t *input, const predict_config_t *config){
+    const dReal *pos = dBodyGetPosition(body);
+    const dReal *vel = dBodyGetLinearVel(body);
+    Vector3 wish = predict_wish_velocity(input, config->move_speed);
+    dReal vy = vel[1];
+    if ((input->buttons & PREDICT_BUTTON_JUMP) && pos[1] <= config->ground_height + PREDICT_GROUND_SLACK) {
+        vy = config->jump_speed;
+    }
+    dBodySetLinearVel(body, wish.x, vy, wish.z);
+    dBodySetAngularVel(body, 0, 0, 0);
+}
+
+static predict_state_t predict_read_body(dBodyID body){
+    const dReal *pos = dBodyGetPosition(body);
+    const dReal *vel = dBodyGetLinearVel(body);
+    return (predict_state_t){
+        .position = { (float)pos[0], (float)pos[1], (float)pos[2] },
+        .velocity = { (float)vel[0], (float)vel[1], (float)vel[2] }
+    };
+}
+
+static void predict_write_body(dBodyID body, predict_state_t state){
+    dBodySetPosition(body, state.position.x, state.position.y, state.position.z);
+    dBodySetLinearVel(body, state.velocity.x, state.velocity.y, state.velocity.z);
+}
+
+//===============================================
+// RING BUFFERS
+//===============================================
+static uint32_t next_pow2(uint32_t v){
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+// inputs in flight for one round trip, doubled for jitter, plus the redundant window
+uint32_t predict_history_for_rtt(uint32_t rtt_ms){
+    uint32_t ticks = (uint32_t)((float)rtt_ms / (PREDICT_TICK_DT * 1000.0f)) + 1;
+    uint32_t size = next_pow2(ticks * 2 + PREDICT_MAX_REDUNDANT);
+    if (size < PREDICT_MIN_HISTORY) size = PREDICT_MIN_HISTORY;
+    if (size > PREDICT_MAX_HISTORY) size = PREDICT_MAX_HISTORY;
+    return size;
+}
+
+// resize a ring indexed by sequence, keeping sequences [first, end)
+static void *ring_resize(void *ring, size_t elem_size, uint32_t old_cap, uint32_t new_cap, uint32_t first, uint32_t end){
+    uint8_t *next = ecs_os_calloc(elem_size * new_cap);
+    if (!next) return NULL;
+    if (ring && old_cap) {
+        if (end - first > old_cap) first = end - old_cap;
+        if (end - first > new_cap) first = end - new_cap;
+        for (uint32_t seq = first; seq != end; seq++) {
+            memcpy(next + (seq & (new_cap - 1)) * elem_size, (uint8_t *)ring + (seq & (old_cap - 1)) * elem_size, elem_size);
+        }
+    }
+    ecs_os_free(ring);
+    return next;
+}
+
+// grow only, shrinking while inputs are in flight would drop them
+static void predict_client_reserve(predict_client_t *client, uint32_t capacity){
+    if (client->capacity >= capacity) return;
+    uint32_t first = client->last_acked;
+    uint32_t end = client->next_sequence;
+    predict_input_t *inputs = ring_resize(client->inputs, sizeof(predict_input_t), client->capacity, capacity, first, end);
+    predict_state_t *states = ring_resize(client->states, sizeof(predict_state_t), client->capacity, capacity, first, end);
+    if (!inputs || !states) {
+        printf("[prediction] ring allocation failed\n");
+        return;
+    }
+    client->inputs = inputs;
+    client->states = states;
+    client->capacity = capacity;
+}
+
+static void predict_server_reserve(predict_server_t *server, uint32_t capacity){
+    if (server->capacity >= capacity) return;
+    predict_input_t *inputs = ring_resize(server->inputs, sizeof(predict_input_t), server->capacity, capacity, server->last_processed + 1, server->highest_received + 1);
+    if (!inputs) {
+        printf("[prediction] ring allocation failed\n");
+        return;
+    }
+    server->inputs = inputs;
+    server->capacity = capacity;
+}
+
+//===============================================
+// CAPSULE
+//===============================================
+// capsule standing on y, same shape as main_ode_controller_test
+ecs_entity_t predict_spawn_capsule(ecs_world_t *world, Vector3 position){
+    const ode_context_t *ctx = ecs_singleton_get(world, ode_context_t);
+    const predict_config_t *config = ecs_singleton_get(world, predict_config_t);
+    if (!ctx || !config) {
+        printf("[prediction] missing ode_context_t or predict_config_t\n");
+        return 0;
+    }
+
+    dBodyID body = dBodyCreate(ctx->world);
+    dMass mass;
+    dMassSetCapsule(&mass, 1.0, 3, 0.5, 1.0); // capsule geoms are along local z
+    dBodySetMass(body, &mass);
+    dGeomID geom = dCreateCapsule(ctx->space, 0.5, 1.0);
+    dGeomSetBody(geom, body);
+
+    dQuaternion q;
+    dQFromAxisAndAngle(q, 1, 0, 0, PI / 2); // stand it up along y
+    dBodySetQuaternion(body, q);
+    dBodySetPosition(body, position.x, position.y, position.z);
+    dBodySetMaxAngularSpeed(body, 0);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, ode_body_t, { .id = body });
+    ecs_set(world, e, ode_geom_t, { .id = geom });
+    ecs_set(world, e, Transform3D, {
+        .position = position,
+        .rotation = QuaternionIdentity(),
+        .scale = (Vector3){1.0f, 1.0f, 1.0f},
+        .localMatrix = MatrixIdentity(),
+        .worldMatrix = MatrixIdentity(),
+        .isDirty = true
+    });
+    if (config->model) {
+        ecs_set(world, e, ModelComponent, { config->model });
+    }
+    return e;
+}
+
+static void predict_destroy_capsule(ecs_world_t *world, ecs_entity_t e){
+    if (!e || !ecs_is_alive(world, e)) return;
+    const ode_geom_t *geom = ecs_get(world, e, ode_geom_t);
+    const ode_body_t *body = ecs_get(world, e, ode_body_t);
+    if (geom && geom->id) dGeomDestroy(geom->id);
+    if (body && body->id) dBodyDestroy(body->id);
+    ecs_remove(world, e, ode_geom_t);
+    ecs_remove(world, e, ode_body_t);
+}
+
+//===============================================
+// CLIENT
+//===============================================
+static uint8_t predict_sample_buttons(void){
+    uint8_t buttons = 0;
+    if (IsKeyDown(KEY_W)) buttons |= PREDICT_BUTTON_FORWARD;
+    if (IsKeyDown(KEY_S)) buttons |= PREDICT_BUTTON_BACKWARD;
+    if (IsKeyDown(KEY_A)) buttons |= PREDICT_BUTTON_LEFT;
+    if (IsKeyDown(KEY_D)) buttons |= PREDICT_BUTTON_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) buttons |= PREDICT_BUTTON_JUMP;
+    return buttons;
+}
+
+static float predict_camera_yaw(const main_context_t *main_context){
+    if (!main_context) return 0.0f;
+    Vector3 forward = Vector3Subtract(main_context->camera.target, main_context->camera.position);
+    return atan2f(forward.z, forward.x);
+}
+
+// [type u8][count u8][input * count], oldest first
+static void predict_send_inputs(ecs_world_t *world, const NetworkState *state, const predict_client_t *client){
+    uint32_t pending = (client->next_sequence - 1) - client->last_acked;
+    uint32_t count = pending < PREDICT_MAX_REDUNDANT ? pending : PREDICT_MAX_REDUNDANT;
+    if (count == 0) return;
+
+    uint8_t buf[2 + PREDICT_MAX_REDUNDANT * PREDICT_INPUT_WIRE_SIZE];
+    buf[0] = ENET_MSG_INPUT;
+    buf[1] = (uint8_t)count;
+    uint8_t *dst = buf + 2;
+    for (uint32_t seq = client->next_sequence - count; seq != client->next_sequence; seq++) {
+        const predict_input_t *input = &client->inputs[seq & (client->capacity - 1)];
+        write_u32(dst, input->sequence);
+        dst[4] = input->buttons;
+        write_f32(dst + 5, input->yaw);
+        dst += PREDICT_INPUT_WIRE_SIZE;
+    }
+    enet_outbox_send(world, state->peer, buf, (size_t)(dst - buf), false);
+}
+
+// sample, store and apply input before the physics step
+void predict_client_input_system(ecs_iter_t *it){
+    predict_client_t *client = ecs_field(it, predict_client_t, 0);
+    ode_body_t *body = ecs_field(it, ode_body_t, 1);
+    const predict_config_t *config = ecs_singleton_get(it->world, predict_config_t);
+    const NetworkState *state = ecs_singleton_get(it->world, NetworkState);
+    const main_context_t *main_context = ecs_singleton_get(it->world, main_context_t);
+    if (!config) return;
+
+    uint32_t rtt = (state && state->peer) ? state->peer->roundTripTime : 0;
+    uint8_t buttons = predict_sample_buttons();
+    float yaw = predict_camera_yaw(main_context);
+
+    for (int i = 0; i < it->count; i++) {
+        predict_client_t *c = &client[i];
+        predict_client_reserve(c, predict_history_for_rtt(rtt));
+        if (!c->capacity) continue;
+        if (c->next_sequence == 0) c->next_sequence = 1; // 0 means nothing acked
+
+        predict_input_t input = {
+            .sequence = c->next_sequence++,
+            .buttons = buttons,
+            .yaw = yaw
+        };
+        c->inputs[input.sequence & (c->capacity - 1)] = input;
+        predict_apply_body(body[i].id, &input, config);
+
+        if (state && !state->isServer && state->isConnected && state->peer) {
+            predict_send_inputs(it->world, state, c);
+        }
+    }
+}
+
+// remember where the step put us for the input sent this tick
+void predict_client_record_system(ecs_iter_t *it){
+    predict_client_t *client = ecs_field(it, predict_client_t, 0);
+    ode_body_t *body = ecs_field(it, ode_body_t, 1);
+    for (int i = 0; i < it->count; i++) {
+        predict_client_t *c = &client[i];
+        if (!c->capacity || c->next_sequence < 2) continue;
+        c->states[(c->next_sequence - 1) & (c->capacity - 1)] = predict_read_body(body[i].id);
+    }
+}
+
+static void predict_client_receive_state(ecs_world_t *world, const enet_packet_t *p){
+    const NetworkState *state = ecs_singleton_get(world, NetworkState);
+    const predict_config_t *config = ecs_singleton_get(world, predict_config_t);
+    if (!state || state->isServer || !config) return;
+    if (p->length < PREDICT_STATE_WIRE_SIZE) return;
+
+    const uint8_t *src = (const uint8_t *)p->data + 1;
+    uint32_t ack = read_u32(src);
+    predict_state_t server = {
+        .position = { read_f32(src + 4), read_f32(src + 8), read_f32(src + 12) },
+        .velocity = { read_f32(src + 16), read_f32(src + 20), read_f32(src + 24) }
+    };
+
+    ecs_iter_t qit = ecs_query_iter(world, predict_client_query);
+    while (ecs_query_next(&qit)) {
+        predict_client_t *client = ecs_field(&qit, predict_client_t, 0);
+        ode_body_t *body = ecs_field(&qit, ode_body_t, 1);
+        for (int i = 0; i < qit.count; i++) {
+            predict_client_t *c = &client[i];
+            // unsequenced packets can arrive late or twice
+            if (!c->capacity || ack <= c->last_acked || ack >= c->next_sequence) continue;
+
+            uint32_t mask = c->capacity - 1;
+            bool in_ring = c->next_sequence - ack <= c->capacity;
+            c->last_acked = ack;
+            c->last_error = in_ring ? Vector3Distance(c->states[ack & mask].position, server.position) : INFINITY;
+            if (c->last_error <= config->correction_epsilon) continue;
+
+            // rewind to the server state and replay what the server has not applied yet
+            predict_state_t s = server;
+            if (in_ring) {
+                c->states[ack & mask] = s;
+                for (uint32_t seq = ack + 1; seq != c->next_sequence; seq++) {
+                    s = predict_integrate(s, &c->inputs[seq & mask], config, PREDICT_TICK_DT);
+                    c->states[seq & mask] = s;
+                }
+            }
+            predict_write_body(body[i].id, s);
+            c->corrections++;
+        }
+    }
+}
+
+//===============================================
+// SERVER
+//===============================================
+static void predict_server_receive_inputs(ecs_world_t *world, const enet_packet_t *p){
+    const NetworkState *state = ecs_singleton_get(world, NetworkState);
+    if (!state || !state->isServer || !p->peer) return;
+
+    ecs_entity_t e = (ecs_entity_t)(uintptr_t)p->peer->data;
+    if (!e || !ecs_is_alive(world, e)) return;
+    predict_server_t *s = ecs_get_mut(world, e, predict_server_t);
+    if (!s) return;
+
+    const uint8_t *src = (const uint8_t *)p->data;
+    uint32_t count = p->length >= 2 ? src[1] : 0;
+    if (p->length < 2 + (size_t)count * PREDICT_INPUT_WIRE_SIZE) return;
+
+    predict_server_reserve(s, predict_history_for_rtt(p->peer->roundTripTime));
+    if (!s->capacity) return;
+
+    src += 2;
+    for (uint32_t i = 0; i < count; i++, src += PREDICT_INPUT_WIRE_SIZE) {
+        uint32_t seq = read_u32(src);
+        // already applied, or so far ahead it would overwrite unapplied input
+        if (seq <= s->last_processed || seq - s->last_processed >= s->capacity) continue;
+        s->inputs[seq & (s->capacity - 1)] = (predict_input_t){
+            .sequence = seq,
+            .buttons = src[4],
+            .yaw = read_f32(src + 5)
+        };
+        if (seq > s->highest_received) s->highest_received = seq;
+    }
+}
+
+// apply one input per tick to each remote capsule
+void predict_server_apply_system(ecs_iter_t *it){
+    predict_server_t *server = ecs_field(it, predict_server_t, 0);
+    const predict_config_t *config = ecs_singleton_get(it->world, predict_config_t);
+    if (!config) return;
+
+    for (int i = 0; i < it->count; i++) {
+        predict_server_t *s = &server[i];
+        if (s->capacity) {
+            // client ran too far ahead (stall or clock drift), catch up
+            if (s->highest_received - s->last_processed > s->capacity / 2) {
+                s->last_processed = s->highest_received - 1;
+            }
+            uint32_t next = s->last_processed + 1;
+            const predict_input_t *slot = &s->inputs[next & (s->capacity - 1)];
+            if (slot->sequence == next) {
+                s->current = *slot;
+                s->last_processed = next;
+            } else if (s->highest_received > next) {
+                // lost even with redundancy, keep holding the last input
+                s->last_processed = next;
+            }
+        }
+
+        const ode_body_t *body = ecs_is_alive(it->world, s->body) ? ecs_get(it->world, s->body, ode_body_t) : NULL;
+        if (body && body->id) {
+            predict_apply_body(body->id, &s->current, config);
+        }
+    }
+}
+
+// [type u8][ack u32][position][velocity]
+void predict_server_send_state_system(ecs_iter_t *it){
+    predict_server_t *server = ecs_field(it, predict_server_t, 0);
+    enet_client_t *client = ecs_field(it, enet_client_t, 1);
+
+    for (int i = 0; i < it->count; i++) {
+        predict_server_t *s = &server[i];
+        if (!s->last_processed || !client[i].peer || client[i].peer->state != ENET_PEER_STATE_CONNECTED) continue;
+        const ode_body_t *body = ecs_is_alive(it->world, s->body) ? ecs_get(it->world, s->body, ode_body_t) : NULL;
+        if (!body || !body->id) continue;
+
+        predict_state_t state = predict_read_body(body->id);
+        uint8_t buf[PREDICT_STATE_WIRE_SIZE];
+        buf[0] = ENET_MSG_STATE;
+        write_u32(buf + 1, s->last_processed);
+        write_f32(buf + 5, state.position.x);
+        write_f32(buf + 9, state.position.y);
+        write_f32(buf + 13, state.position.z);
+        write_f32(buf + 17, state.velocity.x);
+        write_f32(buf + 21, state.velocity.y);
+        write_f32(buf + 25, state.velocity.z);
+        enet_outbox_send(it->world, client[i].peer, buf, sizeof(buf), false);
+    }
+}
+
+//===============================================
+// OBSERVERS
+//===============================================
+void on_receive_prediction(ecs_iter_t *it){
+    enet_packet_t *p = it->param;
+    if (!p || !p->data || p->length < 1) return;
+    uint8_t type = ((const uint8_t *)p->data)[0];
+    if (type == ENET_MSG_INPUT) {
+        predict_server_receive_inputs(it->world, p);
+    } else if (type == ENET_MSG_STATE) {
+        predict_client_receive_state(it->world, p);
+    }
+}
+
+// the client's own player is a capsule child of the peer entity
+static bool predict_peer_has_client(ecs_world_t *world, ecs_entity_t peer){
+    ecs_iter_t cit = ecs_children(world, peer);
+    while (ecs_children_next(&cit)) {
+        for (int i = 0; i < cit.count; i++) {
+            if (ecs_has(world, cit.entities[i], predict_client_t)) {
+                ecs_iter_fini(&cit);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// new connection: server spawns a capsule for the peer, client spawns its own player.
+// OnAdd so setting enet_client_t again does not spawn another one
+void on_add_prediction_peer(ecs_iter_t *it){
+    const NetworkState *state = ecs_singleton_get(it->world, NetworkState);
+    const predict_config_t *config = ecs_singleton_get(it->world, predict_config_t);
+    if (!state || !config) return;
+
+    for (int i = 0; i < it->count; i++) {
+        ecs_entity_t e = it->entities[i];
+        if (ecs_has(it->world, e, predict_server_t)) continue;
+        if (!state->isServer && predict_peer_has_client(it->world, e)) continue;
+        ecs_entity_t capsule = predict_spawn_capsule(it->world, config->spawn);
+        if (!capsule) continue;
+        if (state->isServer) {
+            ecs_set(it->world, e, predict_server_t, { .body = capsule });
+        } else {
+            ecs_add_pair(it->world, capsule, EcsChildOf, e); // removed with the connection
+            ecs_set(it->world, capsule, predict_client_t, { 0 });
+        }
+    }
+}
+
+void on_remove_predict_client(ecs_iter_t *it){
+    predict_client_t *client = ecs_field(it, predict_client_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        ecs_os_free(client[i].inputs);
+        ecs_os_free(client[i].states);
+        client[i].inputs = NULL;
+        client[i].states = NULL;
+        client[i].capacity = 0;
+        predict_destroy_capsule(it->world, it->entities[i]);
+    }
+}
+
+void on_remove_predict_server(ecs_iter_t *it){
+    predict_server_t *server = ecs_field(it, predict_server_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        ecs_os_free(server[i].inputs);
+        server[i].inputs = NULL;
+        server[i].capacity = 0;
+        predict_destroy_capsule(it->world, server[i].body);
+        if (server[i].body && ecs_is_alive(it->world, server[i].body)) {
+            ecs_delete(it->world, server[i].body);
+        }
+    }
+}
+
+// Render HUD system
+void render2d_hud_prediction_system(ecs_iter_t *it){
+    const NetworkState *state = ecs_singleton_get(it->world, NetworkState);
+    ecs_iter_t qit = ecs_query_iter(it->world, predict_client_query);
+    while (ecs_query_next(&qit)) {
+        predict_client_t *client = ecs_field(&qit, predict_client_t, 0);
+        for (int i = 0; i < qit.count; i++) {
+            predict_client_t *c = &client[i];
+            uint32_t rtt = (state && state->peer) ? state->peer->roundTripTime : 0;
+            DrawText(TextFormat("seq %u ack %u pending %u", c->next_sequence, c->last_acked, c->next_sequence ? c->next_sequence - 1 - c->last_acked : 0), 2, 2 + 25 * 4, 20, DARKGRAY);
+            DrawText(TextFormat("rtt %u ms ring %u corrections %u error %.3f", rtt, c->capacity, c->corrections, c->last_error), 2, 2 + 25 * 5, 20, DARKGRAY);
+        }
+    }
+}
+
+void setup_systems_prediction(ecs_world_t *world){
+    predict_client_query = ecs_query(world, {
+        .terms = {
+            { .id = ecs_id(predict_client_t) },
+            { .id = ecs_id(ode_body_t) }
+        },
+        .cache_kind = EcsQueryCacheAuto
+    });
+
+    // before the physics step (ode_physics_system runs in EcsOnUpdate)
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "predict_client_input_system", .add = ecs_ids(ecs_dependson(EcsPreUpdate)) }),
+        .query.terms = {
+            { .id = ecs_id(predict_client_t) },
+            { .id = ecs_id(ode_body_t) }
+        },
+        .callback = predict_client_input_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "predict_server_apply_system", .add = ecs_ids(ecs_dependson(EcsPreUpdate)) }),
+        .query.terms = {
+            { .id = ecs_id(predict_server_t) }
+        },
+        .callback = predict_server_apply_system
+    });
+
+    // after the physics step
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "predict_client_record_system", .add = ecs_ids(ecs_dependson(EcsPostUpdate)) }),
+        .query.terms = {
+            { .id = ecs_id(predict_client_t) },
+            { .id = ecs_id(ode_body_t) }
+        },
+        .callback = predict_client_record_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "predict_server_send_state_system", .add = ecs_ids(ecs_dependson(EcsPostUpdate)) }),
+        .query.terms = {
+            { .id = ecs_id(predict_server_t) },
+            { .id = ecs_id(enet_client_t) }
+        },
+        .callback = predict_server_send_state_system
+    });
+
+    // ONLY 2D
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "render2d_hud_prediction_system", .add = ecs_ids(ecs_dependson(RLRender2D1Phase)) }),
+        .callback = render2d_hud_prediction_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ EcsAny, .src.id = event_receive_packed }},
+        .events = { ecs_id(enet_packet_t) },
+        .callback = on_receive_prediction
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(enet_client_t) }},
+        .events = { EcsOnAdd },
+        .callback = on_add_prediction_peer
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(predict_client_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_predict_client
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(predict_server_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_predict_server
+    });
+}
+
+void setup_components_prediction(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, predict_config_t);
+    ECS_COMPONENT_DEFINE(world, predict_client_t);
+    ECS_COMPONENT_DEFINE(world, predict_server_t);
+}
+
+// call after module_init_enet and module_init_ode
+void module_init_prediction(ecs_world_t *world){
+    setup_components_prediction(world);
+    setup_systems_prediction(world);
+}
@@ -0,0 +1,678 @@
+// module_profiler.c
+// wrapped system calls are timed into the frame being recorded. a phase zone
+// opens with the first system of a phase and closes at the next phase, the
+// per table calls of one system merge into one zone.
+// profiler_frame_system runs in its own phase ahead of EcsOnLoad, it closes
+// the last frame and starts the next, so a frame is start to start
+// including the swap.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecs_components.h"
+#include "module_profiler.h"
+#include "raygui.h"
+
+ECS_COMPONENT_DECLARE(profiler_t);
+
+#define PROFILER_NAME_MAX 512           // interned event names in a trace, the rest go inline
+#define PROFILER_TRACK_UUID 1
+#define PROFILER_SEQUENCE_ID 1
+#define PROFILER_TOP_SYSTEMS 8
+
+typedef struct {
+    ecs_iter_action_t action;           // the system callback
+    void *callback_ctx;
+    char *name;                         // kept until the world ends, zones point at it
+    const char *phase;
+} profiler_wrap_t;
+
+static struct {
+    profiler_frame_t *frames;           // ring, NULL until module_init_profiler
+    int32_t head;                       // frame being recorded
+    int32_t count;                      // complete frames
+    uint64_t frame_id;
+    bool recording;
+    const char *phase;                  // open phase zone
+    int32_t stack[PROFILER_MAX_DEPTH];  // open zones, -1 when dropped
+    int32_t depth;
+    profiler_wrap_t **wraps;
+    int32_t wrap_count;
+    int32_t wrap_capacity;
+} profiler_state;
+
+//===============================================
+// ZONES
+//===============================================
+static profiler_frame_t *profiler_current(void){
+    return &profiler_state.frames[profiler_state.head];
+}
+
+static void profiler_push(const char *name, uint64_t now){
+    profiler_frame_t *frame = profiler_current();
+    int32_t index = -1;
+    if (frame->zone_count < PROFILER_MAX_ZONES && profiler_state.depth < PROFILER_MAX_DEPTH) {
+        index = frame->zone_count++;
+        frame->zones[index] = (profiler_zone_t){ .name = name, .begin = now, .end = now, .depth = profiler_state.depth };
+    } else {
+        frame->dropped++;
+    }
+    if (profiler_state.depth < PROFILER_MAX_DEPTH) profiler_state.stack[profiler_state.depth] = index;
+    profiler_state.depth++;
+}
+
+static void profiler_pop(uint64_t now){
+    if (profiler_state.depth <= 0) return;
+    profiler_state.depth--;
+    if (profiler_state.depth >= PROFILER_MAX_DEPTH) return;
+    int32_t index = profiler_state.stack[profiler_state.depth];
+    if (index >= 0) profiler_current()->zones[index].end = now;
+}
+
+// the next table of the system that just ran reopens its zone
+static void profiler_push_system(const char *name, uint64_t now){
+    profiler_frame_t *frame = profiler_current();
+    if (frame->zone_count > 0 && profiler_state.depth < PROFILER_MAX_DEPTH) {
+        int32_t last = frame->zone_count - 1;
+        if (frame->zones[last].name == name && frame->zones[last].depth == profiler_state.depth) {
+            profiler_state.stack[profiler_state.depth++] = last;
+            return;
+        }
+    }
+    profiler_push(name, now);
+}
+
+static void profiler_enter_phase(const char *phase, uint64_t now){
+    if (phase == profiler_state.phase) return;
+    while (profiler_state.depth > 0) profiler_pop(now);
+    profiler_state.phase = phase;
+    if (phase) profiler_push(phase, now);
+}
+
+void profiler_zone_begin(const char *name){
+    if (!profiler_state.recording) return;
+    profiler_push(name, ecs_os_now());
+}
+
+void profiler_zone_end(void){
+    if (!profiler_state.recording) return;
+    profiler_pop(ecs_os_now());
+}
+
+const profiler_frame_t *profiler_frame(int32_t back){
+    if (!profiler_state.frames || back < 0 || back >= profiler_state.count) return NULL;
+    return &profiler_state.frames[(profiler_state.head - 1 - back + PROFILER_FRAMES * 2) % PROFILER_FRAMES];
+}
+
+int32_t profiler_frame_count(void){
+    return profiler_state.count;
+}
+
+static float profiler_ms(uint64_t begin, uint64_t end){
+    return end > begin ? (float)((double)(end - begin) / 1.0e6) : 0.0f;
+}
+
+//===============================================
+// INSTRUMENT
+//===============================================
+static void profiler_system_callback(ecs_iter_t *it){
+    profiler_wrap_t *wrap = it->callback_ctx;
+    it->callback_ctx = wrap->callback_ctx;
+    if (!profiler_state.recording) {
+        wrap->action(it);
+    } else {
+        uint64_t now = ecs_os_now();
+        // a system run from inside another one nests under it
+        if (profiler_state.depth <= 1) profiler_enter_phase(wrap->phase, now);
+        profiler_push_system(wrap->name, now);
+        wrap->action(it);
+        profiler_pop(ecs_os_now());
+    }
+    it->callback_ctx = wrap;
+}
+
+static void profiler_frame_system(ecs_iter_t *it);
+
+static const char *profiler_phase_name(ecs_world_t *world, ecs_entity_t system){
+    ecs_entity_t phase = ecs_get_target(world, system, EcsDependsOn, 0);
+    if (!phase) return NULL;
+    // the app phases are anonymous entities
+    if (phase == PreLogicUpdatePhase) return "PreLogicUpdatePhase";
+    if (phase == LogicUpdatePhase) return "LogicUpdatePhase";
+    if (phase == RLBeginDrawingPhase) return "RLBeginDrawingPhase";
+    if (phase == RLRender2D0Phase) return "RLRender2D0Phase";
+    if (phase == RLBeginMode3DPhase) return "RLBeginMode3DPhase";
+    if (phase == RLRender3DPhase) return "RLRender3DPhase";
+    if (phase == RLEndMode3DPhase) return "RLEndMode3DPhase";
+    if (phase == RLRender2D1Phase) return "RLRender2D1Phase";
+    if (phase == RLEndDrawingPhase) return "RLEndDrawingPhase";
+    if (phase == EcsOnLoad) return "OnLoad";
+    if (phase == EcsPostLoad) return "PostLoad";
+    if (phase == EcsPreUpdate) return "PreUpdate";
+    if (phase == EcsOnUpdate) return "OnUpdate";
+    if (phase == EcsOnValidate) return "OnValidate";
+    if (phase == EcsPostUpdate) return "PostUpdate";
+    if (phase == EcsPreStore) return "PreStore";
+    if (phase == EcsOnStore) return "OnStore";
+    return "other";
+}
+
+static bool profiler_add_wrap(profiler_wrap_t *wrap){
+    if (profiler_state.wrap_count == profiler_state.wrap_capacity) {
+        int32_t capacity = profiler_state.wrap_capacity ? profiler_state.wrap_capacity * 2 : 64;
+        profiler_wrap_t **wraps = ecs_os_realloc(profiler_state.wraps, sizeof(profiler_wrap_t*) * capacity);
+        if (!wraps) return false;
+        profiler_state.wraps = wraps;
+        profiler_state.wrap_capacity = capacity;
+    }
+    profiler_state.wraps[profiler_state.wrap_count++] = wrap;
+    return true;
+}
+
+int32_t profiler_instrument(ecs_world_t *world){
+    // collect first, ecs_system_init must not run while the query iterates
+    ecs_entity_t *systems = NULL;
+    int32_t count = 0, capacity = 0;
+    ecs_query_t *query = ecs_query(world, {
+        .terms = {{ .id = EcsSystem }},
+        .flags = EcsQueryMatchDisabled
+    });
+    ecs_iter_t it = ecs_query_iter(world, query);
+    while (ecs_query_next(&it)) {
+        for (int i = 0; i < it.count; i++) {
+            if (count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                systems = ecs_os_realloc(systems, sizeof(ecs_entity_t) * capacity);
+            }
+            systems[count++] = it.entities[i];
+        }
+    }
+    ecs_query_fini(query);
+
+    int32_t wrapped = 0;
+    for (int32_t i = 0; i < count; i++) {
+        const ecs_system_t *system = ecs_system_get(world, systems[i]);
+        if (!system || !system->action || system->run || system->callback_ctx_free) continue;
+        if (system->action == profiler_system_callback || system->action == profiler_frame_system) continue;
+
+        profiler_wrap_t *wrap = ecs_os_calloc(sizeof(profiler_wrap_t));
+        if (!wrap) break;
+        const char *name = ecs_get_name(world, systems[i]);
+        char id_name[32];
+        if (!name) {
+            snprintf(id_name, sizeof(id_name), "system #%llu", (unsigned long long)(uint32_t)systems[i]);
+            name = id_name;
+        }
+        wrap->action = system->action;
+        wrap->callback_ctx = system->callback_ctx;
+        wrap->name = ecs_os_strdup(name);
+        wrap->phase = profiler_phase_name(world, systems[i]);
+        if (!wrap->name || !profiler_add_wrap(wrap)) {
+            ecs_os_free(wrap->name);
+            ecs_os_free(wrap);
+            break;
+        }
+
+        // an existing entity updates the system in place, ctx is passed
+        // through so it is neither cleared nor freed
+        ecs_system_init(world, &(ecs_system_desc_t){
+            .entity = systems[i],
+            .callback = profiler_system_callback,
+            .callback_ctx = wrap,
+            .ctx = system->ctx,
+            .ctx_free = system->ctx_free
+        });
+        wrapped++;
+    }
+    ecs_os_free(systems);
+
+    profiler_t *profiler = ecs_singleton_get_mut(world, profiler_t);
+    if (profiler) profiler->instrumented += wrapped;
+    return wrapped;
+}
+
+//===============================================
+// EXPORT
+//===============================================
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+} profiler_buf_t;
+
+static void profiler_buf_bytes(profiler_buf_t *buf, const void *bytes, size_t size){
+    if (buf->failed) return;
+    if (buf->size + size > buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity * 2 : 4096;
+        while (capacity < buf->size + size) capacity *= 2;
+        uint8_t *data = ecs_os_realloc(buf->data, capacity);
+        if (!data) {
+            buf->failed = true;
+            return;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+    memcpy(buf->data + buf->size, bytes, size);
+    buf->size += size;
+}
+
+static void profiler_buf_varint(profiler_buf_t *buf, uint64_t v){
+    uint8_t bytes[10];
+    size_t n = 0;
+    do {
+        uint8_t b = v & 0x7f;
+        v >>= 7;
+        bytes[n++] = b | (v ? 0x80 : 0);
+    } while (v);
+    profiler_buf_bytes(buf, bytes, n);
+}
+
+// protobuf fields, wire type 0 varint and 2 length delimited
+static void profiler_pb_varint(profiler_buf_t *buf, uint32_t field, uint64_t v){
+    profiler_buf_varint(buf, (uint64_t)field << 3);
+    profiler_buf_varint(buf, v);
+}
+
+static void profiler_pb_bytes(profiler_buf_t *buf, uint32_t field, const void *data, size_t size){
+    profiler_buf_varint(buf, ((uint64_t)field << 3) | 2);
+    profiler_buf_varint(buf, size);
+    profiler_buf_bytes(buf, data, size);
+}
+
+static void profiler_pb_string(profiler_buf_t *buf, uint32_t field, const char *s){
+    profiler_pb_bytes(buf, field, s, strlen(s));
+}
+
+typedef struct {
+    profiler_buf_t out;                 // Trace
+    profiler_buf_t packet;              // scratch TracePacket
+    profiler_buf_t event;               // scratch TrackEvent
+    const char *names[PROFILER_NAME_MAX];
+    int32_t name_count;
+} profiler_trace_t;
+
+// iid of a name, 0 when the table is full
+static uint64_t profiler_trace_iid(profiler_trace_t *trace, const char *name, bool add){
+    for (int32_t i = 0; i < trace->name_count; i++) {
+        if (trace->names[i] == name) return (uint64_t)i + 1;
+    }
+    if (!add || trace->name_count == PROFILER_NAME_MAX) return 0;
+    trace->names[trace->name_count++] = name;
+    return (uint64_t)trace->name_count;
+}
+
+// TracePacket { timestamp 8, trusted_packet_sequence_id 10, sequence_flags 13,
+// track_event 11 { type 9, track_uuid 11, name_iid 10 or name 23 } }
+static void profiler_trace_event(profiler_trace_t *trace, uint64_t timestamp, bool begin, const char *name){
+    profiler_buf_t *event = &trace->event;
+    profiler_buf_t *packet = &trace->packet;
+    event->size = 0;
+    profiler_pb_varint(event, 9, begin ? 1 : 2); // TYPE_SLICE_BEGIN, TYPE_SLICE_END
+    profiler_pb_varint(event, 11, PROFILER_TRACK_UUID);
+    if (begin) {
+        uint64_t iid = profiler_trace_iid(trace, name, false);
+        if (iid) profiler_pb_varint(event, 10, iid);
+        else profiler_pb_string(event, 23, name);
+    }
+    packet->size = 0;
+    profiler_pb_varint(packet, 8, timestamp);
+    profiler_pb_varint(packet, 10, PROFILER_SEQUENCE_ID);
+    profiler_pb_varint(packet, 13, 2); // SEQ_NEEDS_INCREMENTAL_STATE
+    profiler_pb_bytes(packet, 11, event->data, event->size);
+    profiler_pb_bytes(&trace->out, 1, packet->data, packet->size);
+}
+
+static void profiler_trace_header(profiler_trace_t *trace){
+    profiler_buf_t *packet = &trace->packet;
+    profiler_buf_t *event = &trace->event; // nested scratch
+    packet->size = 0;
+    profiler_pb_varint(packet, 10, PROFILER_SEQUENCE_ID);
+    profiler_pb_varint(packet, 13, 1); // SEQ_INCREMENTAL_STATE_CLEARED
+
+    // TrackDescriptor 60 { uuid 1, name 2 }
+    event->size = 0;
+    profiler_pb_varint(event, 1, PROFILER_TRACK_UUID);
+    profiler_pb_string(event, 2, "ecs_progress");
+    profiler_pb_bytes(packet, 60, event->data, event->size);
+
+    // InternedData 12 { event_names 2 { iid 1, name 2 } }
+    profiler_buf_t names = { 0 };
+    profiler_buf_t entry = { 0 };
+    for (int32_t i = 0; i < trace->name_count; i++) {
+        entry.size = 0;
+        profiler_pb_varint(&entry, 1, (uint64_t)i + 1);
+        profiler_pb_string(&entry, 2, trace->names[i]);
+        profiler_pb_bytes(&names, 2, entry.data, entry.size);
+    }
+    profiler_pb_bytes(packet, 12, names.data, names.size);
+    if (names.failed || entry.failed) trace->out.failed = true;
+    ecs_os_free(names.data);
+    ecs_os_free(entry.data);
+
+    profiler_pb_bytes(&trace->out, 1, packet->data, packet->size);
+}
+
+static bool profiler_write_file(const char *path, const void *data, size_t size){
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+bool profiler_export_perfetto(const char *path){
+    int32_t count = profiler_frame_count();
+    if (count == 0) return false;
+    profiler_trace_t *trace = ecs_os_calloc(sizeof(profiler_trace_t));
+    if (!trace) return false;
+
+    static const char *frame_name = "frame";
+    profiler_trace_iid(trace, frame_name, true);
+    for (int32_t back = count - 1; back >= 0; back--) {
+        const profiler_frame_t *frame = profiler_frame(back);
+        for (int32_t z = 0; z < frame->zone_count; z++) profiler_trace_iid(trace, frame->zones[z].name, true);
+    }
+    profiler_trace_header(trace);
+
+    // zones are stored in begin order with their depth, ends come from a stack
+    for (int32_t back = count - 1; back >= 0; back--) {
+        const profiler_frame_t *frame = profiler_frame(back);
+        int32_t open[PROFILER_MAX_DEPTH];
+        int32_t top = 0;
+        profiler_trace_event(trace, frame->begin, true, frame_name);
+        for (int32_t z = 0; z < frame->zone_count; z++) {
+            const profiler_zone_t *zone = &frame->zones[z];
+            while (top > 0 && frame->zones[open[top - 1]].depth >= zone->depth) {
+                profiler_trace_event(trace, frame->zones[open[--top]].end, false, NULL);
+            }
+            profiler_trace_event(trace, zone->begin, true, zone->name);
+            if (top < PROFILER_MAX_DEPTH) open[top++] = z;
+        }
+        while (top > 0) profiler_trace_event(trace, frame->zones[open[--top]].end, false, NULL);
+        profiler_trace_event(trace, frame->end, false, NULL);
+    }
+
+    bool ok = !trace->out.failed && !trace->packet.failed && !trace->event.failed
+        && profiler_write_file(path, trace->out.data, trace->out.size);
+    ecs_os_free(trace->out.data);
+    ecs_os_free(trace->packet.data);
+    ecs_os_free(trace->event.data);
+    ecs_os_free(trace);
+    return ok;
+}
+
+// zone names come from system and script names, escape them for json
+static void profiler_json_string(FILE *file, const char *text){
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(file, "\\%c", *c);
+        else if (*c < 0x20) fprintf(file, "\\u%04x", *c);
+        else fputc(*c, file);
+    }
+}
+
+bool profiler_export_json(const char *path){
+    int32_t count = profiler_frame_count();
+    if (count == 0) return false;
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+
+    uint64_t base = profiler_frame(count - 1)->begin;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (int32_t back = count - 1; back >= 0; back--) {
+        const profiler_frame_t *frame = profiler_frame(back);
+        fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"id\":%llu,\"spike\":%s}}",
+            first ? "" : ",\n", (double)(frame->begin - base) / 1000.0, (double)(frame->end - frame->begin) / 1000.0,
+            (unsigned long long)frame->id, frame->spike ? "true" : "false");
+        first = false;
+        for (int32_t z = 0; z < frame->zone_count; z++) {
+            const profiler_zone_t *zone = &frame->zones[z];
+            fprintf(file, ",\n{\"name\":\"");
+            profiler_json_string(file, zone->name);
+            fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                (double)(zone->begin - base) / 1000.0, (double)(zone->end - zone->begin) / 1000.0);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+static void profiler_export_all(void){
+    bool trace = profiler_export_perfetto(PROFILER_TRACE_PATH);
+    bool json = profiler_export_json(PROFILER_JSON_PATH);
+    TraceLog(trace && json ? LOG_INFO : LOG_WARNING, "profiler export: %s %s, %s %s",
+        PROFILER_TRACE_PATH, trace ? "ok" : "failed", PROFILER_JSON_PATH, json ? "ok" : "failed");
+}
+
+//===============================================
+// OVERLAY
+//===============================================
+static Color profiler_zone_color(const char *name){
+    uint32_t hash = 2166136261u;
+    for (const char *c = name; *c; c++) hash = (hash ^ (uint8_t)*c) * 16777619u;
+    return ColorFromHSV((float)(hash % 360), 0.45f, 0.9f);
+}
+
+// newest frame on the right, a click selects the frame and pauses
+static void profiler_draw_graph(profiler_t *profiler, Rectangle bounds){
+    int32_t count = profiler_frame_count();
+    float max_ms = 1000.0f / 30.0f;
+    for (int32_t back = 0; back < count; back++) {
+        const profiler_frame_t *frame = profiler_frame(back);
+        float ms = profiler_ms(frame->begin, frame->end);
+        if (ms > max_ms) max_ms = ms;
+    }
+    float bar = bounds.width / PROFILER_FRAMES;
+    DrawRectangleRec(bounds, Fade(BLACK, 0.25f));
+    for (int32_t back = 0; back < count; back++) {
+        const profiler_frame_t *frame = profiler_frame(back);
+        float h = profiler_ms(frame->begin, frame->end) / max_ms * bounds.height;
+        Color color = frame->spike ? RED : SKYBLUE;
+        if (profiler->paused && back == profiler->selected) color = ORANGE;
+        DrawRectangleRec((Rectangle){ bounds.x + bounds.width - (back + 1) * bar, bounds.y + bounds.height - h, bar > 1.0f ? bar - 1.0f : bar, h }, color);
+    }
+    int y60 = (int)(bounds.y + bounds.height - (1000.0f / 60.0f) / max_ms * bounds.height);
+    DrawLine((int)bounds.x, y60, (int)(bounds.x + bounds.width), y60, Fade(GREEN, 0.8f));
+    DrawText(TextFormat("%.1f ms", max_ms), (int)bounds.x + 2, (int)bounds.y + 2, 10, RAYWHITE);
+
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && CheckCollisionPointRec(mouse, bounds)) {
+        int32_t back = (int32_t)((bounds.x + bounds.width - mouse.x) / bar);
+        if (back >= 0 && back < count) {
+            profiler->selected = back;
+            profiler->paused = true;
+        }
+    }
+}
+
+// zone rows by depth across the frame, hover shows the zone time
+static void profiler_draw_timeline(const profiler_frame_t *frame, Rectangle bounds){
+    const float row = 16.0f;
+    int32_t rows = (int32_t)(bounds.height / row);
+    DrawRectangleRec(bounds, Fade(BLACK, 0.25f));
+    double span = (double)(frame->end - frame->begin);
+    if (span <= 0.0) return;
+    Vector2 mouse = GetMousePosition();
+    const profiler_zone_t *hovered = NULL;
+    for (int32_t z = 0; z < frame->zone_count; z++) {
+        const profiler_zone_t *zone = &frame->zones[z];
+        if (zone->depth >= rows) continue;
+        float x0 = bounds.x + (float)((double)(zone->begin - frame->begin) / span * bounds.width);
+        float x1 = bounds.x + (float)((double)(zone->end - frame->begin) / span * bounds.width);
+        Rectangle r = { x0, bounds.y + zone->depth * row, x1 - x0 > 1.0f ? x1 - x0 : 1.0f, row - 1.0f };
+        DrawRectangleRec(r, profiler_zone_color(zone->name));
+        if (r.width > MeasureText(zone->name, 10) + 4) DrawText(zone->name, (int)r.x + 2, (int)r.y + 3, 10, BLACK);
+        if (CheckCollisionPointRec(mouse, r)) hovered = zone;
+    }
+    if (hovered) {
+        const char *text = TextFormat("%s %.3f ms", hovered->name, profiler_ms(hovered->begin, hovered->end));
+        Rectangle tip = { mouse.x + 12, mouse.y - 18, (float)MeasureText(text, 10) + 8, 16 };
+        DrawRectangleRec(tip, Fade(BLACK, 0.8f));
+        DrawText(text, (int)tip.x + 4, (int)tip.y + 3, 10, RAYWHITE);
+    }
+}
+
+// system zones of the frame by total time
+static void profiler_draw_top(const profiler_frame_t *frame, Rectangle bounds){
+    const char *names[PROFILER_MAX_ZONES];
+    float totals[PROFILER_MAX_ZONES];
+    int32_t count = 0;
+    for (int32_t z = 0; z < frame->zone_count; z++) {
+        const profiler_zone_t *zone = &frame->zones[z];
+        if (zone->depth != 1) continue;
+        int32_t i = 0;
+        while (i < count && names[i] != zone->name) i++;
+        if (i == count) {
+            names[count] = zone->name;
+            totals[count++] = 0.0f;
+        }
+        totals[i] += profiler_ms(zone->begin, zone->end);
+    }
+    GuiGroupBox(bounds, "Top systems");
+    for (int32_t rank = 0; rank < PROFILER_TOP_SYSTEMS && rank < count; rank++) {
+        int32_t best = rank;
+        for (int32_t i = rank + 1; i < count; i++) {
+            if (totals[i] > totals[best]) best = i;
+        }
+        const char *name = names[best];
+        float total = totals[best];
+        names[best] = names[rank];
+        totals[best] = totals[rank];
+        names[rank] = name;
+        totals[rank] = total;
+        DrawText(TextFormat("%6.3f %s", total, name), (int)bounds.x + 6, (int)bounds.y + 10 + rank * 14, 10, DARKGRAY);
+    }
+}
+
+static void profiler_overlay_system(ecs_iter_t *it){
+    profiler_t *profiler = ecs_field(it, profiler_t, 0);
+    if (!profiler->show_overlay) return;
+    if (!profiler->paused) profiler->selected = 0;
+
+    Rectangle panel = { 10, GetScreenHeight() - 250.0f, GetScreenWidth() - 20.0f, 240 };
+    GuiPanel(panel, TextFormat("Profiler  avg %.2f ms  last %.2f ms  spikes %d  systems %d",
+        profiler->average_ms, profiler->last_ms, profiler->spike_count, profiler->instrumented));
+
+    Rectangle button = { panel.x + 6, panel.y + 30, 70, 20 };
+    GuiToggle(button, "Record", &profiler->enabled);
+    button.x += 76;
+    GuiToggle(button, "Pause", &profiler->paused);
+    button.x += 76;
+    if (GuiButton(button, "Export")) profiler_export_all();
+
+    float side = 220.0f;
+    Rectangle graph = { panel.x + 6, panel.y + 56, panel.width - side - 18, 60 };
+    profiler_draw_graph(profiler, graph);
+
+    const profiler_frame_t *frame = profiler_frame(profiler->selected);
+    if (!frame) return;
+    DrawText(TextFormat("frame %llu  %.3f ms  zones %d  dropped %d", (unsigned long long)frame->id,
+        profiler_ms(frame->begin, frame->end), frame->zone_count, frame->dropped),
+        (int)button.x + 76, (int)button.y + 5, 10, DARKGRAY);
+    Rectangle timeline = { graph.x, graph.y + graph.height + 6, graph.width, panel.y + panel.height - graph.y - graph.height - 12 };
+    profiler_draw_timeline(frame, timeline);
+    profiler_draw_top(frame, (Rectangle){ graph.x + graph.width + 6, panel.y + 36, side, panel.height - 42 });
+}
+
+// F3 overlay, F4 writes the ring to disk
+static void profiler_key_system(ecs_iter_t *it){
+    profiler_t *profiler = ecs_field(it, profiler_t, 0);
+    if (IsKeyPressed(KEY_F3)) profiler->show_overlay = !profiler->show_overlay;
+    if (IsKeyPressed(KEY_F4)) profiler_export_all();
+}
+
+// closes the frame being recorded and starts the next one
+static void profiler_frame_system(ecs_iter_t *it){
+    profiler_t *profiler = ecs_field(it, profiler_t, 0);
+    uint64_t now = ecs_os_now();
+    if (profiler_state.recording) {
+        while (profiler_state.depth > 0) profiler_pop(now);
+        profiler_frame_t *frame = profiler_current();
+        frame->end = now;
+        float ms = profiler_ms(frame->begin, frame->end);
+        frame->spike = profiler->average_ms > 0.0f && ms > profiler->average_ms * profiler->spike_ratio;
+        if (frame->spike) profiler->spike_count++;
+        profiler->last_ms = ms;
+        profiler->average_ms = profiler->average_ms > 0.0f ? profiler->average_ms + (ms - profiler->average_ms) * 0.05f : ms;
+        profiler_state.head = (profiler_state.head + 1) % PROFILER_FRAMES;
+        // the head slot is being recorded, one less than the ring is complete
+        if (profiler_state.count < PROFILER_FRAMES - 1) profiler_state.count++;
+    }
+    profiler_state.depth = 0;
+    profiler_state.phase = NULL;
+    profiler_state.frame_id++;
+    profiler_state.recording = profiler_state.frames && profiler->enabled && !profiler->paused;
+    if (profiler_state.recording) {
+        profiler_frame_t *frame = profiler_current();
+        frame->id = profiler_state.frame_id;
+        frame->begin = now;
+        frame->end = now;
+        frame->zone_count = 0;
+        frame->dropped = 0;
+        frame->spike = false;
+    }
+}
+
+static void profiler_fini(ecs_world_t *world, void *ctx){
+    for (int32_t i = 0; i < profiler_state.wrap_count; i++) {
+        ecs_os_free(profiler_state.wraps[i]->name);
+        ecs_os_free(profiler_state.wraps[i]);
+    }
+    ecs_os_free(profiler_state.wraps);
+    ecs_os_free(profiler_state.frames);
+    memset(&profiler_state, 0, sizeof(profiler_state));
+}
+
+void setup_systems_profiler(ecs_world_t *world){
+    // first system of the frame whatever order the modules were set up in,
+    // EcsOnLoad depends on this phase so it is the root of the pipeline
+    ecs_entity_t frame_phase = ecs_entity(world, { .name = "ProfilerFramePhase" });
+    ecs_add_id(world, frame_phase, EcsPhase);
+    ecs_add_pair(world, EcsOnLoad, EcsDependsOn, frame_phase);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "profiler_frame_system", .add = ecs_ids(ecs_dependson(frame_phase)) }),
+        .query.terms = {
+            { .id = ecs_id(profiler_t), .src.id = ecs_id(profiler_t) } // Singleton
+        },
+        .callback = profiler_frame_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "profiler_key_system", .add = ecs_ids(ecs_dependson(LogicUpdatePhase)) }),
+        .query.terms = {
+            { .id = ecs_id(profiler_t), .src.id = ecs_id(profiler_t) } // Singleton
+        },
+        .callback = profiler_key_system
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "profiler_overlay_system", .add = ecs_ids(ecs_dependson(RLRender2D1Phase)) }),
+        .query.terms = {
+            { .id = ecs_id(profiler_t), .src.id = ecs_id(profiler_t) } // Singleton
+        },
+        .callback = profiler_overlay_system
+    });
+}
+
+void setup_components_profiler(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, profiler_t);
+
+    ecs_singleton_set(world, profiler_t, {
+        .enabled = true,
+        .spike_ratio = 2.0f
+    });
+}
+
+// call after module_init_raylib (phases), profiler_instrument after the rest
+void module_init_profiler(ecs_world_t *world){
+    if (!profiler_state.frames) {
+        profiler_state.frames = ecs_os_calloc(sizeof(profiler_frame_t) * PROFILER_FRAMES);
+        ecs_atexit(world, profiler_fini, NULL);
+    }
+    setup_components_profiler(world);
+    setup_systems_profiler(world);
+}
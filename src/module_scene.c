@@ -0,0 +1,389 @@
+// module_scene.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecs_components.h"
+#include "module_scene.h"
+#include "module_block.h"
+#include "module_ode.h"
+#include "module_picking.h"
+#include "file_map.h"
+
+ECS_COMPONENT_DECLARE(scene_t);
+
+#define SCENE_ALIGN_UP(v) (((v) + (SCENE_ALIGN - 1)) & ~(uint64_t)(SCENE_ALIGN - 1))
+
+bool scene_register(ecs_world_t *world, ecs_id_t id, uint32_t tag){
+    scene_t *scene = ecs_singleton_get_mut(world, scene_t);
+    if (!scene || id == 0 || scene->component_count >= SCENE_MAX_COMPONENTS) return false;
+    for (int32_t i = 0; i < scene->component_count; i++) {
+        if (scene->components[i].tag == tag || scene->components[i].id == id) return false;
+    }
+    const ecs_type_info_t *info = ecs_get_type_info(world, id);
+    scene->components[scene->component_count++] = (scene_component_t){
+        .tag = tag,
+        .id = id,
+        .size = info ? info->size : 0
+    };
+    return true;
+}
+
+//===============================================
+// SAVE
+//===============================================
+// one flecs table of scene entities
+typedef struct {
+    ecs_table_t *table;
+    int32_t offset;
+    int32_t count;
+    const ecs_entity_t *entities;
+    ecs_entity_t parent;
+    int32_t depth;
+    int32_t order;                  // query order, keeps the sort stable
+    uint64_t mask;
+    uint32_t first;                 // file index of entities[0]
+} scene_save_block_t;
+
+static int scene_block_compare(const void *a, const void *b){
+    const scene_save_block_t *x = a, *y = b;
+    if (x->depth != y->depth) return x->depth - y->depth;
+    return x->order - y->order;
+}
+
+static int32_t scene_depth(const ecs_world_t *world, ecs_entity_t e){
+    int32_t depth = 0;
+    while ((e = ecs_get_target(world, e, EcsChildOf, 0)) != 0) depth++;
+    return depth;
+}
+
+static bool scene_pad(FILE *file, uint64_t *written){
+    static const uint8_t zero[SCENE_ALIGN] = {0};
+    size_t pad = (size_t)(SCENE_ALIGN_UP(*written) - *written);
+    *written += pad;
+    return pad == 0 || fwrite(zero, 1, pad, file) == pad;
+}
+
+static bool scene_write(FILE *file, const void *data, size_t size, uint64_t *written){
+    *written += size;
+    return size == 0 || fwrite(data, 1, size, file) == size;
+}
+
+// appends a name to the blob, 0 is the empty string at its start
+static uint32_t scene_string(char **strings, uint64_t *size, uint64_t *capacity, const char *name){
+    if (!name || !name[0]) return 0;
+    size_t length = strlen(name) + 1;
+    if (*size + length > *capacity) {
+        uint64_t capacity_new = *capacity ? *capacity : 4096;
+        while (*size + length > capacity_new) capacity_new *= 2;
+        char *grown = ecs_os_realloc(*strings, (size_t)capacity_new);
+        if (!grown) return 0;
+        *strings = grown;
+        *capacity = capacity_new;
+    }
+    uint32_t offset = (uint32_t)*size;
+    memcpy(*strings + offset, name, length);
+    *size += length;
+    return offset;
+}
+
+int32_t scene_save(ecs_world_t *world, const char *path){
+    const scene_t *scene = ecs_singleton_get(world, scene_t);
+    if (!scene) return -1;
+    uint64_t start = ecs_os_now();
+    char tmp_path[1024];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return -1;
+
+    // tables with Transform3D, prefabs and disabled entities are left out
+    ecs_query_t *query = ecs_query(world, {
+        .terms = {{ .id = ecs_id(Transform3D) }}
+    });
+    scene_save_block_t *blocks = NULL;
+    int32_t block_count = 0, block_capacity = 0;
+    uint64_t entity_count = 0;
+    ecs_iter_t it = ecs_query_iter(world, query);
+    while (ecs_query_next(&it)) {
+        if (block_count == block_capacity) {
+            block_capacity = block_capacity ? block_capacity * 2 : 64;
+            scene_save_block_t *grown = ecs_os_realloc(blocks, sizeof(scene_save_block_t) * (size_t)block_capacity);
+            if (!grown) {
+                ecs_iter_fini(&it);
+                ecs_os_free(blocks);
+                ecs_query_fini(query);
+                return -1;
+            }
+            blocks = grown;
+        }
+        scene_save_block_t *block = &blocks[block_count];
+        *block = (scene_save_block_t){
+            .table = it.table,
+            .offset = it.offset,
+            .count = it.count,
+            .entities = it.entities,
+            .parent = ecs_get_target(world, it.entities[0], EcsChildOf, 0),
+            .order = block_count
+        };
+        block->depth = block->parent ? scene_depth(world, block->parent) + 1 : 0;
+        for (int32_t c = 0; c < scene->component_count; c++) {
+            if (ecs_table_has_id(world, it.table, scene->components[c].id)) block->mask |= 1ull << c;
+        }
+        entity_count += (uint64_t)it.count;
+        block_count++;
+    }
+    if (entity_count > INT32_MAX) {
+        ecs_os_free(blocks);
+        ecs_query_fini(query);
+        return -1;
+    }
+
+    // parents first, then every entity gets its index in the file
+    if (block_count > 1) qsort(blocks, (size_t)block_count, sizeof(scene_save_block_t), scene_block_compare);
+    ecs_map_t indices;
+    ecs_map_init(&indices, NULL);
+    uint32_t index = 0;
+    for (int32_t b = 0; b < block_count; b++) {
+        blocks[b].first = index;
+        for (int32_t i = 0; i < blocks[b].count; i++) {
+            ecs_map_insert(&indices, blocks[b].entities[i], index++);
+        }
+    }
+
+    FILE *file = fopen(tmp_path, "wb");
+    bool ok = file != NULL;
+    scene_header_t header = {
+        .magic = SCENE_MAGIC,
+        .version = SCENE_VERSION,
+        .entity_count = (uint32_t)entity_count,
+        .block_count = (uint32_t)block_count,
+        .component_count = (uint32_t)scene->component_count
+    };
+    uint64_t written = 0;
+    if (ok) ok = scene_write(file, &header, sizeof(header), &written);
+    for (int32_t c = 0; ok && c < scene->component_count; c++) {
+        scene_component_entry_t entry = { scene->components[c].tag, (uint32_t)scene->components[c].size };
+        ok = scene_write(file, &entry, sizeof(entry), &written);
+    }
+
+    char *strings = NULL;
+    uint64_t strings_size = 1, strings_capacity = 0;
+    uint32_t *names = NULL;
+    int32_t names_capacity = 0;
+    strings = ecs_os_malloc(4096);
+    if (strings) {
+        strings[0] = '\0';
+        strings_capacity = 4096;
+    } else {
+        ok = false;
+    }
+
+    for (int32_t b = 0; ok && b < block_count; b++) {
+        const scene_save_block_t *block = &blocks[b];
+        ok = scene_pad(file, &written);
+
+        // names first, the block header says whether a column follows
+        if (block->count > names_capacity) {
+            uint32_t *grown = ecs_os_realloc(names, sizeof(uint32_t) * (size_t)block->count);
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            names = grown;
+            names_capacity = block->count;
+        }
+        bool has_names = false;
+        for (int32_t i = 0; i < block->count; i++) {
+            names[i] = scene_string(&strings, &strings_size, &strings_capacity, ecs_get_name(world, block->entities[i]));
+            has_names |= names[i] != 0;
+        }
+
+        uint64_t size = SCENE_ALIGN_UP(sizeof(scene_block_t));
+        for (int32_t c = 0; c < scene->component_count; c++) {
+            if (block->mask & (1ull << c)) size += SCENE_ALIGN_UP((uint64_t)scene->components[c].size * (uint64_t)block->count);
+        }
+        if (has_names) size += SCENE_ALIGN_UP(sizeof(uint32_t) * (uint64_t)block->count);
+
+        int32_t parent = -1;
+        if (block->parent) {
+            ecs_map_val_t *found = ecs_map_get(&indices, block->parent);
+            if (found) parent = (int32_t)*found;
+        }
+        scene_block_t header_block = {
+            .mask = block->mask,
+            .size = size,
+            .count = (uint32_t)block->count,
+            .parent = parent,
+            .has_names = has_names ? 1u : 0u
+        };
+        if (ok) ok = scene_write(file, &header_block, sizeof(header_block), &written);
+        for (int32_t c = 0; ok && c < scene->component_count; c++) {
+            if (!(block->mask & (1ull << c)) || scene->components[c].size == 0) continue;
+            ok = scene_pad(file, &written);
+            const void *column = ecs_table_get_id(world, block->table, scene->components[c].id, block->offset);
+            if (ok) ok = column && scene_write(file, column, (size_t)scene->components[c].size * (size_t)block->count, &written);
+        }
+        if (ok && has_names) {
+            ok = scene_pad(file, &written);
+            if (ok) ok = scene_write(file, names, sizeof(uint32_t) * (size_t)block->count, &written);
+        }
+    }
+
+    if (ok) ok = scene_pad(file, &written);
+    header.strings_offset = written;
+    header.strings_size = strings_size;
+    if (ok) ok = scene_write(file, strings, (size_t)strings_size, &written);
+    if (ok) ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    if (file && fclose(file) != 0) ok = false;
+
+    ecs_os_free(names);
+    ecs_os_free(strings);
+    ecs_map_fini(&indices);
+    ecs_os_free(blocks);
+    ecs_query_fini(query);
+
+    if (ok) ok = file_map_replace(tmp_path, path);
+    if (!ok) {
+        remove(tmp_path);
+        return -1;
+    }
+    scene_t *stats = ecs_singleton_get_mut(world, scene_t);
+    stats->last_entities = (int32_t)entity_count;
+    stats->last_blocks = block_count;
+    stats->last_ms = (float)((double)(ecs_os_now() - start) / 1e6);
+    return (int32_t)entity_count;
+}
+
+//===============================================
+// LOAD
+//===============================================
+int32_t scene_load(ecs_world_t *world, const char *path){
+    const scene_t *scene = ecs_singleton_get(world, scene_t);
+    if (!scene) return -1;
+    uint64_t start = ecs_os_now();
+    file_map_t map;
+    if (!file_map_open(&map, path)) return -1;
+
+    const uint8_t *data = map.data;
+    const scene_header_t *header = (const scene_header_t *)data;
+    uint64_t entries_end = sizeof(scene_header_t);
+    bool ok = map.size >= sizeof(scene_header_t)
+        && header->magic == SCENE_MAGIC
+        && header->version == SCENE_VERSION
+        && header->component_count <= SCENE_MAX_COMPONENTS
+        && header->entity_count <= INT32_MAX;
+    if (ok) {
+        entries_end += sizeof(scene_component_entry_t) * (uint64_t)header->component_count;
+        ok = entries_end <= map.size
+            && header->strings_size > 0
+            && header->strings_offset >= entries_end
+            && header->strings_offset + header->strings_size <= map.size
+            && data[header->strings_offset + header->strings_size - 1] == '\0';
+    }
+    if (!ok) {
+        file_map_close(&map);
+        return -1;
+    }
+    const char *strings = (const char *)data + header->strings_offset;
+
+    // file component to registry index, -1 is skipped
+    const scene_component_entry_t *entries = (const scene_component_entry_t *)(data + sizeof(scene_header_t));
+    int32_t local[SCENE_MAX_COMPONENTS];
+    for (uint32_t c = 0; c < header->component_count; c++) {
+        local[c] = -1;
+        for (int32_t r = 0; r < scene->component_count; r++) {
+            if (scene->components[r].tag != entries[c].tag) continue;
+            if ((uint32_t)scene->components[r].size == entries[c].size) local[c] = r;
+            break;
+        }
+        if (local[c] < 0) {
+            TraceLog(LOG_WARNING, "SCENE: %s skips component %08x (%u bytes)", path, entries[c].tag, entries[c].size);
+        }
+    }
+
+    ecs_entity_t *entities = ecs_os_malloc(sizeof(ecs_entity_t) * ((size_t)header->entity_count + 1));
+    if (!entities) {
+        file_map_close(&map);
+        return -1;
+    }
+    uint32_t created = 0;
+    uint64_t offset = SCENE_ALIGN_UP(entries_end);
+    for (uint32_t b = 0; ok && b < header->block_count; b++) {
+        const scene_block_t *block = (const scene_block_t *)(data + offset);
+        ok = offset + sizeof(scene_block_t) <= header->strings_offset
+            && block->size >= sizeof(scene_block_t)
+            && offset + block->size <= header->strings_offset
+            && block->count > 0
+            && (uint64_t)created + block->count <= header->entity_count
+            && block->parent < (int32_t)created
+            && (header->component_count == 64 || (block->mask >> header->component_count) == 0);
+        if (!ok) break;
+
+        ecs_bulk_desc_t desc = { .count = (int32_t)block->count };
+        void *columns[FLECS_ID_DESC_MAX] = {0};
+        int32_t id_count = 0;
+        bool has_shape = false;
+        uint64_t column = offset + SCENE_ALIGN_UP(sizeof(scene_block_t));
+        for (uint32_t c = 0; c < header->component_count; c++) {
+            if (!(block->mask & (1ull << c))) continue;
+            const void *values = NULL;
+            if (entries[c].size > 0) {
+                values = data + column;
+                column += SCENE_ALIGN_UP((uint64_t)entries[c].size * block->count);
+            }
+            // one slot is kept for the ChildOf pair and one for the terminator
+            if (local[c] < 0 || id_count >= FLECS_ID_DESC_MAX - 2) continue;
+            desc.ids[id_count] = scene->components[local[c]].id;
+            columns[id_count] = (void *)values; // flecs only copies from it
+            has_shape |= desc.ids[id_count] == ecs_id(ode_shape_t);
+            id_count++;
+        }
+        const uint32_t *names = NULL;
+        if (block->has_names) {
+            names = (const uint32_t *)(data + column);
+            column += SCENE_ALIGN_UP(sizeof(uint32_t) * (uint64_t)block->count);
+        }
+        ok = column <= offset + block->size;
+        if (!ok) break;
+        if (block->parent >= 0) desc.ids[id_count++] = ecs_pair(EcsChildOf, entities[block->parent]);
+        desc.data = columns;
+
+        // the returned ids are only valid until the next bulk call
+        const ecs_entity_t *bulk = ecs_bulk_init(world, &desc);
+        if (!bulk) {
+            ok = false;
+            break;
+        }
+        ecs_entity_t *block_entities = entities + created;
+        memcpy(block_entities, bulk, sizeof(ecs_entity_t) * block->count);
+        for (uint32_t i = 0; names && i < block->count; i++) {
+            if (names[i] != 0 && names[i] < header->strings_size) ecs_set_name(world, block_entities[i], strings + names[i]);
+        }
+        if (has_shape) ode_shape_create(world, block_entities, (int32_t)block->count);
+        created += block->count;
+        offset += SCENE_ALIGN_UP(block->size);
+    }
+    ecs_os_free(entities);
+    file_map_close(&map);
+
+    scene_t *stats = ecs_singleton_get_mut(world, scene_t);
+    stats->last_entities = (int32_t)created;
+    stats->last_blocks = (int32_t)header->block_count;
+    stats->last_ms = (float)((double)(ecs_os_now() - start) / 1e6);
+    // a damaged block stops the load, what came before it stays
+    return ok ? (int32_t)created : -1;
+}
+
+//===============================================
+// COMPONENTS
+//===============================================
+void setup_components_scene(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, scene_t);
+}
+
+void module_init_scene(ecs_world_t *world){
+    setup_components_scene(world);
+    ecs_singleton_set(world, scene_t, { 0 });
+    // tags are part of the file format, never reuse one for another type
+    scene_register(world, ecs_id(Transform3D), SCENE_TAG('T', 'R', 'F', '3'));
+    scene_register(world, ecs_id(block_t), SCENE_TAG('B', 'L', 'C', 'K'));
+    scene_register(world, ecs_id(ode_shape_t), SCENE_TAG('O', 'D', 'E', 'S'));
+    scene_register(world, ecs_id(pick_shape_t), SCENE_TAG('P', 'I', 'C', 'K'));
+}
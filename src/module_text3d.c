@@ -0,0 +1,366 @@
+// module_text3d.c
+// world space text labels
+// DrawTextCodepoint3D (examples/c/raylib_text3d.c) checks the batch limit,
+// binds the font texture and pushes a matrix for every glyph. here a label
+// is laid out once into glyph quads in label space, the render system
+// billboards the quads of every visible label into one interleaved vertex
+// buffer and draws it with a single call. quads are not indexed, six
+// vertices each, so the count is not held to 16 bit indices.
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecs_components.h"
+#include "module_text3d.h"
+#include "rlgl.h"
+
+ECS_COMPONENT_DECLARE(text3d_t);
+ECS_COMPONENT_DECLARE(text3d_renderer_t);
+
+// 24 bytes, position, texcoord, normalized color
+typedef struct {
+    float x, y, z;
+    float u, v;
+    unsigned char r, g, b, a;
+} text3d_vertex_t;
+
+static ecs_query_t *text3d_query = NULL;
+
+//===============================================
+// LAYOUT
+//===============================================
+static void text3d_layout_free(text3d_t *label){
+    ecs_os_free(label->glyphs);
+    label->glyphs = NULL;
+    label->glyph_count = 0;
+    label->width = 0.0f;
+    label->height = 0.0f;
+    label->laid_out = false;
+}
+
+// same metrics as DrawTextCodepoint3D, one quad per visible codepoint
+static void text3d_layout(const Font *font, text3d_t *label){
+    text3d_layout_free(label);
+    label->laid_out = true;
+    size_t length = strnlen(label->text, TEXT3D_TEXT_SIZE);
+    if (length == 0 || font->texture.id == 0 || font->baseSize <= 0) return;
+    label->glyphs = ecs_os_malloc(sizeof(text3d_glyph_t) * length); // a codepoint is at least one byte
+    if (!label->glyphs) return;
+
+    float scale = label->size / (float)font->baseSize;
+    float pad = (float)font->glyphPadding;
+    float tex_w = (float)font->texture.width;
+    float tex_h = (float)font->texture.height;
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    for (size_t i = 0; i < length;) {
+        int bytes = 0;
+        int codepoint = GetCodepointNext(&label->text[i], &bytes);
+        i += bytes > 0 ? (size_t)bytes : 1;
+        if (codepoint == '\n') {
+            x = 0.0f;
+            y += label->size + label->spacing;
+            continue;
+        }
+        int index = GetGlyphIndex(*font, codepoint);
+        const GlyphInfo *info = &font->glyphs[index];
+        Rectangle rec = font->recs[index];
+        if (codepoint != ' ' && codepoint != '\t') {
+            text3d_glyph_t *glyph = &label->glyphs[label->glyph_count++];
+            glyph->x0 = x + ((float)info->offsetX - pad) * scale;
+            glyph->y0 = y + ((float)info->offsetY - pad) * scale;
+            glyph->x1 = glyph->x0 + (rec.width + 2.0f * pad) * scale;
+            glyph->y1 = glyph->y0 + (rec.height + 2.0f * pad) * scale;
+            glyph->u0 = (rec.x - pad) / tex_w;
+            glyph->v0 = (rec.y - pad) / tex_h;
+            glyph->u1 = (rec.x + rec.width + pad) / tex_w;
+            glyph->v1 = (rec.y + rec.height + pad) / tex_h;
+        }
+        x += (info->advanceX != 0 ? (float)info->advanceX : rec.width) * scale;
+        if (x > width) width = x;
+        x += label->spacing;
+    }
+    label->width = width;
+    label->height = y + label->size;
+}
+
+// the cache never travels with a copy, the copy is laid out on its own
+static void text3d_t_ctor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    memset(ptr, 0, sizeof(text3d_t) * (size_t)count);
+}
+
+static void text3d_t_dtor(void *ptr, int32_t count, const ecs_type_info_t *type_info){
+    text3d_t *label = ptr;
+    for (int32_t i = 0; i < count; i++) text3d_layout_free(&label[i]);
+}
+
+static void text3d_t_copy(void *dst_ptr, const void *src_ptr, int32_t count, const ecs_type_info_t *type_info){
+    text3d_t *dst = dst_ptr;
+    const text3d_t *src = src_ptr;
+    for (int32_t i = 0; i < count; i++) {
+        text3d_layout_free(&dst[i]);
+        memcpy(dst[i].text, src[i].text, TEXT3D_TEXT_SIZE);
+        dst[i].offset = src[i].offset;
+        dst[i].size = src[i].size;
+        dst[i].spacing = src[i].spacing;
+        dst[i].color = src[i].color;
+    }
+}
+
+static void text3d_t_move(void *dst_ptr, void *src_ptr, int32_t count, const ecs_type_info_t *type_info){
+    text3d_t *dst = dst_ptr;
+    text3d_t *src = src_ptr;
+    for (int32_t i = 0; i < count; i++) {
+        text3d_layout_free(&dst[i]);
+        dst[i] = src[i];
+        src[i].glyphs = NULL;
+        src[i].glyph_count = 0;
+        src[i].laid_out = false;
+    }
+}
+
+// ecs_modified after editing the text in place
+void on_set_text3d(ecs_iter_t *it){
+    text3d_t *label = ecs_field(it, text3d_t, 0);
+    for (int i = 0; i < it->count; i++) text3d_layout_free(&label[i]);
+}
+
+void text3d_set_font(ecs_world_t *world, Font font, bool owned){
+    text3d_renderer_t *renderer = ecs_singleton_get_mut(world, text3d_renderer_t);
+    if (!renderer) return;
+    if (renderer->owns_font) UnloadFont(renderer->font);
+    renderer->font = font;
+    renderer->owns_font = owned;
+    if (!text3d_query) return;
+    ecs_iter_t it = ecs_query_iter(world, text3d_query);
+    while (ecs_query_next(&it)) {
+        text3d_t *label = ecs_field(&it, text3d_t, 1);
+        for (int i = 0; i < it.count; i++) text3d_layout_free(&label[i]);
+    }
+}
+
+//===============================================
+// VERTEX BUFFER
+//===============================================
+static void text3d_attributes(const text3d_renderer_t *renderer){
+    const int *locs = renderer->shader.locs;
+    int stride = (int)sizeof(text3d_vertex_t);
+    rlSetVertexAttribute((unsigned int)locs[SHADER_LOC_VERTEX_POSITION], 3, RL_FLOAT, false, stride, (int)offsetof(text3d_vertex_t, x));
+    rlEnableVertexAttribute((unsigned int)locs[SHADER_LOC_VERTEX_POSITION]);
+    rlSetVertexAttribute((unsigned int)locs[SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_FLOAT, false, stride, (int)offsetof(text3d_vertex_t, u));
+    rlEnableVertexAttribute((unsigned int)locs[SHADER_LOC_VERTEX_TEXCOORD01]);
+    rlSetVertexAttribute((unsigned int)locs[SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, stride, (int)offsetof(text3d_vertex_t, r));
+    rlEnableVertexAttribute((unsigned int)locs[SHADER_LOC_VERTEX_COLOR]);
+}
+
+static void text3d_buffer_unload(text3d_renderer_t *renderer){
+    if (renderer->vao) rlUnloadVertexArray(renderer->vao);
+    if (renderer->vbo) rlUnloadVertexBuffer(renderer->vbo);
+    renderer->vao = 0;
+    renderer->vbo = 0;
+    renderer->gpu_capacity = 0;
+}
+
+// cpu staging and gpu buffer grow together by doubling
+static bool text3d_buffer_reserve(text3d_renderer_t *renderer, int32_t vertex_count){
+    if (vertex_count <= renderer->vertex_capacity) return true;
+    int32_t capacity = renderer->vertex_capacity > 0 ? renderer->vertex_capacity : TEXT3D_MIN_VERTICES;
+    while (capacity < vertex_count) capacity *= 2;
+    void *vertices = ecs_os_realloc(renderer->vertices, sizeof(text3d_vertex_t) * (size_t)capacity);
+    if (!vertices) return false;
+    renderer->vertices = vertices;
+    renderer->vertex_capacity = capacity;
+
+    text3d_buffer_unload(renderer);
+    renderer->vao = rlLoadVertexArray();
+    rlEnableVertexArray(renderer->vao);
+    renderer->vbo = rlLoadVertexBuffer(NULL, (int)(sizeof(text3d_vertex_t) * (size_t)capacity), true);
+    if (renderer->vao) text3d_attributes(renderer);
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    renderer->gpu_capacity = renderer->vbo ? capacity : 0;
+    return renderer->vbo != 0;
+}
+
+//===============================================
+// RENDER
+//===============================================
+static void text3d_corner(text3d_vertex_t *vertex, Vector3 anchor, Vector3 right, Vector3 up,
+                          float x, float y, float u, float v, Color color){
+    vertex->x = anchor.x + right.x * x + up.x * y;
+    vertex->y = anchor.y + right.y * x + up.y * y;
+    vertex->z = anchor.z + right.z * x + up.z * y;
+    vertex->u = u;
+    vertex->v = v;
+    vertex->r = color.r;
+    vertex->g = color.g;
+    vertex->b = color.b;
+    vertex->a = color.a;
+}
+
+// counter clockwise facing the camera, backface culling stays on
+static text3d_vertex_t *text3d_emit(text3d_vertex_t *out, const text3d_t *label, Vector3 anchor, Vector3 right, Vector3 up){
+    float half = label->width * 0.5f;
+    for (int32_t g = 0; g < label->glyph_count; g++) {
+        const text3d_glyph_t *glyph = &label->glyphs[g];
+        float left = glyph->x0 - half;
+        float right_x = glyph->x1 - half;
+        float top = label->height - glyph->y0;
+        float bottom = label->height - glyph->y1;
+        text3d_corner(&out[0], anchor, right, up, left, top, glyph->u0, glyph->v0, label->color);
+        text3d_corner(&out[1], anchor, right, up, left, bottom, glyph->u0, glyph->v1, label->color);
+        text3d_corner(&out[2], anchor, right, up, right_x, bottom, glyph->u1, glyph->v1, label->color);
+        out[3] = out[0];
+        out[4] = out[2];
+        text3d_corner(&out[5], anchor, right, up, right_x, top, glyph->u1, glyph->v0, label->color);
+        out += 6;
+    }
+    return out;
+}
+
+static void text3d_draw(text3d_renderer_t *renderer, int32_t vertex_count){
+    rlUpdateVertexBuffer(renderer->vbo, renderer->vertices, (int)(sizeof(text3d_vertex_t) * (size_t)vertex_count), 0);
+    rlDrawRenderBatchActive(); // whatever raylib batched so far goes first
+
+    const int *locs = renderer->shader.locs;
+    rlEnableShader(renderer->shader.id);
+    Matrix mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], mvp);
+    float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], white, SHADER_UNIFORM_VEC4, 1);
+    int slot = 0;
+    rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE], &slot, SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(0);
+    rlEnableTexture(renderer->font.texture.id);
+    if (!rlEnableVertexArray(renderer->vao)) {
+        rlEnableVertexBuffer(renderer->vbo);
+        text3d_attributes(renderer);
+    }
+    // without the discard shader the transparent glyph corners would hide labels behind them
+    if (!renderer->has_shader) rlDisableDepthMask();
+    rlDrawVertexArray(0, vertex_count);
+    if (!renderer->has_shader) rlEnableDepthMask();
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+void render_3d_text3d_system(ecs_iter_t *it){
+    const main_context_t *main_context = ecs_singleton_get(it->world, main_context_t);
+    text3d_renderer_t *renderer = ecs_singleton_get_mut(it->world, text3d_renderer_t);
+    if (!main_context || !renderer || !text3d_query) return;
+    renderer->labels_drawn = 0;
+    renderer->labels_culled = 0;
+    renderer->glyphs_drawn = 0;
+    renderer->draw_calls = 0;
+    if (renderer->font.texture.id == 0) return;
+
+    const Camera3D *camera = &main_context->camera;
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera->target, camera->position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera->up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+    float max_distance_sq = renderer->max_distance * renderer->max_distance;
+
+    int32_t vertex_count = 0;
+    ecs_iter_t qit = ecs_query_iter(it->world, text3d_query);
+    while (ecs_query_next(&qit)) {
+        const Transform3D *transform = ecs_field(&qit, Transform3D, 0);
+        text3d_t *label = ecs_field(&qit, text3d_t, 1);
+        for (int i = 0; i < qit.count; i++) {
+            if (!label[i].laid_out) text3d_layout(&renderer->font, &label[i]);
+            if (label[i].glyph_count == 0) continue;
+            const Matrix *world = &transform[i].worldMatrix;
+            Vector3 anchor = { world->m12 + label[i].offset.x, world->m13 + label[i].offset.y, world->m14 + label[i].offset.z };
+            Vector3 to = Vector3Subtract(anchor, camera->position);
+            if (Vector3DotProduct(to, to) > max_distance_sq || Vector3DotProduct(to, forward) < 0.0f) {
+                renderer->labels_culled++;
+                continue;
+            }
+            int32_t needed = vertex_count + label[i].glyph_count * 6;
+            if (!text3d_buffer_reserve(renderer, needed)) continue;
+            text3d_emit((text3d_vertex_t *)renderer->vertices + vertex_count, &label[i], anchor, right, up);
+            vertex_count = needed;
+            renderer->labels_drawn++;
+            renderer->glyphs_drawn += label[i].glyph_count;
+        }
+    }
+    if (vertex_count == 0) return;
+    text3d_draw(renderer, vertex_count);
+    renderer->draw_calls = 1;
+}
+
+void on_remove_text3d_renderer(ecs_iter_t *it){
+    text3d_renderer_t *renderer = ecs_field(it, text3d_renderer_t, 0);
+    for (int i = 0; i < it->count; i++) {
+        text3d_buffer_unload(&renderer[i]);
+        ecs_os_free(renderer[i].vertices);
+        if (renderer[i].has_shader) UnloadShader(renderer[i].shader);
+        if (renderer[i].owns_font) UnloadFont(renderer[i].font);
+        memset(&renderer[i], 0, sizeof(text3d_renderer_t));
+    }
+}
+
+void setup_systems_text3d(ecs_world_t *world){
+    text3d_query = ecs_query(world, {
+        .terms = {
+            { .id = ecs_id(Transform3D), .inout = EcsIn },
+            { .id = ecs_id(text3d_t) }
+        },
+        .cache_kind = EcsQueryCacheAuto
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "render_3d_text3d_system", .add = ecs_ids(ecs_dependson(RLRender3DPhase)) }),
+        .callback = render_3d_text3d_system
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(text3d_t) }},
+        .events = { EcsOnSet },
+        .callback = on_set_text3d
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(text3d_renderer_t) }},
+        .events = { EcsOnRemove },
+        .callback = on_remove_text3d_renderer
+    });
+}
+
+void setup_components_text3d(ecs_world_t *world){
+    ECS_COMPONENT_DEFINE(world, text3d_t);
+    ECS_COMPONENT_DEFINE(world, text3d_renderer_t);
+
+    ecs_set_hooks(world, text3d_t, {
+        .ctor = text3d_t_ctor,
+        .dtor = text3d_t_dtor,
+        .copy = text3d_t_copy,
+        .move = text3d_t_move
+    });
+
+    text3d_renderer_t renderer = {
+        .font = GetFontDefault(),
+        .max_distance = TEXT3D_MAX_DISTANCE
+    };
+    // alpha_discard.fs is only written for glsl 330, 100 keeps the default shader
+    int version = rlGetVersion();
+    if (version == RL_OPENGL_33 || version == RL_OPENGL_43) {
+        Shader shader = LoadShader(NULL, "resources/shaders/glsl330/alpha_discard.fs");
+        if (shader.id != rlGetShaderIdDefault()) {
+            renderer.shader = shader;
+            renderer.has_shader = true;
+        }
+    }
+    if (!renderer.has_shader) {
+        renderer.shader.id = rlGetShaderIdDefault();
+        renderer.shader.locs = rlGetShaderLocsDefault();
+    }
+    ecs_singleton_set_ptr(world, text3d_renderer_t, &renderer);
+}
+
+void module_init_text3d(ecs_world_t *world){
+    setup_components_text3d(world);
+    setup_systems_text3d(world);
+}